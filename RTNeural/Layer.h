@@ -1,6 +1,7 @@
 #ifndef LAYER_H_INCLUDED
 #define LAYER_H_INCLUDED
 
+#include "weights_view.h"
 #include <cstddef>
 #include <string>
 
@@ -39,6 +40,28 @@ public:
     /** Implements the forward propagation step for this layer. */
     virtual void forward(const T* input, T* out) noexcept = 0;
 
+    /**
+     * Returns the number of inputs this layer consumes for each new output.
+     * For decimating layers, the following layers in a model only need
+     * to run at the reduced rate.
+     */
+    virtual int getDecimationFactor() const noexcept { return 1; }
+
+    /**
+     * Returns the number of output frames this layer produces for each input.
+     * The output of an upsampling layer is laid out as `outs[factor][out_size / factor]`,
+     * and the following layers in a model run once for each output frame.
+     */
+    virtual int getUpsamplingFactor() const noexcept { return 1; }
+
+    /**
+     * Prepares this layer to process with a given delay length,
+     * for performing sample-rate correction (see SampleRateCorrectionMode).
+     * Recurrent layers delay their state, and convolutional layers scale
+     * their dilation, while other layers do nothing by default.
+     */
+    virtual void prepare(T /*delaySamples*/) { }
+
     const int in_size;
     const int out_size;
 };
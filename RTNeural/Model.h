@@ -1,6 +1,7 @@
 #ifndef MODEL_H_INCLUDED
 #define MODEL_H_INCLUDED
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -8,11 +9,28 @@
 #include "activation/activation.h"
 #include "conv1d/conv1d.h"
 #include "conv1d/conv1d.tpp"
+#include "conv1d/conv1d_quantized.h"
+#include "conv1d/strided_conv1d.h"
+#include "conv2d/conv2d.h"
+#include "conv2d/conv2d.tpp"
 #include "dense/dense.h"
+#include "dense/dense_low_rank.h"
+#include "dense/dense_quantized.h"
+#include "dense/dense_sparse.h"
 #include "gru/gru.h"
 #include "gru/gru.tpp"
+#include "gru/gru_quantized.h"
+#include "gru/gru_sparse.h"
+#include "half_precision/half_precision_layers.h"
 #include "lstm/lstm.h"
 #include "lstm/lstm.tpp"
+#include "lstm/lstm_quantized.h"
+#include "lstm/lstm_sparse.h"
+#include "mapped/mapped_layers.h"
+#include "transposed_conv1d/transposed_conv1d.h"
+#include "transposed_conv1d/transposed_conv1d.tpp"
+#include "wavenet/wavenet.h"
+#include "wavenet/wavenet.tpp"
 
 namespace RTNeural
 {
@@ -43,54 +61,146 @@ public:
         outs.clear();
     }
 
+    /** Returns the input size of the network. */
+    int getInSize() const noexcept { return in_size; }
+
     /** Returns the required input size for the next layer being added to the network. */
     int getNextInSize() const
     {
         if(layers.empty())
             return in_size;
 
-        return layers.back()->out_size;
+        return layers.back()->out_size / layers.back()->getUpsamplingFactor();
     }
 
     /** Adds a new layer to the sequential model. */
     void addLayer(Layer<T>* layer)
     {
+        layer_decimations.push_back(output_decimation);
+        layer_decimation_factors.push_back(layer->getDecimationFactor());
+        layer_upsampling_factors.push_back(layer->getUpsamplingFactor());
+        decimation_counters.push_back(0);
+        output_decimation *= layer->getDecimationFactor();
+
+        // with upsampling layers before the last layer, the last
+        // layer runs more than once, so its outputs are collected
+        const auto num_runs = output_upsampling;
+        output_upsampling *= layer->getUpsamplingFactor();
+        upsampled_outs.assign(num_runs > 1 ? (size_t)(num_runs * layer->out_size) : 0, (T)0);
+
         layers.push_back(layer);
         outs.push_back(vec_type(layer->out_size, (T)0));
     }
 
+    /**
+     * Prepares the recurrent and convolutional layers in the network to
+     * process data at `sampleRateRatio` times the sample rate that the
+     * network was trained at. The ratio must be greater than or equal
+     * to 1 (see SampleRateCorrectionMode).
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(T sampleRateRatio)
+    {
+        for(auto* l : layers)
+            l->prepare(sampleRateRatio);
+
+        reset();
+    }
+
     /** Resets the state of the network layers. */
     void reset()
     {
         for(auto* l : layers)
             l->reset();
+
+        std::fill(decimation_counters.begin(), decimation_counters.end(), 0);
+        std::fill(upsampled_outs.begin(), upsampled_outs.end(), (T)0);
     }
 
-    /** Performs forward propagation for this model. */
+    /**
+     * Performs forward propagation for this model.
+     *
+     * If the model contains decimating layers, the layers
+     * following a decimating layer only run when that layer
+     * produces a new output. Otherwise, the previous model
+     * output is returned.
+     *
+     * If the model contains upsampling layers, the layers
+     * following an upsampling layer run once for each of its
+     * output frames, and `getOutputs()` holds all of the model
+     * output frames. The first output is returned.
+     */
     inline T forward(const T* input)
     {
-        layers[0]->forward(input, outs[0].data());
-
-        for(int i = 1; i < (int)layers.size(); ++i)
-        {
-            layers[i]->forward(outs[i - 1].data(), outs[i].data());
-        }
+        forwardLayers(0, input, 0);
+        return getOutputs()[0];
+    }
 
-        return outs.back()[0];
+    /**
+     * Returns the number of model inputs per run of the layer at the given index.
+     * For models without any decimating layers, this will always be 1.
+     */
+    int getLayerDecimation(int layer_idx) const noexcept
+    {
+        return layer_decimations[layer_idx];
     }
 
-    /** Returns a pointer to the output of the final layer in the network. */
+    /** Returns the number of model inputs per new output of the model. */
+    int getOutputDecimation() const noexcept { return output_decimation; }
+
+    /** Returns the number of output frames the model produces for each input. */
+    int getOutputUpsampling() const noexcept { return output_upsampling; }
+
+    /**
+     * Returns a pointer to the output of the final layer in the network.
+     * For models with upsampling layers, the outputs are laid out as
+     * `outs[getOutputUpsampling()][out_size]`.
+     */
     inline const T* getOutputs() const noexcept
     {
-        return outs.back().data();
+        return upsampled_outs.empty() ? outs.back().data() : upsampled_outs.data();
     }
 
     /** A vector storing the network layers in sequential order. */
     std::vector<Layer<T>*> layers;
 
 private:
-#if RTNEURAL_USE_XSIMD
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
+    /** Runs the layers from `layer_idx` onwards for one input frame, which produces output frame `out_frame`. */
+    inline void forwardLayers(int layer_idx, const T* input, int out_frame) noexcept
+    {
+        for(int i = layer_idx; i < (int)layers.size(); ++i)
+        {
+            layers[i]->forward(input, outs[i].data());
+
+            if(layer_decimation_factors[i] > 1)
+            {
+                const auto has_new_output = decimation_counters[i] == 0;
+                if(++decimation_counters[i] == layer_decimation_factors[i])
+                    decimation_counters[i] = 0;
+
+                if(!has_new_output)
+                    return;
+            }
+
+            if(layer_upsampling_factors[i] > 1 && i < (int)layers.size() - 1)
+            {
+                const auto frame_size = layers[i]->out_size / layer_upsampling_factors[i];
+                for(int p = 0; p < layer_upsampling_factors[i]; ++p)
+                    forwardLayers(i + 1, outs[i].data() + p * frame_size, out_frame * layer_upsampling_factors[i] + p);
+                return;
+            }
+
+            input = outs[i].data();
+        }
+
+        if(!upsampled_outs.empty())
+            std::copy(outs.back().begin(), outs.back().end(), upsampled_outs.begin() + out_frame * (int)outs.back().size());
+    }
+
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
 #elif RTNEURAL_USE_EIGEN
     using vec_type = std::vector<T, Eigen::aligned_allocator<T>>;
 #else
@@ -99,6 +209,15 @@ private:
 
     const int in_size;
     std::vector<vec_type> outs;
+
+    std::vector<int> layer_decimations;
+    std::vector<int> layer_decimation_factors;
+    std::vector<int> decimation_counters;
+    int output_decimation = 1;
+
+    std::vector<int> layer_upsampling_factors;
+    vec_type upsampled_outs;
+    int output_upsampling = 1;
 };
 
 } // namespace RTNeural
@@ -56,6 +56,85 @@ namespace modelt_detail
         forEachInTuple(std::forward<Fn>(fn), std::forward<Tuple>(tuple), TupleIndexSequenceRange<start, num> {});
     }
 
+    /** Returns true if the layer has a new output for the following layer. */
+    template <typename LayerType>
+    constexpr bool isOutputReady(const LayerType&) noexcept
+    {
+        return true;
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int stride>
+    bool isOutputReady(const StridedConv1DT<T, in_size, out_size, kernel_size, dilation_rate, stride>& conv) noexcept
+    {
+        return conv.isOutputReady();
+    }
+
+    /** True for layers that produce several output frames for each input frame. */
+    template <typename LayerType>
+    struct isUpsamplingLayer : std::false_type
+    {
+    };
+
+    template <typename T, int in_size, int num_filters_out, int kernel_size, int stride>
+    struct isUpsamplingLayer<TransposedConv1DT<T, in_size, num_filters_out, kernel_size, stride>> : std::integral_constant<bool, (stride > 1)>
+    {
+    };
+
+    /** True for layers that process each input element independently. */
+    template <typename LayerType>
+    struct isElementwiseLayer : std::false_type
+    {
+    };
+
+    template <typename T, int size, typename MathsProvider>
+    struct isElementwiseLayer<TanhActivationT<T, size, MathsProvider>> : std::true_type
+    {
+    };
+
+    template <typename T, int size>
+    struct isElementwiseLayer<FastTanhT<T, size>> : std::true_type
+    {
+    };
+
+    template <typename T, int size>
+    struct isElementwiseLayer<ReLuActivationT<T, size>> : std::true_type
+    {
+    };
+
+    template <typename T, int size, typename MathsProvider>
+    struct isElementwiseLayer<SigmoidActivationT<T, size, MathsProvider>> : std::true_type
+    {
+    };
+
+    template <typename T, int size, int AlphaNumerator, int AlphaDenominator, typename MathsProvider>
+    struct isElementwiseLayer<ELuActivationT<T, size, AlphaNumerator, AlphaDenominator, MathsProvider>> : std::true_type
+    {
+    };
+
+    template <typename T, int size, typename LUTFunction, int TableSize>
+    struct isElementwiseLayer<LUTActivationT<T, size, LUTFunction, TableSize>> : std::true_type
+    {
+    };
+
+    /**
+     * True if every layer following an upsampling layer is element-wise.
+     * The layers of a ModelT receive the whole output of the previous layer,
+     * so they can't run once for each output frame of an upsampling layer
+     * (like `Model` does), and an element-wise layer is the only kind of
+     * layer that gives the same output either way.
+     */
+    template <bool afterUpsampling, typename... LayerTypes>
+    struct checkUpsamplingLayers : std::true_type
+    {
+    };
+
+    template <bool afterUpsampling, typename LayerType, typename... LayerTypes>
+    struct checkUpsamplingLayers<afterUpsampling, LayerType, LayerTypes...>
+        : std::integral_constant<bool, (!afterUpsampling || isElementwiseLayer<LayerType>::value)
+                && checkUpsamplingLayers<afterUpsampling || isUpsamplingLayer<LayerType>::value, LayerTypes...>::value>
+    {
+    };
+
     // unrolled loop for forward inferencing
     template <size_t idx, size_t Niter>
     struct forward_unroll
@@ -63,6 +142,10 @@ namespace modelt_detail
         template <typename T>
         static void call(T& t)
         {
+            // layers following a decimating layer only run when it has a new output
+            if(!isOutputReady(std::get<idx - 1>(t)))
+                return;
+
             std::get<idx>(t).forward(std::get<idx - 1>(t).outs);
             forward_unroll<idx + 1, Niter - 1>::call(t);
         }
@@ -76,65 +159,110 @@ namespace modelt_detail
     };
 
     template <typename T, typename LayerType>
-    void loadLayer(LayerType&, int&, const nlohmann::json&, const std::string&, int, bool debug)
+    void loadLayer(LayerType&, const nlohmann::json&, const std::string&, int, bool debug)
     {
         json_parser::debug_print("Loading a no-op layer!", debug);
     }
 
     template <typename T, int in_size, int out_size>
-    void loadLayer(DenseT<T, in_size, out_size>& dense, int& json_stream_idx, const nlohmann::json& l,
+    void loadLayer(DenseT<T, in_size, out_size>& dense, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
 
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
-        const auto weights = l["weights"];
+        const auto weights = getLayerWeights(l);
 
         if(checkDense<T>(dense, type, layerDims, debug))
             loadDense<T>(dense, weights);
+    }
 
-        if(!l.contains("activation"))
-        {
-            json_stream_idx++;
-        }
-        else
-        {
-            const auto activationType = l["activation"].get<std::string>();
-            if(activationType.empty())
-                json_stream_idx++;
-        }
+    template <typename T, int in_size, int out_size, int rank>
+    void loadLayer(LowRankDenseT<T, in_size, out_size, rank>& dense, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = l["weights"];
+        const auto layerRank = l.contains("rank") ? l["rank"].get<int>() : 0;
+
+        if(checkLowRankDense<T>(dense, type, layerDims, layerRank, debug))
+            loadLowRankDense<T>(dense, weights);
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, SampleRateCorrectionMode mode, int maxSampleRateRatio>
+    void loadLayer(Conv1DT<T, in_size, out_size, kernel_size, dilation_rate, mode, maxSampleRateRatio>& conv, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].back().get<int>();
+
+        if(checkConv1D<T>(conv, type, layerDims, kernel, dilation, debug))
+            loadConv1D<T>(conv, kernel, dilation, weights);
+    }
+
+    template <typename T, int in_size, int out_size>
+    void loadLayer(QuantizedDenseT<T, in_size, out_size>& dense, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkDense<T>(dense, type, layerDims, debug))
+            loadDense<T>(dense, weights);
     }
 
     template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate>
-    void loadLayer(Conv1DT<T, in_size, out_size, kernel_size, dilation_rate>& conv, int& json_stream_idx, const nlohmann::json& l,
+    void loadLayer(QuantizedConv1DT<T, in_size, out_size, kernel_size, dilation_rate>& conv, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
 
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
-        const auto weights = l["weights"];
+        const auto weights = getLayerWeights(l);
         const auto kernel = l["kernel_size"].back().get<int>();
         const auto dilation = l["dilation"].back().get<int>();
 
         if(checkConv1D<T>(conv, type, layerDims, kernel, dilation, debug))
             loadConv1D<T>(conv, kernel, dilation, weights);
+    }
 
-        if(!l.contains("activation"))
-        {
-            json_stream_idx++;
-        }
-        else
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, int stride>
+    void loadLayer(StridedConv1DT<T, in_size, out_size, kernel_size, dilation_rate, stride>& conv, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].back().get<int>();
+        const auto strides = l.contains("strides") ? l["strides"].back().get<int>() : 1;
+
+        if(checkConv1D<T>(conv, type, layerDims, kernel, dilation, debug))
         {
-            const auto activationType = l["activation"].get<std::string>();
-            if(activationType.empty())
-                json_stream_idx++;
+            if(strides != conv.getStride())
+                debug_print("Wrong stride! Expected: " + std::to_string(conv.getStride()), debug);
+            else
+                loadConv1D<T>(conv, kernel, dilation, weights);
         }
     }
 
-    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
-    void loadLayer(GRULayerT<T, in_size, out_size, mode>& gru, int& json_stream_idx, const nlohmann::json& l,
+    template <typename T, int in_size, int num_filters_out, int kernel_size, int stride>
+    void loadLayer(TransposedConv1DT<T, in_size, num_filters_out, kernel_size, stride>& conv, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
@@ -142,27 +270,276 @@ namespace modelt_detail
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
         const auto weights = l["weights"];
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto strides = l["strides"].back().get<int>();
+
+        if(checkTransposedConv1D<T>(conv, type, layerDims, kernel, strides, debug))
+            loadTransposedConv1D<T>(conv, weights);
+    }
+
+    template <typename T, int num_filters_in, int num_filters_out, int num_features_in, int kernel_size_time,
+        int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+    void loadLayer(Conv2DT<T, num_filters_in, num_filters_out, num_features_in, kernel_size_time, kernel_size_feature, dilation_rate, stride, valid_pad>& conv,
+        const nlohmann::json& l, const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = l["weights"];
+        const auto kernel_time = l["kernel_size"].front().get<int>();
+        const auto kernel_feature = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].front().get<int>();
+        const auto strides = l["strides"].back().get<int>();
+        const auto is_valid_pad = l["padding"].get<std::string>() == "valid";
+
+        if(checkConv2D<T>(conv, type, layerDims, kernel_time, kernel_feature, dilation, strides, is_valid_pad, debug))
+            loadConv2D<T>(conv, weights);
+    }
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int maxDelaySamples>
+    void loadLayer(GRULayerT<T, in_size, out_size, mode, MathsProvider, maxDelaySamples>& gru, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
 
         if(checkGRU<T>(gru, type, layerDims, debug))
             loadGRU<T>(gru, weights);
+    }
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int maxDelaySamples>
+    void loadLayer(LSTMLayerT<T, in_size, out_size, mode, MathsProvider, maxDelaySamples>& lstm, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
 
-        json_stream_idx++;
+        if(checkLSTM<T>(lstm, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights);
     }
 
-    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode>
-    void loadLayer(LSTMLayerT<T, in_size, out_size, mode>& lstm, int& json_stream_idx, const nlohmann::json& l,
+    template <typename T, int in_size, int out_size, typename QType>
+    void loadLayer(QuantizedGRULayerT<T, in_size, out_size, QType>& gru, const nlohmann::json& l,
         const std::string& type, int layerDims, bool debug)
     {
         using namespace json_parser;
 
         debug_print("Layer: " + type, debug);
         debug_print("  Dims: " + std::to_string(layerDims), debug);
-        const auto weights = l["weights"];
+        const auto weights = getLayerWeights(l);
+
+        if(checkGRU<T>(gru, type, layerDims, debug))
+            loadGRU<T>(gru, weights);
+    }
+
+    template <typename T, int in_size, int out_size, typename QType>
+    void loadLayer(QuantizedLSTMLayerT<T, in_size, out_size, QType>& lstm, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
 
         if(checkLSTM<T>(lstm, type, layerDims, debug))
             loadLSTM<T>(lstm, weights);
+    }
 
-        json_stream_idx++;
+    template <typename T, int in_size, int out_size, int block_rows, int block_cols>
+    void loadLayer(SparseGRULayerT<T, in_size, out_size, block_rows, block_cols>& gru, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkGRU<T>(gru, type, layerDims, debug))
+            loadGRU<T>(gru, weights);
+    }
+
+    template <typename T, int in_size, int out_size, int block_rows, int block_cols>
+    void loadLayer(SparseLSTMLayerT<T, in_size, out_size, block_rows, block_cols>& lstm, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkLSTM<T>(lstm, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights);
+    }
+
+    template <typename T, int in_size, int out_size, int block_rows, int block_cols>
+    void loadLayer(SparseDenseT<T, in_size, out_size, block_rows, block_cols>& dense, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkDense<T>(dense, type, layerDims, debug))
+            loadDense<T>(dense, weights);
+    }
+
+    template <typename T, int in_size, int out_size, typename HalfType>
+    void loadLayer(HalfDenseT<T, in_size, out_size, HalfType>& dense, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkDense<T>(dense, type, layerDims, debug))
+            loadDense<T>(dense, weights);
+    }
+
+    template <typename T, int in_size, int out_size, int kernel_size, int dilation_rate, typename HalfType>
+    void loadLayer(HalfConv1DT<T, in_size, out_size, kernel_size, dilation_rate, HalfType>& conv, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].back().get<int>();
+
+        if(checkConv1D<T>(conv, type, layerDims, kernel, dilation, debug))
+            loadConv1D<T>(conv, kernel, dilation, weights);
+    }
+
+    template <typename T, int in_size, int out_size, typename HalfType>
+    void loadLayer(HalfGRULayerT<T, in_size, out_size, HalfType>& gru, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkGRU<T>(gru, type, layerDims, debug))
+            loadGRU<T>(gru, weights);
+    }
+
+    template <typename T, int in_size, int out_size, typename HalfType>
+    void loadLayer(HalfLSTMLayerT<T, in_size, out_size, HalfType>& lstm, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkLSTM<T>(lstm, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights);
+    }
+
+    template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+    void loadLayer(WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>& block, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = l["weights"];
+        const auto n_channels = l["channels"].get<int>();
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].back().get<int>();
+
+        if(checkWaveNetBlock<T>(block, type, layerDims, n_channels, kernel, dilation, debug))
+            loadWaveNetBlock<T>(block, weights);
+    }
+
+    /**
+     * True for layers with a built-in activation, such as the recurrent layers.
+     * Other layers share their json layer with the activation layer that follows
+     * them in the model, but these layers always move on to the next json layer.
+     */
+    template <typename LayerType>
+    struct hasBuiltInActivation : std::false_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int maxDelaySamples>
+    struct hasBuiltInActivation<GRULayerT<T, in_size, out_size, mode, MathsProvider, maxDelaySamples>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, SampleRateCorrectionMode mode, typename MathsProvider, int maxDelaySamples>
+    struct hasBuiltInActivation<LSTMLayerT<T, in_size, out_size, mode, MathsProvider, maxDelaySamples>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, typename QType>
+    struct hasBuiltInActivation<QuantizedGRULayerT<T, in_size, out_size, QType>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, typename QType>
+    struct hasBuiltInActivation<QuantizedLSTMLayerT<T, in_size, out_size, QType>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, int block_rows, int block_cols>
+    struct hasBuiltInActivation<SparseGRULayerT<T, in_size, out_size, block_rows, block_cols>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, int block_rows, int block_cols>
+    struct hasBuiltInActivation<SparseLSTMLayerT<T, in_size, out_size, block_rows, block_cols>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, typename HalfType>
+    struct hasBuiltInActivation<HalfGRULayerT<T, in_size, out_size, HalfType>> : std::true_type
+    {
+    };
+
+    template <typename T, int in_size, int out_size, typename HalfType>
+    struct hasBuiltInActivation<HalfLSTMLayerT<T, in_size, out_size, HalfType>> : std::true_type
+    {
+    };
+
+    template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+    struct hasBuiltInActivation<WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>> : std::true_type
+    {
+    };
+
+    /**
+     * Returns the index of the json layer that the next layer of the model is loaded
+     * from, after loading a layer from the json layer at `json_stream_idx`. This only
+     * depends on the layer types and the json layers, so the layers can be matched to
+     * their json layers without loading them.
+     */
+    template <typename LayerType>
+    int nextJsonLayerIndex(const LayerType&, int json_stream_idx, const nlohmann::json& l)
+    {
+        if(hasBuiltInActivation<LayerType>::value || !l.contains("activation"))
+            return json_stream_idx + 1;
+
+        // the layer's activation is loaded by the next layer of the model, from the same json layer
+        const auto activationType = l["activation"].get<std::string>();
+        return activationType.empty() ? json_stream_idx + 1 : json_stream_idx;
     }
 
 } // namespace modelt_detail
@@ -183,10 +560,13 @@ namespace modelt_detail
 template <typename T, int in_size, int out_size, typename... Layers>
 class ModelT
 {
+    static_assert(modelt_detail::checkUpsamplingLayers<false, Layers...>::value,
+        "Only element-wise activation layers may follow a TransposedConv1DT layer in a ModelT!");
+
 public:
     ModelT()
     {
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
         for(int i = 0; i < v_in_size; ++i)
             v_ins[i] = v_type((T)0);
 #elif RTNEURAL_USE_EIGEN
@@ -220,9 +600,19 @@ public:
     inline typename std::enable_if<(N > 1), T>::type
     forward(const T* input)
     {
-#if RTNEURAL_USE_XSIMD
-        for(int i = 0; i < v_in_size; ++i)
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        for(int i = 0; i < in_size / v_size; ++i)
             v_ins[i] = xsimd::load_aligned(input + i * v_size);
+
+        if(v_in_tail_size > 0)
+        {
+            // the last input vector is only partially filled, so we
+            // load it from a zero-padded copy, to avoid reading past
+            // the end of the input array.
+            T tail alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size] {};
+            std::copy(input + (v_in_size - 1) * v_size, input + in_size, tail);
+            v_ins[v_in_size - 1] = xsimd::load_aligned(tail);
+        }
 #elif RTNEURAL_USE_EIGEN
         auto v_ins = Eigen::Map<const vec_type, RTNeuralEigenAlignment>(input);
 #else // RTNEURAL_USE_STL
@@ -231,7 +621,7 @@ public:
         std::get<0>(layers).forward(v_ins);
         modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
 
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
         for(int i = 0; i < v_out_size; ++i)
             xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
 #elif RTNEURAL_USE_EIGEN
@@ -247,7 +637,7 @@ public:
     inline typename std::enable_if<N == 1, T>::type
     forward(const T* input)
     {
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
         v_ins[0] = (v_type)input[0];
 #elif RTNEURAL_USE_EIGEN
         const auto v_ins = vec_type::Constant(input[0]);
@@ -258,7 +648,7 @@ public:
         std::get<0>(layers).forward(v_ins);
         modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
 
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
         for(int i = 0; i < v_out_size; ++i)
             xsimd::store_aligned(outs + i * v_size, get<n_layers - 1>().outs[i]);
 #elif RTNEURAL_USE_EIGEN
@@ -275,13 +665,20 @@ public:
         return outs;
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /**
+     * Loads neural network model weights from a json stream.
+     *
+     * The layer weights can be loaded concurrently, on up to `numThreads`
+     * threads (or one thread per core, if `numThreads` is zero), which
+     * reduces the loading time for large models. Debug messages are only
+     * printed when the layers are loaded on a single thread.
+     */
+    void parseJson(const nlohmann::json& parent, const bool debug = false, std::initializer_list<std::string> custom_layers = {}, const int numThreads = 1)
     {
         using namespace json_parser;
 
-        auto shape = parent["in_shape"];
-        auto json_layers = parent["layers"];
+        const auto& shape = parent["in_shape"];
+        const auto& json_layers = parent["layers"];
 
         if(!shape.is_array() || !json_layers.is_array())
             return;
@@ -295,6 +692,10 @@ public:
             return;
         }
 
+        // when loading in parallel, the layers are matched to the json layers first, and loaded afterwards
+        const auto parallel = numThreads != 1 && !debug;
+        std::vector<std::function<void()>> tasks;
+
         int json_stream_idx = 0;
         modelt_detail::forEachInTuple([&](auto& layer, size_t) {
             if(json_stream_idx >= (int)json_layers.size())
@@ -303,7 +704,7 @@ public:
                 return;
             }
 
-            const auto l = json_layers.at(json_stream_idx);
+            const auto& l = json_layers.at(json_stream_idx);
             const auto type = l["type"].get<std::string>();
             const auto layerShape = l["shape"];
             const auto layerDims = layerShape.back().get<int>();
@@ -334,33 +735,44 @@ public:
                 return;
             }
 
-            modelt_detail::loadLayer<T>(layer, json_stream_idx, l, type, layerDims, debug);
+            if(parallel)
+                tasks.push_back([&layer, &l, type, layerDims] { modelt_detail::loadLayer<T>(layer, l, type, layerDims, false); });
+            else
+                modelt_detail::loadLayer<T>(layer, l, type, layerDims, debug);
+
+            json_stream_idx = modelt_detail::nextJsonLayerIndex(layer, json_stream_idx, l);
         },
             layers);
+
+        json_parser::detail::runTasks(tasks, numThreads);
     }
 
-    /** Loads neural network model weights from a json stream. */
-    void parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {})
+    /** Loads neural network model weights from a json stream (see above). */
+    void parseJson(std::ifstream& jsonStream, const bool debug = false, std::initializer_list<std::string> custom_layers = {}, const int numThreads = 1)
     {
         nlohmann::json parent;
         jsonStream >> parent;
-        return parseJson(parent, debug, custom_layers);
+        return parseJson(parent, debug, custom_layers, numThreads);
     }
 
 private:
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
     using v_type = xsimd::simd_type<T>;
     static constexpr auto v_size = (int)v_type::size;
     static constexpr auto v_in_size = ceil_div(in_size, v_size);
     static constexpr auto v_out_size = ceil_div(out_size, v_size);
+    static constexpr auto v_in_tail_size = in_size % v_size;
     v_type v_ins[v_in_size];
+
+    // the output vectors are stored whole, so the output array is padded to a multiple of the vector size
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_out_size * v_size];
 #elif RTNEURAL_USE_EIGEN
     using vec_type = Eigen::Matrix<T, in_size, 1>;
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 #else // RTNEURAL_USE_STL
     T v_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
-#endif
-
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
 
     std::tuple<Layers...> layers;
     static constexpr size_t n_layers = sizeof...(Layers);
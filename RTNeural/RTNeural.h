@@ -18,4 +18,7 @@
 // RTNeural includes:
 #include "Model.h"
 #include "ModelT.h"
+#include "binary_model_loader.h"
+#include "fixed_point/fixed_point_model.h"
 #include "model_loader.h"
+#include "model_loader_streaming.h"
@@ -37,10 +37,12 @@ private:
 
 } // namespace RTNeural
 
+#include "activation_lut.h"
+
 #if RTNEURAL_USE_EIGEN
 #include "activation_eigen.h"
 
-#elif RTNEURAL_USE_XSIMD
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
 #include "activation_xsimd.h"
 
 #elif RTNEURAL_USE_ACCELERATE
@@ -54,14 +56,14 @@ namespace RTNeural
 {
 
 /** Dynamic implementation of a tanh activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class TanhActivation final : public Activation<T>
 {
 public:
     /** Constructs a tanh activation layer for a given size. */
     explicit TanhActivation(int size)
         : Activation<T>(
-            size, [](T x) { return std::tanh(x); }, "tanh")
+            size, [](T x) { return MathsProvider::tanh(x); }, "tanh")
     {
     }
 
@@ -74,12 +76,12 @@ public:
     inline void forward(const T* input, T* out) noexcept override
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            out[i] = std::tanh(input[i]);
+            out[i] = MathsProvider::tanh(input[i]);
     }
 };
 
 /** Static implementation of a tanh activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class TanhActivationT
 {
 public:
@@ -100,7 +102,7 @@ public:
     inline void forward(const T (&ins)[size]) noexcept
     {
         for(int i = 0; i < size; ++i)
-            outs[i] = std::tanh(ins[i]);
+            outs[i] = MathsProvider::tanh(ins[i]);
     }
 
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
@@ -206,14 +208,14 @@ public:
 };
 
 /** Dynamic implementation of a sigmoid activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivation final : public Activation<T>
 {
 public:
     /** Constructs a sigmoid activation layer for a given size. */
     explicit SigmoidActivation(int size)
         : Activation<T>(
-            size, [](T x) { return sigmoid(x); }, "sigmoid")
+            size, [](T x) { return MathsProvider::sigmoid(x); }, "sigmoid")
     {
     }
 
@@ -224,7 +226,7 @@ public:
 };
 
 /** Static implementation of a sigmoid activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivationT
 {
 public:
@@ -245,14 +247,14 @@ public:
     inline void forward(const T (&ins)[size]) noexcept
     {
         for(int i = 0; i < size; ++i)
-            outs[i] = sigmoid(ins[i]);
+            outs[i] = MathsProvider::sigmoid(ins[i]);
     }
 
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
 };
 
 /** Dynamic implementation of a softmax activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivation final : public Activation<T>
 {
 public:
@@ -271,12 +273,12 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const T* input, T* out) noexcept override
     {
-        softmax(input, out, Layer<T>::out_size);
+        softmax<MathsProvider>(input, out, Layer<T>::out_size);
     }
 };
 
 /** Static implementation of a softmax activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivationT
 {
 public:
@@ -296,10 +298,13 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const T (&ins)[size]) noexcept
     {
+        // subtract the largest input before exponentiating, so that exp() can't overflow
+        const auto max_value = *std::max_element(ins, ins + size);
+
         T exp_sum = 0;
         for(int i = 0; i < size; ++i)
         {
-            outs[i] = std::exp(ins[i]);
+            outs[i] = MathsProvider::exp(ins[i] - max_value);
             exp_sum += outs[i];
         }
 
@@ -314,14 +319,14 @@ public:
 };
 
 /** Dynamic implementation of a elu activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class ELuActivation final : public Activation<T>
 {
 public:
     /** Constructs a softmax activation layer for a given size. */
     explicit ELuActivation(int size)
         : Activation<T>(
-            size, [this](T x) { return x > (T)0 ? x : (alpha * (std::exp(x) - (T)1)); }, "elu")
+            size, [this](T x) { return x > (T)0 ? x : (alpha * (MathsProvider::exp(x) - (T)1)); }, "elu")
     {
     }
 
@@ -338,7 +343,7 @@ private:
 };
 
 /** Static implementation of a elu activation layer. */
-template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1>
+template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1, typename MathsProvider = DefaultMathsProvider>
 class ELuActivationT
 {
 public:
@@ -361,7 +366,7 @@ public:
     forward(const T (&ins)[size]) noexcept
     {
         for(int i = 0; i < size; ++i)
-            outs[i] = ins[i] > (T)0 ? ins[i] : (std::exp(ins[i]) - (T)1);
+            outs[i] = ins[i] > (T)0 ? ins[i] : (MathsProvider::exp(ins[i]) - (T)1);
     }
 
     /** Performs forward propagation for elu activation (with custom alpha parameter). */
@@ -371,12 +376,67 @@ public:
     {
         static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
         for(int i = 0; i < size; ++i)
-            outs[i] = ins[i] > (T)0 ? ins[i] : (alpha * (std::exp(ins[i]) - (T)1));
+            outs[i] = ins[i] > (T)0 ? ins[i] : (alpha * (MathsProvider::exp(ins[i]) - (T)1));
+    }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+};
+
+/**
+ * Static implementation of an activation layer that evaluates
+ * its activation function from a lookup table with linear
+ * interpolation (see LUTActivation).
+ */
+template <typename T, int size, typename LUTFunction, int TableSize = 1024>
+class LUTActivationT
+{
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    /** Constructs a lookup-table activation layer for a given table range. */
+    explicit LUTActivationT(T minInput = LUTFunction::defaultMinInput(),
+        T maxInput = LUTFunction::defaultMaxInput())
+    {
+        table.build(&LUTFunction::compute, minInput, maxInput, TableSize);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return LUTFunction::name(); }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for this activation. */
+    inline void forward(const T (&ins)[size]) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            outs[i] = lut_detail::lookup<LUTFunction>(table, ins[i]);
     }
 
+    /** Returns an upper bound on the absolute error of this layer, compared to the exact activation function. */
+    T getMaxError() const noexcept { return lut_detail::maxError<LUTFunction>(table); }
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[size];
+
+private:
+    LookupTable<T> table;
 };
 
+/** Static implementation of a lookup-table tanh activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using TanhLUTActivationT = LUTActivationT<T, size, lut_detail::TanhLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table sigmoid activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using SigmoidLUTActivationT = LUTActivationT<T, size, lut_detail::SigmoidLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table elu activation layer. */
+template <typename T, int size, int TableSize = 1024, int AlphaNumerator = 1, int AlphaDenominator = 1>
+using ELuLUTActivationT = LUTActivationT<T, size, lut_detail::ELuLUTFunction<T, AlphaNumerator, AlphaDenominator>, TableSize>;
+
 } // namespace RTNeural
 
 #endif // RTNEURAL_USE_EIGEN
@@ -7,7 +7,7 @@ namespace RTNeural
 {
 
 /** Dynamic implementation of a tanh activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class TanhActivation : public Activation<T>
 {
 public:
@@ -29,7 +29,7 @@ public:
     {
         inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
             input, Layer<T>::in_size, 1);
-        outVec = inVec.array().tanh();
+        outVec = MathsProvider::tanh(inVec);
 
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
@@ -39,7 +39,7 @@ public:
 };
 
 /** Static implementation of a tanh activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class TanhActivationT
 {
     using v_type = Eigen::Matrix<T, size, 1>;
@@ -65,7 +65,7 @@ public:
     /** Performs forward propagation for tanh activation. */
     inline void forward(const v_type& ins) noexcept
     {
-        outs = ins.array().tanh();
+        outs = MathsProvider::tanh(ins);
     }
 
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
@@ -211,7 +211,7 @@ private:
 
 /** Dynamic implementation of a sigmoid activation layer. */
 
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivation : public Activation<T>
 {
 public:
@@ -233,8 +233,7 @@ public:
     {
         inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
             input, Layer<T>::in_size, 1);
-        outVec = inVec.array();
-        sigmoid(outVec);
+        outVec = MathsProvider::sigmoid(inVec);
 
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
@@ -244,7 +243,7 @@ public:
 };
 
 /** Static implementation of a sigmoid activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivationT
 {
     using v_type = Eigen::Matrix<T, size, 1>;
@@ -270,7 +269,7 @@ public:
     /** Performs forward propagation for sigmoid activation. */
     inline void forward(const v_type& ins) noexcept
     {
-        outs = (T)1 / (((T)-1 * ins.array()).array().exp() + (T)1);
+        outs = MathsProvider::sigmoid(ins);
     }
 
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
@@ -280,7 +279,7 @@ private:
 };
 
 /** Dynamic implementation of a softmax activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivation : public Activation<T>
 {
 public:
@@ -302,8 +301,9 @@ public:
     {
         inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
             input, Layer<T>::in_size, 1);
-        outVec = inVec.array();
-        softmax(outVec);
+        // subtract the largest input before exponentiating, so that exp() can't overflow
+        outVec = MathsProvider::exp(inVec.array() - inVec.maxCoeff());
+        outVec = outVec / outVec.sum();
 
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
@@ -313,7 +313,7 @@ public:
 };
 
 /** Static implementation of a softmax activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivationT
 {
     using v_type = Eigen::Matrix<T, size, 1>;
@@ -339,7 +339,8 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const v_type& ins) noexcept
     {
-        outs = ins.array().exp();
+        // subtract the largest input before exponentiating, so that exp() can't overflow
+        outs = MathsProvider::exp(ins.array() - ins.maxCoeff());
         outs = outs / outs.sum();
     }
 
@@ -350,7 +351,7 @@ private:
 };
 
 /** Dynamic implementation of a elu activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class ELuActivation : public Activation<T>
 {
 public:
@@ -374,7 +375,7 @@ public:
         inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
             input, Layer<T>::in_size, 1);
 
-        outVec = (inVec.array() > (T)0).select(inVec, alpha * (inVec.array().exp() - ones.array()));
+        outVec = (inVec.array() > (T)0).select(inVec, alpha * (MathsProvider::exp(inVec) - ones.array()));
         std::copy(outVec.data(), outVec.data() + Layer<T>::in_size, out);
     }
 
@@ -390,7 +391,7 @@ private:
 };
 
 /** Static implementation of a elu activation layer. */
-template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1>
+template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1, typename MathsProvider = DefaultMathsProvider>
 class ELuActivationT
 {
     using v_type = Eigen::Matrix<T, size, 1>;
@@ -418,7 +419,7 @@ public:
     inline typename std::enable_if<A_N == 1 && A_D == 1, void>::type
     forward(const v_type& ins) noexcept
     {
-        outs = (ins.array() > (T)0).select(ins, ins.array().exp() - ones.array());
+        outs = (ins.array() > (T)0).select(ins, MathsProvider::exp(ins) - ones.array());
     }
 
     /** Performs forward propagation for elu activation (with custom alpha parameter). */
@@ -427,7 +428,7 @@ public:
     forward(const v_type& ins) noexcept
     {
         static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
-        outs = (ins.array() > (T)0).select(ins, alpha * (ins.array().exp() - ones.array()));
+        outs = (ins.array() > (T)0).select(ins, alpha * (MathsProvider::exp(ins) - ones.array()));
     }
 
     Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
@@ -437,6 +438,66 @@ private:
     T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 };
 
+/**
+ * Static implementation of an activation layer that evaluates
+ * its activation function from a lookup table with linear
+ * interpolation (see LUTActivation).
+ */
+template <typename T, int size, typename LUTFunction, int TableSize = 1024>
+class LUTActivationT
+{
+    using v_type = Eigen::Matrix<T, size, 1>;
+
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    /** Constructs a lookup-table activation layer for a given table range. */
+    explicit LUTActivationT(T minInput = LUTFunction::defaultMinInput(),
+        T maxInput = LUTFunction::defaultMaxInput())
+        : outs(outs_internal)
+    {
+        outs = v_type::Zero();
+        table.build(&LUTFunction::compute, minInput, maxInput, TableSize);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return LUTFunction::name(); }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for this activation. */
+    inline void forward(const v_type& ins) noexcept
+    {
+        for(int i = 0; i < size; ++i)
+            outs(i) = lut_detail::lookup<LUTFunction>(table, ins(i));
+    }
+
+    /** Returns an upper bound on the absolute error of this layer, compared to the exact activation function. */
+    T getMaxError() const noexcept { return lut_detail::maxError<LUTFunction>(table); }
+
+    Eigen::Map<v_type, RTNeuralEigenAlignment> outs;
+
+private:
+    LookupTable<T> table;
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+};
+
+/** Static implementation of a lookup-table tanh activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using TanhLUTActivationT = LUTActivationT<T, size, lut_detail::TanhLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table sigmoid activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using SigmoidLUTActivationT = LUTActivationT<T, size, lut_detail::SigmoidLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table elu activation layer. */
+template <typename T, int size, int TableSize = 1024, int AlphaNumerator = 1, int AlphaDenominator = 1>
+using ELuLUTActivationT = LUTActivationT<T, size, lut_detail::ELuLUTFunction<T, AlphaNumerator, AlphaDenominator>, TableSize>;
+
 } // namespace RTNeural
 
 #endif // ACTIVATIONEIGEN_H_INCLUDED
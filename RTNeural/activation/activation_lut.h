@@ -0,0 +1,243 @@
+#ifndef ACTIVATIONLUT_H_INCLUDED
+#define ACTIVATIONLUT_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * A lookup table for a scalar function, with evenly spaced entries
+ * over [minInput, maxInput], and linear interpolation between them.
+ * Inputs outside of the table range are clamped to the first or
+ * last table entry.
+ *
+ * For a function with a bounded second derivative f'', the
+ * interpolation error within the table range is at most
+ * h^2 / 8 * max|f''|, where h = (maxInput - minInput) / (tableSize - 1).
+ */
+template <typename T>
+class LookupTable
+{
+public:
+    LookupTable() = default;
+
+    /** Fills the table with `tableSize` evenly spaced values of func(x), for x in [minInput, maxInput]. */
+    template <typename FuncType>
+    void build(FuncType&& func, T newMinInput, T newMaxInput, int tableSize)
+    {
+        minInput = newMinInput;
+        maxInput = newMaxInput;
+        maxIndex = (T)(tableSize - 1);
+        scale = maxIndex / (maxInput - minInput);
+        offset = -minInput * scale;
+
+        // the extra entry at the end lets the interpolation read
+        // table[index + 1] without any bounds checking.
+        table.resize((size_t)tableSize + 1);
+        for(int i = 0; i < tableSize; ++i)
+            table[(size_t)i] = func(minInput + (maxInput - minInput) * (T)i / maxIndex);
+        table[(size_t)tableSize] = table[(size_t)tableSize - 1];
+    }
+
+    /** Returns the interpolated table value for the given input. */
+    inline T operator()(T x) const noexcept
+    {
+        // the argument order here makes sure that NaN inputs are mapped into the table
+        const auto pos = std::min(maxIndex, std::max((T)0, x * scale + offset));
+        const auto index = (int)pos;
+        const auto frac = pos - (T)index;
+        return table[(size_t)index] + frac * (table[(size_t)index + 1] - table[(size_t)index]);
+    }
+
+    /** Returns the lower end of the table range. */
+    T getMinInput() const noexcept { return minInput; }
+
+    /** Returns the upper end of the table range. */
+    T getMaxInput() const noexcept { return maxInput; }
+
+    /** Returns the number of table entries. */
+    int getTableSize() const noexcept { return (int)maxIndex + 1; }
+
+    /** Returns the distance between adjacent table entries. */
+    T getStepSize() const noexcept { return (T)1 / scale; }
+
+    /** Returns the maximum table index, as a floating-point value. */
+    T getMaxIndex() const noexcept { return maxIndex; }
+
+    /** Returns the factor used to map inputs to table positions: pos = x * scale + offset */
+    T getScale() const noexcept { return scale; }
+
+    /** Returns the offset used to map inputs to table positions: pos = x * scale + offset */
+    T getOffset() const noexcept { return offset; }
+
+    /** Returns a pointer to the table data (getTableSize() + 1 entries). */
+    const T* data() const noexcept { return table.data(); }
+
+private:
+    std::vector<T> table;
+    T minInput = (T)0;
+    T maxInput = (T)0;
+    T maxIndex = (T)0;
+    T scale = (T)0;
+    T offset = (T)0;
+};
+
+#ifndef DOXYGEN
+/**
+ * Descriptions of the functions that can be used with the
+ * lookup-table activation layers. Each description provides
+ * the exact function, the default table range, and the terms
+ * used to compute the layer's maximum error.
+ */
+namespace lut_detail
+{
+    template <typename T>
+    struct TanhLUTFunction
+    {
+        static std::string name() { return "tanh"; }
+        static T compute(T x) noexcept { return std::tanh(x); }
+
+        static constexpr T defaultMinInput() noexcept { return (T)-8; }
+        static constexpr T defaultMaxInput() noexcept { return (T)8; }
+        static constexpr bool identityAboveRange = false;
+
+        // max|tanh''(x)| = 4 / (3 sqrt(3))
+        static constexpr T maxSecondDerivative() noexcept { return (T)0.769800359; }
+        static T saturationError(T minInput, T maxInput) noexcept
+        {
+            return std::max((T)1 - std::tanh(maxInput), (T)1 + std::tanh(minInput));
+        }
+    };
+
+    template <typename T>
+    struct SigmoidLUTFunction
+    {
+        static std::string name() { return "sigmoid"; }
+        static T compute(T x) noexcept { return (T)1 / ((T)1 + std::exp(-x)); }
+
+        static constexpr T defaultMinInput() noexcept { return (T)-16; }
+        static constexpr T defaultMaxInput() noexcept { return (T)16; }
+        static constexpr bool identityAboveRange = false;
+
+        // max|sigmoid''(x)| = 1 / (6 sqrt(3))
+        static constexpr T maxSecondDerivative() noexcept { return (T)0.0962250449; }
+        static T saturationError(T minInput, T maxInput) noexcept
+        {
+            return std::max((T)1 - compute(maxInput), compute(minInput));
+        }
+    };
+
+    /** ELU only needs a table for negative inputs, since the function is the identity for x > 0. */
+    template <typename T, int AlphaNumerator = 1, int AlphaDenominator = 1>
+    struct ELuLUTFunction
+    {
+        static constexpr T alpha() noexcept { return (T)AlphaNumerator / (T)AlphaDenominator; }
+
+        static std::string name() { return "elu"; }
+        static T compute(T x) noexcept { return x > (T)0 ? x : alpha() * (std::exp(x) - (T)1); }
+
+        static constexpr T defaultMinInput() noexcept { return (T)-16; }
+        static constexpr T defaultMaxInput() noexcept { return (T)0; }
+        static constexpr bool identityAboveRange = true;
+
+        // max|elu''(x)| = alpha, for x <= 0
+        static constexpr T maxSecondDerivative() noexcept { return alpha() < (T)0 ? -alpha() : alpha(); }
+        static T saturationError(T minInput, T /* maxInput */) noexcept
+        {
+            return maxSecondDerivative() * std::exp(minInput);
+        }
+    };
+
+    /** Looks up a single value, passing through inputs above the table range for functions that need it. */
+    template <typename LUTFunction, typename T>
+    static inline T lookup(const LookupTable<T>& table, T x) noexcept
+    {
+        if(LUTFunction::identityAboveRange && x > table.getMaxInput())
+            return x;
+
+        return table(x);
+    }
+
+    /**
+     * Returns an upper bound on the absolute error of a lookup-table
+     * activation, compared to the exact function. The bound assumes
+     * that the function is smooth over the table range (e.g. an ELU
+     * table should not extend above zero).
+     */
+    template <typename LUTFunction, typename T>
+    static inline T maxError(const LookupTable<T>& table) noexcept
+    {
+        const auto h = table.getStepSize();
+        const auto interpError = h * h / (T)8 * LUTFunction::maxSecondDerivative();
+        return interpError + LUTFunction::saturationError(table.getMinInput(), table.getMaxInput());
+    }
+} // namespace lut_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of an activation layer that evaluates
+ * its activation function from a lookup table with linear
+ * interpolation.
+ *
+ * With the default table size (1024 entries) and range, the
+ * maximum absolute errors are approximately:
+ * - tanh ([-8, 8]): 2.4e-5
+ * - sigmoid ([-16, 16]): 1.2e-5
+ * - elu ([-16, 0]): 3.1e-5
+ *
+ * The error bound for a given table can be computed with getMaxError().
+ */
+template <typename T, typename LUTFunction>
+class LUTActivation : public Activation<T>
+{
+public:
+    /** Constructs a lookup-table activation layer for a given size, table size, and table range. */
+    explicit LUTActivation(int size, int tableSize = 1024,
+        T minInput = LUTFunction::defaultMinInput(),
+        T maxInput = LUTFunction::defaultMaxInput())
+        : Activation<T>(size, {}, LUTFunction::name())
+    {
+        table.build(&LUTFunction::compute, minInput, maxInput, tableSize);
+    }
+
+    LUTActivation(std::initializer_list<int> sizes)
+        : LUTActivation(*sizes.begin())
+    {
+    }
+
+    /** Performs forward propagation for this activation. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = lut_detail::lookup<LUTFunction>(table, input[i]);
+    }
+
+    /** Returns an upper bound on the absolute error of this layer, compared to the exact activation function. */
+    T getMaxError() const noexcept { return lut_detail::maxError<LUTFunction>(table); }
+
+    /** Returns the lookup table used by this layer. */
+    const LookupTable<T>& getTable() const noexcept { return table; }
+
+private:
+    LookupTable<T> table;
+};
+
+/** Dynamic implementation of a lookup-table tanh activation layer. */
+template <typename T>
+using TanhLUTActivation = LUTActivation<T, lut_detail::TanhLUTFunction<T>>;
+
+/** Dynamic implementation of a lookup-table sigmoid activation layer. */
+template <typename T>
+using SigmoidLUTActivation = LUTActivation<T, lut_detail::SigmoidLUTFunction<T>>;
+
+/** Dynamic implementation of a lookup-table elu activation layer (with alpha = 1). */
+template <typename T>
+using ELuLUTActivation = LUTActivation<T, lut_detail::ELuLUTFunction<T>>;
+
+} // namespace RTNeural
+
+#endif // ACTIVATIONLUT_H_INCLUDED
@@ -7,7 +7,7 @@ namespace RTNeural
 {
 
 /** Dynamic implementation of a tanh activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class TanhActivation : public Activation<T>
 {
 public:
@@ -25,12 +25,12 @@ public:
     /** Performs forward propagation for tanh activation. */
     inline void forward(const T* input, T* out) noexcept override
     {
-        tanh(input, out, Layer<T>::in_size);
+        vApply(input, out, Layer<T>::in_size, [](const auto& x) { return MathsProvider::tanh(x); });
     }
 };
 
 /** Static implementation of a tanh activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class TanhActivationT
 {
     using v_type = xsimd::simd_type<T>;
@@ -59,7 +59,7 @@ public:
     inline void forward(const v_type (&ins)[v_io_size]) noexcept
     {
         for(int i = 0; i < v_io_size; ++i)
-            outs[i] = xsimd::tanh(ins[i]);
+            outs[i] = MathsProvider::tanh(ins[i]);
     }
 
     v_type outs[v_io_size];
@@ -149,7 +149,7 @@ public:
             [](auto const& a, auto const& b) { return xsimd::max(a, b); });
     }
 
-    std::vector<T, xsimd::aligned_allocator<T>> zeros;
+    std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>> zeros;
 };
 
 /** Static implementation of a ReLU activation layer. */
@@ -189,7 +189,7 @@ public:
 };
 
 /** Dynamic implementation of a sigmoid activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivation : public Activation<T>
 {
 public:
@@ -207,12 +207,12 @@ public:
     /** Performs forward propagation for sigmoid activation. */
     inline void forward(const T* input, T* out) noexcept override
     {
-        sigmoid(input, out, Layer<T>::in_size);
+        vApply(input, out, Layer<T>::in_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
     }
 };
 
 /** Static implementation of a sigmoid activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SigmoidActivationT
 {
     using v_type = xsimd::simd_type<T>;
@@ -241,14 +241,14 @@ public:
     inline void forward(const v_type (&ins)[v_io_size]) noexcept
     {
         for(int i = 0; i < v_io_size; ++i)
-            outs[i] = (T)1.0 / ((T)1.0 + xsimd::exp(-ins[i]));
+            outs[i] = MathsProvider::sigmoid(ins[i]);
     }
 
     v_type outs[v_io_size];
 };
 
 /** Dynamic implementation of a softmax activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivation : public Activation<T>
 {
 public:
@@ -266,12 +266,12 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const T* input, T* out) noexcept override
     {
-        softmax(input, out, Layer<T>::in_size);
+        softmax<MathsProvider>(input, out, Layer<T>::in_size);
     }
 };
 
 /** Static implementation of a softmax activation layer. */
-template <typename T, int size>
+template <typename T, int size, typename MathsProvider = DefaultMathsProvider>
 class SoftmaxActivationT
 {
     using v_type = xsimd::simd_type<T>;
@@ -286,6 +286,12 @@ public:
     {
         for(int i = 0; i < v_io_size; ++i)
             outs[i] = v_type((T)0);
+
+        // the last batch may contain padding lanes, which shouldn't contribute to the softmax
+        T lane_index alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size];
+        for(int i = 0; i < v_size; ++i)
+            lane_index[i] = (T)i;
+        last_valid_lanes = xsimd::load_aligned(lane_index) < v_type((T)(size - (v_io_size - 1) * v_size));
     }
 
     /** Returns the name of this layer. */
@@ -299,12 +305,20 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const v_type (&ins)[v_io_size]) noexcept
     {
+        // subtract the largest input before exponentiating, so that exp() can't overflow
+        const auto lowest = v_type(std::numeric_limits<T>::lowest());
+        auto max_vec = xsimd::select(last_valid_lanes, ins[v_io_size - 1], lowest);
+        for(int i = 0; i < v_io_size - 1; ++i)
+            max_vec = xsimd::max(max_vec, ins[i]);
+        const auto max_value = v_type(maths_detail::reduce_max_vec(max_vec));
+
+        for(int i = 0; i < v_io_size; ++i)
+            outs[i] = MathsProvider::exp(ins[i] - max_value);
+        outs[v_io_size - 1] = xsimd::select(last_valid_lanes, outs[v_io_size - 1], v_type((T)0));
+
         v_type exp_sum {};
         for(int i = 0; i < v_io_size; ++i)
-        {
-            outs[i] = xsimd::exp(ins[i]);
             exp_sum += outs[i];
-        }
 
         const auto exp_sum_recip = v_type((T)1 / xsimd::reduce_add(exp_sum));
         for(int i = 0; i < v_io_size; ++i)
@@ -312,10 +326,13 @@ public:
     }
 
     v_type outs[v_io_size];
+
+private:
+    typename v_type::batch_bool_type last_valid_lanes;
 };
 
 /** Dynamic implementation of a elu activation layer. */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class ELuActivation final : public Activation<T>
 {
 public:
@@ -334,7 +351,9 @@ public:
     /** Performs forward propagation for softmax activation. */
     inline void forward(const T* input, T* out) noexcept override
     {
-        elu(input, out, Layer<T>::in_size, alpha);
+        const auto alphaVal = alpha;
+        vApply(input, out, Layer<T>::in_size, [alphaVal](const auto& x)
+            { return xsimd::select(x > (T)0, x, alphaVal * (MathsProvider::exp(x) - (T)1)); });
     }
 
     /** Sets a custom value for the layer's "alpha" parameter. */
@@ -345,7 +364,7 @@ private:
 };
 
 /** Static implementation of a elu activation layer. */
-template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1>
+template <typename T, int size, int AlphaNumerator = 1, int AlphaDenominator = 1, typename MathsProvider = DefaultMathsProvider>
 class ELuActivationT
 {
     using v_type = xsimd::simd_type<T>;
@@ -372,7 +391,7 @@ public:
     forward(const v_type (&ins)[v_io_size]) noexcept
     {
         for(int i = 0; i < v_io_size; ++i)
-            outs[i] = xsimd::select(ins[i] > (T)0, ins[i], xsimd::exp(ins[i]) - (T)1);
+            outs[i] = xsimd::select(ins[i] > (T)0, ins[i], MathsProvider::exp(ins[i]) - (T)1);
     }
 
     /** Performs forward propagation for elu activation (with custom alpha parameter). */
@@ -382,12 +401,102 @@ public:
     {
         static constexpr T alpha = (T)AlphaNumerator / (T)AlphaDenominator;
         for(int i = 0; i < v_io_size; ++i)
-            outs[i] = xsimd::select(ins[i] > (T)0, ins[i], alpha * (xsimd::exp(ins[i]) - (T)1));
+            outs[i] = xsimd::select(ins[i] > (T)0, ins[i], alpha * (MathsProvider::exp(ins[i]) - (T)1));
+    }
+
+    v_type outs[v_io_size];
+};
+
+/**
+ * Static implementation of an activation layer that evaluates
+ * its activation function from a lookup table with linear
+ * interpolation (see LUTActivation).
+ *
+ * With XSIMD 9 or newer, the table lookups use SIMD gather
+ * instructions, otherwise each lane is looked up separately.
+ */
+template <typename T, int size, typename LUTFunction, int TableSize = 1024>
+class LUTActivationT
+{
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_io_size = ceil_div(size, v_size);
+
+public:
+    static constexpr auto in_size = size;
+    static constexpr auto out_size = size;
+
+    /** Constructs a lookup-table activation layer for a given table range. */
+    explicit LUTActivationT(T minInput = LUTFunction::defaultMinInput(),
+        T maxInput = LUTFunction::defaultMaxInput())
+    {
+        for(int i = 0; i < v_io_size; ++i)
+            outs[i] = v_type((T)0);
+
+        table.build(&LUTFunction::compute, minInput, maxInput, TableSize);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return LUTFunction::name(); }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for this activation. */
+    inline void forward(const v_type (&ins)[v_io_size]) noexcept
+    {
+        for(int i = 0; i < v_io_size; ++i)
+            outs[i] = lookup(ins[i]);
     }
 
+    /** Returns an upper bound on the absolute error of this layer, compared to the exact activation function. */
+    T getMaxError() const noexcept { return lut_detail::maxError<LUTFunction>(table); }
+
     v_type outs[v_io_size];
+
+private:
+    inline v_type lookup(const v_type& x) const noexcept
+    {
+#if XSIMD_VERSION_MAJOR >= 9
+        // NaN lanes fail the comparison, so they are mapped to the start of the table (like the scalar lookup)
+        const auto scaled = x * table.getScale() + table.getOffset();
+        const auto pos = xsimd::select(scaled > v_type((T)0), xsimd::min(v_type(table.getMaxIndex()), scaled), v_type((T)0));
+        const auto index = xsimd::to_int(pos);
+        const auto frac = pos - xsimd::to_float(index);
+        const auto y0 = v_type::gather(table.data(), index);
+        const auto y1 = v_type::gather(table.data() + 1, index);
+        const auto y = y0 + frac * (y1 - y0);
+#else
+        T lanes alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size];
+        x.store_aligned(lanes);
+        for(int i = 0; i < v_size; ++i)
+            lanes[i] = table(lanes[i]);
+        const auto y = xsimd::load_aligned(lanes);
+#endif
+
+        if(LUTFunction::identityAboveRange)
+            return xsimd::select(x > v_type(table.getMaxInput()), x, y);
+
+        return y;
+    }
+
+    LookupTable<T> table;
 };
 
+/** Static implementation of a lookup-table tanh activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using TanhLUTActivationT = LUTActivationT<T, size, lut_detail::TanhLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table sigmoid activation layer. */
+template <typename T, int size, int TableSize = 1024>
+using SigmoidLUTActivationT = LUTActivationT<T, size, lut_detail::SigmoidLUTFunction<T>, TableSize>;
+
+/** Static implementation of a lookup-table elu activation layer. */
+template <typename T, int size, int TableSize = 1024, int AlphaNumerator = 1, int AlphaDenominator = 1>
+using ELuLUTActivationT = LUTActivationT<T, size, lut_detail::ELuLUTFunction<T, AlphaNumerator, AlphaDenominator>, TableSize>;
+
 } // namespace RTNeural
 
 #endif // ACTIVATIONXSIMD_H_INCLUDED
@@ -0,0 +1,709 @@
+#pragma once
+
+#include "model_loader.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RTNeural
+{
+/**
+ * Utility functions for loading models from a compact binary format,
+ * which is faster to load than json.
+ *
+ * The binary format is laid out as follows (all values are little-endian,
+ * and are converted to the host byte order when the model is loaded):
+ * - a BinaryFileHeader
+ * - a table of BinaryLayerRecords, one for each layer
+ * - the layer weights, as float32 tensors, each aligned to 64 bytes
+ *
+ * The tensors are stored in the layout that the layers compute with, so
+ * that they can be used directly from the file, without any re-ordering.
+ * Each matrix is stored by column (i.e. column-major, with each input's
+ * weights for all of the outputs next to each other), which is also the
+ * layout of the json model weights:
+ * - dense: weights [in_size][out_size], bias [out_size]
+ * - conv1d: weights [kernel_size][in_size][out_size] (most recent input first), bias [out_size]
+ * - gru: kernel [in_size][3 * out_size], recurrent [out_size][3 * out_size], bias [2][3 * out_size]
+ * - lstm: kernel [in_size][4 * out_size], recurrent [out_size][4 * out_size], bias [4 * out_size]
+ *
+ * When a float model is loaded from a file on a little-endian machine,
+ * the layers (see MappedDense, MappedConv1D, MappedGRULayer, and
+ * MappedLSTMLayer) use the weights in place in the memory-mapped file,
+ * which stays mapped for as long as the model uses it. Otherwise (for
+ * other types, or for models loaded from memory), the weights are copied
+ * into each layer's own storage as the model is loaded, so the binary
+ * data does not need to outlive the model.
+ *
+ * Binary model files can be created from a json model with convertJson(),
+ * or from a Tensorflow model with `save_model_binary()` in `python/model_utils.py`.
+ */
+namespace binary_parser
+{
+    /** The binary format version written by convertJson(). */
+    constexpr uint32_t formatVersion = 3;
+
+    /** The byte-order marker in the file header, which reads as this value once converted to the host byte order. */
+    constexpr uint32_t byteOrderMarker = 0x01020304;
+
+    /** The alignment of the weight tensors in the binary format, in bytes. */
+    constexpr uint64_t tensorAlignment = 64;
+
+    /** The maximum number of weight tensors for each layer. */
+    constexpr int maxTensors = 4;
+
+    /**
+     * The largest Conv1D layer that will be loaded from a binary model, as the
+     * number of values in its dilated kernels (out_size * in_size * kernel_size * dilation).
+     * The dilated kernels are allocated when the layer is constructed, so this stops
+     * a corrupted dilation rate from allocating an unreasonable amount of memory.
+     */
+    constexpr uint64_t maxConv1DStorageSize = (uint64_t)1 << 26;
+
+    /** The header at the start of a binary model file. */
+    struct BinaryFileHeader
+    {
+        char magic[4]; // "RTNB"
+        uint32_t byte_order; // byteOrderMarker
+        uint32_t version;
+        uint32_t in_size;
+        uint32_t num_layers;
+        uint32_t reserved;
+    };
+
+    /** The description of one layer in a binary model file. */
+    struct BinaryLayerRecord
+    {
+        char type[24]; // layer type, e.g. "dense" (null-terminated)
+        char activation[16]; // activation type, e.g. "tanh", or empty (null-terminated)
+        int32_t in_size;
+        int32_t out_size;
+        int32_t kernel_size;
+        int32_t dilation;
+        uint32_t num_tensors;
+        uint32_t reserved;
+        uint64_t tensor_offsets[maxTensors]; // offset of each tensor from the start of the file, in bytes
+        uint64_t tensor_sizes[maxTensors]; // number of float32 values in each tensor
+    };
+
+    static_assert(sizeof(BinaryFileHeader) == 24, "Unexpected binary header size!");
+    static_assert(sizeof(BinaryLayerRecord) == 128, "Unexpected binary layer record size!");
+
+    /**
+     * A read-only view of a file in memory. On POSIX systems, the file is
+     * memory-mapped, so only the pages that are used are read from disk.
+     * Otherwise, the file is read into memory.
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#if !defined(_WIN32)
+            const auto fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+                return;
+
+            struct stat fileStat;
+            if(::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+            {
+                auto* mapped = ::mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped != MAP_FAILED)
+                {
+                    mappedData = mapped;
+                    fileSize = (size_t)fileStat.st_size;
+                }
+            }
+
+            ::close(fd);
+#else
+            std::ifstream stream(path, std::ifstream::binary);
+            if(!stream)
+                return;
+
+            fileData.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            fileSize = fileData.size();
+#endif
+        }
+
+        ~MappedFile()
+        {
+#if !defined(_WIN32)
+            if(mappedData != nullptr)
+                ::munmap(mappedData, fileSize);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /** Returns a pointer to the file contents, or nullptr if the file could not be opened. */
+        const void* data() const noexcept
+        {
+#if !defined(_WIN32)
+            return mappedData;
+#else
+            return fileData.empty() ? nullptr : fileData.data();
+#endif
+        }
+
+        /** Returns the size of the file in bytes. */
+        size_t size() const noexcept { return fileSize; }
+
+    private:
+#if !defined(_WIN32)
+        void* mappedData = nullptr;
+#else
+        std::vector<char> fileData;
+#endif
+        size_t fileSize = 0;
+    };
+
+#ifndef DOXYGEN
+    namespace detail
+    {
+        /** Returns a null-terminated string from a fixed-size character field. */
+        template <size_t N>
+        std::string readString(const char (&field)[N])
+        {
+            return std::string(field, std::find(field, field + N, '\0'));
+        }
+
+        /** Copies a string into a fixed-size character field, returning false if it does not fit. */
+        template <size_t N>
+        bool writeString(char (&field)[N], const std::string& str)
+        {
+            if(str.size() >= N)
+                return false;
+
+            std::fill(field, field + N, '\0');
+            std::copy(str.begin(), str.end(), field);
+            return true;
+        }
+
+        inline bool isLittleEndianHost() noexcept
+        {
+            const uint32_t value = 1;
+            uint8_t firstByte;
+            std::memcpy(&firstByte, &value, 1);
+            return firstByte == 1;
+        }
+
+        /** Converts a value between little-endian and the host byte order (the conversion is the same in both directions). */
+        template <typename ValueType>
+        ValueType convertLittleEndian(ValueType value) noexcept
+        {
+            if(isLittleEndianHost())
+                return value;
+
+            uint8_t bytes[sizeof(ValueType)];
+            std::memcpy(bytes, &value, sizeof(ValueType));
+            std::reverse(bytes, bytes + sizeof(ValueType));
+            std::memcpy(&value, bytes, sizeof(ValueType));
+            return value;
+        }
+
+        inline BinaryFileHeader convertLittleEndian(BinaryFileHeader header) noexcept
+        {
+            header.byte_order = convertLittleEndian(header.byte_order);
+            header.version = convertLittleEndian(header.version);
+            header.in_size = convertLittleEndian(header.in_size);
+            header.num_layers = convertLittleEndian(header.num_layers);
+            header.reserved = convertLittleEndian(header.reserved);
+            return header;
+        }
+
+        inline BinaryLayerRecord convertLittleEndian(BinaryLayerRecord record) noexcept
+        {
+            record.in_size = convertLittleEndian(record.in_size);
+            record.out_size = convertLittleEndian(record.out_size);
+            record.kernel_size = convertLittleEndian(record.kernel_size);
+            record.dilation = convertLittleEndian(record.dilation);
+            record.num_tensors = convertLittleEndian(record.num_tensors);
+            record.reserved = convertLittleEndian(record.reserved);
+            for(int i = 0; i < maxTensors; ++i)
+            {
+                record.tensor_offsets[i] = convertLittleEndian(record.tensor_offsets[i]);
+                record.tensor_sizes[i] = convertLittleEndian(record.tensor_sizes[i]);
+            }
+
+            return record;
+        }
+
+        /** Multiplies tensor dimensions, saturating at the largest uint64_t instead of overflowing. */
+        inline uint64_t multiplySizes(uint64_t a, uint64_t b) noexcept
+        {
+            if(a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+                return std::numeric_limits<uint64_t>::max();
+
+            return a * b;
+        }
+
+        /** Returns the expected number of values in each tensor for a layer, or an empty vector for an unsupported layer. */
+        inline std::vector<uint64_t> expectedTensorSizes(const std::string& type, uint64_t in_size, uint64_t out_size, uint64_t kernel_size)
+        {
+            if(type == "dense")
+                return { multiplySizes(out_size, in_size), out_size };
+
+            if(type == "conv1d")
+                return { multiplySizes(multiplySizes(out_size, in_size), kernel_size), out_size };
+
+            if(type == "gru")
+                return { multiplySizes(in_size, multiplySizes(3, out_size)), multiplySizes(out_size, multiplySizes(3, out_size)), multiplySizes(6, out_size) };
+
+            if(type == "lstm")
+                return { multiplySizes(in_size, multiplySizes(4, out_size)), multiplySizes(out_size, multiplySizes(4, out_size)), multiplySizes(4, out_size) };
+
+            return {};
+        }
+
+        /** Reads a float32 tensor from a binary model, as a vector with type T. */
+        template <typename T>
+        std::vector<T> readVector(const uint8_t* tensor, int size)
+        {
+            std::vector<T> values((size_t)size);
+            for(int i = 0; i < size; ++i)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, tensor + (size_t)i * sizeof(float), sizeof(float));
+                bits = convertLittleEndian(bits);
+
+                float value;
+                std::memcpy(&value, &bits, sizeof(float));
+                values[(size_t)i] = (T)value;
+            }
+
+            return values;
+        }
+
+        template <typename T>
+        const T* mappedTensor(const uint8_t*, std::false_type) noexcept
+        {
+            return nullptr;
+        }
+
+        template <typename T>
+        const T* mappedTensor(const uint8_t* tensor, std::true_type) noexcept
+        {
+            if(!isLittleEndianHost() || reinterpret_cast<std::uintptr_t>(tensor) % alignof(float) != 0)
+                return nullptr;
+
+            return reinterpret_cast<const float*>(tensor);
+        }
+
+        /**
+         * Returns a pointer to a float32 tensor in a binary model, if it can
+         * be used in place with type T (i.e. T is float, and the tensor is
+         * aligned and in the host byte order), or nullptr otherwise.
+         */
+        template <typename T>
+        const T* mappedTensor(const uint8_t* tensor) noexcept
+        {
+            return mappedTensor<T>(tensor, std::is_same<T, float> {});
+        }
+
+        /**
+         * Returns a row-major view of a float32 tensor from a binary model.
+         * Tensors that can be used in place are viewed directly in the file
+         * data, while any other tensors are converted into the buffer first.
+         * Either way, the layer setters copy the weights into the layer's
+         * own storage.
+         */
+        template <typename T, int num_dims>
+        WeightsView<T, num_dims> readTensor(const uint8_t* tensor, const int (&sizes)[num_dims], std::vector<T>& buffer)
+        {
+            if(const auto* values = mappedTensor<T>(tensor))
+                return WeightsView<T, num_dims>::rowMajor(values, sizes);
+
+            int total_size = 1;
+            for(int d = 0; d < num_dims; ++d)
+                total_size *= sizes[d];
+
+            buffer = readVector<T>(tensor, total_size);
+            return WeightsView<T, num_dims>::rowMajor(buffer.data(), sizes);
+        }
+
+        /**
+         * Creates a neural network model from a binary model in memory.
+         * If storage is not null, it owns the binary data, and the layers
+         * keep it alive while they use the weights in place.
+         */
+        template <typename T>
+        std::unique_ptr<Model<T>> parseBinary(const void* data, size_t size, const std::shared_ptr<const void>& storage, const bool debug)
+        {
+            using json_parser::debug_print;
+
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            if(bytes == nullptr || size < sizeof(BinaryFileHeader))
+            {
+                debug_print("Binary model is too small!", debug);
+                return {};
+            }
+
+            BinaryFileHeader header;
+            std::memcpy(&header, bytes, sizeof(BinaryFileHeader));
+            header = convertLittleEndian(header);
+            if(std::memcmp(header.magic, "RTNB", 4) != 0)
+            {
+                debug_print("Not a binary model!", debug);
+                return {};
+            }
+
+            if(header.byte_order != byteOrderMarker)
+            {
+                debug_print("Binary model has the wrong byte order!", debug);
+                return {};
+            }
+
+            if(header.version != formatVersion)
+            {
+                debug_print("Unsupported binary model version!", debug);
+                return {};
+            }
+
+            if(size < sizeof(BinaryFileHeader) + (uint64_t)header.num_layers * sizeof(BinaryLayerRecord))
+            {
+                debug_print("Binary model layer table is incomplete!", debug);
+                return {};
+            }
+
+            if(header.in_size == 0 || header.in_size > (uint32_t)std::numeric_limits<int>::max())
+            {
+                debug_print("Wrong input size!", debug);
+                return {};
+            }
+
+            debug_print("# dimensions: " + std::to_string(header.in_size), debug);
+            auto model = std::make_unique<Model<T>>((int)header.in_size);
+
+            for(uint32_t layerIdx = 0; layerIdx < header.num_layers; ++layerIdx)
+            {
+                BinaryLayerRecord record;
+                std::memcpy(&record, bytes + sizeof(BinaryFileHeader) + layerIdx * sizeof(BinaryLayerRecord), sizeof(BinaryLayerRecord));
+                record = convertLittleEndian(record);
+
+                const auto type = readString(record.type);
+                debug_print("Layer: " + type, debug);
+                debug_print("  Dims: " + std::to_string(record.out_size), debug);
+
+                if(record.in_size != model->getNextInSize() || record.out_size <= 0 || record.kernel_size < 0)
+                {
+                    debug_print("Wrong layer size!", debug);
+                    return {};
+                }
+
+                if(type == "conv1d" && (record.kernel_size < 1 || record.dilation < 1))
+                {
+                    debug_print("Wrong kernel size or dilation rate!", debug);
+                    return {};
+                }
+
+                if(type == "conv1d")
+                {
+                    // the dilation rate does not change the tensor sizes, but Conv1D stores its kernels and state dilated
+                    const auto stateSize = multiplySizes(multiplySizes((uint64_t)record.kernel_size, (uint64_t)record.dilation), (uint64_t)record.in_size);
+                    if(stateSize > (uint64_t)std::numeric_limits<int>::max() || multiplySizes(stateSize, (uint64_t)record.out_size) > maxConv1DStorageSize)
+                    {
+                        debug_print("Convolution layer is too large!", debug);
+                        return {};
+                    }
+                }
+
+                const auto expectedSizes = expectedTensorSizes(type, (uint64_t)record.in_size, (uint64_t)record.out_size, (uint64_t)record.kernel_size);
+                if(expectedSizes.empty())
+                {
+                    debug_print("Unsupported layer type!", debug);
+                    return {};
+                }
+
+                if(record.num_tensors != expectedSizes.size())
+                {
+                    debug_print("Wrong number of weight tensors!", debug);
+                    return {};
+                }
+
+                // the tensor sizes are also limited to the range of int, since the layers use int sizes
+                const uint8_t* tensors[maxTensors] {};
+                for(size_t i = 0; i < expectedSizes.size(); ++i)
+                {
+                    const auto offset = record.tensor_offsets[i];
+                    const auto numValues = record.tensor_sizes[i];
+                    if(numValues != expectedSizes[i] || numValues > (uint64_t)std::numeric_limits<int>::max()
+                       || offset > size || numValues > (size - offset) / sizeof(float))
+                    {
+                        debug_print("Invalid weight tensor!", debug);
+                        return {};
+                    }
+
+                    tensors[i] = bytes + offset;
+                }
+
+                // float layers can use the weights in place, as long as the storage keeps them alive
+                const T* mapped[maxTensors] {};
+                auto isMapped = storage != nullptr;
+                for(size_t i = 0; i < expectedSizes.size(); ++i)
+                {
+                    mapped[i] = mappedTensor<T>(tensors[i]);
+                    isMapped = isMapped && mapped[i] != nullptr;
+                }
+
+                const auto in_size = record.in_size;
+                const auto out_size = record.out_size;
+                if(type == "dense" && isMapped)
+                {
+                    model->addLayer(new MappedDense<T>(in_size, out_size, mapped[0], mapped[1], storage));
+                }
+                else if(type == "dense")
+                {
+                    auto dense = std::make_unique<Dense<T>>(in_size, out_size);
+                    std::vector<T> buffer;
+                    dense->setWeights(readTensor<T>(tensors[0], { in_size, out_size }, buffer).transposed());
+                    auto bias = readVector<T>(tensors[1], out_size);
+                    dense->setBias(bias.data());
+                    model->addLayer(dense.release());
+                }
+                else if(type == "conv1d" && isMapped)
+                {
+                    model->addLayer(new MappedConv1D<T>(in_size, out_size, record.kernel_size, record.dilation, mapped[0], mapped[1], storage));
+                }
+                else if(type == "conv1d")
+                {
+                    const auto kernel_size = record.kernel_size;
+                    auto conv = std::make_unique<Conv1D<T>>(in_size, out_size, kernel_size, record.dilation);
+                    std::vector<T> buffer;
+                    conv->setWeights(readTensor<T>(tensors[0], { kernel_size, in_size, out_size }, buffer).transposed(0, 2));
+                    conv->setBias(readVector<T>(tensors[1], out_size));
+                    model->addLayer(conv.release());
+                }
+                else if(type == "gru" && isMapped)
+                {
+                    model->addLayer(new MappedGRULayer<T>(in_size, out_size, mapped[0], mapped[1], mapped[2], storage));
+                }
+                else if(type == "gru")
+                {
+                    auto gru = std::make_unique<GRULayer<T>>(in_size, out_size);
+                    std::vector<T> buffer;
+                    gru->setWVals(readTensor<T>(tensors[0], { in_size, 3 * out_size }, buffer));
+                    gru->setUVals(readTensor<T>(tensors[1], { out_size, 3 * out_size }, buffer));
+                    gru->setBVals(readTensor<T>(tensors[2], { 2, 3 * out_size }, buffer));
+                    model->addLayer(gru.release());
+                }
+                else if(type == "lstm" && isMapped)
+                {
+                    model->addLayer(new MappedLSTMLayer<T>(in_size, out_size, mapped[0], mapped[1], mapped[2], storage));
+                }
+                else if(type == "lstm")
+                {
+                    auto lstm = std::make_unique<LSTMLayer<T>>(in_size, out_size);
+                    std::vector<T> buffer;
+                    lstm->setWVals(readTensor<T>(tensors[0], { in_size, 4 * out_size }, buffer));
+                    lstm->setUVals(readTensor<T>(tensors[1], { out_size, 4 * out_size }, buffer));
+                    lstm->setBVals(readVector<T>(tensors[2], 4 * out_size));
+                    model->addLayer(lstm.release());
+                }
+
+                const auto activationType = readString(record.activation);
+                if(!activationType.empty())
+                {
+                    debug_print("  activation: " + activationType, debug);
+                    auto activation = json_parser::createActivation<T>(activationType, out_size);
+                    if(activation == nullptr)
+                    {
+                        debug_print("Unsupported activation type!", debug);
+                        return {};
+                    }
+
+                    model->addLayer(activation.release());
+                }
+            }
+
+            return model;
+        }
+    } // namespace detail
+#endif // DOXYGEN
+
+    /**
+     * Creates a neural network model from a binary model in memory.
+     * Returns nullptr if the data is not a valid binary model.
+     *
+     * The weights are copied into the layers, so the data does not
+     * need to outlive the model.
+     */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseBinary(const void* data, size_t size, const bool debug = false)
+    {
+        return detail::parseBinary<T>(data, size, nullptr, debug);
+    }
+
+    /**
+     * Creates a neural network model from a binary model file.
+     * Returns nullptr if the file could not be opened, or is
+     * not a valid binary model.
+     *
+     * For float models, the layers use the weights in place in
+     * the memory-mapped file, which stays mapped until the last
+     * of those layers is destroyed.
+     */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseBinary(const std::string& filePath, const bool debug = false)
+    {
+        auto file = std::make_shared<const MappedFile>(filePath);
+        if(file->data() == nullptr)
+        {
+            json_parser::debug_print("Unable to open binary model file: " + filePath, debug);
+            return {};
+        }
+
+        return detail::parseBinary<T>(file->data(), file->size(), file, debug);
+    }
+
+    /**
+     * Converts a json model to the binary format, and writes it to a stream.
+     *
+     * Dense, Conv1D (without striding), GRU, and LSTM layers are supported,
+     * with tanh, ReLU, sigmoid, softmax, and ELu activations. Quantized
+     * layers and pruning masks are applied to the weights, which are always
+     * stored as float32. Returns false if the model contains a layer that
+     * is not supported.
+     */
+    inline bool convertJson(const nlohmann::json& parent, std::ostream& out, const bool debug = false)
+    {
+        using json_parser::debug_print;
+
+        const auto shape = parent["in_shape"];
+        const auto layers = parent["layers"];
+        if(!shape.is_array() || !layers.is_array())
+            return false;
+
+        BinaryFileHeader header {};
+        std::copy_n("RTNB", 4, header.magic);
+        header.byte_order = byteOrderMarker;
+        header.version = formatVersion;
+        header.in_size = shape.back().get<uint32_t>();
+        header.num_layers = (uint32_t)layers.size();
+
+        std::vector<BinaryLayerRecord> records;
+        std::vector<std::vector<float>> tensors;
+        auto nextInSize = (int)header.in_size;
+        auto nextOffset = (uint64_t)(sizeof(BinaryFileHeader) + layers.size() * sizeof(BinaryLayerRecord));
+
+        const auto addTensor = [&](BinaryLayerRecord& record, std::vector<float>&& tensor) {
+            nextOffset = (nextOffset + tensorAlignment - 1) / tensorAlignment * tensorAlignment;
+            record.tensor_offsets[record.num_tensors] = nextOffset;
+            record.tensor_sizes[record.num_tensors] = tensor.size();
+            record.num_tensors++;
+            nextOffset += tensor.size() * sizeof(float);
+            tensors.push_back(std::move(tensor));
+        };
+
+        for(const auto& l : layers)
+        {
+            auto type = l["type"].get<std::string>();
+            if(type == "time-distributed-dense")
+                type = "dense";
+
+            debug_print("Layer: " + type, debug);
+            if(l.contains("rank") || l.contains("activation_lut") || (l.contains("strides") && l["strides"].back().get<int>() > 1))
+            {
+                debug_print("Low-rank layers, lookup-table activations, and strided convolutions are not supported by the binary format!", debug);
+                return false;
+            }
+
+            BinaryLayerRecord record {};
+            // recurrent layers apply their activations internally
+            const auto hasActivation = (type == "dense" || type == "conv1d") && l.contains("activation");
+            const auto activation = hasActivation ? l["activation"].get<std::string>() : std::string {};
+            if(!detail::writeString(record.type, type) || !detail::writeString(record.activation, activation))
+                return false;
+
+            record.in_size = nextInSize;
+            record.out_size = l["shape"].back().get<int>();
+            const auto weights = json_parser::getLayerWeights(l);
+
+            const auto flatten = [](const nlohmann::json& matrix) {
+                std::vector<float> flat;
+                for(const auto& row : matrix)
+                    for(const auto& value : row)
+                        flat.push_back(value.get<float>());
+                return flat;
+            };
+
+            if(type == "dense")
+            {
+                addTensor(record, flatten(weights[0]));
+                addTensor(record, weights[1].get<std::vector<float>>());
+            }
+            else if(type == "conv1d")
+            {
+                const auto kernel_size = (size_t)l["kernel_size"].back().get<int>();
+                record.kernel_size = (int32_t)kernel_size;
+                record.dilation = l["dilation"].back().get<int>();
+
+                // the json kernel has the oldest input first
+                std::vector<float> kernel;
+                for(size_t k = kernel_size; k > 0; --k)
+                {
+                    const auto tap = flatten(weights[0][k - 1]);
+                    kernel.insert(kernel.end(), tap.begin(), tap.end());
+                }
+
+                addTensor(record, std::move(kernel));
+                addTensor(record, weights[1].get<std::vector<float>>());
+            }
+            else if(type == "gru" || type == "lstm")
+            {
+                addTensor(record, flatten(weights[0]));
+                addTensor(record, flatten(weights[1]));
+                addTensor(record, type == "gru" ? flatten(weights[2]) : weights[2].get<std::vector<float>>());
+            }
+            else
+            {
+                debug_print("Layer type is not supported by the binary format!", debug);
+                return false;
+            }
+
+            records.push_back(record);
+            nextInSize = record.out_size;
+        }
+
+        const auto fileHeader = detail::convertLittleEndian(header);
+        out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(BinaryFileHeader));
+        for(const auto& record : records)
+        {
+            const auto fileRecord = detail::convertLittleEndian(record);
+            out.write(reinterpret_cast<const char*>(&fileRecord), sizeof(BinaryLayerRecord));
+        }
+
+        auto offset = (uint64_t)(sizeof(BinaryFileHeader) + records.size() * sizeof(BinaryLayerRecord));
+        size_t tensorIdx = 0;
+        for(const auto& record : records)
+        {
+            for(uint32_t i = 0; i < record.num_tensors; ++i)
+            {
+                const std::vector<char> padding((size_t)(record.tensor_offsets[i] - offset), 0);
+                out.write(padding.data(), (std::streamsize)padding.size());
+
+                auto& tensor = tensors[tensorIdx++];
+                for(auto& value : tensor)
+                    value = detail::convertLittleEndian(value);
+                out.write(reinterpret_cast<const char*>(tensor.data()), (std::streamsize)(tensor.size() * sizeof(float)));
+                offset = record.tensor_offsets[i] + tensor.size() * sizeof(float);
+            }
+        }
+
+        return (bool)out;
+    }
+
+} // namespace binary_parser
+} // namespace RTNeural
@@ -1,5 +1,23 @@
 #pragma once
 
+#ifndef RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY
+/**
+ * The default maximum delay length (in samples) that can be used by
+ * templated recurrent layers doing sample-rate correction (see the
+ * `maxDelaySamples` template argument of GRULayerT and LSTMLayerT),
+ * and the default maximum sample-rate ratio for templated convolutional
+ * layers (see the `maxSampleRateRatio` template argument of Conv1DT).
+ */
+#define RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY 16
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 namespace RTNeural
 {
 
@@ -15,6 +33,14 @@ namespace RTNeural
  * is 2x the training sample rate). Note that sample-rate correction
  * does not support delay lengths less than 1-sample, so the target sample
  * rate must always be greater than or equal to the training sample rate.
+ * The delay is stored in a fixed-size circular buffer, so delays are
+ * limited to the layer's `maxDelaySamples` template argument (by default
+ * RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY samples). The dynamic recurrent
+ * layers size their delay lines at run-time instead.
+ *
+ * Convolutional layers (e.g. Conv1DT) can also use this class, in which
+ * case the dilation of the convolution kernel is scaled by the sample-rate
+ * ratio instead.
  */
 enum class SampleRateCorrectionMode
 {
@@ -23,6 +49,384 @@ enum class SampleRateCorrectionMode
     LinInterp, // sample rate correction with linear interpolation (can be used with non-integer delay lengths)
 };
 
+/**
+ * Returns the DelayBuffer capacity needed by a templated recurrent layer,
+ * so that it can be prepared with delays of up to `maxDelaySamples` samples.
+ */
+constexpr int sampleRateCorrectionDelayCapacity(SampleRateCorrectionMode mode, int maxDelaySamples) noexcept
+{
+    // NoInterp reads (delay - 1) frames back, and LinInterp reads up to floor(delay) frames back
+    const auto maxReadDelay = mode == SampleRateCorrectionMode::None ? 0
+        : (mode == SampleRateCorrectionMode::NoInterp ? maxDelaySamples - 1 : maxDelaySamples);
+
+    int capacity = 1;
+    while(capacity <= maxReadDelay)
+        capacity *= 2;
+    return capacity;
+}
+
+/** DelayBuffer capacity for buffers that are sized at run-time, with DelayBuffer::resize(). */
+constexpr int dynamicDelayCapacity = 0;
+
+#ifndef DOXYGEN
+namespace delay_detail
+{
+    /** Frame storage for a DelayBuffer with a fixed capacity. */
+    template <typename FrameType, int capacity>
+    struct DelayStorage
+    {
+        static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "Delay buffer capacity must be a power of two!");
+
+        static constexpr int maxDelay() noexcept { return capacity - 1; }
+
+        static constexpr int mask = capacity - 1;
+        FrameType frames[capacity];
+    };
+
+    /** Frame storage for a DelayBuffer with a run-time capacity. */
+    template <typename FrameType>
+    struct DelayStorage<FrameType, dynamicDelayCapacity>
+    {
+        int maxDelay() const noexcept { return mask; }
+
+        /**
+         * Allocates enough frames to read delays of up to `newMaxDelay` frames,
+         * rounded up so that the capacity is a power of two.
+         */
+        void resize(int newMaxDelay, const FrameType& frame)
+        {
+            int newCapacity = 1;
+            while(newCapacity <= newMaxDelay)
+                newCapacity *= 2;
+
+            frames.assign((size_t)newCapacity, frame);
+            mask = newCapacity - 1;
+        }
+
+        int mask = 0;
+        std::vector<FrameType> frames = std::vector<FrameType>(1);
+    };
+} // namespace delay_detail
+#endif // DOXYGEN
+
+/**
+ * Circular buffer, used by recurrent layers to delay their state
+ * when doing sample-rate correction. Writing a new frame and reading
+ * a delayed frame are both O(1), regardless of the delay length.
+ *
+ * @param FrameType: the type of frame stored in the buffer
+ * @param capacity: the number of frames stored in the buffer (must be a power of two),
+ *                  or dynamicDelayCapacity for buffers that are sized with resize()
+ */
+template <typename FrameType, int capacity>
+class DelayBuffer : private delay_detail::DelayStorage<FrameType, capacity>
+{
+    using Storage = delay_detail::DelayStorage<FrameType, capacity>;
+
+public:
+    /** Returns the maximum delay that can be read from the buffer. */
+    using Storage::maxDelay;
+
+    /** Fills every frame in the buffer with the given frame. */
+    void reset(const FrameType& frame) noexcept
+    {
+        for(auto& f : Storage::frames)
+            f = frame;
+        write_ptr = 0;
+    }
+
+    /** Returns the frame that is currently being written. */
+    FrameType& writeFrame() noexcept { return Storage::frames[write_ptr]; }
+
+    /** Returns the frame that was written `delay` frames before the current frame. */
+    const FrameType& read(int delay) const noexcept { return Storage::frames[(write_ptr - delay) & Storage::mask]; }
+
+    /** Moves the buffer on to the next frame. */
+    void advance() noexcept { write_ptr = (write_ptr + 1) & Storage::mask; }
+
+    /**
+     * Resizes a buffer with a run-time capacity, so that delays of up to
+     * `newMaxDelay` frames can be read, and fills it with the given frame.
+     *
+     * This method allocates memory, so it should not be called
+     * from a real-time context.
+     */
+    template <int C = capacity>
+    typename std::enable_if<C == dynamicDelayCapacity, void>::type
+    resize(int newMaxDelay, const FrameType& frame)
+    {
+        Storage::resize(newMaxDelay, frame);
+        write_ptr = 0;
+    }
+
+private:
+    int write_ptr = 0;
+};
+
+/**
+ * Delay line used by the dynamic recurrent layers (e.g. LSTMLayer, GRULayer)
+ * to perform sample-rate correction. This is the run-time equivalent of
+ * SampleRateCorrectionMode: integer delay lengths are used without
+ * interpolation, and non-integer delay lengths use linear interpolation.
+ *
+ * The frames are stored in a DelayBuffer, which is sized for the delay
+ * length when the delay line is prepared, so processing a frame is O(1),
+ * and the delay length is not limited by RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY.
+ */
+template <typename T>
+class SampleRateCorrectionDelay
+{
+public:
+    /**
+     * Prepares the delay line for a given frame size and delay length.
+     * A delay length of 1 sample (or less) disables the delay line.
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(int newFrameSize, T delaySamples)
+    {
+        active = delaySamples > (T)1;
+        frame_size = newFrameSize;
+
+        delayOffset = active ? (int)std::floor(delaySamples) : 1;
+        delayPlus1Mult = active ? delaySamples - std::floor(delaySamples) : (T)0;
+        delayMult = (T)1 - delayPlus1Mult;
+
+        zeroFrame.assign((size_t)frame_size, (T)0);
+        if(active)
+            frames.resize(delayOffset, zeroFrame);
+
+        reset();
+    }
+
+    /** Clears the delay line. */
+    void reset()
+    {
+        if(active)
+            frames.reset(zeroFrame);
+    }
+
+    /** Returns true if the delay line has been prepared with a delay longer than 1 sample. */
+    bool isActive() const noexcept { return active; }
+
+    /** Pushes a new frame into the delay line, and replaces it with the delayed frame. */
+    inline void process(T* frame) noexcept
+    {
+        std::copy(frame, frame + frame_size, frames.writeFrame().begin());
+
+        const auto& delayed = frames.read(delayOffset);
+        const auto& delayedMinus1 = frames.read(delayOffset - 1);
+        if(delayPlus1Mult == (T)0)
+        {
+            std::copy(delayedMinus1.begin(), delayedMinus1.end(), frame);
+        }
+        else
+        {
+            for(int i = 0; i < frame_size; ++i)
+                frame[i] = delayPlus1Mult * delayed[(size_t)i] + delayMult * delayedMinus1[(size_t)i];
+        }
+
+        frames.advance();
+    }
+
+private:
+    DelayBuffer<std::vector<T>, dynamicDelayCapacity> frames;
+    std::vector<T> zeroFrame;
+    int frame_size = 0;
+    bool active = false;
+
+    int delayOffset = 1;
+    T delayMult = (T)1;
+    T delayPlus1Mult = (T)0;
+};
+
+/**
+ * Delay line used by the convolutional layers (e.g. Conv1D, Conv1DT)
+ * to perform sample-rate correction. When processing at `sampleRateRatio`
+ * times the training sample rate, the dilation of the kernel is scaled by
+ * the same ratio, and kernel taps that fall between two samples are
+ * linearly interpolated.
+ */
+template <typename T>
+class FractionalDilationDelay
+{
+public:
+    /**
+     * Prepares the delay line for a given convolution kernel and sample-rate ratio.
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(int numChannels, int kernelSize, int dilation, T sampleRateRatio)
+    {
+        num_channels = numChannels;
+        ratio = sampleRateRatio;
+
+        tap_offsets.resize((size_t)kernelSize, 0);
+        tap_fracs.resize((size_t)kernelSize, (T)0);
+        for(int j = 0; j < kernelSize; ++j)
+        {
+            const auto tapDelay = (T)(j * dilation) * sampleRateRatio;
+            tap_offsets[(size_t)j] = (int)std::floor(tapDelay);
+            tap_fracs[(size_t)j] = tapDelay - std::floor(tapDelay);
+        }
+
+        int capacity = 1;
+        while(capacity < tap_offsets.back() + 2)
+            capacity *= 2;
+
+        mask = capacity - 1;
+        frames.resize((size_t)(capacity * num_channels), (T)0);
+
+        reset();
+    }
+
+    /** Clears the delay line. */
+    void reset()
+    {
+        std::fill(frames.begin(), frames.end(), (T)0);
+        write_ptr = 0;
+    }
+
+    /** Returns the sample-rate ratio that the delay line was prepared with. */
+    T getSampleRateRatio() const noexcept { return ratio; }
+
+    /** Pushes a new input frame into the delay line. */
+    inline void push(const T* input) noexcept
+    {
+        write_ptr = (write_ptr + 1) & mask;
+        std::copy(input, input + num_channels, &frames[(size_t)(write_ptr * num_channels)]);
+    }
+
+    /** Gathers the kernel taps for the most recent input frame, laid out as taps[kernel_size][num_channels]. */
+    inline void gather(T* taps) const noexcept
+    {
+        for(size_t j = 0; j < tap_offsets.size(); ++j)
+        {
+            auto* tap = taps + j * (size_t)num_channels;
+            const auto* x0 = getFrame(write_ptr - tap_offsets[j]);
+            const auto frac = tap_fracs[j];
+            if(frac == (T)0)
+            {
+                std::copy(x0, x0 + num_channels, tap);
+                continue;
+            }
+
+            const auto* x1 = getFrame(write_ptr - tap_offsets[j] - 1);
+            for(int k = 0; k < num_channels; ++k)
+                tap[k] = ((T)1 - frac) * x0[k] + frac * x1[k];
+        }
+    }
+
+private:
+    inline const T* getFrame(int idx) const noexcept
+    {
+        return &frames[(size_t)((idx & mask) * num_channels)];
+    }
+
+    std::vector<T> frames;
+    std::vector<int> tap_offsets;
+    std::vector<T> tap_fracs;
+
+    int num_channels = 0;
+    int mask = 0;
+    int write_ptr = 0;
+    T ratio = (T)1;
+};
+
+/**
+ * Static equivalent of FractionalDilationDelay, used by Conv1DT.
+ * The frames are stored in a fixed-size circular buffer, which is
+ * sized so that the layer can be prepared with sample-rate ratios
+ * of up to `maxSampleRateRatio`.
+ */
+template <typename T, int num_channels, int kernel_size, int dilation_rate, int maxSampleRateRatio>
+class FractionalDilationDelayT
+{
+    // the longest tap delay, plus one frame for interpolation
+    static constexpr int capacity = sampleRateCorrectionDelayCapacity(SampleRateCorrectionMode::LinInterp,
+        (kernel_size - 1) * dilation_rate * maxSampleRateRatio + 1);
+    static constexpr int mask = capacity - 1;
+
+public:
+    /** Prepares the delay line for a given sample-rate ratio. */
+    void prepare(T sampleRateRatio) noexcept
+    {
+        assert(sampleRateRatio <= (T)maxSampleRateRatio && "Sample-rate ratio is larger than the maxSampleRateRatio template argument!");
+        ratio = sampleRateRatio;
+
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            const auto tapDelay = (T)(j * dilation_rate) * sampleRateRatio;
+            tap_offsets[j] = (int)std::floor(tapDelay);
+            tap_fracs[j] = tapDelay - std::floor(tapDelay);
+        }
+
+        reset();
+    }
+
+    /** Clears the delay line. */
+    void reset() noexcept
+    {
+        std::fill(&frames[0][0], &frames[0][0] + capacity * num_channels, (T)0);
+        write_ptr = 0;
+    }
+
+    /** Returns the sample-rate ratio that the delay line was prepared with. */
+    T getSampleRateRatio() const noexcept { return ratio; }
+
+    /** Pushes a new input frame into the delay line. */
+    inline void push(const T* input) noexcept
+    {
+        write_ptr = (write_ptr + 1) & mask;
+        std::copy(input, input + num_channels, frames[write_ptr]);
+    }
+
+    /** Gathers the kernel taps for the most recent input frame, laid out as taps[kernel_size][num_channels]. */
+    inline void gather(T* taps) const noexcept
+    {
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            auto* tap = taps + j * num_channels;
+            const auto* x0 = frames[(write_ptr - tap_offsets[j]) & mask];
+            const auto frac = tap_fracs[j];
+            if(frac == (T)0)
+            {
+                std::copy(x0, x0 + num_channels, tap);
+                continue;
+            }
+
+            const auto* x1 = frames[(write_ptr - tap_offsets[j] - 1) & mask];
+            for(int k = 0; k < num_channels; ++k)
+                tap[k] = ((T)1 - frac) * x0[k] + frac * x1[k];
+        }
+    }
+
+private:
+    T frames[capacity][num_channels] {};
+    int tap_offsets[kernel_size] {};
+    T tap_fracs[kernel_size] {};
+
+    int write_ptr = 0;
+    T ratio = (T)1;
+};
+
+#ifndef DOXYGEN
+namespace delay_detail
+{
+    /** Stand-in for FractionalDilationDelayT in convolutions without sample-rate correction. */
+    template <typename T>
+    struct NoDilationDelay
+    {
+        void prepare(T) noexcept { }
+        void reset() noexcept { }
+        void push(const T*) noexcept { }
+        void gather(T*) const noexcept { }
+    };
+} // namespace delay_detail
+#endif // DOXYGEN
+
 /** Divides two numbers and rounds up if there is a remainder. */
 template <typename T>
 constexpr T ceil_div(T num, T den)
@@ -30,6 +434,61 @@ constexpr T ceil_div(T num, T den)
     return (num + den - 1) / den;
 }
 
+#ifndef DOXYGEN
+/** Utilities for computing the dimensions of a 2D convolution along the feature axis. */
+namespace conv2d_detail
+{
+    /** Returns the number of output features (same as Tensorflow's "valid" or "same" padding). */
+    constexpr int num_features_out(int num_features_in, int kernel_size, int stride, bool valid_pad)
+    {
+        return valid_pad ? ceil_div(num_features_in - kernel_size + 1, stride) : ceil_div(num_features_in, stride);
+    }
+
+    constexpr int pad_total(int num_features_out, int num_features_in, int kernel_size, int stride)
+    {
+        return (num_features_out - 1) * stride + kernel_size > num_features_in ? (num_features_out - 1) * stride + kernel_size - num_features_in : 0;
+    }
+
+    /** Returns the amount of zero-padding at the start of the feature axis. */
+    constexpr int pad_left(int num_features_in, int kernel_size, int stride, bool valid_pad)
+    {
+        return valid_pad ? 0 : pad_total(num_features_out(num_features_in, kernel_size, stride, valid_pad), num_features_in, kernel_size, stride) / 2;
+    }
+} // namespace conv2d_detail
+#endif // DOXYGEN
+
+#ifndef DOXYGEN
+/**
+ * Utilities for kernels that keep one accumulator per lane, and only add
+ * the lanes together at the end. The multiply-adds are then element-wise,
+ * so they can use SIMD instructions without reordering any floating-point
+ * sums (which compilers won't do without -ffast-math).
+ */
+namespace lanes_detail
+{
+    /**
+     * With GCC and Clang, `LaneVector<T, N>::type` holds N lanes in a vector
+     * register (using the vector extensions), which the compiler lowers to
+     * the SIMD instructions of the target. Otherwise (or if N is not a power
+     * of two), `is_vector` is false, and kernels use an array of scalar lanes.
+     */
+    template <typename T, int N, bool = (N > 1 && (N & (N - 1)) == 0)>
+    struct LaneVector
+    {
+        static constexpr bool is_vector = false;
+    };
+
+#if defined(__GNUC__) || defined(__clang__)
+    template <typename T, int N>
+    struct LaneVector<T, N, true>
+    {
+        static constexpr bool is_vector = true;
+        typedef T type __attribute__((vector_size(N * sizeof(T))));
+    };
+#endif
+} // namespace lanes_detail
+#endif // DOXYGEN
+
 /** Pade approximation of std::tanh() */
 template <typename T>
 static inline T tanh_approx(T x) noexcept
@@ -44,12 +503,22 @@ static inline T tanh_approx(T x) noexcept
 }
 } // namespace RTNeural
 
+#if RTNEURAL_USE_EIGEN
+#include "maths/maths_eigen.h"
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+#include "maths/maths_xsimd.h"
+#else
+#include "maths/maths_stl.h"
+#endif
+
 #if RTNEURAL_USE_EIGEN
 #include <Eigen/Dense>
 
 namespace RTNeural
 {
-#if RTNEURAL_DEFAULT_ALIGNMENT == 32
+#if RTNEURAL_DEFAULT_ALIGNMENT == 64
+constexpr auto RTNeuralEigenAlignment = Eigen::Aligned64;
+#elif RTNEURAL_DEFAULT_ALIGNMENT == 32
 constexpr auto RTNeuralEigenAlignment = Eigen::Aligned32;
 #else
 constexpr auto RTNeuralEigenAlignment = Eigen::Aligned16;
@@ -66,7 +535,8 @@ template <typename T>
 static inline void
 softmax(Eigen::Matrix<T, Eigen::Dynamic, 1>& vector) noexcept
 {
-    vector = vector.array().exp();
+    // subtract the largest input before exponentiating, so that exp() can't overflow
+    vector = (vector.array() - vector.maxCoeff()).exp();
     vector = vector / vector.sum();
 }
 
@@ -83,39 +553,43 @@ static inline auto fast_tanh(const MatType& in) noexcept
 }
 } // namespace RTNeural
 
-#elif RTNEURAL_USE_XSIMD
-#include <xsimd/xsimd.hpp>
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+#include <algorithm>
+#include <limits>
 
+#if RTNEURAL_USE_VECTOR_EXT
+#include "vector_ext/vector_ext.h"
+#else
 #include <xsimd/stl/algorithms.hpp>
+#include <xsimd/xsimd.hpp>
+#endif
 
 namespace RTNeural
 {
 
+// The aligned buffers used by the XSIMD layers must be aligned for the widest vector type.
+static_assert(RTNEURAL_DEFAULT_ALIGNMENT >= alignof(xsimd::simd_type<float>) && RTNEURAL_DEFAULT_ALIGNMENT >= alignof(xsimd::simd_type<double>),
+    "RTNEURAL_DEFAULT_ALIGNMENT is smaller than the alignment required by the XSIMD architecture! (e.g. AVX requires 32, AVX-512 requires 64)");
+
 template <typename T>
 static inline xsimd::simd_type<T> set_value(xsimd::simd_type<T> x, int idx, T value) noexcept
 {
-    union UnionType
-    {
-        xsimd::simd_type<T> v;
-        T s[xsimd::simd_type<T>::size];
-    };
-    UnionType u { x };
+    using b_type = xsimd::simd_type<T>;
+    T lanes alignas(alignof(b_type))[b_type::size];
+    xsimd::store_aligned(lanes, x);
 
-    u.s[idx] = value;
-    return u.v;
+    lanes[idx] = value;
+    return xsimd::load_aligned(lanes);
 }
 
 template <typename T>
 static inline T get_value(xsimd::simd_type<T> x, int idx) noexcept
 {
-    union UnionType
-    {
-        xsimd::simd_type<T> v;
-        T s[xsimd::simd_type<T>::size];
-    };
-    UnionType u { x };
+    using b_type = xsimd::simd_type<T>;
+    T lanes alignas(alignof(b_type))[b_type::size];
+    xsimd::store_aligned(lanes, x);
 
-    return u.s[idx];
+    return lanes[idx];
 }
 
 template <typename T>
@@ -171,6 +645,35 @@ static inline void vCopy(const T* in, T* out, int dim) noexcept
         out[i] = in[i];
 }
 
+/**
+ * Applies a vectorized function (e.g. one of the MathsProvider methods) to an array.
+ * The remaining part that doesn't fill a whole vector is processed from a zero-padded vector.
+ */
+template <typename T, typename VecFunc>
+static inline void vApply(const T* in, T* out, int dim, VecFunc&& func) noexcept
+{
+    using b_type = xsimd::simd_type<T>;
+    constexpr auto inc = (int)b_type::size;
+
+    // size for which the vectorization is possible
+    auto vec_size = dim - dim % inc;
+    for(int i = 0; i < vec_size; i += inc)
+    {
+        b_type x_vec = xsimd::load_aligned(&in[i]);
+        b_type y_vec = func(x_vec);
+        xsimd::store_aligned(&out[i], y_vec);
+    }
+
+    if(vec_size < dim)
+    {
+        T tail alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inc] {};
+        std::copy(in + vec_size, in + dim, tail);
+        b_type y_vec = func(b_type(xsimd::load_aligned(tail)));
+        xsimd::store_aligned(tail, y_vec);
+        std::copy(tail, tail + (dim - vec_size), out + vec_size);
+    }
+}
+
 template <typename T>
 static inline void sigmoid(const T* in, T* out, int dim) noexcept
 {
@@ -182,7 +685,7 @@ static inline void sigmoid(const T* in, T* out, int dim) noexcept
     for(int i = 0; i < vec_size; i += inc)
     {
         b_type x_vec = xsimd::load_aligned(&in[i]);
-        b_type y_vec = (T)1.0 / ((T)1.0 + xsimd::exp(-x_vec));
+        b_type y_vec = maths_detail::sigmoid_vec(x_vec);
         xsimd::store_aligned(&out[i], y_vec);
     }
 
@@ -191,31 +694,52 @@ static inline void sigmoid(const T* in, T* out, int dim) noexcept
         out[i] = 1.0 / (1.0 + std::exp(-in[i]));
 }
 
-template <typename T>
+template <typename MathsProvider = DefaultMathsProvider, typename T>
 static inline void softmax(const T* in, T* out, int dim) noexcept
 {
     using b_type = xsimd::simd_type<T>;
     constexpr auto inc = (int)b_type::size;
 
-    b_type exp_sum_vec {};
-
     // size for which the vectorization is possible
     auto vec_size = dim - dim % inc;
+
+    // subtract the largest input before exponentiating, so that exp() can't overflow
+    auto max_value = std::numeric_limits<T>::lowest();
+    if(vec_size > 0)
+    {
+        b_type max_vec = xsimd::load_aligned(&in[0]);
+        for(int i = inc; i < vec_size; i += inc)
+            max_vec = xsimd::max(max_vec, xsimd::load_aligned(&in[i]));
+        max_value = maths_detail::reduce_max_vec(max_vec);
+    }
+
+    for(auto i = vec_size; i < dim; ++i)
+        max_value = std::max(max_value, in[i]);
+
+    const b_type max_vec(max_value);
+    b_type exp_sum_vec {};
     for(int i = 0; i < vec_size; i += inc)
     {
         b_type x_vec = xsimd::load_aligned(&in[i]);
-        b_type y_vec = xsimd::exp(x_vec);
+        b_type y_vec = MathsProvider::exp(x_vec - max_vec);
         exp_sum_vec += y_vec;
         xsimd::store_aligned(&out[i], y_vec);
     }
 
     T exp_sum = xsimd::reduce_add(exp_sum_vec);
 
-    // Remaining part that cannot be vectorize
-    for(auto i = vec_size; i < dim; ++i)
+    // Remaining part that cannot be vectorized, computed from a zero-padded vector
+    if(vec_size < dim)
     {
-        out[i] = std::exp(in[i]);
-        exp_sum += out[i];
+        T tail alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inc] {};
+        std::copy(in + vec_size, in + dim, tail);
+        b_type y_vec = MathsProvider::exp(b_type(xsimd::load_aligned(tail)) - max_vec);
+        xsimd::store_aligned(tail, y_vec);
+        for(auto i = vec_size; i < dim; ++i)
+        {
+            out[i] = tail[i - vec_size];
+            exp_sum += out[i];
+        }
     }
 
     const auto exp_sum_recip = (T)1 / exp_sum;
@@ -264,7 +788,7 @@ static inline void elu(const T* in, T* out, int dim, T alpha) noexcept
     for(int i = 0; i < vec_size; i += inc)
     {
         b_type x_vec = xsimd::load_aligned(&in[i]);
-        b_type y_vec = xsimd::select(x_vec > (T)0, x_vec, alpha * (xsimd::exp(x_vec) - (T)1));
+        b_type y_vec = maths_detail::elu_vec(x_vec, alpha);
         xsimd::store_aligned(&out[i], y_vec);
     }
 
@@ -276,24 +800,7 @@ static inline void elu(const T* in, T* out, int dim, T alpha) noexcept
 template <typename T>
 static inline xsimd::simd_type<T> fast_tanh(const xsimd::simd_type<T>& x) noexcept
 {
-    using b_type = xsimd::simd_type<T>;
-
-    static const b_type clamp_hi((T)5.7);
-    static const b_type clamp_lo((T)-5.7);
-    auto xc = xsimd::clip(x, clamp_lo, clamp_hi); // clamp to range [-clamp, clamp]
-
-    static const b_type v2027025((T)2027025);
-    static const b_type v270270((T)270270);
-    static const b_type v6930((T)6930);
-    static const b_type v36((T)36);
-    static const b_type v945945((T)945945);
-    static const b_type v51975((T)51975);
-    static const b_type v630((T)630);
-
-    auto x2 = xc * xc;
-    auto numerator = xc * (v2027025 + x2 * (v270270 + x2 * (v6930 + v36 * x2)));
-    auto denominator = v2027025 + x2 * (v945945 + x2 * (v51975 + x2 * (v630 + x2)));
-    return numerator / denominator;
+    return maths_detail::tanh_pade_vec(x);
 }
 
 template <typename T>
@@ -353,7 +860,13 @@ static inline void softmax(const float* in, float* out, int dim) noexcept
     const auto dim_int = static_cast<int>(dim);
     float exp_sum;
 
-    vvexpf(out, in, &dim_int);
+    // subtract the largest input before exponentiating, so that exp() can't overflow
+    float max_value;
+    vDSP_maxv(in, 1, &max_value, dim);
+    const auto neg_max_value = -max_value;
+    vDSP_vsadd(in, 1, &neg_max_value, out, 1, dim);
+
+    vvexpf(out, out, &dim_int);
     vDSP_sve(out, 1, &exp_sum, dim);
     vDSP_vsdiv(out, 1, &exp_sum, out, 1, dim);
 }
@@ -363,7 +876,13 @@ static inline void softmax(const double* in, double* out, int dim) noexcept
     const auto dim_int = static_cast<int>(dim);
     double exp_sum;
 
-    vvexp(out, in, &dim_int);
+    // subtract the largest input before exponentiating, so that exp() can't overflow
+    double max_value;
+    vDSP_maxvD(in, 1, &max_value, dim);
+    const auto neg_max_value = -max_value;
+    vDSP_vsaddD(in, 1, &neg_max_value, out, 1, dim);
+
+    vvexp(out, out, &dim_int);
     vDSP_sveD(out, 1, &exp_sum, dim);
     vDSP_vsdivD(out, 1, &exp_sum, out, 1, dim);
 }
@@ -375,6 +894,8 @@ static inline void softmax(const double* in, double* out, int dim) noexcept
 #include <cmath>
 #include <numeric>
 
+#include "dispatch/layer_kernels.h"
+
 namespace RTNeural
 {
 
@@ -390,13 +911,16 @@ static inline T sigmoid(T value) noexcept
     return (T)1 / ((T)1 + std::exp(-value));
 }
 
-template <typename T>
+template <typename MathsProvider = DefaultMathsProvider, typename T>
 static inline void softmax(const T* input, T* out, int size) noexcept
 {
+    // subtract the largest input before exponentiating, so that exp() can't overflow
+    const auto max_value = *std::max_element(input, input + size);
+
     T exp_sum = 0;
     for(int i = 0; i < size; ++i)
     {
-        out[i] = std::exp(input[i]);
+        out[i] = MathsProvider::exp(input[i] - max_value);
         exp_sum += out[i];
     }
 
@@ -4,7 +4,7 @@
 #if RTNEURAL_USE_EIGEN
 #include "conv1d_eigen.h"
 #include "conv1d_eigen.tpp"
-#elif RTNEURAL_USE_XSIMD
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
 #include "conv1d_xsimd.h"
 #include "conv1d_xsimd.tpp"
 #elif RTNEURAL_USE_ACCELERATE
@@ -29,7 +29,7 @@ namespace RTNeural
  * the `forward()` method.
  */
 template <typename T>
-class Conv1D final : public Layer<T>
+class Conv1D : public Layer<T>
 {
 public:
     /**
@@ -43,18 +43,50 @@ public:
     Conv1D(int in_size, int out_size, int kernel_size, int dilation);
     Conv1D(std::initializer_list<int> sizes);
     Conv1D(const Conv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
     Conv1D& operator=(const Conv1D& other);
     virtual ~Conv1D();
 
     /** Resets the layer state. */
     void reset() override;
 
+    /**
+     * Prepares the layer to process data at `sampleRateRatio` times the
+     * sample rate that the layer was trained at. The dilation of the
+     * kernel is scaled by the same ratio, and any kernel taps that fall
+     * between two samples are linearly interpolated.
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(T sampleRateRatio) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
     /** Performs forward propagation for this layer. */
     inline void forward(const T* input, T* h) noexcept override
     {
+        // a kernel of size 1 is a dense layer, so no state is needed
+        if(kernel_size == 1)
+        {
+            kernels.matVec(fastWeights.data(), Layer<T>::out_size, Layer<T>::in_size, input, h);
+            addBias(h);
+            return;
+        }
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            tapDelay.gather(taps.data());
+
+            const auto num_taps = kernel_size * Layer<T>::in_size;
+            kernels.matVec(fastWeights.data(), Layer<T>::out_size, num_taps, taps.data(), h);
+            addBias(h);
+            return;
+        }
+
         // insert input into double-buffered state
         for(int k = 0; k < Layer<T>::in_size; ++k)
         {
@@ -62,13 +94,51 @@ public:
             state[k][state_ptr + state_size] = input[k];
         }
 
-        for(int i = 0; i < Layer<T>::out_size; ++i)
+        if(Layer<T>::in_size == 1)
         {
-            h[i] = (T)0;
-            for(int k = 0; k < Layer<T>::in_size; ++k)
-                h[i] += vMult(&state[k][state_ptr], kernelWeights[i][k], state_size);
+            // gather the non-zero kernel taps, and skip the dilation gaps
+            for(int j = 0; j < kernel_size; ++j)
+                taps[j] = state[0][state_ptr + j * dilation_rate];
 
-            h[i] += bias[i];
+            kernels.matVec(fastWeights.data(), Layer<T>::out_size, kernel_size, taps.data(), h);
+            addBias(h);
+        }
+        else
+        {
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+            {
+                h[i] = (T)0;
+                for(int k = 0; k < Layer<T>::in_size; ++k)
+                    h[i] += vMult(&state[k][state_ptr], kernelWeights[i][k], state_size);
+
+                h[i] += bias[i];
+            }
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const T* input) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            return;
+        }
+
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+        {
+            state[k][state_ptr] = input[k];
+            state[k][state_ptr + state_size] = input[k];
         }
 
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
@@ -81,6 +151,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -101,6 +178,22 @@ public:
     int getDilationRate() const noexcept { return dilation_rate; }
 
 private:
+    /** Returns true if the layer uses the contiguous fast-path weights. */
+    bool usesFastWeights() const noexcept { return kernel_size == 1 || Layer<T>::in_size == 1 || useSampleRateCorrection; }
+
+    /**
+     * Allocates the fast-path weights, and copies them from the kernel weights.
+     * This is only called from the constructor, setWeights(), and prepare(),
+     * so forward() never allocates.
+     */
+    void updateFastWeights();
+
+    inline void addBias(T* h) const noexcept
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            h[i] += bias[i];
+    }
+
     const int dilation_rate;
     const int kernel_size;
     const int state_size;
@@ -109,6 +202,15 @@ private:
     T* bias;
     T** state;
     int state_ptr = 0;
+
+    // contiguous weights, laid out as fastWeights[out_size][kernel_size][in_size]
+    // (only allocated for the fast paths, and for sample-rate correction)
+    std::vector<T> fastWeights;
+    std::vector<T> taps;
+    dispatch::LayerKernels kernels;
+
+    FractionalDilationDelay<T> tapDelay;
+    bool useSampleRateCorrection = false;
 };
 
 //====================================================
@@ -126,8 +228,10 @@ private:
  * @param out_sizet: the output size for the layer
  * @param kernel_size: the size of the convolution kernel
  * @param dilation_rate: the dilation rate to use for dilated convolution
+ * @param sampleRateCorr: the sample-rate correction mode to use for the convolution kernel
+ * @param maxSampleRateRatio: the largest sample-rate ratio that the layer can be prepared with
  */
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, int maxSampleRateRatio = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class Conv1DT
 {
     static constexpr auto state_size = kernel_size * dilation_rate;
@@ -144,11 +248,23 @@ public:
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
+    /** Prepares the convolution to process at an integer multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+    prepare(int sampleRateRatio);
+
+    /** Prepares the convolution to process at a (possibly fractional) multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+    prepare(T sampleRateRatio);
+
     /** Resets the layer state. */
     void reset();
 
     /** Performs forward propagation for this layer. */
-    inline void forward(const T (&ins)[in_size]) noexcept
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N > 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const T (&ins)[in_size]) noexcept
     {
         // insert input into double-buffered state
         for(int k = 0; k < in_size; ++k)
@@ -167,6 +283,72 @@ public:
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /** Performs forward propagation for this layer (kernel_size == 1). */
+    template <int K = kernel_size>
+    inline typename std::enable_if<K == 1, void>::type
+    forward(const T (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = bias[i] + std::inner_product(ins, ins + in_size, fast_weights[i], (T)0);
+    }
+
+    /** Performs forward propagation for this layer (in_size == 1). */
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N == 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const T (&ins)[in_size]) noexcept
+    {
+        // insert input into double-buffered state
+        state[0][state_ptr] = ins[0];
+        state[0][state_ptr + state_size] = ins[0];
+
+        // gather the non-zero kernel taps, and skip the dilation gaps
+        for(int j = 0; j < kernel_size; ++j)
+            taps[j] = state[0][state_ptr + j * dilation_rate];
+
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = bias[i] + std::inner_product(taps, taps + kernel_size, fast_weights[i], (T)0);
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /** Performs forward propagation for this layer (with sample-rate correction). */
+    template <int K = kernel_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && M != SampleRateCorrectionMode::None), void>::type
+    forward(const T (&ins)[in_size]) noexcept
+    {
+        tap_delay.push(ins);
+        tap_delay.gather(taps);
+
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = bias[i] + std::inner_product(taps, taps + fast_weights_size, fast_weights[i], (T)0);
+    }
+
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const T (&ins)[in_size]) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(sampleRateCorr != SampleRateCorrectionMode::None)
+        {
+            tap_delay.push(ins);
+            return;
+        }
+
+        for(int k = 0; k < in_size; ++k)
+        {
+            state[k][state_ptr] = ins[k];
+            state[k][state_ptr + state_size] = ins[k];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /**
      * Sets the layer weights.
      * 
@@ -174,6 +356,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -195,6 +384,18 @@ private:
 
     T weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][in_size][state_size];
     T bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    // contiguous weights, laid out as fast_weights[out_size][kernel_size][in_size], used for the
+    // kernel_size == 1 and in_size == 1 cases, and for sample-rate correction
+    static constexpr auto fast_weights_size = (kernel_size == 1 || in_size == 1 || sampleRateCorr != SampleRateCorrectionMode::None) ? kernel_size * in_size : 1;
+    T fast_weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][fast_weights_size];
+    T taps alignas(RTNEURAL_DEFAULT_ALIGNMENT)[fast_weights_size];
+
+    // delay line for sample-rate correction (empty when sample-rate correction is disabled)
+    using tap_delay_type = typename std::conditional<sampleRateCorr == SampleRateCorrectionMode::None,
+        delay_detail::NoDilationDelay<T>,
+        FractionalDilationDelayT<T, in_size, kernel_size, dilation_rate, maxSampleRateRatio>>::type;
+    tap_delay_type tap_delay;
 };
 
 } // namespace RTNeural
@@ -3,7 +3,7 @@
 namespace RTNeural
 {
 
-#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_ACCELERATE
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT && !RTNEURAL_USE_ACCELERATE
 
 template <typename T>
 Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation)
@@ -28,6 +28,9 @@ Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation)
     state = new T*[in_size];
     for(int k = 0; k < in_size; ++k)
         state[k] = new T[2 * state_size];
+
+    if(usesFastWeights())
+        updateFastWeights();
 }
 
 template <typename T>
@@ -40,13 +43,33 @@ template <typename T>
 Conv1D<T>::Conv1D(const Conv1D<T>& other)
     : Conv1D<T>(other.in_size, other.out_size, other.kernel_size, other.dilation_rate)
 {
+    *this = other;
 }
 
 template <typename T>
 Conv1D<T>& Conv1D<T>::operator=(const Conv1D<T>& other)
 {
-    if(&other != this)
-        *this = Conv1D<T>(other);
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && Layer<T>::out_size == other.out_size
+        && kernel_size == other.kernel_size && dilation_rate == other.dilation_rate);
+
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            std::copy(other.kernelWeights[i][k], &other.kernelWeights[i][k][state_size], kernelWeights[i][k]);
+
+    std::copy(other.bias, &other.bias[Layer<T>::out_size], bias);
+
+    for(int k = 0; k < Layer<T>::in_size; ++k)
+        std::copy(other.state[k], &other.state[k][2 * state_size], state[k]);
+    state_ptr = other.state_ptr;
+
+    fastWeights = other.fastWeights;
+    taps = other.taps;
+    tapDelay = other.tapDelay;
+    useSampleRateCorrection = other.useSampleRateCorrection;
 
     return *this;
 }
@@ -76,6 +99,21 @@ void Conv1D<T>::reset()
     state_ptr = 0;
     for(int k = 0; k < Layer<T>::in_size; ++k)
         std::fill(state[k], &state[k][2 * state_size], (T)0);
+
+    tapDelay.reset();
+}
+
+template <typename T>
+void Conv1D<T>::prepare(T sampleRateRatio)
+{
+    useSampleRateCorrection = kernel_size > 1 && sampleRateRatio != (T)1;
+    if(useSampleRateCorrection)
+    {
+        tapDelay.prepare(Layer<T>::in_size, kernel_size, dilation_rate, sampleRateRatio);
+        updateFastWeights();
+    }
+
+    reset();
 }
 
 template <typename T>
@@ -85,6 +123,21 @@ void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weigh
         for(int k = 0; k < Layer<T>::in_size; ++k)
             for(int j = 0; j < kernel_size; ++j)
                 kernelWeights[i][k][j * dilation_rate] = weights[i][k][j];
+
+    if(usesFastWeights())
+        updateFastWeights();
+}
+
+template <typename T>
+void Conv1D<T>::setWeights(const WeightsView<T, 3>& weights)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                kernelWeights[i][k][j * dilation_rate] = weights(i, k, j);
+
+    if(usesFastWeights())
+        updateFastWeights();
 }
 
 template <typename T>
@@ -94,35 +147,79 @@ void Conv1D<T>::setBias(const std::vector<T>& biasVals)
         bias[i] = biasVals[i];
 }
 
+template <typename T>
+void Conv1D<T>::updateFastWeights()
+{
+    const auto num_taps = kernel_size * Layer<T>::in_size;
+    fastWeights.resize((size_t)(Layer<T>::out_size * num_taps), (T)0);
+    taps.resize((size_t)num_taps, (T)0);
+
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                fastWeights[(size_t)(i * num_taps + j * Layer<T>::in_size + k)] = kernelWeights[i][k][j * dilation_rate];
+}
+
 //====================================================
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::Conv1DT()
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::Conv1DT()
 {
     for(int i = 0; i < out_size; ++i)
         for(int j = 0; j < in_size; ++j)
             for(int k = 0; k < state_size; ++k)
                 weights[i][j][k] = (T)0.0;
 
+    for(int i = 0; i < out_size; ++i)
+        for(int j = 0; j < fast_weights_size; ++j)
+            fast_weights[i][j] = (T)0.0;
+
+    for(int j = 0; j < fast_weights_size; ++j)
+        taps[j] = (T)0.0;
+
     for(int i = 0; i < out_size; ++i)
         bias[i] = (T)0.0;
 
     for(int i = 0; i < out_size; ++i)
         outs[i] = (T)0.0;
 
+    if(sampleRateCorr != SampleRateCorrectionMode::None)
+        tap_delay.prepare((T)1);
+
+    reset();
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+template <SampleRateCorrectionMode srCorr>
+std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::prepare(int sampleRateRatio)
+{
+    tap_delay.prepare((T)sampleRateRatio);
+    reset();
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+template <SampleRateCorrectionMode srCorr>
+std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::prepare(T sampleRateRatio)
+{
+    tap_delay.prepare(sampleRateRatio);
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::reset()
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::reset()
 {
     state_ptr = 0;
     for(int k = 0; k < in_size; ++k)
         for(int i = 0; i < 2 * state_size; ++i)
             state[k][i] = (T)0.0;
+
+    if(sampleRateCorr != SampleRateCorrectionMode::None)
+        tap_delay.reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -132,10 +229,39 @@ void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::setWeights(con
                 weights[i][k][j * dilation_rate] = ws[i][k][j];
         }
     }
+
+    if(fast_weights_size == kernel_size * in_size)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    fast_weights[i][j * in_size + k] = ws[i][k][j];
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setWeights(const WeightsView<T, 3>& ws)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int j = 0; j < kernel_size; ++j)
+                weights[i][k][j * dilation_rate] = ws(i, k, j);
+        }
+    }
+
+    if(fast_weights_size == kernel_size * in_size)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    fast_weights[i][j * in_size + k] = ws(i, k, j);
+    }
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::setBias(const std::vector<T>& biasVals)
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setBias(const std::vector<T>& biasVals)
 {
     for(int i = 0; i < out_size; ++i)
         bias[i] = biasVals[i];
@@ -17,6 +17,8 @@ public:
     Conv1D(int in_size, int out_size, int kernel_size, int dilation);
     Conv1D(std::initializer_list<int> sizes);
     Conv1D(const Conv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
     Conv1D& operator=(const Conv1D& other);
     virtual ~Conv1D();
 
@@ -41,9 +43,29 @@ public:
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const T* input) noexcept
+    {
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+        {
+            state[k][state_ptr] = input[k];
+            state[k][state_ptr + state_size] = input[k];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /** Sets the layer weights. */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /** Sets the layer weights from a weights view. */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /** Sets the layer biases. */
     void setBias(const std::vector<T>& biasVals);
 
@@ -38,12 +38,30 @@ template <typename T>
 Conv1D<T>::Conv1D(const Conv1D<T>& other)
     : Conv1D<T>(other.in_size, other.out_size, other.kernel_size, other.dilation_rate)
 {
+    *this = other;
 }
 
 template <typename T>
 Conv1D<T>& Conv1D<T>::operator=(const Conv1D<T>& other)
 {
-    return *this = Conv1D<T>(other);
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && Layer<T>::out_size == other.out_size
+        && kernel_size == other.kernel_size && dilation_rate == other.dilation_rate);
+
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            std::copy(other.kernelWeights[i][k], &other.kernelWeights[i][k][state_size], kernelWeights[i][k]);
+
+    std::copy(other.bias, &other.bias[Layer<T>::out_size], bias);
+
+    for(int k = 0; k < Layer<T>::in_size; ++k)
+        std::copy(other.state[k], &other.state[k][2 * state_size], state[k]);
+    state_ptr = other.state_ptr;
+
+    return *this;
 }
 
 template <typename T>
@@ -82,6 +100,15 @@ void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weigh
                 kernelWeights[i][k][j * dilation_rate] = weights[i][k][j];
 }
 
+template <typename T>
+void Conv1D<T>::setWeights(const WeightsView<T, 3>& weights)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                kernelWeights[i][k][j * dilation_rate] = weights(i, k, j);
+}
+
 template <typename T>
 void Conv1D<T>::setBias(const std::vector<T>& biasVals)
 {
@@ -2,6 +2,7 @@
 #define CONV1DEIGEN_H_INCLUDED
 
 #include "../Layer.h"
+#include "../common.h"
 #include <Eigen/Dense>
 
 namespace RTNeural
@@ -32,12 +33,25 @@ public:
     Conv1D(int in_size, int out_size, int kernel_size, int dilation);
     Conv1D(std::initializer_list<int> sizes);
     Conv1D(const Conv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
     Conv1D& operator=(const Conv1D& other);
     virtual ~Conv1D();
 
     /** Resets the layer state. */
     void reset() override;
 
+    /**
+     * Prepares the layer to process data at `sampleRateRatio` times the
+     * sample rate that the layer was trained at. The dilation of the
+     * kernel is scaled by the same ratio, and any kernel taps that fall
+     * between two samples are linearly interpolated.
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(T sampleRateRatio) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
@@ -47,19 +61,75 @@ public:
         inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
             input, Layer<T>::in_size, 1);
 
+        // a kernel of size 1 is a dense layer, so no state is needed
+        if(kernel_size == 1)
+        {
+            outVec.noalias() = fastWeights * inVec + bias;
+            std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
+            return;
+        }
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            tapDelay.gather(taps.data());
+
+            outVec.noalias() = fastWeights * taps + bias;
+            std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
+            return;
+        }
+
         // insert input into double-buffered state
         state.col(state_ptr) = inVec;
         state.col(state_ptr + state_size) = inVec;
 
-        for(int i = 0; i < Layer<T>::out_size; ++i)
-            outVec(i, 0) = state.block(0, state_ptr, Layer<T>::in_size, state_size).cwiseProduct(kernelWeights[i]).sum();
+        if(Layer<T>::in_size == 1)
+        {
+            // gather the non-zero kernel taps, and skip the dilation gaps
+            for(int j = 0; j < kernel_size; ++j)
+                taps(j) = state(0, state_ptr + j * dilation_rate);
+
+            outVec.noalias() = fastWeights * taps + bias;
+        }
+        else
+        {
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+                outVec(i, 0) = state.block(0, state_ptr, Layer<T>::in_size, state_size).cwiseProduct(kernelWeights[i]).sum();
+
+            outVec = outVec + bias;
+        }
 
-        outVec = outVec + bias;
         std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
 
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const T* input) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            return;
+        }
+
+        inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
+            input, Layer<T>::in_size, 1);
+
+        state.col(state_ptr) = inVec;
+        state.col(state_ptr + state_size) = inVec;
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /**
      * Sets the layer weights.
      * 
@@ -67,6 +137,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -81,6 +158,16 @@ public:
     int getDilationRate() const noexcept { return dilation_rate; }
 
 private:
+    /** Returns true if the layer uses the contiguous fast-path weights. */
+    bool usesFastWeights() const noexcept { return kernel_size == 1 || Layer<T>::in_size == 1 || useSampleRateCorrection; }
+
+    /**
+     * Allocates the fast-path weights, and copies them from the kernel weights.
+     * This is only called from the constructor, setWeights(), and prepare(),
+     * so forward() never allocates.
+     */
+    void updateFastWeights();
+
     const int dilation_rate;
     const int kernel_size;
     const int state_size;
@@ -93,6 +180,14 @@ private:
 
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
+
+    // contiguous weights, with columns laid out as [kernel_size][in_size]
+    // (only allocated for the fast paths, and for sample-rate correction)
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> fastWeights;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> taps;
+
+    FractionalDilationDelay<T> tapDelay;
+    bool useSampleRateCorrection = false;
 };
 
 //====================================================
@@ -110,8 +205,10 @@ private:
  * @param out_sizet: the output size for the layer
  * @param kernel_size: the size of the convolution kernel
  * @param dilation_rate: the dilation rate to use for dilated convolution
+ * @param sampleRateCorr: the sample-rate correction mode to use for the convolution kernel
+ * @param maxSampleRateRatio: the largest sample-rate ratio that the layer can be prepared with
  */
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, int maxSampleRateRatio = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class Conv1DT
 {
     using vec_type = Eigen::Matrix<T, out_sizet, 1>;
@@ -121,6 +218,12 @@ class Conv1DT
 
     using weights_type = Eigen::Matrix<T, in_sizet, state_size>;
 
+    // contiguous weights, with columns laid out as [kernel_size][in_size], used for the
+    // kernel_size == 1 and in_size == 1 cases, and for sample-rate correction
+    static constexpr auto fast_weights_size = (kernel_size == 1 || in_sizet == 1 || sampleRateCorr != SampleRateCorrectionMode::None) ? kernel_size * in_sizet : 1;
+    using fast_weights_type = Eigen::Matrix<T, out_sizet, fast_weights_size>;
+    using taps_type = Eigen::Matrix<T, fast_weights_size, 1>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -133,11 +236,23 @@ public:
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
+    /** Prepares the convolution to process at an integer multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+    prepare(int sampleRateRatio);
+
+    /** Prepares the convolution to process at a (possibly fractional) multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+    prepare(T sampleRateRatio);
+
     /** Resets the layer state. */
     void reset();
 
     /** Performs forward propagation for this layer. */
-    inline void forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N > 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
     {
         // insert input into double-buffered state
         state.col(state_ptr) = ins;
@@ -151,6 +266,66 @@ public:
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /** Performs forward propagation for this layer (kernel_size == 1). */
+    template <int K = kernel_size>
+    inline typename std::enable_if<K == 1, void>::type
+    forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
+    {
+        outs.noalias() = fast_weights * ins + bias;
+    }
+
+    /** Performs forward propagation for this layer (in_size == 1). */
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N == 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
+    {
+        // insert input into double-buffered state
+        state(0, state_ptr) = ins(0);
+        state(0, state_ptr + state_size) = ins(0);
+
+        // gather the non-zero kernel taps, and skip the dilation gaps
+        for(int j = 0; j < kernel_size; ++j)
+            taps(j) = state(0, state_ptr + j * dilation_rate);
+
+        outs.noalias() = fast_weights * taps + bias;
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /** Performs forward propagation for this layer (with sample-rate correction). */
+    template <int K = kernel_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && M != SampleRateCorrectionMode::None), void>::type
+    forward(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
+    {
+        tap_delay.push(ins.data());
+        tap_delay.gather(taps.data());
+
+        outs.noalias() = fast_weights * taps + bias;
+    }
+
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const Eigen::Matrix<T, in_size, 1>& ins) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(sampleRateCorr != SampleRateCorrectionMode::None)
+        {
+            tap_delay.push(ins.data());
+            return;
+        }
+
+        state.col(state_ptr) = ins;
+        state.col(state_ptr + state_size) = ins;
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /**
      * Sets the layer weights.
      * 
@@ -158,6 +333,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -181,6 +363,15 @@ private:
 
     weights_type weights[out_size];
     vec_type bias;
+
+    fast_weights_type fast_weights;
+    taps_type taps;
+
+    // delay line for sample-rate correction (empty when sample-rate correction is disabled)
+    using tap_delay_type = typename std::conditional<sampleRateCorr == SampleRateCorrectionMode::None,
+        delay_detail::NoDilationDelay<T>,
+        FractionalDilationDelayT<T, in_size, kernel_size, dilation_rate, maxSampleRateRatio>>::type;
+    tap_delay_type tap_delay;
 };
 
 } // RTNeural
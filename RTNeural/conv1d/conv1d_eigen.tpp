@@ -18,6 +18,9 @@ Conv1D<T>::Conv1D(int in_size, int out_size, int kernel_size, int dilation)
     state = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(in_size, 2 * state_size);
     inVec = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(in_size, 1);
     outVec = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, 1);
+
+    if(usesFastWeights())
+        updateFastWeights();
 }
 
 template <typename T>
@@ -30,12 +33,29 @@ template <typename T>
 Conv1D<T>::Conv1D(const Conv1D<T>& other)
     : Conv1D<T>(other.in_size, other.out_size, other.kernel_size, other.dilation_rate)
 {
+    *this = other;
 }
 
 template <typename T>
 Conv1D<T>& Conv1D<T>::operator=(const Conv1D<T>& other)
 {
-    return *this = Conv1D<T>(other);
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && Layer<T>::out_size == other.out_size
+        && kernel_size == other.kernel_size && dilation_rate == other.dilation_rate);
+
+    kernelWeights = other.kernelWeights;
+    bias = other.bias;
+    state = other.state;
+    state_ptr = other.state_ptr;
+    fastWeights = other.fastWeights;
+    taps = other.taps;
+    tapDelay = other.tapDelay;
+    useSampleRateCorrection = other.useSampleRateCorrection;
+
+    return *this;
 }
 
 template <typename T>
@@ -46,6 +66,20 @@ void Conv1D<T>::reset()
 {
     state_ptr = 0;
     state = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(Layer<T>::in_size, 2 * state_size);
+    tapDelay.reset();
+}
+
+template <typename T>
+void Conv1D<T>::prepare(T sampleRateRatio)
+{
+    useSampleRateCorrection = kernel_size > 1 && sampleRateRatio != (T)1;
+    if(useSampleRateCorrection)
+    {
+        tapDelay.prepare(Layer<T>::in_size, kernel_size, dilation_rate, sampleRateRatio);
+        updateFastWeights();
+    }
+
+    reset();
 }
 
 template <typename T>
@@ -55,6 +89,21 @@ void Conv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weigh
         for(int k = 0; k < Layer<T>::in_size; ++k)
             for(int j = 0; j < kernel_size; ++j)
                 kernelWeights[i](k, j * dilation_rate) = weights[i][k][j];
+
+    if(usesFastWeights())
+        updateFastWeights();
+}
+
+template <typename T>
+void Conv1D<T>::setWeights(const WeightsView<T, 3>& weights)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                kernelWeights[i](k, j * dilation_rate) = weights(i, k, j);
+
+    if(usesFastWeights())
+        updateFastWeights();
 }
 
 template <typename T>
@@ -64,37 +113,104 @@ void Conv1D<T>::setBias(const std::vector<T>& biasVals)
         bias(i, 0) = biasVals[i];
 }
 
+template <typename T>
+void Conv1D<T>::updateFastWeights()
+{
+    const auto num_taps = kernel_size * Layer<T>::in_size;
+    if(fastWeights.rows() != Layer<T>::out_size || fastWeights.cols() != num_taps)
+    {
+        fastWeights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(Layer<T>::out_size, num_taps);
+        taps = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(num_taps);
+    }
+
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                fastWeights(i, j * Layer<T>::in_size + k) = kernelWeights[i](k, j * dilation_rate);
+}
+
 //====================================================
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::Conv1DT()
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::Conv1DT()
     : outs(outs_internal)
 {
     for(int k = 0; k < out_size; ++k)
         weights[k] = weights_type::Zero();
 
     bias = vec_type::Zero();
+    fast_weights = fast_weights_type::Zero();
+    taps = taps_type::Zero();
+
+    if(sampleRateCorr != SampleRateCorrectionMode::None)
+        tap_delay.prepare((T)1);
+
+    reset();
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+template <SampleRateCorrectionMode srCorr>
+std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::prepare(int sampleRateRatio)
+{
+    tap_delay.prepare((T)sampleRateRatio);
+    reset();
+}
 
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+template <SampleRateCorrectionMode srCorr>
+std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::prepare(T sampleRateRatio)
+{
+    tap_delay.prepare(sampleRateRatio);
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::reset()
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::reset()
 {
     state_ptr = 0;
     state = state_type::Zero();
+
+    if(sampleRateCorr != SampleRateCorrectionMode::None)
+        tap_delay.reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
 {
     for(int i = 0; i < out_size; ++i)
         for(int k = 0; k < in_size; ++k)
             for(int j = 0; j < kernel_size; ++j)
                 weights[i](k, j * dilation_rate) = ws[i][k][j];
+
+    if(fast_weights_size == kernel_size * in_size)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    fast_weights(i, j * in_size + k) = ws[i][k][j];
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setWeights(const WeightsView<T, 3>& ws)
+{
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                weights[i](k, j * dilation_rate) = ws(i, k, j);
+
+    if(fast_weights_size == kernel_size * in_size)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    fast_weights(i, j * in_size + k) = ws(i, k, j);
+    }
 }
 
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
-void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>::setBias(const std::vector<T>& biasVals)
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr, int maxSampleRateRatio>
+void Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate, sampleRateCorr, maxSampleRateRatio>::setBias(const std::vector<T>& biasVals)
 {
     for(int i = 0; i < out_size; ++i)
         bias(i) = biasVals[i];
@@ -0,0 +1,295 @@
+#ifndef CONV1DQUANTIZED_H_INCLUDED
+#define CONV1DQUANTIZED_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a 1-dimensional convolution layer
+ * with int8 weights, no activation, and no stride.
+ *
+ * The weights are quantized with one scale per output channel.
+ * Each input frame is quantized to int8 with its own scale when
+ * it enters the layer state, the products for each kernel tap are
+ * accumulated in int32, and the result is dequantized as part of
+ * the bias addition.
+ *
+ * This implementation was designed to be used for "temporal
+ * convolution", so the input to each call to `forward()` should
+ * be one frame of the input signal.
+ */
+template <typename T>
+class QuantizedConv1D final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a quantized convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param out_size: the output size for the layer
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    QuantizedConv1D(int in_size, int out_size, int kernel_size, int dilation)
+        : Layer<T>(in_size, out_size)
+        , kernel_size(kernel_size)
+        , dilation_rate(dilation)
+        , state_size((kernel_size - 1) * dilation + 1)
+        , weights((size_t)(out_size * kernel_size * in_size), (int8_t)0)
+        , scales((size_t)out_size, (T)1)
+        , bias((size_t)out_size, (T)0)
+        , state((size_t)(2 * state_size * in_size), (int8_t)0)
+        , state_scales((size_t)(2 * state_size), (T)0)
+    {
+    }
+
+    QuantizedConv1D(std::initializer_list<int> sizes)
+        : QuantizedConv1D(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+    {
+    }
+
+    /** Resets the layer state. */
+    void reset() override
+    {
+        std::fill(state.begin(), state.end(), (int8_t)0);
+        std::fill(state_scales.begin(), state_scales.end(), (T)0);
+        state_ptr = 0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv1d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+
+        // quantize the new input frame, and insert it into the double-buffered state
+        auto* frame = &state[(size_t)(state_ptr * in_size)];
+        state_scales[(size_t)state_ptr] = quantization_detail::quantizeVector(input, frame, in_size);
+        state_scales[(size_t)(state_ptr + state_size)] = state_scales[(size_t)state_ptr];
+        std::copy(frame, frame + in_size, &state[(size_t)((state_ptr + state_size) * in_size)]);
+
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto* channel_weights = &weights[(size_t)(i * kernel_size * in_size)];
+
+            T sum = (T)0;
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                const auto tap = state_ptr + j * dilation_rate;
+                const auto acc = quantization_detail::dot(channel_weights + j * in_size, &state[(size_t)(tap * in_size)], in_size);
+                sum += (T)acc * state_scales[(size_t)tap];
+            }
+
+            out[i] = bias[(size_t)i] + sum * scales[(size_t)i];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size][kernel_size]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& newWeights)
+    {
+        const auto in_size = Layer<T>::in_size;
+        quantization_detail::quantizeChannels<T>(
+            [&newWeights, in_size](int i, int n) { return newWeights[(size_t)i][(size_t)(n % in_size)][(size_t)(n / in_size)]; },
+            Layer<T>::out_size, kernel_size * in_size, weights.data(), scales.data());
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the (dequantized) weight for a given output, input, and kernel index. */
+    T getWeight(int outIndex, int inIndex, int kernelIndex) const noexcept
+    {
+        const auto in_size = Layer<T>::in_size;
+        return (T)weights[(size_t)((outIndex * kernel_size + kernelIndex) * in_size + inIndex)] * scales[(size_t)outIndex];
+    }
+
+private:
+    const int kernel_size;
+    const int dilation_rate;
+    const int state_size;
+
+    // weights[out_size][kernel_size][in_size], with the most recent input at kernel index 0
+    std::vector<int8_t> weights;
+    std::vector<T> scales;
+    std::vector<T> bias;
+
+    // state[2 * state_size][in_size], with one quantization scale per frame
+    std::vector<int8_t> state;
+    std::vector<T> state_scales;
+    int state_ptr = 0;
+};
+
+//====================================================
+/**
+ * Static implementation of a 1-dimensional convolution layer
+ * with int8 weights, no activation, and no stride.
+ *
+ * See QuantizedConv1D for details about the quantization.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param out_sizet: the output size for the layer
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ */
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+class QuantizedConv1DT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+    static constexpr auto state_size = (kernel_size - 1) * dilation_rate + 1;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    QuantizedConv1DT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), (int8_t)0);
+        std::fill(std::begin(scales), std::end(scales), (T)1);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset()
+    {
+        std::fill(&state[0][0], &state[0][0] + 2 * state_size * in_size, (int8_t)0);
+        std::fill(std::begin(state_scales), std::end(state_scales), (T)0);
+        state_ptr = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        // quantize the new input frame, and insert it into the double-buffered state
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        state_scales[state_ptr] = quantization_detail::quantizeVector(input, state[state_ptr], in_size);
+        state_scales[state_ptr + state_size] = state_scales[state_ptr];
+        std::copy(state[state_ptr], state[state_ptr] + in_size, state[state_ptr + state_size]);
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto* channel_weights = weights + i * kernel_size * in_size;
+
+            T sum = (T)0;
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                const auto tap = state_ptr + j * dilation_rate;
+                sum += (T)quantization_detail::dot(channel_weights + j * in_size, state[tap], in_size) * state_scales[tap];
+            }
+
+            scalar_outs[i] = bias[i] + sum * scales[i];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size][kernel_size]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& newWeights)
+    {
+        quantization_detail::quantizeChannels<T>(
+            [&newWeights](int i, int n) { return newWeights[(size_t)i][(size_t)(n % in_size)][(size_t)(n / in_size)]; },
+            out_size, kernel_size * in_size, weights, scales);
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + out_size, bias);
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // weights[out_size][kernel_size][in_size], with the most recent input at kernel index 0
+    int8_t weights[out_size * kernel_size * in_size];
+    T scales[out_size];
+    T bias[out_size];
+
+    // double-buffered state, with one quantization scale per frame
+    int8_t state[2 * state_size][in_size];
+    T state_scales[2 * state_size];
+    int state_ptr = 0;
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // CONV1DQUANTIZED_H_INCLUDED
@@ -33,18 +33,54 @@ public:
     Conv1D(int in_size, int out_size, int kernel_size, int dilation);
     Conv1D(std::initializer_list<int> sizes);
     Conv1D(const Conv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
     Conv1D& operator=(const Conv1D& other);
     virtual ~Conv1D();
 
     /** Resets the layer state. */
     void reset() override;
 
+    /**
+     * Prepares the layer to process data at `sampleRateRatio` times the
+     * sample rate that the layer was trained at. The dilation of the
+     * kernel is scaled by the same ratio, and any kernel taps that fall
+     * between two samples are linearly interpolated.
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(T sampleRateRatio) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "conv1d"; }
 
     /** Performs forward propagation for this layer. */
     inline void forward(const T* input, T* h) noexcept override
     {
+        // a kernel of size 1 is a dense layer, so no state is needed
+        if(kernel_size == 1)
+        {
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+                h[i] = vMult(input, &fastWeights[i * Layer<T>::in_size], prod_fast.data(), Layer<T>::in_size);
+
+            vAdd(h, bias.data(), h, Layer<T>::out_size);
+            return;
+        }
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            tapDelay.gather(taps.data());
+
+            const auto num_taps = kernel_size * Layer<T>::in_size;
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+                h[i] = vMult(taps.data(), &fastWeights[i * num_taps], prod_fast.data(), num_taps);
+
+            vAdd(h, bias.data(), h, Layer<T>::out_size);
+            return;
+        }
+
         // insert input into double-buffered state
         // @TODO: vectorize this!
         for(int k = 0; k < Layer<T>::in_size; ++k)
@@ -53,11 +89,23 @@ public:
             state[k][state_ptr + state_size] = input[k];
         }
 
-        for(int i = 0; i < Layer<T>::out_size; ++i)
+        if(Layer<T>::in_size == 1)
         {
-            h[i] = (T)0;
-            for(int k = 0; k < Layer<T>::in_size; ++k)
-                h[i] += vMult(&state[k][state_ptr], kernelWeights[i][k].data(), prod_state.data(), state_size);
+            // gather the non-zero kernel taps, and skip the dilation gaps
+            for(int j = 0; j < kernel_size; ++j)
+                taps[j] = state[0][state_ptr + j * dilation_rate];
+
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+                h[i] = vMult(taps.data(), &fastWeights[i * kernel_size], prod_fast.data(), kernel_size);
+        }
+        else
+        {
+            for(int i = 0; i < Layer<T>::out_size; ++i)
+            {
+                h[i] = (T)0;
+                for(int k = 0; k < Layer<T>::in_size; ++k)
+                    h[i] += vMult(&state[k][state_ptr], kernelWeights[i][k].data(), prod_state.data(), state_size);
+            }
         }
 
         vAdd(h, bias.data(), h, Layer<T>::out_size);
@@ -65,6 +113,32 @@ public:
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const T* input) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(useSampleRateCorrection)
+        {
+            tapDelay.push(input);
+            return;
+        }
+
+        for(int k = 0; k < Layer<T>::in_size; ++k)
+        {
+            state[k][state_ptr] = input[k];
+            state[k][state_ptr + state_size] = input[k];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /**
      * Sets the layer weights.
      * 
@@ -72,6 +146,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -86,7 +167,17 @@ public:
     int getDilationRate() const noexcept { return dilation_rate; }
 
 private:
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
+    /** Returns true if the layer uses the contiguous fast-path weights. */
+    bool usesFastWeights() const noexcept { return kernel_size == 1 || Layer<T>::in_size == 1 || useSampleRateCorrection; }
+
+    /**
+     * Allocates the fast-path weights, and copies them from the kernel weights.
+     * This is only called from the constructor, setWeights(), and prepare(),
+     * so forward() never allocates.
+     */
+    void updateFastWeights();
+
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
     using vec2_type = std::vector<vec_type>;
     using vec3_type = std::vector<vec2_type>;
 
@@ -100,6 +191,15 @@ private:
     int state_ptr = 0;
 
     vec_type prod_state;
+
+    // contiguous weights, laid out as fastWeights[out_size][kernel_size][in_size]
+    // (only allocated for the fast paths, and for sample-rate correction)
+    vec_type fastWeights;
+    vec_type taps;
+    vec_type prod_fast;
+
+    FractionalDilationDelay<T> tapDelay;
+    bool useSampleRateCorrection = false;
 };
 
 //====================================================
@@ -117,8 +217,10 @@ private:
  * @param out_sizet: the output size for the layer
  * @param kernel_size: the size of the convolution kernel
  * @param dilation_rate: the dilation rate to use for dilated convolution
+ * @param sampleRateCorr: the sample-rate correction mode to use for the convolution kernel
+ * @param maxSampleRateRatio: the largest sample-rate ratio that the layer can be prepared with
  */
-template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, int maxSampleRateRatio = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class Conv1DT
 {
     using v_type = xsimd::simd_type<T>;
@@ -128,6 +230,10 @@ class Conv1DT
     static constexpr auto state_size = kernel_size * dilation_rate;
     static constexpr auto v_state_size = ceil_div(state_size, v_size);
 
+    // transposed weights, laid out as fast_weights[kernel_size][in_size], used for the
+    // kernel_size == 1 and in_size == 1 cases, and for sample-rate correction
+    static constexpr auto fast_weights_size = (kernel_size == 1 || in_sizet == 1 || sampleRateCorr != SampleRateCorrectionMode::None) ? kernel_size * in_sizet : 1;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -140,11 +246,23 @@ public:
     /** Returns false since convolution is not an activation layer. */
     constexpr bool isActivation() const noexcept { return false; }
 
+    /** Prepares the convolution to process at an integer multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
+    prepare(int sampleRateRatio);
+
+    /** Prepares the convolution to process at a (possibly fractional) multiple of the training sample rate. */
+    template <SampleRateCorrectionMode srCorr = sampleRateCorr>
+    std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
+    prepare(T sampleRateRatio);
+
     /** Resets the layer state. */
     void reset();
 
     /** Performs forward propagation for this layer. */
-    inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N > 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const v_type (&ins)[v_in_size]) noexcept
     {
         // insert input into double-buffered state
         for(int k = 0; k < v_in_size; ++k)
@@ -155,10 +273,13 @@ public:
 
         for(int i = 0; i < v_out_size; ++i)
         {
+            // the last output vector may only be partially filled
+            const auto n_outs = out_size - i * v_size < v_size ? out_size - i * v_size : v_size;
+
             T out_sum alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size] { (T)0 };
             for(int j = 0; j < v_in_size; ++j)
             {
-                for(int k = 0; k < v_size; ++k)
+                for(int k = 0; k < n_outs; ++k)
                 {
                     for(int l = 0; l < state_size; ++l)
                         out_sum[k] += xsimd::reduce_add(state[j][state_ptr + l] * weights[i * v_size + k][j][l]);
@@ -171,6 +292,100 @@ public:
         state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
     }
 
+    /** Performs forward propagation for this layer (kernel_size == 1). */
+    template <int K = kernel_size>
+    inline typename std::enable_if<K == 1, void>::type
+    forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        T scalar_in alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size];
+        for(int k = 0; k < v_in_size; ++k)
+            ins[k].store_aligned(scalar_in + k * v_size);
+
+        for(int i = 0; i < v_out_size; ++i)
+            outs[i] = bias[i];
+
+        for(int k = 0; k < in_size; ++k)
+        {
+            for(int i = 0; i < v_out_size; ++i)
+                outs[i] += scalar_in[k] * fast_weights[k][i];
+        }
+    }
+
+    /** Performs forward propagation for this layer (in_size == 1). */
+    template <int K = kernel_size, int N = in_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && N == 1 && M == SampleRateCorrectionMode::None), void>::type
+    forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        // insert input into double-buffered state
+        state[0][state_ptr] = ins[0];
+        state[0][state_ptr + state_size] = ins[0];
+
+        for(int i = 0; i < v_out_size; ++i)
+            outs[i] = bias[i];
+
+        // only evaluate the non-zero kernel taps, and skip the dilation gaps
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            const auto tap = get_value(state[0][state_ptr + j * dilation_rate], 0);
+            for(int i = 0; i < v_out_size; ++i)
+                outs[i] += tap * fast_weights[j][i];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /** Performs forward propagation for this layer (with sample-rate correction). */
+    template <int K = kernel_size, SampleRateCorrectionMode M = sampleRateCorr>
+    inline typename std::enable_if<(K > 1 && M != SampleRateCorrectionMode::None), void>::type
+    forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        T scalar_in alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size];
+        for(int k = 0; k < v_in_size; ++k)
+            ins[k].store_aligned(scalar_in + k * v_size);
+
+        tap_delay.push(scalar_in);
+        tap_delay.gather(taps);
+
+        for(int i = 0; i < v_out_size; ++i)
+            outs[i] = bias[i];
+
+        for(int j = 0; j < fast_weights_size; ++j)
+        {
+            for(int i = 0; i < v_out_size; ++i)
+                outs[i] += taps[j] * fast_weights[j][i];
+        }
+    }
+
+    /**
+     * Pushes a new input into the layer state, without
+     * computing the layer output. This is useful for
+     * strided convolutions, which only need to compute
+     * an output every few inputs.
+     */
+    inline void skip(const v_type (&ins)[v_in_size]) noexcept
+    {
+        if(kernel_size == 1)
+            return;
+
+        if(sampleRateCorr != SampleRateCorrectionMode::None)
+        {
+            T scalar_in alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size];
+            for(int k = 0; k < v_in_size; ++k)
+                ins[k].store_aligned(scalar_in + k * v_size);
+
+            tap_delay.push(scalar_in);
+            return;
+        }
+
+        for(int k = 0; k < v_in_size; ++k)
+        {
+            state[k][state_ptr] = ins[k];
+            state[k][state_ptr + state_size] = ins[k];
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
     /**
      * Sets the layer weights.
      * 
@@ -178,6 +393,13 @@ public:
      */
     void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][in_size][kernel_size * dilation]
+     */
+    void setWeights(const WeightsView<T, 3>& weights);
+
     /**
      * Sets the layer biases.
      * 
@@ -199,6 +421,15 @@ private:
 
     v_type weights[out_size][v_in_size][state_size];
     v_type bias[v_out_size];
+
+    v_type fast_weights[fast_weights_size][v_out_size];
+    T taps alignas(RTNEURAL_DEFAULT_ALIGNMENT)[fast_weights_size];
+
+    // delay line for sample-rate correction (empty when sample-rate correction is disabled)
+    using tap_delay_type = typename std::conditional<sampleRateCorr == SampleRateCorrectionMode::None,
+        delay_detail::NoDilationDelay<T>,
+        FractionalDilationDelayT<T, in_size, kernel_size, dilation_rate, maxSampleRateRatio>>::type;
+    tap_delay_type tap_delay;
 };
 
 } // namespace RTNeural
@@ -0,0 +1,152 @@
+#ifndef STRIDEDCONV1D_H_INCLUDED
+#define STRIDEDCONV1D_H_INCLUDED
+
+#include "conv1d.h"
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a strided 1-dimensional convolution
+ * layer with no activation.
+ *
+ * The layer state is updated for every input, but the convolution
+ * is only evaluated on every `stride`-th input (starting with the
+ * first input after a reset). For the other inputs, the previous
+ * output is left untouched. When used in a `Model`, the layers
+ * following this one only run when a new output is ready.
+ */
+template <typename T>
+class StridedConv1D final : public Conv1D<T>
+{
+public:
+    /**
+     * Constructs a strided convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param out_size: the output size for the layer
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     * @param stride: the number of inputs to consume for each output
+     */
+    StridedConv1D(int in_size, int out_size, int kernel_size, int dilation, int stride)
+        : Conv1D<T>(in_size, out_size, kernel_size, dilation)
+        , stride(stride)
+    {
+    }
+
+    StridedConv1D(std::initializer_list<int> sizes)
+        : StridedConv1D<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3), *(sizes.begin() + 4))
+    {
+    }
+
+    StridedConv1D(const StridedConv1D& other)
+        : Conv1D<T>(other)
+        , stride(other.stride)
+        , strides_counter(other.strides_counter)
+    {
+    }
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    StridedConv1D& operator=(const StridedConv1D& other)
+    {
+        Conv1D<T>::operator=(other);
+        stride = other.stride;
+        strides_counter = other.strides_counter;
+        return *this;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "strided-conv1d"; }
+
+    /** Resets the layer state. */
+    void reset() override
+    {
+        Conv1D<T>::reset();
+        strides_counter = stride - 1;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        strides_counter = (strides_counter == stride - 1 ? 0 : strides_counter + 1);
+
+        if(strides_counter == 0)
+            Conv1D<T>::forward(input, h);
+        else
+            Conv1D<T>::skip(input);
+    }
+
+    /** Returns the convolution stride. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns the decimation factor of this layer (i.e. the stride). */
+    int getDecimationFactor() const noexcept override { return stride; }
+
+    /** Returns true if the most recent call to `forward()` computed a new output. */
+    bool isOutputReady() const noexcept { return strides_counter == 0; }
+
+private:
+    int stride;
+    int strides_counter = stride - 1;
+};
+
+#if !RTNEURAL_USE_ACCELERATE
+//====================================================
+/**
+ * Static implementation of a strided 1-dimensional convolution
+ * layer with no activation.
+ *
+ * The layer state is updated for every input, but the convolution
+ * is only evaluated on every `stride`-th input (starting with the
+ * first input after a reset). When used in a `ModelT`, the layers
+ * following this one only run when a new output is ready.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param out_sizet: the output size for the layer
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ * @param stride: the number of inputs to consume for each output
+ */
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, int stride>
+class StridedConv1DT : public Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>
+{
+    using conv_type = Conv1DT<T, in_sizet, out_sizet, kernel_size, dilation_rate>;
+
+public:
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "strided-conv1d"; }
+
+    /** Resets the layer state. */
+    void reset()
+    {
+        conv_type::reset();
+        strides_counter = stride - 1;
+    }
+
+    /** Performs forward propagation for this layer. */
+    template <typename InputType>
+    inline void forward(const InputType& ins) noexcept
+    {
+        strides_counter = (strides_counter == stride - 1 ? 0 : strides_counter + 1);
+
+        if(strides_counter == 0)
+            conv_type::forward(ins);
+        else
+            conv_type::skip(ins);
+    }
+
+    /** Returns the convolution stride. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns true if the most recent call to `forward()` computed a new output. */
+    bool isOutputReady() const noexcept { return strides_counter == 0; }
+
+private:
+    int strides_counter = stride - 1;
+};
+#endif
+
+} // namespace RTNeural
+
+#endif // STRIDEDCONV1D_H_INCLUDED
@@ -0,0 +1,141 @@
+#include "conv2d.h"
+
+namespace RTNeural
+{
+
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT
+
+template <typename T>
+Conv2D<T>::Conv2D(int num_filters_in, int num_filters_out, int num_features_in, int kernel_size_time,
+    int kernel_size_feature, int dilation, int stride, bool valid_pad)
+    : Layer<T>(num_filters_in * num_features_in,
+        num_filters_out * conv2d_detail::num_features_out(num_features_in, kernel_size_feature, stride, valid_pad))
+    , num_filters_in(num_filters_in)
+    , num_filters_out(num_filters_out)
+    , num_features_in(num_features_in)
+    , kernel_size_time(kernel_size_time)
+    , kernel_size_feature(kernel_size_feature)
+    , dilation_rate(dilation)
+    , stride(stride)
+    , valid_pad(valid_pad)
+    , num_features_out(conv2d_detail::num_features_out(num_features_in, kernel_size_feature, stride, valid_pad))
+    , pad_left(conv2d_detail::pad_left(num_features_in, kernel_size_feature, stride, valid_pad))
+    , state_size((kernel_size_time - 1) * dilation)
+{
+    kernelWeights = std::vector<std::vector<T>>(kernel_size_time * kernel_size_feature,
+        std::vector<T>(num_filters_out * num_filters_in, (T)0));
+    bias.resize(num_filters_out, (T)0);
+    state.resize(2 * state_size * Layer<T>::in_size, (T)0);
+}
+
+template <typename T>
+Conv2D<T>::Conv2D(std::initializer_list<int> sizes)
+    : Conv2D<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3),
+        *(sizes.begin() + 4), *(sizes.begin() + 5), *(sizes.begin() + 6), *(sizes.begin() + 7) != 0)
+{
+}
+
+template <typename T>
+Conv2D<T>::Conv2D(const Conv2D<T>& other)
+    : Conv2D<T>(other.num_filters_in, other.num_filters_out, other.num_features_in, other.kernel_size_time,
+        other.kernel_size_feature, other.dilation_rate, other.stride, other.valid_pad)
+{
+    *this = other;
+}
+
+template <typename T>
+Conv2D<T>& Conv2D<T>::operator=(const Conv2D<T>& other)
+{
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(num_filters_in == other.num_filters_in && num_filters_out == other.num_filters_out
+        && num_features_in == other.num_features_in && kernel_size_time == other.kernel_size_time
+        && kernel_size_feature == other.kernel_size_feature && dilation_rate == other.dilation_rate
+        && stride == other.stride && valid_pad == other.valid_pad);
+
+    kernelWeights = other.kernelWeights;
+    bias = other.bias;
+    state = other.state;
+    state_ptr = other.state_ptr;
+
+    return *this;
+}
+
+template <typename T>
+void Conv2D<T>::reset()
+{
+    state_ptr = 0;
+    std::fill(state.begin(), state.end(), (T)0);
+}
+
+template <typename T>
+void Conv2D<T>::setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& weights)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < num_filters_in; ++ci)
+            for(int kt = 0; kt < kernel_size_time; ++kt)
+                for(int kf = 0; kf < kernel_size_feature; ++kf)
+                    kernelWeights[kt * kernel_size_feature + kf][co * num_filters_in + ci] = weights[co][ci][kt][kf];
+}
+
+template <typename T>
+void Conv2D<T>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = biasVals[co];
+}
+
+//====================================================
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time, kernel_size_feature, dilation_rate, stride, valid_pad>::Conv2DT()
+{
+    for(int kt = 0; kt < kernel_size_time; ++kt)
+        for(int kf = 0; kf < kernel_size_feature; ++kf)
+            for(int co = 0; co < num_filters_out; ++co)
+                for(int ci = 0; ci < num_filters_in; ++ci)
+                    weights[kt][kf][co][ci] = (T)0.0;
+
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = (T)0.0;
+
+    for(int i = 0; i < out_size; ++i)
+        outs[i] = (T)0.0;
+
+    reset();
+}
+
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+void Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time, kernel_size_feature, dilation_rate, stride, valid_pad>::reset()
+{
+    state_ptr = 0;
+    for(int i = 0; i < state_alloc_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            state[i][k] = (T)0.0;
+}
+
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+void Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time, kernel_size_feature, dilation_rate, stride, valid_pad>::setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& ws)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < num_filters_in; ++ci)
+            for(int kt = 0; kt < kernel_size_time; ++kt)
+                for(int kf = 0; kf < kernel_size_feature; ++kf)
+                    weights[kt][kf][co][ci] = ws[co][ci][kt][kf];
+}
+
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+void Conv2DT<T, num_filters_in_t, num_filters_out_t, num_features_in_t, kernel_size_time, kernel_size_feature, dilation_rate, stride, valid_pad>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = biasVals[co];
+}
+
+#endif
+
+} // namespace RTNeural
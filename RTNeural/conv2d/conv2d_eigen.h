@@ -0,0 +1,326 @@
+#ifndef CONV2DEIGEN_H_INCLUDED
+#define CONV2DEIGEN_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a 2-dimensional convolution layer
+ * with no activation.
+ *
+ * This implementation was designed to be used for time-frequency
+ * models, so the layer convolves across the feature (frequency)
+ * axis of each input frame, and performs a causal "temporal
+ * convolution" across frames. Each input frame has size
+ * `num_features_in * num_filters_in`, laid out as
+ * `frame[feature][filter]`, and each output frame is laid out as
+ * `frame[feature][filter]`, with `num_features_out` features.
+ *
+ * The layer has a "state" made up of past input frames. To ensure
+ * that the state is initialized to zero, please make sure to call
+ * `reset()` before your first call to the `forward()` method.
+ */
+template <typename T>
+class Conv2D : public Layer<T>
+{
+public:
+    /**
+     * Constructs a 2D convolution layer for the given dimensions.
+     *
+     * @param num_filters_in: the number of input filters (channels)
+     * @param num_filters_out: the number of output filters (channels)
+     * @param num_features_in: the number of input features (e.g. frequency bins)
+     * @param kernel_size_time: the size of the convolution kernel along the time axis
+     * @param kernel_size_feature: the size of the convolution kernel along the feature axis
+     * @param dilation: the dilation rate to use along the time axis
+     * @param stride: the stride to use along the feature axis
+     * @param valid_pad: true for "valid" padding along the feature axis, false for "same" padding
+     */
+    Conv2D(int num_filters_in, int num_filters_out, int num_features_in, int kernel_size_time,
+        int kernel_size_feature, int dilation, int stride, bool valid_pad);
+    Conv2D(std::initializer_list<int> sizes);
+    Conv2D(const Conv2D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    Conv2D& operator=(const Conv2D& other);
+    virtual ~Conv2D() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv2d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
+            input, Layer<T>::in_size, 1);
+
+        for(int fo = 0; fo < num_features_out; ++fo)
+            outVec.segment(fo * num_filters_out, num_filters_out) = bias;
+
+        for(int kt = 0; kt < kernel_size_time; ++kt)
+        {
+            if(kt == 0)
+                convolveFrame(inVec, kt);
+            else
+                convolveFrame(state.col(state_ptr + state_size - kt * dilation_rate), kt);
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            state.col(state_ptr) = inVec;
+            state.col(state_ptr + state_size) = inVec;
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+
+        std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size
+     * weights[num_filters_out][num_filters_in][kernel_size_time][kernel_size_feature],
+     * where time index 0 corresponds to the most recent input frame.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of input filters. */
+    int getNumFiltersIn() const noexcept { return num_filters_in; }
+
+    /** Returns the number of output filters. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the number of input features. */
+    int getNumFeaturesIn() const noexcept { return num_features_in; }
+
+    /** Returns the number of output features. */
+    int getNumFeaturesOut() const noexcept { return num_features_out; }
+
+    /** Returns the size of the convolution kernel along the time axis. */
+    int getKernelSizeTime() const noexcept { return kernel_size_time; }
+
+    /** Returns the size of the convolution kernel along the feature axis. */
+    int getKernelSizeFeature() const noexcept { return kernel_size_feature; }
+
+    /** Returns the convolution dilation rate along the time axis. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the convolution stride along the feature axis. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns true if the layer uses "valid" padding along the feature axis. */
+    bool isValidPad() const noexcept { return valid_pad; }
+
+private:
+    /** Convolves a single frame along the feature axis, and accumulates the result into outVec. */
+    template <typename FrameType>
+    inline void convolveFrame(const FrameType& frame, int kt) noexcept
+    {
+        for(int fo = 0; fo < num_features_out; ++fo)
+        {
+            for(int kf = 0; kf < kernel_size_feature; ++kf)
+            {
+                const auto fi = fo * stride + kf - pad_left;
+                if(fi < 0 || fi >= num_features_in)
+                    continue;
+
+                outVec.segment(fo * num_filters_out, num_filters_out).noalias()
+                    += kernelWeights[kt * kernel_size_feature + kf] * frame.segment(fi * num_filters_in, num_filters_in);
+            }
+        }
+    }
+
+    const int num_filters_in;
+    const int num_filters_out;
+    const int num_features_in;
+    const int kernel_size_time;
+    const int kernel_size_feature;
+    const int dilation_rate;
+    const int stride;
+    const bool valid_pad;
+    const int num_features_out;
+    const int pad_left;
+    const int state_size;
+
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> kernelWeights;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> bias;
+
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> state;
+    int state_ptr = 0;
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
+};
+
+//====================================================
+/**
+ * Static implementation of a 2-dimensional convolution layer
+ * with no activation.
+ *
+ * This implementation was designed to be used for time-frequency
+ * models, so the layer convolves across the feature (frequency)
+ * axis of each input frame, and performs a causal "temporal
+ * convolution" across frames. See `Conv2D` for more information.
+ *
+ * To ensure that the state is initialized to zero, please make sure
+ * to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param num_filters_in_t: the number of input filters (channels)
+ * @param num_filters_out_t: the number of output filters (channels)
+ * @param num_features_in_t: the number of input features (e.g. frequency bins)
+ * @param kernel_size_time: the size of the convolution kernel along the time axis
+ * @param kernel_size_feature: the size of the convolution kernel along the feature axis
+ * @param dilation_rate: the dilation rate to use along the time axis
+ * @param stride: the stride to use along the feature axis
+ * @param valid_pad: true for "valid" padding along the feature axis, false for "same" padding
+ */
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+class Conv2DT
+{
+    static constexpr auto state_size = (kernel_size_time - 1) * dilation_rate;
+    static constexpr auto state_alloc_size = state_size > 0 ? 2 * state_size : 1;
+
+public:
+    static constexpr auto num_filters_in = num_filters_in_t;
+    static constexpr auto num_filters_out = num_filters_out_t;
+    static constexpr auto num_features_in = num_features_in_t;
+    static constexpr auto num_features_out = conv2d_detail::num_features_out(num_features_in_t, kernel_size_feature, stride, valid_pad);
+    static constexpr auto pad_left = conv2d_detail::pad_left(num_features_in_t, kernel_size_feature, stride, valid_pad);
+
+    static constexpr auto in_size = num_filters_in * num_features_in;
+    static constexpr auto out_size = num_filters_out * num_features_out;
+
+private:
+    using in_vec_type = Eigen::Matrix<T, in_size, 1>;
+    using out_vec_type = Eigen::Matrix<T, out_size, 1>;
+    using bias_type = Eigen::Matrix<T, num_filters_out, 1>;
+    using state_type = Eigen::Matrix<T, in_size, state_alloc_size>;
+    using weights_type = Eigen::Matrix<T, num_filters_out, num_filters_in>;
+
+public:
+    Conv2DT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv2d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const in_vec_type& ins) noexcept
+    {
+        for(int fo = 0; fo < num_features_out; ++fo)
+            outs.template segment<num_filters_out>(fo * num_filters_out) = bias;
+
+        for(int kt = 0; kt < kernel_size_time; ++kt)
+        {
+            if(kt == 0)
+                convolveFrame(ins, kt);
+            else
+                convolveFrame(state.col(state_ptr + state_size - kt * dilation_rate), kt);
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            state.col(state_ptr) = ins;
+            state.col(state_ptr + state_size) = ins;
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size
+     * weights[num_filters_out][num_filters_in][kernel_size_time][kernel_size_feature],
+     * where time index 0 corresponds to the most recent input frame.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of input filters. */
+    int getNumFiltersIn() const noexcept { return num_filters_in; }
+
+    /** Returns the number of output filters. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the number of input features. */
+    int getNumFeaturesIn() const noexcept { return num_features_in; }
+
+    /** Returns the number of output features. */
+    int getNumFeaturesOut() const noexcept { return num_features_out; }
+
+    /** Returns the size of the convolution kernel along the time axis. */
+    int getKernelSizeTime() const noexcept { return kernel_size_time; }
+
+    /** Returns the size of the convolution kernel along the feature axis. */
+    int getKernelSizeFeature() const noexcept { return kernel_size_feature; }
+
+    /** Returns the convolution dilation rate along the time axis. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the convolution stride along the feature axis. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns true if the layer uses "valid" padding along the feature axis. */
+    bool isValidPad() const noexcept { return valid_pad; }
+
+    Eigen::Map<out_vec_type, RTNeuralEigenAlignment> outs;
+
+private:
+    /** Convolves a single frame along the feature axis, and accumulates the result into outs. */
+    template <typename FrameType>
+    inline void convolveFrame(const FrameType& frame, int kt) noexcept
+    {
+        for(int fo = 0; fo < num_features_out; ++fo)
+        {
+            for(int kf = 0; kf < kernel_size_feature; ++kf)
+            {
+                const auto fi = fo * stride + kf - pad_left;
+                if(fi < 0 || fi >= num_features_in)
+                    continue;
+
+                outs.template segment<num_filters_out>(fo * num_filters_out).noalias()
+                    += weights[kt][kf] * frame.template segment<num_filters_in>(fi * num_filters_in);
+            }
+        }
+    }
+
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    state_type state;
+    int state_ptr = 0;
+
+    weights_type weights[kernel_size_time][kernel_size_feature];
+    bias_type bias;
+};
+
+} // namespace RTNeural
+
+#endif // CONV2DEIGEN_H_INCLUDED
@@ -0,0 +1,336 @@
+#ifndef CONV2DXSIMD_H_INCLUDED
+#define CONV2DXSIMD_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a 2-dimensional convolution layer
+ * with no activation.
+ *
+ * This implementation was designed to be used for time-frequency
+ * models, so the layer convolves across the feature (frequency)
+ * axis of each input frame, and performs a causal "temporal
+ * convolution" across frames. Each input frame has size
+ * `num_features_in * num_filters_in`, laid out as
+ * `frame[feature][filter]`, and each output frame is laid out as
+ * `frame[feature][filter]`, with `num_features_out` features.
+ *
+ * The layer has a "state" made up of past input frames. To ensure
+ * that the state is initialized to zero, please make sure to call
+ * `reset()` before your first call to the `forward()` method.
+ */
+template <typename T>
+class Conv2D : public Layer<T>
+{
+public:
+    /**
+     * Constructs a 2D convolution layer for the given dimensions.
+     *
+     * @param num_filters_in: the number of input filters (channels)
+     * @param num_filters_out: the number of output filters (channels)
+     * @param num_features_in: the number of input features (e.g. frequency bins)
+     * @param kernel_size_time: the size of the convolution kernel along the time axis
+     * @param kernel_size_feature: the size of the convolution kernel along the feature axis
+     * @param dilation: the dilation rate to use along the time axis
+     * @param stride: the stride to use along the feature axis
+     * @param valid_pad: true for "valid" padding along the feature axis, false for "same" padding
+     */
+    Conv2D(int num_filters_in, int num_filters_out, int num_features_in, int kernel_size_time,
+        int kernel_size_feature, int dilation, int stride, bool valid_pad);
+    Conv2D(std::initializer_list<int> sizes);
+    Conv2D(const Conv2D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    Conv2D& operator=(const Conv2D& other);
+    virtual ~Conv2D() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv2d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        for(int fo = 0; fo < num_features_out; ++fo)
+            std::copy(bias.begin(), bias.end(), &h[fo * num_filters_out]);
+
+        for(int kt = 0; kt < kernel_size_time; ++kt)
+        {
+            const auto* x = kt == 0 ? input : &state[(state_ptr + state_size - kt * dilation_rate) * Layer<T>::in_size];
+
+            for(int fo = 0; fo < num_features_out; ++fo)
+            {
+                for(int kf = 0; kf < kernel_size_feature; ++kf)
+                {
+                    const auto fi = fo * stride + kf - pad_left;
+                    if(fi < 0 || fi >= num_features_in)
+                        continue;
+
+                    // copy to aligned memory so the multiply can be vectorized
+                    std::copy(&x[fi * num_filters_in], &x[(fi + 1) * num_filters_in], frame_slice.begin());
+
+                    const auto& w = kernelWeights[kt * kernel_size_feature + kf];
+                    for(int co = 0; co < num_filters_out; ++co)
+                        h[fo * num_filters_out + co] += vMult(frame_slice.data(), w[co].data(), prod_state.data(), num_filters_in);
+                }
+            }
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            std::copy(input, input + Layer<T>::in_size, &state[state_ptr * Layer<T>::in_size]);
+            std::copy(input, input + Layer<T>::in_size, &state[(state_ptr + state_size) * Layer<T>::in_size]);
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size
+     * weights[num_filters_out][num_filters_in][kernel_size_time][kernel_size_feature],
+     * where time index 0 corresponds to the most recent input frame.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of input filters. */
+    int getNumFiltersIn() const noexcept { return num_filters_in; }
+
+    /** Returns the number of output filters. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the number of input features. */
+    int getNumFeaturesIn() const noexcept { return num_features_in; }
+
+    /** Returns the number of output features. */
+    int getNumFeaturesOut() const noexcept { return num_features_out; }
+
+    /** Returns the size of the convolution kernel along the time axis. */
+    int getKernelSizeTime() const noexcept { return kernel_size_time; }
+
+    /** Returns the size of the convolution kernel along the feature axis. */
+    int getKernelSizeFeature() const noexcept { return kernel_size_feature; }
+
+    /** Returns the convolution dilation rate along the time axis. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the convolution stride along the feature axis. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns true if the layer uses "valid" padding along the feature axis. */
+    bool isValidPad() const noexcept { return valid_pad; }
+
+private:
+    const int num_filters_in;
+    const int num_filters_out;
+    const int num_features_in;
+    const int kernel_size_time;
+    const int kernel_size_feature;
+    const int dilation_rate;
+    const int stride;
+    const bool valid_pad;
+    const int num_features_out;
+    const int pad_left;
+    const int state_size;
+
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
+    using vec2_type = std::vector<vec_type>;
+    using vec3_type = std::vector<vec2_type>;
+
+    vec3_type kernelWeights;
+    vec_type bias;
+
+    vec_type state;
+    int state_ptr = 0;
+
+    vec_type frame_slice;
+    vec_type prod_state;
+};
+
+//====================================================
+/**
+ * Static implementation of a 2-dimensional convolution layer
+ * with no activation.
+ *
+ * This implementation was designed to be used for time-frequency
+ * models, so the layer convolves across the feature (frequency)
+ * axis of each input frame, and performs a causal "temporal
+ * convolution" across frames. See `Conv2D` for more information.
+ *
+ * To ensure that the state is initialized to zero, please make sure
+ * to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param num_filters_in_t: the number of input filters (channels)
+ * @param num_filters_out_t: the number of output filters (channels)
+ * @param num_features_in_t: the number of input features (e.g. frequency bins)
+ * @param kernel_size_time: the size of the convolution kernel along the time axis
+ * @param kernel_size_feature: the size of the convolution kernel along the feature axis
+ * @param dilation_rate: the dilation rate to use along the time axis
+ * @param stride: the stride to use along the feature axis
+ * @param valid_pad: true for "valid" padding along the feature axis, false for "same" padding
+ */
+template <typename T, int num_filters_in_t, int num_filters_out_t, int num_features_in_t, int kernel_size_time,
+    int kernel_size_feature, int dilation_rate, int stride, bool valid_pad>
+class Conv2DT
+{
+    static constexpr auto state_size = (kernel_size_time - 1) * dilation_rate;
+    static constexpr auto state_alloc_size = state_size > 0 ? 2 * state_size : 1;
+
+public:
+    static constexpr auto num_filters_in = num_filters_in_t;
+    static constexpr auto num_filters_out = num_filters_out_t;
+    static constexpr auto num_features_in = num_features_in_t;
+    static constexpr auto num_features_out = conv2d_detail::num_features_out(num_features_in_t, kernel_size_feature, stride, valid_pad);
+    static constexpr auto pad_left = conv2d_detail::pad_left(num_features_in_t, kernel_size_feature, stride, valid_pad);
+
+    static constexpr auto in_size = num_filters_in * num_features_in;
+    static constexpr auto out_size = num_filters_out * num_features_out;
+
+private:
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_size, v_size);
+    static constexpr auto v_out_size = ceil_div(out_size, v_size);
+    static constexpr auto v_filters_out_size = ceil_div(num_filters_out, v_size);
+
+public:
+    Conv2DT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv2d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        for(int k = 0; k < v_in_size; ++k)
+            ins[k].store_aligned(&ins_scalar[k * v_size]);
+
+        for(int fo = 0; fo < num_features_out; ++fo)
+            for(int j = 0; j < v_filters_out_size; ++j)
+                acc[fo][j] = bias[j];
+
+        for(int kt = 0; kt < kernel_size_time; ++kt)
+        {
+            const T* x = kt == 0 ? &ins_scalar[0] : &state[state_ptr + state_size - kt * dilation_rate][0];
+
+            for(int fo = 0; fo < num_features_out; ++fo)
+            {
+                for(int kf = 0; kf < kernel_size_feature; ++kf)
+                {
+                    const auto fi = fo * stride + kf - pad_left;
+                    if(fi < 0 || fi >= num_features_in)
+                        continue;
+
+                    // broadcast each input filter across the output filters
+                    for(int ci = 0; ci < num_filters_in; ++ci)
+                    {
+                        const v_type xv((T)x[fi * num_filters_in + ci]);
+                        for(int j = 0; j < v_filters_out_size; ++j)
+                            acc[fo][j] = xsimd::fma(xv, weights[kt][kf][ci][j], acc[fo][j]);
+                    }
+                }
+            }
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            std::copy(ins_scalar, ins_scalar + in_size, state[state_ptr]);
+            std::copy(ins_scalar, ins_scalar + in_size, state[state_ptr + state_size]);
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+
+        // re-pack [feature][filter] outputs into SIMD registers
+        for(int fo = 0; fo < num_features_out; ++fo)
+        {
+            for(int j = 0; j < v_filters_out_size; ++j)
+                acc[fo][j].store_aligned(&acc_scalar[j * v_size]);
+            std::copy(acc_scalar, acc_scalar + num_filters_out, &outs_scalar[fo * num_filters_out]);
+        }
+
+        for(int i = 0; i < v_out_size; ++i)
+            outs[i] = xsimd::load_aligned(&outs_scalar[i * v_size]);
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size
+     * weights[num_filters_out][num_filters_in][kernel_size_time][kernel_size_feature],
+     * where time index 0 corresponds to the most recent input frame.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<std::vector<T>>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of input filters. */
+    int getNumFiltersIn() const noexcept { return num_filters_in; }
+
+    /** Returns the number of output filters. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the number of input features. */
+    int getNumFeaturesIn() const noexcept { return num_features_in; }
+
+    /** Returns the number of output features. */
+    int getNumFeaturesOut() const noexcept { return num_features_out; }
+
+    /** Returns the size of the convolution kernel along the time axis. */
+    int getKernelSizeTime() const noexcept { return kernel_size_time; }
+
+    /** Returns the size of the convolution kernel along the feature axis. */
+    int getKernelSizeFeature() const noexcept { return kernel_size_feature; }
+
+    /** Returns the convolution dilation rate along the time axis. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the convolution stride along the feature axis. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns true if the layer uses "valid" padding along the feature axis. */
+    bool isValidPad() const noexcept { return valid_pad; }
+
+    v_type outs[v_out_size];
+
+private:
+    T ins_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size];
+    T outs_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_out_size * v_size];
+    T acc_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_filters_out_size * v_size];
+    v_type acc[num_features_out][v_filters_out_size];
+
+    T state alignas(RTNEURAL_DEFAULT_ALIGNMENT)[state_alloc_size][in_size];
+    int state_ptr = 0;
+
+    v_type weights[kernel_size_time][kernel_size_feature][num_filters_in][v_filters_out_size];
+    v_type bias[v_filters_out_size];
+};
+
+} // namespace RTNeural
+
+#endif // CONV2DXSIMD_H_INCLUDED
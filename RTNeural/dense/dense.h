@@ -7,55 +7,17 @@
 
 #if RTNEURAL_USE_EIGEN
 #include "dense_eigen.h"
-#elif RTNEURAL_USE_XSIMD
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
 #include "dense_xsimd.h"
 #elif RTNEURAL_USE_ACCELERATE
 #include "dense_accelerate.h"
 #else
 #include "../Layer.h"
+#include "../common.h"
 
 namespace RTNeural
 {
 
-#ifndef DOXYGEN
-/** Single-output dense layer used internally */
-template <typename T>
-class Dense1
-{
-public:
-    explicit Dense1(int in_size)
-        : in_size(in_size)
-    {
-        weights = new T[in_size];
-    }
-
-    ~Dense1() { delete[] weights; }
-
-    inline T forward(const T* input) noexcept
-    {
-        return std::inner_product(weights, weights + in_size, input, (T)0) + bias;
-    }
-
-    void setWeights(const T* newWeights)
-    {
-        for(int i = 0; i < in_size; ++i)
-            weights[i] = newWeights[i];
-    }
-
-    void setBias(T b) { bias = b; }
-
-    T getWeight(int i) const noexcept { return weights[i]; }
-
-    T getBias() const noexcept { return bias; }
-
-private:
-    const int in_size;
-    T bias;
-
-    T* weights;
-};
-#endif // DOXYGEN
-
 /**
  * Dynamic implementation of a fully-connected (dense) layer,
  * with no activation.
@@ -67,10 +29,9 @@ public:
     /** Constructs a dense layer for a given input and output size. */
     Dense(int in_size, int out_size)
         : Layer<T>(in_size, out_size)
+        , weights((size_t)(in_size * out_size), (T)0)
+        , bias((size_t)out_size, (T)0)
     {
-        subLayers = new Dense1<T>*[out_size];
-        for(int i = 0; i < out_size; ++i)
-            subLayers[i] = new Dense1<T>(in_size);
     }
 
     Dense(std::initializer_list<int> sizes)
@@ -88,13 +49,7 @@ public:
         return *this = Dense(other);
     }
 
-    virtual ~Dense()
-    {
-        for(int i = 0; i < Layer<T>::out_size; ++i)
-            delete subLayers[i];
-
-        delete[] subLayers;
-    }
+    virtual ~Dense() = default;
 
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "dense"; }
@@ -102,8 +57,9 @@ public:
     /** Performs forward propagation for this layer. */
     inline void forward(const T* input, T* out) noexcept override
     {
+        kernels.matVec(weights.data(), Layer<T>::out_size, Layer<T>::in_size, input, out);
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            out[i] = subLayers[i]->forward(input);
+            out[i] += bias[(size_t)i];
     }
 
     /**
@@ -115,7 +71,20 @@ public:
     void setWeights(const std::vector<std::vector<T>>& newWeights)
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setWeights(newWeights[i].data());
+            std::copy(newWeights[i].begin(), newWeights[i].begin() + Layer<T>::in_size, &weights[(size_t)(i * Layer<T>::in_size)]);
+    }
+
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[(size_t)(i * Layer<T>::in_size + k)] = newWeights(i, k);
     }
 
     /**
@@ -127,7 +96,7 @@ public:
     void setWeights(T** newWeights)
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setWeights(newWeights[i]);
+            std::copy(newWeights[i], newWeights[i] + Layer<T>::in_size, &weights[(size_t)(i * Layer<T>::in_size)]);
     }
 
     /**
@@ -136,21 +105,22 @@ public:
      */
     void setBias(T* b)
     {
-        for(int i = 0; i < Layer<T>::out_size; ++i)
-            subLayers[i]->setBias(b[i]);
+        std::copy(b, b + Layer<T>::out_size, bias.begin());
     }
 
     /** Returns the weights value at the given indices. */
     T getWeight(int i, int k) const noexcept
     {
-        return subLayers[i]->getWeight(k);
+        return weights[(size_t)(i * Layer<T>::in_size + k)];
     }
 
     /** Returns the bias value at the given index. */
-    T getBias(int i) const noexcept { return subLayers[i]->getBias(); }
+    T getBias(int i) const noexcept { return bias[(size_t)i]; }
 
 private:
-    Dense1<T>** subLayers;
+    std::vector<T> weights; // weights[out_size][in_size]
+    std::vector<T> bias;
+    dispatch::LayerKernels kernels;
 };
 
 //====================================================
@@ -191,8 +161,9 @@ public:
     /** Performs forward propagation for this layer. */
     inline void forward(const T (&ins)[in_size]) noexcept
     {
+        kernels.matVec(weights, out_size, in_size, ins, outs);
         for(int i = 0; i < out_size; ++i)
-            outs[i] = std::inner_product(ins, ins + in_size, &weights[i * in_size], (T)0) + bias[i];
+            outs[i] += bias[i];
     }
 
     /**
@@ -213,6 +184,24 @@ public:
         }
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+            {
+                auto idx = i * in_size + k;
+                weights[idx] = newWeights(i, k);
+            }
+        }
+    }
+
     /**
      * Sets the layer weights from a given vector.
      * 
@@ -246,6 +235,7 @@ public:
 private:
     T bias[out_size];
     T weights[weights_size];
+    dispatch::LayerKernels kernels;
 };
 
 } // namespace RTNeural
@@ -64,6 +64,14 @@ public:
                 weights[i][k] = newWeights[i][k];
     }
 
+    /** Sets the layer weights from a weights view. */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[i][k] = newWeights(i, k);
+    }
+
     /** Sets the layer weights from a given array. */
     void setWeights(T** newWeights)
     {
@@ -69,6 +69,19 @@ public:
                 weights(i, k) = newWeights[i][k];
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights(i, k) = newWeights(i, k);
+    }
+
     /**
      * Sets the layer weights from a given array.
      * 
@@ -157,6 +170,19 @@ public:
                 weights(i, k) = newWeights[i][k];
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights(i, k) = newWeights(i, k);
+    }
+
     /**
      * Sets the layer weights from a given vector.
      * 
@@ -0,0 +1,180 @@
+#ifndef DENSELOWRANK_H_INCLUDED
+#define DENSELOWRANK_H_INCLUDED
+
+#include "dense.h"
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer,
+ * with a low-rank weight matrix and no activation.
+ *
+ * The weight matrix is factorized as W = U * V, where V has
+ * dimensions [rank][in_size], and U has dimensions [out_size][rank],
+ * so the layer computes y = U * (V * x) + b. When the rank is much
+ * smaller than the layer size, this needs far fewer operations than
+ * a full Dense layer. Both products are computed with Dense layers,
+ * so they use the vectorized implementation for the current backend.
+ */
+template <typename T>
+class LowRankDense final : public Layer<T>
+{
+public:
+    /** Constructs a low-rank dense layer for a given input size, output size, and rank. */
+    LowRankDense(int in_size, int out_size, int rank)
+        : Layer<T>(in_size, out_size)
+        , rank(rank)
+        , v_layer(in_size, rank)
+        , u_layer(rank, out_size)
+        , v_outs((size_t)rank, (T)0)
+    {
+        std::vector<T> zeros((size_t)rank, (T)0);
+        v_layer.setBias(zeros.data());
+    }
+
+    LowRankDense(std::initializer_list<int> sizes)
+        : LowRankDense(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2))
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        v_layer.forward(input, v_outs.data());
+        u_layer.forward(v_outs.data(), out);
+    }
+
+    /**
+     * Sets the weights for the first factor of the weight matrix.
+     *
+     * The dimension of the weights vector must be
+     * weights[rank][in_size]
+     */
+    void setVWeights(const std::vector<std::vector<T>>& vWeights)
+    {
+        v_layer.setWeights(vWeights);
+    }
+
+    /**
+     * Sets the weights for the second factor of the weight matrix.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][rank]
+     */
+    void setUWeights(const std::vector<std::vector<T>>& uWeights)
+    {
+        u_layer.setWeights(uWeights);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(T* b)
+    {
+        u_layer.setBias(b);
+    }
+
+    /** Returns the rank of the weight matrix. */
+    int getRank() const noexcept { return rank; }
+
+private:
+    const int rank;
+
+    Dense<T> v_layer;
+    Dense<T> u_layer;
+
+    std::vector<T> v_outs;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * with a low-rank weight matrix and no activation.
+ *
+ * See LowRankDense for details.
+ */
+template <typename T, int in_sizet, int out_sizet, int rankt>
+class LowRankDenseT
+{
+    using v_layer_type = DenseT<T, in_sizet, rankt>;
+    using u_layer_type = DenseT<T, rankt, out_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+    static constexpr auto rank = rankt;
+
+    LowRankDenseT()
+        : outs(u_layer.outs)
+    {
+        T zeros[rank] {};
+        v_layer.setBias(zeros);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    template <typename Inputs>
+    inline void forward(const Inputs& ins) noexcept
+    {
+        v_layer.forward(ins);
+        u_layer.forward(v_layer.outs);
+    }
+
+    /**
+     * Sets the weights for the first factor of the weight matrix.
+     *
+     * The dimension of the weights vector must be
+     * weights[rank][in_size]
+     */
+    void setVWeights(const std::vector<std::vector<T>>& vWeights)
+    {
+        v_layer.setWeights(vWeights);
+    }
+
+    /**
+     * Sets the weights for the second factor of the weight matrix.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][rank]
+     */
+    void setUWeights(const std::vector<std::vector<T>>& uWeights)
+    {
+        u_layer.setWeights(uWeights);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(T* b)
+    {
+        u_layer.setBias(b);
+    }
+
+    /** Returns the rank of the weight matrix. */
+    constexpr int getRank() const noexcept { return rank; }
+
+private:
+    v_layer_type v_layer;
+    u_layer_type u_layer;
+
+public:
+    decltype(u_layer_type::outs)& outs;
+};
+
+} // namespace RTNeural
+
+#endif // DENSELOWRANK_H_INCLUDED
@@ -0,0 +1,231 @@
+#ifndef DENSEQUANTIZED_H_INCLUDED
+#define DENSEQUANTIZED_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer,
+ * with int8 weights and no activation.
+ *
+ * The weights are quantized with one scale per output channel.
+ * On each call to `forward()`, the inputs are quantized to int8
+ * with a single scale, the products are accumulated in int32, and
+ * the result is dequantized as part of the bias addition. This
+ * uses 4x less memory for the weights than Dense<float>, at the
+ * cost of some accuracy (see quantization_detail).
+ */
+template <typename T>
+class QuantizedDense final : public Layer<T>
+{
+public:
+    /** Constructs a quantized dense layer for a given input and output size. */
+    QuantizedDense(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , weights((size_t)(in_size * out_size), (int8_t)0)
+        , scales((size_t)out_size, (T)1)
+        , bias((size_t)out_size, (T)0)
+        , quantized_ins((size_t)in_size, (int8_t)0)
+    {
+    }
+
+    QuantizedDense(std::initializer_list<int> sizes)
+        : QuantizedDense(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto in_scale = quantization_detail::quantizeVector(input, quantized_ins.data(), in_size);
+
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto acc = quantization_detail::dot(&weights[(size_t)(i * in_size)], quantized_ins.data(), in_size);
+            out[i] = bias[(size_t)i] + (T)acc * (scales[(size_t)i] * in_scale);
+        }
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        quantization_detail::quantizeChannels<T>([&newWeights](int i, int k) { return newWeights[(size_t)i][(size_t)k]; },
+            Layer<T>::out_size, Layer<T>::in_size, weights.data(), scales.data());
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        quantization_detail::quantizeChannels<T>([newWeights](int i, int k) { return newWeights[i][k]; },
+            Layer<T>::out_size, Layer<T>::in_size, weights.data(), scales.data());
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the (dequantized) weight connecting input k to output i. */
+    T getWeight(int i, int k) const noexcept
+    {
+        return (T)weights[(size_t)(i * Layer<T>::in_size + k)] * scales[(size_t)i];
+    }
+
+    /** Returns the bias value for output i. */
+    T getBias(int i) const noexcept { return bias[(size_t)i]; }
+
+private:
+    std::vector<int8_t> weights; // weights[out_size][in_size]
+    std::vector<T> scales;
+    std::vector<T> bias;
+
+    std::vector<int8_t> quantized_ins;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * with int8 weights and no activation.
+ *
+ * See QuantizedDense for details about the quantization.
+ */
+template <typename T, int in_sizet, int out_sizet>
+class QuantizedDenseT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    QuantizedDenseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), (int8_t)0);
+        std::fill(std::begin(scales), std::end(scales), (T)1);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        const auto in_scale = quantization_detail::quantizeVector(input, quantized_ins, in_size);
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto acc = quantization_detail::dot(weights + i * in_size, quantized_ins, in_size);
+            scalar_outs[i] = bias[i] + (T)acc * (scales[i] * in_scale);
+        }
+
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        quantization_detail::quantizeChannels<T>([&newWeights](int i, int k) { return newWeights[(size_t)i][(size_t)k]; },
+            out_size, in_size, weights, scales);
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        quantization_detail::quantizeChannels<T>([newWeights](int i, int k) { return newWeights[i][k]; },
+            out_size, in_size, weights, scales);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, bias);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    int8_t weights[out_size * in_size]; // weights[out_size][in_size]
+    T scales[out_size];
+    T bias[out_size];
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+    int8_t quantized_ins[in_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // DENSEQUANTIZED_H_INCLUDED
@@ -0,0 +1,265 @@
+#ifndef DENSESPARSE_H_INCLUDED
+#define DENSESPARSE_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+#include "../sparse/sparse.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer,
+ * with block-sparse weights and no activation.
+ *
+ * The weight matrix is divided into blocks of block_rows x block_cols
+ * weights (1x4 or 4x4 blocks work well), and only the blocks that
+ * contain a non-zero weight are stored and multiplied. This is useful
+ * for pruned networks, where most of the weights are zero.
+ */
+template <typename T, int block_rows = 1, int block_cols = 4>
+class SparseDense final : public Layer<T>
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+public:
+    /** Constructs a sparse dense layer for a given input and output size. */
+    SparseDense(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , num_block_rows(ceil_div(out_size, block_rows))
+        , row_ptr((size_t)(num_block_rows + 1), 0)
+        , bias((size_t)out_size, (T)0)
+        , padded_ins((size_t)(ceil_div(in_size, block_cols) * block_cols), (T)0)
+        , padded_outs((size_t)(num_block_rows * block_rows), (T)0)
+    {
+    }
+
+    SparseDense(std::initializer_list<int> sizes)
+        : SparseDense(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        std::copy(input, input + Layer<T>::in_size, padded_ins.begin());
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr.data(), col_idx.data(), values.data(),
+            num_block_rows, padded_ins.data(), padded_outs.data());
+
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = padded_outs[(size_t)i] + bias[(size_t)i];
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        packWeights([&newWeights](int i, int k) { return newWeights[(size_t)i][(size_t)k]; });
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        packWeights([newWeights](int i, int k) { return newWeights[i][k]; });
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the weight connecting input k to output i. */
+    T getWeight(int i, int k) const noexcept
+    {
+        const auto br = i / block_rows;
+        for(int b = row_ptr[(size_t)br]; b < row_ptr[(size_t)br + 1]; ++b)
+        {
+            if(col_idx[(size_t)b] == k / block_cols)
+                return values[(size_t)((b * block_rows + i % block_rows) * block_cols + k % block_cols)];
+        }
+
+        return (T)0;
+    }
+
+    /** Returns the bias value for output i. */
+    T getBias(int i) const noexcept { return bias[(size_t)i]; }
+
+    /** Returns the number of weight blocks that are stored. */
+    int getNumBlocks() const noexcept { return (int)col_idx.size(); }
+
+private:
+    template <typename WeightFunc>
+    void packWeights(WeightFunc&& getWeight)
+    {
+        const auto numBlocks = sparse_detail::countBlocks<block_rows, block_cols>(getWeight, Layer<T>::out_size, Layer<T>::in_size);
+        col_idx.resize((size_t)numBlocks);
+        values.resize((size_t)(numBlocks * block_rows * block_cols));
+        sparse_detail::packBlocks<T, block_rows, block_cols>(getWeight, Layer<T>::out_size, Layer<T>::in_size,
+            row_ptr.data(), col_idx.data(), values.data());
+    }
+
+    const int num_block_rows;
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<T> values;
+    std::vector<T> bias;
+
+    std::vector<T> padded_ins;
+    std::vector<T> padded_outs;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * with block-sparse weights and no activation.
+ *
+ * The number of non-zero blocks is only known once the weights
+ * are loaded, so the layer has space for every block of the
+ * weight matrix, but only the non-zero blocks are multiplied.
+ *
+ * See SparseDense for details.
+ */
+template <typename T, int in_sizet, int out_sizet, int block_rows = 1, int block_cols = 4>
+class SparseDenseT
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+    static constexpr auto num_block_rows = ceil_div(out_sizet, block_rows);
+    static constexpr auto num_block_cols = ceil_div(in_sizet, block_cols);
+    static constexpr auto max_blocks = num_block_rows * num_block_cols;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    SparseDenseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(row_ptr), std::end(row_ptr), 0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(padded_ins), std::end(padded_ins), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        std::copy(input, input + in_size, padded_ins);
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr, col_idx, values, num_block_rows, padded_ins, scalar_outs);
+
+        for(int i = 0; i < out_size; ++i)
+            scalar_outs[i] += bias[i];
+
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        num_blocks = sparse_detail::packBlocks<T, block_rows, block_cols>([&newWeights](int i, int k) { return newWeights[(size_t)i][(size_t)k]; },
+            out_size, in_size, row_ptr, col_idx, values);
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        num_blocks = sparse_detail::packBlocks<T, block_rows, block_cols>([newWeights](int i, int k) { return newWeights[i][k]; },
+            out_size, in_size, row_ptr, col_idx, values);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, bias);
+    }
+
+    /** Returns the number of non-zero weight blocks. */
+    int getNumBlocks() const noexcept { return num_blocks; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    int row_ptr[num_block_rows + 1];
+    int col_idx[max_blocks];
+    T values alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_blocks * block_rows * block_cols];
+    int num_blocks = 0;
+    T bias[out_size];
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+    T padded_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_block_cols * block_cols];
+
+    // padded to a whole number of blocks, and a whole number of SIMD vectors (for the largest vector size, 16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(ceil_div(out_size, block_rows) * block_rows, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // DENSESPARSE_H_INCLUDED
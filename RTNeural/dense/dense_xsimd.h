@@ -2,7 +2,11 @@
 #define DENSEXSIMD_H_INCLUDED
 
 #include "../Layer.h"
+#if RTNEURAL_USE_VECTOR_EXT
+#include "../vector_ext/vector_ext.h"
+#else
 #include <xsimd/xsimd.hpp>
+#endif
 
 namespace RTNeural
 {
@@ -72,6 +76,19 @@ public:
                 weights[i][k] = newWeights[i][k];
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[i][k] = newWeights(i, k);
+    }
+
     /**
      * Sets the layer weights from a given array.
      * 
@@ -102,7 +119,7 @@ public:
     T getBias(int i) const noexcept { return bias[i]; }
 
 private:
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
     using vec2_type = std::vector<vec_type>;
 
     vec_type bias;
@@ -187,6 +204,23 @@ public:
         }
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     * 
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+            {
+                weights[k][i / v_size] = set_value(weights[k][i / v_size], i % v_size, newWeights(i, k));
+            }
+        }
+    }
+
     /**
      * Sets the layer weights from a given vector.
      * 
@@ -270,6 +304,18 @@ public:
         }
     }
 
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            for(int k = 0; k < in_size; ++k)
+            {
+                auto idx = k / v_size;
+                weights[idx] = set_value(weights[idx], k % v_size, newWeights(i, k));
+            }
+        }
+    }
+
     void setWeights(T** newWeights)
     {
         for(int i = 0; i < out_size; ++i)
@@ -352,6 +398,18 @@ public:
             weights[i / v_size] = set_value(weights[i / v_size], i % v_size, newWeights[i][0]);
     }
 
+    /**
+     * Sets the layer weights from a weights view.
+     *
+     * The dimensions of the weights view must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const WeightsView<T, 2>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            weights[i / v_size] = set_value(weights[i / v_size], i % v_size, newWeights(i, 0));
+    }
+
     /**
      * Sets the layer weights from a given vector.
      *
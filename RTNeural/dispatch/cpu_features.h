@@ -0,0 +1,161 @@
+#pragma once
+
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define RTNEURAL_DISPATCH_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define RTNEURAL_DISPATCH_X86 1
+#else
+#define RTNEURAL_DISPATCH_X86 0
+#endif
+
+namespace RTNeural
+{
+namespace dispatch
+{
+
+    /**
+     * Instruction sets that the library can be compiled for, when
+     * using runtime dispatch. The values are ordered, so that a
+     * "larger" instruction set is preferred over a "smaller" one.
+     *
+     * On non-x86 platforms, only the Baseline instruction set is used.
+     */
+    enum class InstructionSet
+    {
+        Baseline = 0, // SSE2 on x86-64, or the compiler default elsewhere
+        AVX2 = 1, // AVX2 + FMA
+        AVX512 = 2, // AVX-512 F/DQ/VL/BW + AVX2 + FMA
+    };
+
+    /** Returns a readable name for an instruction set. */
+    inline std::string getInstructionSetName(InstructionSet isa)
+    {
+        switch(isa)
+        {
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        case InstructionSet::Baseline:
+        default:
+            return "Baseline";
+        }
+    }
+
+    /** CPU features relevant to the instruction sets above. */
+    struct CPUFeatures
+    {
+        bool sse2 = false;
+        bool avx2 = false;
+        bool fma = false;
+        bool avx512f = false;
+        bool avx512dq = false;
+        bool avx512vl = false;
+        bool avx512bw = false;
+
+        /**
+         * True if the operating system saves the AVX (YMM) and
+         * AVX-512 (ZMM, opmask) register state on context switches.
+         */
+        bool os_avx = false;
+        bool os_avx512 = false;
+    };
+
+#ifndef DOXYGEN
+    namespace cpu_detail
+    {
+#if RTNEURAL_DISPATCH_X86
+        static inline void cpuid(int leaf, int subleaf, unsigned int (&regs)[4]) noexcept
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuidex(info, leaf, subleaf);
+            for(int i = 0; i < 4; ++i)
+                regs[i] = (unsigned int)info[i];
+#else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        static inline unsigned long long xgetbv() noexcept
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            unsigned int eax, edx;
+            __asm__ volatile("xgetbv"
+                             : "=a"(eax), "=d"(edx)
+                             : "c"(0));
+            return ((unsigned long long)edx << 32) | eax;
+#endif
+        }
+#endif // RTNEURAL_DISPATCH_X86
+
+        inline CPUFeatures detect() noexcept
+        {
+            CPUFeatures features;
+
+#if RTNEURAL_DISPATCH_X86
+            unsigned int regs[4] {};
+            cpuid(0, 0, regs);
+            const auto max_leaf = regs[0];
+            if(max_leaf < 1)
+                return features;
+
+            cpuid(1, 0, regs);
+            features.sse2 = (regs[3] & (1u << 26)) != 0;
+            features.fma = (regs[2] & (1u << 12)) != 0;
+
+            const auto osxsave = (regs[2] & (1u << 27)) != 0;
+            if(osxsave)
+            {
+                const auto xcr0 = xgetbv();
+                features.os_avx = (xcr0 & 0x06) == 0x06; // XMM + YMM state
+                features.os_avx512 = features.os_avx && (xcr0 & 0xe0) == 0xe0; // opmask + ZMM state
+            }
+
+            if(max_leaf >= 7)
+            {
+                cpuid(7, 0, regs);
+                features.avx2 = (regs[1] & (1u << 5)) != 0;
+                features.avx512f = (regs[1] & (1u << 16)) != 0;
+                features.avx512dq = (regs[1] & (1u << 17)) != 0;
+                features.avx512bw = (regs[1] & (1u << 30)) != 0;
+                features.avx512vl = (regs[1] & (1u << 31)) != 0;
+            }
+#endif
+
+            return features;
+        }
+    } // namespace cpu_detail
+#endif // DOXYGEN
+
+    /** Returns the features of the CPU that the program is running on (detected once, on the first call). */
+    inline const CPUFeatures& getCPUFeatures() noexcept
+    {
+        static const CPUFeatures features = cpu_detail::detect();
+        return features;
+    }
+
+    /** Returns true if the current CPU (and operating system) can run code compiled for the given instruction set. */
+    inline bool isSupported(InstructionSet isa) noexcept
+    {
+        const auto& f = getCPUFeatures();
+        switch(isa)
+        {
+        case InstructionSet::AVX2:
+            return f.os_avx && f.avx2 && f.fma;
+        case InstructionSet::AVX512:
+            return f.os_avx512 && f.avx2 && f.fma && f.avx512f && f.avx512dq && f.avx512vl && f.avx512bw;
+        case InstructionSet::Baseline:
+        default:
+            return true;
+        }
+    }
+
+} // namespace dispatch
+} // namespace RTNeural
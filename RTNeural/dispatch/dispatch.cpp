@@ -0,0 +1,108 @@
+#include "dispatch_kernels.h"
+#include <atomic>
+
+// The instruction sets compiled in addition to the baseline (see cmake/SIMDDispatch.cmake).
+#ifndef RTNEURAL_DISPATCH_AVX2
+#define RTNEURAL_DISPATCH_AVX2 0
+#endif
+
+#ifndef RTNEURAL_DISPATCH_AVX512
+#define RTNEURAL_DISPATCH_AVX512 0
+#endif
+
+namespace RTNeural
+{
+namespace dispatch
+{
+
+#ifndef DOXYGEN
+// Kernel tables, defined in dispatch_kernels.cpp for each compiled instruction set.
+#define RTNEURAL_DECLARE_DISPATCH_ISA(ns)                \
+    namespace ns                                         \
+    {                                                    \
+        const KernelTable& getKernelTable() noexcept; \
+    }
+
+    RTNEURAL_DECLARE_DISPATCH_ISA(isa_baseline)
+#if RTNEURAL_DISPATCH_AVX2
+    RTNEURAL_DECLARE_DISPATCH_ISA(isa_avx2)
+#endif
+#if RTNEURAL_DISPATCH_AVX512
+    RTNEURAL_DECLARE_DISPATCH_ISA(isa_avx512)
+#endif
+#undef RTNEURAL_DECLARE_DISPATCH_ISA
+
+    namespace
+    {
+        const KernelTable& getKernelTable(InstructionSet isa) noexcept
+        {
+            switch(isa)
+            {
+#if RTNEURAL_DISPATCH_AVX512
+            case InstructionSet::AVX512:
+                return isa_avx512::getKernelTable();
+#endif
+#if RTNEURAL_DISPATCH_AVX2
+            case InstructionSet::AVX2:
+                return isa_avx2::getKernelTable();
+#endif
+            default:
+                return isa_baseline::getKernelTable();
+            }
+        }
+
+        // The kernels in use, which are chosen the first time they are needed.
+        std::atomic<const KernelTable*> activeKernels { nullptr };
+    } // namespace
+#endif // DOXYGEN
+
+    bool isCompiled(InstructionSet isa) noexcept
+    {
+        switch(isa)
+        {
+        case InstructionSet::Baseline:
+            return true;
+        case InstructionSet::AVX2:
+            return RTNEURAL_DISPATCH_AVX2 != 0;
+        case InstructionSet::AVX512:
+            return RTNEURAL_DISPATCH_AVX512 != 0;
+        default:
+            return false;
+        }
+    }
+
+    InstructionSet getBestInstructionSet() noexcept
+    {
+        for(auto isa : { InstructionSet::AVX512, InstructionSet::AVX2 })
+        {
+            if(isCompiled(isa) && isSupported(isa))
+                return isa;
+        }
+
+        return InstructionSet::Baseline;
+    }
+
+    const KernelTable& getKernels() noexcept
+    {
+        const auto* kernels = activeKernels.load(std::memory_order_acquire);
+        if(kernels == nullptr)
+        {
+            // if another thread chose the kernels first, keep its choice
+            const auto* bestKernels = &getKernelTable(getBestInstructionSet());
+            kernels = activeKernels.compare_exchange_strong(kernels, bestKernels, std::memory_order_acq_rel) ? bestKernels : kernels;
+        }
+
+        return *kernels;
+    }
+
+    bool setInstructionSet(InstructionSet isa) noexcept
+    {
+        if(! isCompiled(isa) || ! isSupported(isa))
+            return false;
+
+        activeKernels.store(&getKernelTable(isa), std::memory_order_release);
+        return true;
+    }
+
+} // namespace dispatch
+} // namespace RTNeural
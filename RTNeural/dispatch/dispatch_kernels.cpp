@@ -0,0 +1,98 @@
+/**
+ * This file is compiled once for each instruction set enabled with
+ * RTNEURAL_DISPATCH (see cmake/SIMDDispatch.cmake), with that
+ * instruction set's compiler flags, and the following definitions:
+ * - RTNEURAL_DISPATCH_ISA: the InstructionSet being compiled
+ * - RTNEURAL_DISPATCH_NAMESPACE: a unique namespace for this instruction set
+ *
+ * The kernels are written as plain loops, which the compiler vectorizes
+ * for the instruction set, and have internal linkage, so the copies
+ * compiled for each instruction set can't be merged by the linker. The
+ * only symbol exported from this file is the instruction set's
+ * getKernelTable(), and the kernels must not call any inline functions
+ * from other headers, since those could be shared between instruction sets.
+ *
+ * Every instruction set does the same operations in the same order (the
+ * dot products always keep the same number of partial sums), and the
+ * kernels are compiled with -ffp-contract=off, so that the compiler can't
+ * fuse the multiply-adds on instruction sets with FMA. As a result, all of
+ * the instruction sets give bit-identical results (see dispatch_test.hpp).
+ * The kernels don't assume that their inputs are aligned, so the layers'
+ * buffers only need the baseline's RTNEURAL_DEFAULT_ALIGNMENT.
+ */
+
+#if ! defined(RTNEURAL_DISPATCH_ISA) || ! defined(RTNEURAL_DISPATCH_NAMESPACE)
+#error "This file should only be compiled by the RTNEURAL_DISPATCH build!"
+#endif
+
+#include "dispatch_kernels.h"
+
+namespace RTNeural
+{
+namespace dispatch
+{
+    namespace
+    {
+        // The dot product keeps this many independent partial sums,
+        // so that it can be vectorized without re-ordering the sums.
+        constexpr int numPartialSums = 16;
+
+        template <typename T>
+        inline T dotKernel(const T* a, const T* b, int size)
+        {
+            T partialSums[numPartialSums] {};
+
+            int i = 0;
+            for(; i + numPartialSums <= size; i += numPartialSums)
+            {
+                for(int k = 0; k < numPartialSums; ++k)
+                    partialSums[k] += a[i + k] * b[i + k];
+            }
+
+            T sum = (T)0;
+            for(; i < size; ++i)
+                sum += a[i] * b[i];
+
+            for(int k = 0; k < numPartialSums; ++k)
+                sum += partialSums[k];
+
+            return sum;
+        }
+
+        template <typename T>
+        void matVecKernel(const T* A, int rows, int cols, const T* x, T* __restrict y)
+        {
+            for(int i = 0; i < rows; ++i)
+                y[i] = dotKernel(A + i * cols, x, cols);
+        }
+
+        template <typename T>
+        void multiplyAddColumnsKernel(const T* A, int rows, int cols, const T* x, T* __restrict y)
+        {
+            for(int k = 0; k < cols; ++k)
+            {
+                const T* __restrict aCol = A + k * rows;
+                const T xk = x[k];
+                for(int i = 0; i < rows; ++i)
+                    y[i] += aCol[i] * xk;
+            }
+        }
+
+        const KernelTable kernelTable {
+            RTNEURAL_DISPATCH_ISA,
+            &matVecKernel<float>,
+            &matVecKernel<double>,
+            &multiplyAddColumnsKernel<float>,
+            &multiplyAddColumnsKernel<double>,
+        };
+    } // namespace
+
+    namespace RTNEURAL_DISPATCH_NAMESPACE
+    {
+        const KernelTable& getKernelTable() noexcept
+        {
+            return kernelTable;
+        }
+    } // namespace RTNEURAL_DISPATCH_NAMESPACE
+} // namespace dispatch
+} // namespace RTNeural
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "cpu_features.h"
+
+namespace RTNeural
+{
+namespace dispatch
+{
+
+    /**
+     * The kernels compiled for one of the instruction sets enabled
+     * with RTNEURAL_DISPATCH. Each instruction set's kernels are
+     * compiled in their own translation unit (see dispatch_kernels.cpp),
+     * and the layers call them through this table (see LayerKernels).
+     * Each kernel processes a whole matrix, so a layer makes one
+     * indirect call per matrix product, rather than one per row.
+     */
+    struct KernelTable
+    {
+        /** The instruction set that these kernels were compiled for. */
+        InstructionSet isa;
+
+        /** Computes y = A * x, where A has size [rows][cols], and is stored by row. */
+        void (*matVecFloat)(const float* A, int rows, int cols, const float* x, float* y);
+        void (*matVecDouble)(const double* A, int rows, int cols, const double* x, double* y);
+
+        /** Computes y += A * x, where A has size [rows][cols], and is stored by column (as A[cols][rows]). */
+        void (*multiplyAddColumnsFloat)(const float* A, int rows, int cols, const float* x, float* y);
+        void (*multiplyAddColumnsDouble)(const double* A, int rows, int cols, const double* x, double* y);
+    };
+
+    /** Returns true if the library was compiled with support for the given instruction set. */
+    bool isCompiled(InstructionSet isa) noexcept;
+
+    /** Returns the best instruction set that was compiled, and is supported by the current CPU. */
+    InstructionSet getBestInstructionSet() noexcept;
+
+    /**
+     * Returns the kernels that newly created layers will use. Unless
+     * another instruction set has been chosen with setInstructionSet(),
+     * these are the kernels for getBestInstructionSet().
+     */
+    const KernelTable& getKernels() noexcept;
+
+    /** Returns the instruction set of the kernels that newly created layers will use. */
+    inline InstructionSet getInstructionSet() noexcept { return getKernels().isa; }
+
+    /**
+     * Chooses the instruction set for the library's kernels. Returns
+     * false (and keeps the current kernels) if the instruction set
+     * was not compiled, or is not supported by the current CPU.
+     *
+     * Each layer looks up its kernels once, when it is constructed,
+     * so the new instruction set is only used by models that are
+     * created (or loaded) after this call.
+     */
+    bool setInstructionSet(InstructionSet isa) noexcept;
+
+} // namespace dispatch
+} // namespace RTNeural
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <numeric>
+
+#if RTNEURAL_DISPATCH_ENABLED
+#include "dispatch_kernels.h"
+#endif
+
+namespace RTNeural
+{
+namespace dispatch
+{
+
+    /**
+     * The matrix kernels used by a layer.
+     *
+     * With RTNEURAL_DISPATCH, the kernels for the current instruction set
+     * (see getKernels()) are looked up once, when the layer is constructed,
+     * so every layer of a model keeps using the instruction set that was
+     * chosen when the model was created, and each matrix product is a
+     * single call into the kernels compiled for that instruction set.
+     *
+     * Otherwise, this class is empty, and the kernels are plain loops,
+     * which are inlined into the layer.
+     */
+    class LayerKernels
+    {
+    public:
+#if RTNEURAL_DISPATCH_ENABLED
+        LayerKernels() noexcept
+            : kernels(&getKernels())
+        {
+        }
+
+        /** Returns the instruction set of these kernels. */
+        InstructionSet getInstructionSet() const noexcept { return kernels->isa; }
+
+        void matVec(const float* A, int rows, int cols, const float* x, float* y) const noexcept
+        {
+            kernels->matVecFloat(A, rows, cols, x, y);
+        }
+
+        void matVec(const double* A, int rows, int cols, const double* x, double* y) const noexcept
+        {
+            kernels->matVecDouble(A, rows, cols, x, y);
+        }
+
+        void multiplyAddColumns(const float* A, int rows, int cols, const float* x, float* y) const noexcept
+        {
+            kernels->multiplyAddColumnsFloat(A, rows, cols, x, y);
+        }
+
+        void multiplyAddColumns(const double* A, int rows, int cols, const double* x, double* y) const noexcept
+        {
+            kernels->multiplyAddColumnsDouble(A, rows, cols, x, y);
+        }
+#endif
+
+        /** Computes y = A * x, where A has size [rows][cols], and is stored by row. */
+        template <typename T>
+        void matVec(const T* A, int rows, int cols, const T* x, T* y) const noexcept
+        {
+            for(int i = 0; i < rows; ++i)
+                y[i] = std::inner_product(A + i * cols, A + (i + 1) * cols, x, (T)0);
+        }
+
+        /**
+         * Computes y += A * x, where A has size [rows][cols], and is stored
+         * by column (as A[cols][rows]). Each column is added to all of the
+         * rows at once, so the multiply-adds are element-wise, and there are
+         * no sums that would need to be reordered to use SIMD instructions.
+         */
+        template <typename T>
+        void multiplyAddColumns(const T* A, int rows, int cols, const T* x, T* y) const noexcept
+        {
+            for(int k = 0; k < cols; ++k)
+            {
+                const auto* aCol = A + k * rows;
+                const auto xk = x[k];
+                for(int i = 0; i < rows; ++i)
+                    y[i] += aCol[i] * xk;
+            }
+        }
+
+#if RTNEURAL_DISPATCH_ENABLED
+    private:
+        const KernelTable* kernels;
+#endif
+    };
+
+} // namespace dispatch
+} // namespace RTNeural
@@ -0,0 +1,239 @@
+#ifndef FIXEDPOINT_H_INCLUDED
+#define FIXEDPOINT_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace fixed_point_detail
+{
+    /**
+     * Shifts a value right by `shift` bits, rounding to the nearest
+     * integer (ties round up). Negative shifts are left shifts, and
+     * the caller is responsible for making sure that they don't overflow.
+     *
+     * Note that right shifts of negative values are assumed to be
+     * arithmetic shifts, which is the case for every compiler that
+     * RTNeural supports (and is guaranteed from C++20).
+     */
+    constexpr int64_t roundShift(int64_t x, int shift) noexcept
+    {
+        return shift > 0 ? ((x + ((int64_t)1 << (shift - 1))) >> shift)
+                         : (shift == 0 ? x : x * ((int64_t)1 << -shift));
+    }
+
+    /** Clamps a value to a range. */
+    constexpr int64_t clamp(int64_t x, int64_t low, int64_t high) noexcept
+    {
+        return x < low ? low : (x > high ? high : x);
+    }
+
+    /** Clamps a value to the range of an int32_t. */
+    constexpr int64_t clamp32(int64_t x) noexcept
+    {
+        return clamp(x, (int64_t)std::numeric_limits<int32_t>::min(), (int64_t)std::numeric_limits<int32_t>::max());
+    }
+
+    /** The number of fractional bits used for gate values (the outputs of sigmoid and tanh): Q0.31 */
+    constexpr int gate_frac_bits = 31;
+} // namespace fixed_point_detail
+#endif // DOXYGEN
+
+/**
+ * A signed fixed-point number, stored as a `StorageType` integer
+ * with `FracBits` fractional bits (the Qm.n format, with
+ * m = 8 * sizeof(StorageType) - 1 - FracBits integer bits and
+ * n = FracBits fractional bits).
+ *
+ * All arithmetic is done with integers, and saturates at the
+ * limits of the format instead of wrapping around. Converting
+ * from floating-point rounds to the nearest representable value.
+ *
+ * The format should be chosen so that the largest values in the
+ * network (inputs, weights, and intermediate layer outputs) fit
+ * into the integer bits. For example, Q15 can only represent
+ * values in [-1, 1), while FixedPoint<int16_t, 11> (Q4.11) can
+ * represent values in [-16, 16), with less precision.
+ */
+template <typename StorageType, int FracBits>
+struct FixedPoint
+{
+    static_assert(std::is_integral<StorageType>::value && std::is_signed<StorageType>::value,
+        "FixedPoint storage type must be a signed integer!");
+    static_assert(sizeof(StorageType) <= 4, "FixedPoint supports 8, 16, and 32-bit storage types!");
+
+    using storage_type = StorageType;
+
+    /** Total number of bits, including the sign bit. */
+    static constexpr int total_bits = 8 * (int)sizeof(StorageType);
+
+    /** Number of fractional bits. */
+    static constexpr int frac_bits = FracBits;
+
+    /** Number of integer bits, not including the sign bit. */
+    static constexpr int int_bits = total_bits - 1 - FracBits;
+
+    static_assert(FracBits >= 0 && FracBits < total_bits, "FixedPoint fractional bits must be in [0, total bits)!");
+
+    /**
+     * Products are accumulated in 64-bit integers. For 32-bit storage,
+     * the products are shifted right before they are accumulated,
+     * to leave 16 guard bits for the sum.
+     */
+    static constexpr int accum_shift = (2 * total_bits - 2 - 47) > 0
+        ? ((2 * total_bits - 2 - 47) < FracBits ? (2 * total_bits - 2 - 47) : FracBits)
+        : 0;
+
+    /** Number of fractional bits in an accumulated sum of products. */
+    static constexpr int accum_frac_bits = 2 * FracBits - accum_shift;
+
+    /**
+     * Number of fractional bits for the intermediate values inside
+     * the recurrent layers, which are kept in 32-bit integers, and
+     * are multiplied with the Q0.31 gate values in 64-bit integers.
+     */
+    static constexpr int wide_frac_bits = FracBits < 24 ? FracBits : 24;
+
+    StorageType raw = 0;
+
+    /** Creates a fixed-point number from its raw integer representation. */
+    static constexpr FixedPoint fromRaw(StorageType rawValue) noexcept
+    {
+        FixedPoint x {};
+        x.raw = rawValue;
+        return x;
+    }
+
+    /** Returns the largest representable value. */
+    static constexpr FixedPoint maxValue() noexcept { return fromRaw(std::numeric_limits<StorageType>::max()); }
+
+    /** Returns the smallest representable value. */
+    static constexpr FixedPoint minValue() noexcept { return fromRaw(std::numeric_limits<StorageType>::min()); }
+
+    /** Returns the raw value, saturated to the range of the storage type. */
+    static constexpr StorageType saturate(int64_t rawValue) noexcept
+    {
+        return (StorageType)fixed_point_detail::clamp(rawValue,
+            (int64_t)std::numeric_limits<StorageType>::min(),
+            (int64_t)std::numeric_limits<StorageType>::max());
+    }
+
+    /**
+     * Converts an integer with `fromFracBits` fractional bits to this
+     * format, with rounding and saturation.
+     */
+    static constexpr FixedPoint fromFixed(int64_t value, int fromFracBits) noexcept
+    {
+        return fromFracBits >= FracBits
+            ? fromRaw(saturate(fixed_point_detail::roundShift(value, fromFracBits - FracBits)))
+            // clamp before shifting left, so that the shift can't overflow
+            : fromRaw(saturate(fixed_point_detail::clamp(value,
+                                   (int64_t)std::numeric_limits<StorageType>::min() - 1,
+                                   (int64_t)std::numeric_limits<StorageType>::max() + 1)
+                * ((int64_t)1 << (FracBits - fromFracBits))));
+    }
+
+    /** Converts this number to an integer with `toFracBits` fractional bits (with rounding). */
+    constexpr int64_t toFixed(int toFracBits) const noexcept
+    {
+        return fixed_point_detail::roundShift((int64_t)raw, FracBits - toFracBits);
+    }
+
+    /** Converts a floating-point value to fixed-point, with rounding and saturation. */
+    template <typename T>
+    static FixedPoint fromFloat(T value) noexcept
+    {
+        static_assert(std::is_floating_point<T>::value, "fromFloat requires a floating-point type!");
+        if(std::isnan(value))
+            return {};
+
+        const auto scaled = std::round(std::ldexp((double)value, FracBits));
+        if(scaled >= (double)std::numeric_limits<StorageType>::max())
+            return maxValue();
+        if(scaled <= (double)std::numeric_limits<StorageType>::min())
+            return minValue();
+
+        return fromRaw((StorageType)scaled);
+    }
+
+    /** Converts this number to floating-point. */
+    template <typename T = float>
+    T toFloat() const noexcept
+    {
+        return std::ldexp((T)raw, -FracBits);
+    }
+
+    /** Returns the difference between two adjacent values in this format. */
+    template <typename T = float>
+    static T epsilon() noexcept
+    {
+        return std::ldexp((T)1, -FracBits);
+    }
+
+    constexpr FixedPoint operator+(FixedPoint other) const noexcept { return fromRaw(saturate((int64_t)raw + (int64_t)other.raw)); }
+    constexpr FixedPoint operator-(FixedPoint other) const noexcept { return fromRaw(saturate((int64_t)raw - (int64_t)other.raw)); }
+    constexpr FixedPoint operator-() const noexcept { return fromRaw(saturate(-(int64_t)raw)); }
+    constexpr FixedPoint operator*(FixedPoint other) const noexcept { return fromFixed((int64_t)raw * (int64_t)other.raw, 2 * FracBits); }
+
+    FixedPoint& operator+=(FixedPoint other) noexcept { return *this = *this + other; }
+    FixedPoint& operator-=(FixedPoint other) noexcept { return *this = *this - other; }
+    FixedPoint& operator*=(FixedPoint other) noexcept { return *this = *this * other; }
+
+    constexpr bool operator==(FixedPoint other) const noexcept { return raw == other.raw; }
+    constexpr bool operator!=(FixedPoint other) const noexcept { return raw != other.raw; }
+    constexpr bool operator<(FixedPoint other) const noexcept { return raw < other.raw; }
+    constexpr bool operator>(FixedPoint other) const noexcept { return raw > other.raw; }
+    constexpr bool operator<=(FixedPoint other) const noexcept { return raw <= other.raw; }
+    constexpr bool operator>=(FixedPoint other) const noexcept { return raw >= other.raw; }
+};
+
+/** Q15 fixed-point format: 16-bit, with values in [-1, 1) */
+using Q15 = FixedPoint<int16_t, 15>;
+
+/** Q31 fixed-point format: 32-bit, with values in [-1, 1) */
+using Q31 = FixedPoint<int32_t, 31>;
+
+/**
+ * Accumulates a sum of fixed-point products in a 64-bit integer,
+ * without any intermediate rounding or saturation.
+ */
+template <typename FixedType>
+struct FixedAccumulator
+{
+    static constexpr int frac_bits = FixedType::accum_frac_bits;
+
+    int64_t value = 0;
+
+    /** Adds a fixed-point value to the sum. */
+    inline void add(FixedType x) noexcept
+    {
+        value += (int64_t)x.raw * ((int64_t)1 << (frac_bits - FixedType::frac_bits));
+    }
+
+    /** Adds the product of two fixed-point values to the sum. */
+    inline void mac(FixedType a, FixedType b) noexcept
+    {
+        value += ((int64_t)a.raw * (int64_t)b.raw) >> FixedType::accum_shift;
+    }
+
+    /** Returns the sum, rounded and saturated to the fixed-point format. */
+    inline FixedType get() const noexcept
+    {
+        return FixedType::fromFixed(value, frac_bits);
+    }
+
+    /** Returns the sum with FixedType::wide_frac_bits fractional bits, saturated to 32 bits. */
+    inline int64_t getWide() const noexcept
+    {
+        return fixed_point_detail::clamp32(fixed_point_detail::roundShift(value, frac_bits - FixedType::wide_frac_bits));
+    }
+};
+
+} // namespace RTNeural
+
+#endif // FIXEDPOINT_H_INCLUDED
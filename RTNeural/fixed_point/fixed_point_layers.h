@@ -0,0 +1,493 @@
+#ifndef FIXEDPOINTLAYERS_H_INCLUDED
+#define FIXEDPOINTLAYERS_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "fixed_point.h"
+#include "fixed_point_maths.h"
+
+namespace RTNeural
+{
+
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * using fixed-point arithmetic.
+ *
+ * The weights are given as floating-point values,
+ * and are converted to `FixedType` when they are set.
+ */
+template <typename FixedType, int in_sizet, int out_sizet>
+class FixedDenseT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    FixedDenseT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            FixedAccumulator<FixedType> acc;
+            acc.add(bias[i]);
+            for(int k = 0; k < in_size; ++k)
+                acc.mac(weights[i][k], ins[k]);
+
+            outs[i] = acc.get();
+        }
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size]
+     */
+    template <typename T>
+    void setWeights(const std::vector<std::vector<T>>& newWeights);
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    template <typename T>
+    void setBias(const T* b);
+
+    FixedType outs[out_size];
+
+private:
+    FixedType weights[out_size][in_size];
+    FixedType bias[out_size];
+};
+
+/**
+ * Static implementation of a 1-dimensional convolution layer
+ * with no stride, using fixed-point arithmetic.
+ *
+ * The weights are given as floating-point values,
+ * and are converted to `FixedType` when they are set.
+ */
+template <typename FixedType, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+class FixedConv1DT
+{
+    static constexpr auto state_size = (kernel_size - 1) * dilation_rate + 1;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    FixedConv1DT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        // insert input into double-buffered state
+        for(int k = 0; k < in_size; ++k)
+        {
+            state[state_ptr][k] = ins[k];
+            state[state_ptr + state_size][k] = ins[k];
+        }
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            FixedAccumulator<FixedType> acc;
+            acc.add(bias[i]);
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                const auto& tap = state[state_ptr + j * dilation_rate];
+                for(int k = 0; k < in_size; ++k)
+                    acc.mac(weights[i][j][k], tap[k]);
+            }
+
+            outs[i] = acc.get();
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size][kernel_size]
+     */
+    template <typename T>
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& newWeights);
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    template <typename T>
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    FixedType outs[out_size];
+
+private:
+    FixedType state[2 * state_size][in_size];
+    int state_ptr = 0;
+
+    // weights[out_size][kernel_size][in_size], with the most recent input at kernel index 0
+    FixedType weights[out_size][kernel_size][in_size];
+    FixedType bias[out_size];
+};
+
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer,
+ * using fixed-point arithmetic.
+ *
+ * The gate values are computed in Q0.31, and the intermediate
+ * values are kept with FixedType::wide_frac_bits fractional bits,
+ * so the precision of the layer is mostly determined by the
+ * precision of `FixedType`.
+ *
+ * The weights are given as floating-point values,
+ * and are converted to `FixedType` when they are set.
+ */
+template <typename FixedType, int in_sizet, int out_sizet>
+class FixedGRULayerT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    FixedGRULayerT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        using namespace fixed_point_detail;
+        constexpr auto wide_frac_bits = FixedType::wide_frac_bits;
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto zt = fixed_point_maths::sigmoid(gateSum(ins, Wz[i], Uz[i], bz[i]), wide_frac_bits);
+            const auto rt = fixed_point_maths::sigmoid(gateSum(ins, Wr[i], Ur[i], br[i]), wide_frac_bits);
+
+            FixedAccumulator<FixedType> kernel_acc;
+            kernel_acc.add(bh0[i]);
+            for(int k = 0; k < in_size; ++k)
+                kernel_acc.mac(Wh[i][k], ins[k]);
+
+            FixedAccumulator<FixedType> recurrent_acc;
+            recurrent_acc.add(bh1[i]);
+            for(int k = 0; k < out_size; ++k)
+                recurrent_acc.mac(Uh[i][k], outs[k]);
+
+            const auto ct = clamp32(roundShift(rt * recurrent_acc.getWide(), gate_frac_bits) + kernel_acc.getWide());
+            const auto ht = roundShift(fixed_point_maths::tanh(ct, wide_frac_bits), gate_frac_bits - wide_frac_bits);
+
+            // (1 - zt) * ht + zt * outs = ht + zt * (outs - ht)
+            const auto prev = outs[i].toFixed(wide_frac_bits);
+            next_outs[i] = FixedType::fromFixed(ht + roundShift(zt * clamp32(prev - ht), gate_frac_bits), wide_frac_bits);
+        }
+
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = next_outs[i];
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    template <typename T>
+    void setWVals(const std::vector<std::vector<T>>& wVals);
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    template <typename T>
+    void setUVals(const std::vector<std::vector<T>>& uVals);
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    template <typename T>
+    void setBVals(const std::vector<std::vector<T>>& bVals);
+
+    FixedType outs[out_size];
+
+private:
+    /** Returns W * ins + U * outs + b, with FixedType::wide_frac_bits fractional bits */
+    inline int64_t gateSum(const FixedType (&ins)[in_size], const FixedType (&W)[in_size],
+        const FixedType (&U)[out_size], FixedType b) const noexcept
+    {
+        FixedAccumulator<FixedType> acc;
+        acc.add(b);
+        for(int k = 0; k < in_size; ++k)
+            acc.mac(W[k], ins[k]);
+        for(int k = 0; k < out_size; ++k)
+            acc.mac(U[k], outs[k]);
+
+        return acc.getWide();
+    }
+
+    // kernel weights
+    FixedType Wz[out_size][in_size];
+    FixedType Wr[out_size][in_size];
+    FixedType Wh[out_size][in_size];
+
+    // recurrent weights
+    FixedType Uz[out_size][out_size];
+    FixedType Ur[out_size][out_size];
+    FixedType Uh[out_size][out_size];
+
+    // biases
+    FixedType bz[out_size];
+    FixedType br[out_size];
+    FixedType bh0[out_size];
+    FixedType bh1[out_size];
+
+    FixedType next_outs[out_size];
+};
+
+/**
+ * Static implementation of a long short-term memory (LSTM) layer,
+ * using fixed-point arithmetic.
+ *
+ * The gate values are computed in Q0.31, and the cell state is
+ * kept in 32-bit integers with FixedType::wide_frac_bits fractional
+ * bits, so the cell state can grow beyond the range of `FixedType`.
+ *
+ * The weights are given as floating-point values,
+ * and are converted to `FixedType` when they are set.
+ */
+template <typename FixedType, int in_sizet, int out_sizet>
+class FixedLSTMLayerT
+{
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    FixedLSTMLayerT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        using namespace fixed_point_detail;
+        constexpr auto wide_frac_bits = FixedType::wide_frac_bits;
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto ft = fixed_point_maths::sigmoid(gateSum(ins, Wf[i], Uf[i], bf[i]), wide_frac_bits);
+            const auto it = fixed_point_maths::sigmoid(gateSum(ins, Wi[i], Ui[i], bi[i]), wide_frac_bits);
+            const auto ot = fixed_point_maths::sigmoid(gateSum(ins, Wo[i], Uo[i], bo[i]), wide_frac_bits);
+            const auto gt = fixed_point_maths::tanh(gateSum(ins, Wc[i], Uc[i], bc[i]), wide_frac_bits);
+
+            // ct = ft * ct + it * gt
+            ct[i] = (int32_t)clamp32(roundShift(ft * ct[i], gate_frac_bits)
+                + roundShift(it * gt, 2 * gate_frac_bits - wide_frac_bits));
+
+            // outs = ot * tanh(ct)
+            const auto out = roundShift(ot * fixed_point_maths::tanh(ct[i], wide_frac_bits), gate_frac_bits);
+            next_outs[i] = FixedType::fromFixed(out, gate_frac_bits);
+        }
+
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = next_outs[i];
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    template <typename T>
+    void setWVals(const std::vector<std::vector<T>>& wVals);
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    template <typename T>
+    void setUVals(const std::vector<std::vector<T>>& uVals);
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    template <typename T>
+    void setBVals(const std::vector<T>& bVals);
+
+    FixedType outs[out_size];
+
+private:
+    /** Returns W * ins + U * outs + b, with FixedType::wide_frac_bits fractional bits */
+    inline int64_t gateSum(const FixedType (&ins)[in_size], const FixedType (&W)[in_size],
+        const FixedType (&U)[out_size], FixedType b) const noexcept
+    {
+        FixedAccumulator<FixedType> acc;
+        acc.add(b);
+        for(int k = 0; k < in_size; ++k)
+            acc.mac(W[k], ins[k]);
+        for(int k = 0; k < out_size; ++k)
+            acc.mac(U[k], outs[k]);
+
+        return acc.getWide();
+    }
+
+    // kernel weights
+    FixedType Wi[out_size][in_size];
+    FixedType Wf[out_size][in_size];
+    FixedType Wc[out_size][in_size];
+    FixedType Wo[out_size][in_size];
+
+    // recurrent weights
+    FixedType Ui[out_size][out_size];
+    FixedType Uf[out_size][out_size];
+    FixedType Uc[out_size][out_size];
+    FixedType Uo[out_size][out_size];
+
+    // biases
+    FixedType bi[out_size];
+    FixedType bf[out_size];
+    FixedType bc[out_size];
+    FixedType bo[out_size];
+
+    // cell state, with FixedType::wide_frac_bits fractional bits
+    int32_t ct[out_size];
+
+    FixedType next_outs[out_size];
+};
+
+/** Static implementation of a tanh activation layer, using fixed-point arithmetic. */
+template <typename FixedType, int sizet>
+class FixedTanhActivationT
+{
+public:
+    static constexpr auto in_size = sizet;
+    static constexpr auto out_size = sizet;
+
+    FixedTanhActivationT() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "tanh"; }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for tanh activation. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = FixedType::fromFixed(fixed_point_maths::tanh(ins[i].raw, FixedType::frac_bits), fixed_point_detail::gate_frac_bits);
+    }
+
+    FixedType outs[out_size] {};
+};
+
+/** Static implementation of a sigmoid activation layer, using fixed-point arithmetic. */
+template <typename FixedType, int sizet>
+class FixedSigmoidActivationT
+{
+public:
+    static constexpr auto in_size = sizet;
+    static constexpr auto out_size = sizet;
+
+    FixedSigmoidActivationT() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "sigmoid"; }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for sigmoid activation. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = FixedType::fromFixed(fixed_point_maths::sigmoid(ins[i].raw, FixedType::frac_bits), fixed_point_detail::gate_frac_bits);
+    }
+
+    FixedType outs[out_size] {};
+};
+
+/** Static implementation of a ReLU activation layer, using fixed-point arithmetic. */
+template <typename FixedType, int sizet>
+class FixedReLuActivationT
+{
+public:
+    static constexpr auto in_size = sizet;
+    static constexpr auto out_size = sizet;
+
+    FixedReLuActivationT() = default;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "relu"; }
+
+    /** Returns true since this layer is an activation layer. */
+    constexpr bool isActivation() const noexcept { return true; }
+
+    void reset() { }
+
+    /** Performs forward propagation for ReLU activation. */
+    inline void forward(const FixedType (&ins)[in_size]) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = ins[i].raw > 0 ? ins[i] : FixedType {};
+    }
+
+    FixedType outs[out_size] {};
+};
+
+} // namespace RTNeural
+
+#include "fixed_point_layers.tpp"
+
+#endif // FIXEDPOINTLAYERS_H_INCLUDED
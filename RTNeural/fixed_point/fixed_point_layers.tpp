@@ -0,0 +1,250 @@
+namespace RTNeural
+{
+
+//====================================================
+template <typename FixedType, int in_sizet, int out_sizet>
+FixedDenseT<FixedType, in_sizet, out_sizet>::FixedDenseT()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+            weights[i][k] = FixedType {};
+
+        bias[i] = FixedType {};
+        outs[i] = FixedType {};
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedDenseT<FixedType, in_sizet, out_sizet>::setWeights(const std::vector<std::vector<T>>& newWeights)
+{
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            weights[i][k] = FixedType::fromFloat(newWeights[i][k]);
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedDenseT<FixedType, in_sizet, out_sizet>::setBias(const T* b)
+{
+    for(int i = 0; i < out_size; ++i)
+        bias[i] = FixedType::fromFloat(b[i]);
+}
+
+//====================================================
+template <typename FixedType, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+FixedConv1DT<FixedType, in_sizet, out_sizet, kernel_size, dilation_rate>::FixedConv1DT()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int j = 0; j < kernel_size; ++j)
+            for(int k = 0; k < in_size; ++k)
+                weights[i][j][k] = FixedType {};
+
+        bias[i] = FixedType {};
+        outs[i] = FixedType {};
+    }
+
+    reset();
+}
+
+template <typename FixedType, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+void FixedConv1DT<FixedType, in_sizet, out_sizet, kernel_size, dilation_rate>::reset()
+{
+    state_ptr = 0;
+    for(int i = 0; i < 2 * state_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            state[i][k] = FixedType {};
+}
+
+template <typename FixedType, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+template <typename T>
+void FixedConv1DT<FixedType, in_sizet, out_sizet, kernel_size, dilation_rate>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+{
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                weights[i][j][k] = FixedType::fromFloat(ws[i][k][j]);
+}
+
+template <typename FixedType, int in_sizet, int out_sizet, int kernel_size, int dilation_rate>
+template <typename T>
+void FixedConv1DT<FixedType, in_sizet, out_sizet, kernel_size, dilation_rate>::setBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < out_size; ++i)
+        bias[i] = FixedType::fromFloat(biasVals[i]);
+}
+
+//====================================================
+template <typename FixedType, int in_sizet, int out_sizet>
+FixedGRULayerT<FixedType, in_sizet, out_sizet>::FixedGRULayerT()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            Wz[i][k] = FixedType {};
+            Wr[i][k] = FixedType {};
+            Wh[i][k] = FixedType {};
+        }
+
+        for(int k = 0; k < out_size; ++k)
+        {
+            Uz[i][k] = FixedType {};
+            Ur[i][k] = FixedType {};
+            Uh[i][k] = FixedType {};
+        }
+
+        bz[i] = FixedType {};
+        br[i] = FixedType {};
+        bh0[i] = FixedType {};
+        bh1[i] = FixedType {};
+    }
+
+    reset();
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+void FixedGRULayerT<FixedType, in_sizet, out_sizet>::reset()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        outs[i] = FixedType {};
+        next_outs[i] = FixedType {};
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedGRULayerT<FixedType, in_sizet, out_sizet>::setWVals(const std::vector<std::vector<T>>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Wz[j][i] = FixedType::fromFloat(wVals[i][j]);
+            Wr[j][i] = FixedType::fromFloat(wVals[i][j + out_size]);
+            Wh[j][i] = FixedType::fromFloat(wVals[i][j + 2 * out_size]);
+        }
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedGRULayerT<FixedType, in_sizet, out_sizet>::setUVals(const std::vector<std::vector<T>>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Uz[j][i] = FixedType::fromFloat(uVals[i][j]);
+            Ur[j][i] = FixedType::fromFloat(uVals[i][j + out_size]);
+            Uh[j][i] = FixedType::fromFloat(uVals[i][j + 2 * out_size]);
+        }
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedGRULayerT<FixedType, in_sizet, out_sizet>::setBVals(const std::vector<std::vector<T>>& bVals)
+{
+    // the input and recurrent biases are summed before
+    // the conversion, to avoid rounding them twice
+    for(int k = 0; k < out_size; ++k)
+    {
+        bz[k] = FixedType::fromFloat(bVals[0][k] + bVals[1][k]);
+        br[k] = FixedType::fromFloat(bVals[0][k + out_size] + bVals[1][k + out_size]);
+        bh0[k] = FixedType::fromFloat(bVals[0][k + 2 * out_size]);
+        bh1[k] = FixedType::fromFloat(bVals[1][k + 2 * out_size]);
+    }
+}
+
+//====================================================
+template <typename FixedType, int in_sizet, int out_sizet>
+FixedLSTMLayerT<FixedType, in_sizet, out_sizet>::FixedLSTMLayerT()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            Wi[i][k] = FixedType {};
+            Wf[i][k] = FixedType {};
+            Wc[i][k] = FixedType {};
+            Wo[i][k] = FixedType {};
+        }
+
+        for(int k = 0; k < out_size; ++k)
+        {
+            Ui[i][k] = FixedType {};
+            Uf[i][k] = FixedType {};
+            Uc[i][k] = FixedType {};
+            Uo[i][k] = FixedType {};
+        }
+
+        bi[i] = FixedType {};
+        bf[i] = FixedType {};
+        bc[i] = FixedType {};
+        bo[i] = FixedType {};
+    }
+
+    reset();
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+void FixedLSTMLayerT<FixedType, in_sizet, out_sizet>::reset()
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        outs[i] = FixedType {};
+        next_outs[i] = FixedType {};
+        ct[i] = 0;
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedLSTMLayerT<FixedType, in_sizet, out_sizet>::setWVals(const std::vector<std::vector<T>>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Wi[j][i] = FixedType::fromFloat(wVals[i][j]);
+            Wf[j][i] = FixedType::fromFloat(wVals[i][j + out_size]);
+            Wc[j][i] = FixedType::fromFloat(wVals[i][j + 2 * out_size]);
+            Wo[j][i] = FixedType::fromFloat(wVals[i][j + 3 * out_size]);
+        }
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedLSTMLayerT<FixedType, in_sizet, out_sizet>::setUVals(const std::vector<std::vector<T>>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Ui[j][i] = FixedType::fromFloat(uVals[i][j]);
+            Uf[j][i] = FixedType::fromFloat(uVals[i][j + out_size]);
+            Uc[j][i] = FixedType::fromFloat(uVals[i][j + 2 * out_size]);
+            Uo[j][i] = FixedType::fromFloat(uVals[i][j + 3 * out_size]);
+        }
+    }
+}
+
+template <typename FixedType, int in_sizet, int out_sizet>
+template <typename T>
+void FixedLSTMLayerT<FixedType, in_sizet, out_sizet>::setBVals(const std::vector<T>& bVals)
+{
+    for(int k = 0; k < out_size; ++k)
+    {
+        bi[k] = FixedType::fromFloat(bVals[k]);
+        bf[k] = FixedType::fromFloat(bVals[k + out_size]);
+        bc[k] = FixedType::fromFloat(bVals[k + 2 * out_size]);
+        bo[k] = FixedType::fromFloat(bVals[k + 3 * out_size]);
+    }
+}
+
+} // namespace RTNeural
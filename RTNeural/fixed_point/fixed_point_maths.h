@@ -0,0 +1,208 @@
+#ifndef FIXEDPOINTMATHS_H_INCLUDED
+#define FIXEDPOINTMATHS_H_INCLUDED
+
+#include "fixed_point.h"
+
+namespace RTNeural
+{
+
+/**
+ * Fixed-point sigmoid and tanh approximations.
+ *
+ * The inputs are 64-bit integers with a given number of fractional
+ * bits (up to 31), and the outputs are Q0.31 values, stored in 64-bit
+ * integers. Both functions are computed from a table of sigmoid values
+ * over [0, 16], with 64 entries per unit and linear interpolation,
+ * using only integer arithmetic, so the results are bit-exact on
+ * every platform.
+ *
+ * The maximum approximation error is about 2.9e-6 for sigmoid,
+ * and 5.9e-6 for tanh.
+ */
+namespace fixed_point_maths
+{
+#ifndef DOXYGEN
+    namespace detail
+    {
+        constexpr int table_steps_log2 = 6; // 64 table entries per unit
+        constexpr int64_t table_max_index = 1024; // table covers [0, 16]
+
+        /**
+         * round(2^31 * sigmoid(i / 64)), for i in [0, 1024]
+         * Generated with: [round(2**31 / (1 + math.exp(-i / 64))) for i in range(1025)]
+         */
+        inline const int32_t* getSigmoidTable() noexcept
+        {
+            static constexpr int32_t table[] = {
+            1073741824, 1082130261, 1090517675, 1098903041, 1107285338, 1115663544, 1124036640, 1132403611,
+            1140763443, 1149115126, 1157457653, 1165790024, 1174111241, 1182420314, 1190716257, 1198998091,
+            1207264843, 1215515549, 1223749251, 1231964999, 1240161854, 1248338882, 1256495161, 1264629779,
+            1272741832, 1280830429, 1288894687, 1296933737, 1304946721, 1312932790, 1320891112, 1328820863,
+            1336721235, 1344591432, 1352430671, 1360238184, 1368013214, 1375755023, 1383462882, 1391136080,
+            1398773921, 1406375722, 1413940816, 1421468552, 1428958294, 1436409422, 1443821330, 1451193431,
+            1458525151, 1465815933, 1473065238, 1480272541, 1487437333, 1494559123, 1501637435, 1508671810,
+            1515661806, 1522606996, 1529506969, 1536361332, 1543169708, 1549931734, 1556647065, 1563315373,
+            1569936343, 1576509680, 1583035100, 1589512339, 1595941146, 1602321287, 1608652541, 1614934705,
+            1621167590, 1627351021, 1633484838, 1639568898, 1645603068, 1651587233, 1657521290, 1663405152,
+            1669238741, 1675021999, 1680754875, 1686437336, 1692069358, 1697650933, 1703182061, 1708662759,
+            1714093053, 1719472982, 1724802594, 1730081952, 1735311128, 1740490203, 1745619273, 1750698440,
+            1755727819, 1760707532, 1765637713, 1770518505, 1775350059, 1780132536, 1784866104, 1789550942,
+            1794187234, 1798775174, 1803314964, 1807806812, 1812250933, 1816647551, 1820996895, 1825299201,
+            1829554711, 1833763674, 1837926343, 1842042979, 1846113847, 1850139217, 1854119364, 1858054569,
+            1861945116, 1865791295, 1869593398, 1873351722, 1877066570, 1880738244, 1884367053, 1887953307,
+            1891497322, 1894999414, 1898459902, 1901879108, 1905257357, 1908594976, 1911892293, 1915149637,
+            1918367342, 1921545741, 1924685168, 1927785961, 1930848455, 1933872990, 1936859905, 1939809538,
+            1942722231, 1945598325, 1948438159, 1951242076, 1954010417, 1956743522, 1959441734, 1962105394,
+            1964734840, 1967330415, 1969892457, 1972421305, 1974917298, 1977380772, 1979812065, 1982211512,
+            1984579447, 1986916203, 1989222114, 1991497509, 1993742718, 1995958069, 1998143889, 2000300502,
+            2002428233, 2004527403, 2006598332, 2008641339, 2010656740, 2012644849, 2014605980, 2016540444,
+            2018448549, 2020330603, 2022186909, 2024017772, 2025823491, 2027604365, 2029360691, 2031092762,
+            2032800871, 2034485306, 2036146356, 2037784306, 2039399438, 2040992032, 2042562367, 2044110719,
+            2045637361, 2047142563, 2048626595, 2050089723, 2051532210, 2052954317, 2054356304, 2055738427,
+            2057100941, 2058444095, 2059768141, 2061073324, 2062359889, 2063628078, 2064878130, 2066110281,
+            2067324768, 2068521821, 2069701670, 2070864543, 2072010665, 2073140258, 2074253541, 2075350734,
+            2076432050, 2077497704, 2078547905, 2079582862, 2080602781, 2081607865, 2082598316, 2083574333,
+            2084536112, 2085483847, 2086417732, 2087337955, 2088244705, 2089138168, 2090018525, 2090885959,
+            2091740648, 2092582769, 2093412497, 2094230004, 2095035461, 2095829036, 2096610896, 2097381203,
+            2098140122, 2098887811, 2099624429, 2100350132, 2101065074, 2101769408, 2102463284, 2103146849,
+            2103820252, 2104483635, 2105137143, 2105780915, 2106415092, 2107039810, 2107655204, 2108261409,
+            2108858556, 2109446776, 2110026197, 2110596946, 2111159148, 2111712927, 2112258404, 2112795699,
+            2113324932, 2113846219, 2114359675, 2114865414, 2115363549, 2115854191, 2116337448, 2116813428,
+            2117282239, 2117743984, 2118198767, 2118646691, 2119087855, 2119522358, 2119950300, 2120371776,
+            2120786881, 2121195709, 2121598354, 2121994905, 2122385453, 2122770086, 2123148893, 2123521958,
+            2123889368, 2124251206, 2124607555, 2124958496, 2125304109, 2125644474, 2125979669, 2126309770,
+            2126634854, 2126954994, 2127270266, 2127580741, 2127886491, 2128187587, 2128484098, 2128776092,
+            2129063638, 2129346802, 2129625650, 2129900245, 2130170653, 2130436935, 2130699155, 2130957372,
+            2131211646, 2131462038, 2131708606, 2131951406, 2132190496, 2132425932, 2132657769, 2132886060,
+            2133110860, 2133332221, 2133550195, 2133764833, 2133976186, 2134184303, 2134389233, 2134591024,
+            2134789724, 2134985380, 2135178037, 2135367742, 2135554538, 2135738470, 2135919582, 2136097915,
+            2136273513, 2136446417, 2136616668, 2136784305, 2136949369, 2137111900, 2137271934, 2137429511,
+            2137584667, 2137737440, 2137887866, 2138035980, 2138181818, 2138325415, 2138466804, 2138606019,
+            2138743094, 2138878061, 2139010951, 2139141798, 2139270632, 2139397483, 2139522383, 2139645361,
+            2139766445, 2139885666, 2140003052, 2140118630, 2140232428, 2140344474, 2140454794, 2140563416,
+            2140670363, 2140775664, 2140879342, 2140981422, 2141081929, 2141180887, 2141278320, 2141374251,
+            2141468703, 2141561699, 2141653261, 2141743411, 2141832171, 2141919562, 2142005605, 2142090321,
+            2142173730, 2142255852, 2142336708, 2142416315, 2142494694, 2142571864, 2142647843, 2142722649,
+            2142796300, 2142868815, 2142940210, 2143010502, 2143079710, 2143147849, 2143214935, 2143280986,
+            2143346017, 2143410043, 2143473081, 2143535144, 2143596249, 2143656411, 2143715642, 2143773959,
+            2143831374, 2143887903, 2143943558, 2143998353, 2144052301, 2144105415, 2144157709, 2144209194,
+            2144259884, 2144309790, 2144358924, 2144407299, 2144454926, 2144501817, 2144547983, 2144593435,
+            2144638184, 2144682241, 2144725617, 2144768323, 2144810367, 2144851762, 2144892516, 2144932640,
+            2144972144, 2145011036, 2145049327, 2145087026, 2145124141, 2145160682, 2145196658, 2145232077,
+            2145266949, 2145301281, 2145335081, 2145368359, 2145401122, 2145433377, 2145465134, 2145496399,
+            2145527180, 2145557485, 2145587321, 2145616696, 2145645615, 2145674087, 2145702119, 2145729716,
+            2145756887, 2145783636, 2145809972, 2145835900, 2145861427, 2145886558, 2145911301, 2145935660,
+            2145959642, 2145983253, 2146006499, 2146029384, 2146051916, 2146074098, 2146095937, 2146117438,
+            2146138606, 2146159446, 2146179963, 2146200163, 2146220050, 2146239629, 2146258904, 2146277882,
+            2146296565, 2146314959, 2146333068, 2146350897, 2146368449, 2146385730, 2146402743, 2146419493,
+            2146435983, 2146452218, 2146468201, 2146483937, 2146499429, 2146514681, 2146529696, 2146544480,
+            2146559034, 2146573362, 2146587469, 2146601357, 2146615031, 2146628492, 2146641745, 2146654792,
+            2146667637, 2146680284, 2146692734, 2146704992, 2146717059, 2146728940, 2146740637, 2146752152,
+            2146763489, 2146774650, 2146785639, 2146796457, 2146807108, 2146817593, 2146827916, 2146838079,
+            2146848085, 2146857936, 2146867634, 2146877181, 2146886581, 2146895835, 2146904946, 2146913915,
+            2146922746, 2146931440, 2146939999, 2146948425, 2146956721, 2146964888, 2146972929, 2146980845,
+            2146988639, 2146996311, 2147003865, 2147011302, 2147018623, 2147025831, 2147032928, 2147039914,
+            2147046792, 2147053563, 2147060230, 2147066793, 2147073255, 2147079616, 2147085879, 2147092044,
+            2147098115, 2147104091, 2147109974, 2147115766, 2147121469, 2147127083, 2147132610, 2147138052,
+            2147143409, 2147148683, 2147153875, 2147158987, 2147164020, 2147168974, 2147173852, 2147178655,
+            2147183382, 2147188037, 2147192619, 2147197131, 2147201572, 2147205945, 2147210250, 2147214488,
+            2147218660, 2147222768, 2147226812, 2147230793, 2147234713, 2147238572, 2147242371, 2147246111,
+            2147249794, 2147253419, 2147256988, 2147260502, 2147263961, 2147267366, 2147270719, 2147274020,
+            2147277270, 2147280469, 2147283619, 2147286720, 2147289772, 2147292778, 2147295737, 2147298650,
+            2147301518, 2147304341, 2147307121, 2147309857, 2147312552, 2147315204, 2147317815, 2147320386,
+            2147322917, 2147325409, 2147327862, 2147330277, 2147332654, 2147334995, 2147337300, 2147339569,
+            2147341802, 2147344001, 2147346166, 2147348297, 2147350396, 2147352461, 2147354495, 2147356497,
+            2147358468, 2147360409, 2147362320, 2147364201, 2147366052, 2147367875, 2147369670, 2147371437,
+            2147373177, 2147374889, 2147376575, 2147378235, 2147379869, 2147381478, 2147383062, 2147384622,
+            2147386157, 2147387668, 2147389156, 2147390621, 2147392063, 2147393483, 2147394881, 2147396257,
+            2147397612, 2147398946, 2147400259, 2147401552, 2147402824, 2147404077, 2147405311, 2147406525,
+            2147407721, 2147408898, 2147410057, 2147411198, 2147412321, 2147413427, 2147414515, 2147415587,
+            2147416642, 2147417681, 2147418704, 2147419711, 2147420702, 2147421678, 2147422639, 2147423584,
+            2147424516, 2147425432, 2147426335, 2147427223, 2147428098, 2147428959, 2147429807, 2147430642,
+            2147431464, 2147432273, 2147433069, 2147433853, 2147434625, 2147435385, 2147436133, 2147436870,
+            2147437595, 2147438309, 2147439012, 2147439704, 2147440385, 2147441056, 2147441716, 2147442367,
+            2147443007, 2147443637, 2147444257, 2147444868, 2147445469, 2147446061, 2147446643, 2147447217,
+            2147447782, 2147448338, 2147448885, 2147449424, 2147449955, 2147450477, 2147450992, 2147451498,
+            2147451996, 2147452487, 2147452970, 2147453446, 2147453914, 2147454375, 2147454829, 2147455276,
+            2147455715, 2147456148, 2147456575, 2147456995, 2147457408, 2147457815, 2147458215, 2147458609,
+            2147458998, 2147459380, 2147459756, 2147460126, 2147460491, 2147460850, 2147461203, 2147461551,
+            2147461894, 2147462231, 2147462563, 2147462890, 2147463212, 2147463529, 2147463841, 2147464148,
+            2147464450, 2147464748, 2147465041, 2147465329, 2147465613, 2147465893, 2147466168, 2147466439,
+            2147466706, 2147466969, 2147467227, 2147467482, 2147467732, 2147467979, 2147468222, 2147468461,
+            2147468697, 2147468928, 2147469157, 2147469381, 2147469603, 2147469820, 2147470035, 2147470246,
+            2147470453, 2147470658, 2147470859, 2147471058, 2147471253, 2147471445, 2147471634, 2147471821,
+            2147472004, 2147472184, 2147472362, 2147472537, 2147472709, 2147472879, 2147473046, 2147473210,
+            2147473372, 2147473531, 2147473688, 2147473843, 2147473995, 2147474144, 2147474292, 2147474437,
+            2147474580, 2147474720, 2147474859, 2147474995, 2147475129, 2147475261, 2147475391, 2147475519,
+            2147475645, 2147475769, 2147475891, 2147476012, 2147476130, 2147476247, 2147476361, 2147476474,
+            2147476585, 2147476695, 2147476803, 2147476909, 2147477013, 2147477116, 2147477217, 2147477317,
+            2147477415, 2147477512, 2147477607, 2147477701, 2147477793, 2147477884, 2147477973, 2147478061,
+            2147478148, 2147478233, 2147478317, 2147478400, 2147478481, 2147478561, 2147478640, 2147478718,
+            2147478794, 2147478869, 2147478943, 2147479016, 2147479088, 2147479159, 2147479228, 2147479297,
+            2147479364, 2147479431, 2147479496, 2147479561, 2147479624, 2147479686, 2147479748, 2147479808,
+            2147479868, 2147479926, 2147479984, 2147480041, 2147480097, 2147480152, 2147480206, 2147480259,
+            2147480312, 2147480364, 2147480415, 2147480465, 2147480514, 2147480563, 2147480610, 2147480658,
+            2147480704, 2147480750, 2147480794, 2147480839, 2147480882, 2147480925, 2147480967, 2147481009,
+            2147481050, 2147481090, 2147481130, 2147481169, 2147481207, 2147481245, 2147481282, 2147481319,
+            2147481355, 2147481391, 2147481426, 2147481460, 2147481494, 2147481527, 2147481560, 2147481593,
+            2147481625, 2147481656, 2147481687, 2147481717, 2147481747, 2147481777, 2147481806, 2147481834,
+            2147481862, 2147481890, 2147481917, 2147481944, 2147481970, 2147481997, 2147482022, 2147482047,
+            2147482072, 2147482097, 2147482121, 2147482144, 2147482168, 2147482191, 2147482213, 2147482235,
+            2147482257, 2147482279, 2147482300, 2147482321, 2147482342, 2147482362, 2147482382, 2147482401,
+            2147482421, 2147482440, 2147482458, 2147482477, 2147482495, 2147482513, 2147482531, 2147482548,
+            2147482565, 2147482582, 2147482598, 2147482615, 2147482631, 2147482646, 2147482662, 2147482677,
+            2147482692, 2147482707, 2147482722, 2147482736, 2147482750, 2147482764, 2147482778, 2147482791,
+            2147482804, 2147482818, 2147482830, 2147482843, 2147482856, 2147482868, 2147482880, 2147482892,
+            2147482904, 2147482915, 2147482927, 2147482938, 2147482949, 2147482960, 2147482970, 2147482981,
+            2147482991, 2147483001, 2147483011, 2147483021, 2147483031, 2147483040, 2147483050, 2147483059,
+            2147483068, 2147483077, 2147483086, 2147483095, 2147483103, 2147483112, 2147483120, 2147483128,
+            2147483136, 2147483144, 2147483152, 2147483160, 2147483167, 2147483175, 2147483182, 2147483189,
+            2147483197, 2147483204, 2147483210, 2147483217, 2147483224, 2147483230, 2147483237, 2147483243,
+            2147483250, 2147483256, 2147483262, 2147483268, 2147483274, 2147483280, 2147483285, 2147483291,
+            2147483296, 2147483302, 2147483307, 2147483312, 2147483318, 2147483323, 2147483328, 2147483333,
+            2147483338, 2147483343, 2147483347, 2147483352, 2147483356, 2147483361, 2147483365, 2147483370,
+            2147483374, 2147483378, 2147483383, 2147483387, 2147483391, 2147483395, 2147483399, 2147483403,
+            2147483406,
+            };
+            return table;
+        }
+
+        /** Returns sigmoid(x) in Q0.31, for x >= 0 with `fracBits` fractional bits */
+        inline int64_t sigmoidPositive(int64_t x, int fracBits) noexcept
+        {
+            const auto* table = getSigmoidTable();
+            if((x >> fracBits) >= (table_max_index >> table_steps_log2))
+                return table[table_max_index];
+
+            const auto scaled = x * ((int64_t)1 << table_steps_log2);
+            const auto index = scaled >> fracBits;
+            const auto frac = scaled - (index << fracBits);
+            const auto y0 = (int64_t)table[index];
+            const auto y1 = (int64_t)table[index + 1];
+            return y0 + fixed_point_detail::roundShift((y1 - y0) * frac, fracBits);
+        }
+    } // namespace detail
+#endif // DOXYGEN
+
+    /** Returns sigmoid(x) in Q0.31, where x has `fracBits` fractional bits. */
+    inline int64_t sigmoid(int64_t x, int fracBits) noexcept
+    {
+        constexpr auto one = (int64_t)1 << fixed_point_detail::gate_frac_bits;
+        return x >= 0 ? detail::sigmoidPositive(x, fracBits) : one - detail::sigmoidPositive(-x, fracBits);
+    }
+
+    /** Returns tanh(x) in Q0.31, where x has `fracBits` fractional bits. */
+    inline int64_t tanh(int64_t x, int fracBits) noexcept
+    {
+        // tanh(x) = 2 * sigmoid(2x) - 1
+        constexpr auto one = (int64_t)1 << fixed_point_detail::gate_frac_bits;
+        const auto ax = x >= 0 ? x : -x;
+        const auto sig2x = fracBits > 0 ? detail::sigmoidPositive(ax, fracBits - 1) : detail::sigmoidPositive(2 * ax, 0);
+        const auto y = 2 * sig2x - one;
+        return x >= 0 ? y : -y;
+    }
+} // namespace fixed_point_maths
+
+} // namespace RTNeural
+
+#endif // FIXEDPOINTMATHS_H_INCLUDED
@@ -0,0 +1,243 @@
+#ifndef FIXEDPOINTMODEL_H_INCLUDED
+#define FIXEDPOINTMODEL_H_INCLUDED
+
+#include "../ModelT.h"
+#include "fixed_point_layers.h"
+
+#if MODELT_AVAILABLE
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace modelt_detail
+{
+    template <typename T, typename FixedType, int in_size, int out_size>
+    void loadLayer(FixedDenseT<FixedType, in_size, out_size>& dense, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+
+        if(checkDense<T>(dense, type, layerDims, debug))
+            loadDense<T>(dense, weights);
+    }
+
+    template <typename T, typename FixedType, int in_size, int out_size, int kernel_size, int dilation_rate>
+    void loadLayer(FixedConv1DT<FixedType, in_size, out_size, kernel_size, dilation_rate>& conv, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = getLayerWeights(l);
+        const auto kernel = l["kernel_size"].back().get<int>();
+        const auto dilation = l["dilation"].back().get<int>();
+
+        if(checkConv1D<T>(conv, type, layerDims, kernel, dilation, debug))
+            loadConv1D<T>(conv, kernel, dilation, weights);
+    }
+
+    template <typename T, typename FixedType, int in_size, int out_size>
+    void loadLayer(FixedGRULayerT<FixedType, in_size, out_size>& gru, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = l["weights"];
+
+        if(checkGRU<T>(gru, type, layerDims, debug))
+            loadGRU<T>(gru, weights);
+    }
+
+    template <typename T, typename FixedType, int in_size, int out_size>
+    void loadLayer(FixedLSTMLayerT<FixedType, in_size, out_size>& lstm, const nlohmann::json& l,
+        const std::string& type, int layerDims, bool debug)
+    {
+        using namespace json_parser;
+
+        debug_print("Layer: " + type, debug);
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+        const auto weights = l["weights"];
+
+        if(checkLSTM<T>(lstm, type, layerDims, debug))
+            loadLSTM<T>(lstm, weights);
+    }
+
+    template <typename FixedType, int in_size, int out_size>
+    struct hasBuiltInActivation<FixedGRULayerT<FixedType, in_size, out_size>> : std::true_type
+    {
+    };
+
+    template <typename FixedType, int in_size, int out_size>
+    struct hasBuiltInActivation<FixedLSTMLayerT<FixedType, in_size, out_size>> : std::true_type
+    {
+    };
+} // namespace modelt_detail
+#endif // DOXYGEN
+
+/**
+ *  A static sequential neural network model, using fixed-point arithmetic.
+ *
+ *  The inference is done entirely with integer arithmetic, so the
+ *  model outputs are bit-exact on every platform. The weights are
+ *  loaded from the same json files as the floating-point models,
+ *  and are converted to `FixedType` at load time.
+ *
+ *  To use this class, you must define the layers at compile-time:
+ *  ```
+ *  using FixedType = FixedPoint<int32_t, 24>;
+ *  FixedModelT<FixedType, 1, 1,
+ *      FixedDenseT<FixedType, 1, 8>,
+ *      FixedTanhActivationT<FixedType, 8>,
+ *      FixedDenseT<FixedType, 8, 1>
+ *  > model;
+ *  ```
+ */
+template <typename FixedType, int in_size, int out_size, typename... Layers>
+class FixedModelT
+{
+public:
+    FixedModelT() = default;
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    auto& get() noexcept
+    {
+        return std::get<Index>(layers);
+    }
+
+    /** Get a reference to the layer at index `Index`. */
+    template <int Index>
+    const auto& get() const noexcept
+    {
+        return std::get<Index>(layers);
+    }
+
+    /** Resets the state of the network layers. */
+    void reset()
+    {
+        modelt_detail::forEachInTuple([&](auto& layer, size_t) { layer.reset(); }, layers);
+    }
+
+    /** Performs forward propagation for this model. */
+    inline FixedType forward(const FixedType* input) noexcept
+    {
+        std::copy(input, input + in_size, ins);
+
+        std::get<0>(layers).forward(ins);
+        modelt_detail::forward_unroll<1, n_layers - 1>::call(layers);
+
+        const auto& layer_outs = get<n_layers - 1>().outs;
+        std::copy(layer_outs, layer_outs + out_size, outs);
+        return outs[0];
+    }
+
+    /**
+     * Performs forward propagation for this model, with floating-point
+     * inputs and outputs. The inputs are converted to `FixedType`, and
+     * the first output is converted back to floating-point.
+     */
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type
+    forward(const T* input) noexcept
+    {
+        FixedType fixed_input[in_size];
+        for(int i = 0; i < in_size; ++i)
+            fixed_input[i] = FixedType::fromFloat(input[i]);
+
+        return forward(fixed_input).template toFloat<T>();
+    }
+
+    /** Returns a pointer to the output of the final layer in the network. */
+    inline const FixedType* getOutputs() const noexcept
+    {
+        return outs;
+    }
+
+    /** Loads neural network model weights from a json stream. */
+    void parseJson(const nlohmann::json& parent, const bool debug = false)
+    {
+        using namespace json_parser;
+
+        auto shape = parent["in_shape"];
+        auto json_layers = parent["layers"];
+
+        if(!shape.is_array() || !json_layers.is_array())
+            return;
+
+        const auto nDims = shape.back().get<int>();
+        debug_print("# dimensions: " + std::to_string(nDims), debug);
+
+        if(nDims != in_size)
+        {
+            debug_print("Incorrect input size!", debug);
+            return;
+        }
+
+        int json_stream_idx = 0;
+        modelt_detail::forEachInTuple([&](auto& layer, size_t) {
+            if(json_stream_idx >= (int)json_layers.size())
+            {
+                debug_print("Too many layers!", debug);
+                return;
+            }
+
+            const auto l = json_layers.at(json_stream_idx);
+            const auto type = l["type"].get<std::string>();
+            const auto layerShape = l["shape"];
+            const auto layerDims = layerShape.back().get<int>();
+
+            if(layer.isActivation()) // activation layers don't need initialisation
+            {
+                if(!l.contains("activation"))
+                {
+                    debug_print("No activation layer expected!", debug);
+                    return;
+                }
+
+                const auto activationType = l["activation"].get<std::string>();
+                if(!activationType.empty())
+                {
+                    debug_print("  activation: " + activationType, debug);
+                    checkActivation(layer, activationType, layerDims, debug);
+                }
+
+                json_stream_idx++;
+                return;
+            }
+
+            // the weights are read as doubles, and converted to fixed-point by the layers
+            modelt_detail::loadLayer<double>(layer, l, type, layerDims, debug);
+            json_stream_idx = modelt_detail::nextJsonLayerIndex(layer, json_stream_idx, l);
+        },
+            layers);
+    }
+
+    /** Loads neural network model weights from a json stream. */
+    void parseJson(std::ifstream& jsonStream, const bool debug = false)
+    {
+        nlohmann::json parent;
+        jsonStream >> parent;
+        return parseJson(parent, debug);
+    }
+
+private:
+    FixedType ins[in_size] {};
+    FixedType outs[out_size] {};
+
+    std::tuple<Layers...> layers;
+    static constexpr size_t n_layers = sizeof...(Layers);
+};
+
+} // namespace RTNeural
+
+#endif // MODELT_AVAILABLE
+
+#endif // FIXEDPOINTMODEL_H_INCLUDED
@@ -6,7 +6,7 @@
 #if RTNEURAL_USE_EIGEN
 #include "gru_eigen.h"
 #include "gru_eigen.tpp"
-#elif RTNEURAL_USE_XSIMD
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
 #include "gru_xsimd.h"
 #include "gru_xsimd.tpp"
 #elif RTNEURAL_USE_ACCELERATE
@@ -27,8 +27,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class GRULayer final : public Layer<T>
 {
 public:
@@ -40,7 +44,19 @@ public:
     virtual ~GRULayer();
 
     /** Resets the state of the GRU. */
-    void reset() override { std::fill(ht1, ht1 + Layer<T>::out_size, (T)0); }
+    void reset() override
+    {
+        std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
+        outs_delayed.reset();
+    }
+
+    /**
+     * Prepares the GRU to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
 
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
@@ -50,12 +66,15 @@ public:
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
         {
-            zVec[i] = sigmoid(vMult(zWeights.W[i], input, Layer<T>::in_size) + vMult(zWeights.U[i], ht1, Layer<T>::out_size) + zWeights.b[0][i] + zWeights.b[1][i]);
-            rVec[i] = sigmoid(vMult(rWeights.W[i], input, Layer<T>::in_size) + vMult(rWeights.U[i], ht1, Layer<T>::out_size) + rWeights.b[0][i] + rWeights.b[1][i]);
-            cVec[i] = std::tanh(vMult(cWeights.W[i], input, Layer<T>::in_size) + rVec[i] * (vMult(cWeights.U[i], ht1, Layer<T>::out_size) + cWeights.b[1][i]) + cWeights.b[0][i]);
+            zVec[i] = MathsProvider::sigmoid(vMult(zWeights.W[i], input, Layer<T>::in_size) + vMult(zWeights.U[i], ht1, Layer<T>::out_size) + zWeights.b[0][i] + zWeights.b[1][i]);
+            rVec[i] = MathsProvider::sigmoid(vMult(rWeights.W[i], input, Layer<T>::in_size) + vMult(rWeights.U[i], ht1, Layer<T>::out_size) + rWeights.b[0][i] + rWeights.b[1][i]);
+            cVec[i] = MathsProvider::tanh(vMult(cWeights.W[i], input, Layer<T>::in_size) + rVec[i] * (vMult(cWeights.U[i], ht1, Layer<T>::out_size) + cWeights.b[1][i]) + cWeights.b[0][i]);
             h[i] = ((T)1 - zVec[i]) * cVec[i] + zVec[i] * ht1[i];
         }
 
+        if(outs_delayed.isActive())
+            outs_delayed.process(h);
+
         std::copy(h, h + Layer<T>::out_size, ht1);
     }
 
@@ -87,6 +106,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -94,6 +120,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -101,6 +134,13 @@ public:
      */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /**
+     * Sets the layer bias from a weights view.
+     * 
+     * The bias view must have size weights[2][3 * out_size]
+     */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     /** Returns the kernel weight for the given indices. */
     T getWVal(int i, int k) const noexcept;
 
@@ -133,6 +173,9 @@ protected:
     T* rVec;
     T* cVec;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     static constexpr int kNumBiasLayers { 2 };
 };
 
@@ -144,10 +187,22 @@ protected:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class GRULayerT
 {
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<std::array<T, out_sizet>, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -182,19 +237,19 @@ public:
         recurrent_mat_mul(outs, Uz, zt);
         kernel_mat_mul(ins, Wz, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            zt[i] = sigmoid(zt[i] + bz[i] + kernel_outs[i]);
+            zt[i] = MathsProvider::sigmoid(zt[i] + bz[i] + kernel_outs[i]);
 
         // compute rt
         recurrent_mat_mul(outs, Ur, rt);
         kernel_mat_mul(ins, Wr, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            rt[i] = sigmoid(rt[i] + br[i] + kernel_outs[i]);
+            rt[i] = MathsProvider::sigmoid(rt[i] + br[i] + kernel_outs[i]);
 
         // compute h_hat
         recurrent_mat_mul(outs, Uh, ct);
         kernel_mat_mul(ins, Wh, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            ht[i] = std::tanh(rt[i] * (ct[i] + bh1[i]) + bh0[i] + kernel_outs[i]);
+            ht[i] = MathsProvider::tanh(rt[i] * (ct[i] + bh1[i]) + bh0[i] + kernel_outs[i]);
 
         computeOutput();
     }
@@ -207,17 +262,17 @@ public:
         // compute zt
         recurrent_mat_mul(outs, Uz, zt);
         for(int i = 0; i < out_size; ++i)
-            zt[i] = sigmoid(zt[i] + bz[i] + (Wz_1[i] * ins[0]));
+            zt[i] = MathsProvider::sigmoid(zt[i] + bz[i] + (Wz_1[i] * ins[0]));
 
         // compute rt
         recurrent_mat_mul(outs, Ur, rt);
         for(int i = 0; i < out_size; ++i)
-            rt[i] = sigmoid(rt[i] + br[i] + (Wr_1[i] * ins[0]));
+            rt[i] = MathsProvider::sigmoid(rt[i] + br[i] + (Wr_1[i] * ins[0]));
 
         // compute h_hat
         recurrent_mat_mul(outs, Uh, ct);
         for(int i = 0; i < out_size; ++i)
-            ht[i] = std::tanh(rt[i] * (ct[i] + bh1[i]) + bh0[i] + (Wh_1[i] * ins[0]));
+            ht[i] = MathsProvider::tanh(rt[i] * (ct[i] + bh1[i]) + bh0[i] + (Wh_1[i] * ins[0]));
 
         computeOutput();
     }
@@ -229,6 +284,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -236,6 +298,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -243,6 +312,13 @@ public:
      */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /**
+     * Sets the layer bias from a weights view.
+     * 
+     * The bias view must have size weights[2][3 * out_size]
+     */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
 private:
@@ -259,49 +335,42 @@ private:
     computeOutput() noexcept
     {
         for(int i = 0; i < out_size; ++i)
-            outs_delayed[delayWriteIdx][i] = ((T)1.0 - zt[i]) * ht[i] + zt[i] * outs[i];
+            outs_delayed.writeFrame()[i] = ((T)1.0 - zt[i]) * ht[i] + zt[i] * outs[i];
 
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(outs_delayed, outs);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, T (&out)[out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
         for(int i = 0; i < out_size; ++i)
-            out[i] = delayVec[0][i];
+            out[i] = delayed[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, T (&out)[out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
+        const auto& delayedMinus1 = delayBuffer.read(delayOffset - 1);
         for(int i = 0; i < out_size; ++i)
-            out[i] = delayPlus1Mult * delayVec[0][i] + delayMult * delayVec[1][i];
+            out[i] = delayPlus1Mult * delayed[i] + delayMult * delayedMinus1[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
-    static inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size]) noexcept
+    inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size]) const noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + out_size, vec, (T)0);
+        kernels.matVec(&mat[0][0], out_size, out_size, vec, out);
     }
 
-    static inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size]) noexcept
+    inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size]) const noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + in_size, vec, (T)0);
+        kernels.matVec(&mat[0][0], out_size, in_size, vec, out);
     }
 
     // kernel weights
@@ -332,9 +401,11 @@ private:
     T ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ht alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
+    dispatch::LayerKernels kernels;
+
     // needed for delays when doing sample rate correction
-    std::vector<std::array<T, out_size>> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     T delayMult = (T)1;
     T delayPlus1Mult = (T)0;
 };
@@ -3,9 +3,9 @@
 namespace RTNeural
 {
 
-#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_ACCELERATE
-template <typename T>
-GRULayer<T>::GRULayer(int in_size, int out_size)
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT && !RTNEURAL_USE_ACCELERATE
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
     , zWeights(in_size, out_size)
     , rWeights(in_size, out_size)
@@ -17,28 +17,28 @@ GRULayer<T>::GRULayer(int in_size, int out_size)
     cVec = new T[out_size];
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(std::initializer_list<int> sizes)
-    : GRULayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(std::initializer_list<int> sizes)
+    : GRULayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(const GRULayer<T>& other)
-    : GRULayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(const GRULayer<T, MathsProvider>& other)
+    : GRULayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-GRULayer<T>& GRULayer<T>::operator=(const GRULayer<T>& other)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>& GRULayer<T, MathsProvider>::operator=(const GRULayer<T, MathsProvider>& other)
 {
     if(&other != this)
-        *this = GRULayer<T>(other);
+        *this = GRULayer<T, MathsProvider>(other);
     return *this;
 }
 
-template <typename T>
-GRULayer<T>::~GRULayer()
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::~GRULayer()
 {
     delete[] ht1;
     delete[] zVec;
@@ -46,8 +46,8 @@ GRULayer<T>::~GRULayer()
     delete[] cVec;
 }
 
-template <typename T>
-GRULayer<T>::WeightSet::WeightSet(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
     : out_size(out_size)
 {
     W = new T*[out_size];
@@ -66,8 +66,8 @@ GRULayer<T>::WeightSet::WeightSet(int in_size, int out_size)
     }
 }
 
-template <typename T>
-GRULayer<T>::WeightSet::~WeightSet()
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::WeightSet::~WeightSet()
 {
     for(int i = 0; i < kNumBiasLayers; ++i)
     {
@@ -85,8 +85,15 @@ GRULayer<T>::WeightSet::~WeightSet()
     delete[] U;
 }
 
-template <typename T>
-void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -99,8 +106,22 @@ void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setWVals(T** wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.W[k][i] = wVals(i, k);
+            rWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(T** wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -113,8 +134,8 @@ void GRULayer<T>::setWVals(T** wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -127,8 +148,22 @@ void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(T** uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.U[k][i] = uVals(i, k);
+            rWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(T** uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -141,8 +176,8 @@ void GRULayer<T>::setUVals(T** uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -155,8 +190,22 @@ void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(T** bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.b[i][k] = bVals(i, k);
+            rWeights.b[i][k] = bVals(i, k + Layer<T>::out_size);
+            cWeights.b[i][k] = bVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(T** bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -169,8 +218,8 @@ void GRULayer<T>::setBVals(T** bVals)
     }
 }
 
-template <typename T>
-T GRULayer<T>::getWVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getWVal(int i, int k) const noexcept
 {
     T** set = zWeights.W;
     if(k > 2 * Layer<T>::out_size)
@@ -187,8 +236,8 @@ T GRULayer<T>::getWVal(int i, int k) const noexcept
     return set[i][k];
 }
 
-template <typename T>
-T GRULayer<T>::getUVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getUVal(int i, int k) const noexcept
 {
     T** set = zWeights.U;
     if(k > 2 * Layer<T>::out_size)
@@ -205,8 +254,8 @@ T GRULayer<T>::getUVal(int i, int k) const noexcept
     return set[i][k];
 }
 
-template <typename T>
-T GRULayer<T>::getBVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getBVal(int i, int k) const noexcept
 {
     T** set = zWeights.b;
     if(k > 2 * Layer<T>::out_size)
@@ -224,8 +273,8 @@ T GRULayer<T>::getBVal(int i, int k) const noexcept
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::GRULayerT()
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -269,39 +318,38 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& vec : outs_delayed)
-            std::fill(vec.begin(), vec.end(), T {});
+        outs_delayed.reset({});
     }
 
     // reset output state
@@ -310,8 +358,8 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
 }
 
 // kernel weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < in_size; ++i)
     {
@@ -331,9 +379,30 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Wz[j][i] = wVals(i, j);
+            Wr[j][i] = wVals(i, j + out_size);
+            Wh[j][i] = wVals(i, j + 2 * out_size);
+        }
+    }
+
+    for(int j = 0; j < out_size; ++j)
+    {
+        Wz_1[j] = wVals(0, j);
+        Wr_1[j] = wVals(0, j + out_size);
+        Wh_1[j] = wVals(0, j + 2 * out_size);
+    }
+}
+
 // recurrent weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -346,9 +415,23 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Uz[j][i] = uVals(i, j);
+            Ur[j][i] = uVals(i, j + out_size);
+            Uh[j][i] = uVals(i, j + 2 * out_size);
+        }
+    }
+}
+
 // biases
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
@@ -359,6 +442,18 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vect
     }
 }
 
-#endif // !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int k = 0; k < out_size; ++k)
+    {
+        bz[k] = bVals(0, k) + bVals(1, k);
+        br[k] = bVals(0, k + out_size) + bVals(1, k + out_size);
+        bh0[k] = bVals(0, k + 2 * out_size);
+        bh1[k] = bVals(1, k + 2 * out_size);
+    }
+}
+
+#endif // !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT
 
 } // namespace RTNeural
@@ -21,7 +21,19 @@ public:
     virtual ~GRULayer();
 
     /** Resets the state of the GRU. */
-    void reset() override { std::fill(ht1, ht1 + Layer<T>::out_size, (T)0); }
+    void reset() override
+    {
+        std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
+        outs_delayed.reset();
+    }
+
+    /**
+     * Prepares the GRU to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
 
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
@@ -44,12 +56,21 @@ public:
     /** Sets the layer kernel weights. */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /** Sets the layer kernel weights from a weights view. */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /** Sets the layer recurrent weights. */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /** Sets the layer recurrent weights from a weights view. */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /** Sets the layer biases. */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /** Sets the layer biases from a weights view. */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     T getWVal(int i, int k) const noexcept;
     T getUVal(int i, int k) const noexcept;
     T getBVal(int i, int k) const noexcept;
@@ -98,6 +119,9 @@ protected:
         vDSP_vmul(zVec, 1, ht1, 1, ht1, 1, Layer<T>::out_size);
         vDSP_vadd(h, 1, ht1, 1, h, 1, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+            outs_delayed.process(h);
+
         cblas_scopy((int)Layer<T>::out_size, h, 1, ht1, 1);
     }
 
@@ -144,11 +168,17 @@ protected:
         vDSP_vmulD(zVec, 1, ht1, 1, ht1, 1, Layer<T>::out_size);
         vDSP_vaddD(h, 1, ht1, 1, h, 1, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+            outs_delayed.process(h);
+
         cblas_dcopy((int)Layer<T>::out_size, h, 1, ht1, 1);
     }
 
     T* ht1;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     struct WeightSet
     {
         WeightSet(int in_size, int out_size);
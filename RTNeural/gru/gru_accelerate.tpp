@@ -82,6 +82,13 @@ GRULayer<T>::WeightSet::~WeightSet()
     delete[] U;
 }
 
+template <typename T>
+void GRULayer<T>::prepare(T delaySamples)
+{
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
 template <typename T>
 void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
@@ -96,6 +103,20 @@ void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
+template <typename T>
+void GRULayer<T>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.W[k][i] = wVals(i, k);
+            rWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
 template <typename T>
 void GRULayer<T>::setWVals(T** wVals)
 {
@@ -124,6 +145,20 @@ void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
+template <typename T>
+void GRULayer<T>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.U[k][i] = uVals(i, k);
+            rWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
 template <typename T>
 void GRULayer<T>::setUVals(T** uVals)
 {
@@ -152,6 +187,20 @@ void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
     }
 }
 
+template <typename T>
+void GRULayer<T>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.b[i][k] = bVals(i, k);
+            rWeights.b[i][k] = bVals(i, k + Layer<T>::out_size);
+            cWeights.b[i][k] = bVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
 template <typename T>
 void GRULayer<T>::setBVals(T** bVals)
 {
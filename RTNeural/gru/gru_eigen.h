@@ -14,8 +14,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class GRULayer : public Layer<T>
 {
 public:
@@ -30,8 +34,17 @@ public:
     void reset() override
     {
         std::fill(ht1.data(), ht1.data() + Layer<T>::out_size, (T)0);
+        outs_delayed.reset();
     }
 
+    /**
+     * Prepares the GRU to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
 
@@ -43,13 +56,17 @@ public:
 
         zVec.noalias() = wVec_z * inVec + uVec_z * ht1 + bVec_z.col(0) + bVec_z.col(1);
         rVec.noalias() = wVec_r * inVec + uVec_r * ht1 + bVec_r.col(0) + bVec_r.col(1);
-        sigmoid(zVec);
-        sigmoid(rVec);
+        zVec = MathsProvider::sigmoid(zVec);
+        rVec = MathsProvider::sigmoid(rVec);
 
         cVec.noalias() = wVec_c * inVec + rVec.cwiseProduct(uVec_c * ht1 + bVec_c.col(1)) + bVec_c.col(0);
-        cVec = cVec.array().tanh();
+        cVec = MathsProvider::tanh(cVec);
 
         ht1 = (ones - zVec).cwiseProduct(cVec) + zVec.cwiseProduct(ht1);
+
+        if(outs_delayed.isActive())
+            outs_delayed.process(ht1.data());
+
         std::copy(ht1.data(), ht1.data() + Layer<T>::out_size, h);
     }
 
@@ -77,12 +94,21 @@ public:
     /** Returns the kernel weight for the given indices. */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /** Sets the layer kernel weights from a weights view. */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /** Returns the recurrent weight for the given indices. */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /** Sets the layer recurrent weights from a weights view. */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /** Returns the bias value for the given indices. */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /** Sets the layer bias from a weights view. */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     T getWVal(int i, int k) const noexcept;
     T getUVal(int i, int k) const noexcept;
     T getBVal(int i, int k) const noexcept;
@@ -99,6 +125,9 @@ private:
     Eigen::Matrix<T, Eigen::Dynamic, 2> bVec_c;
 
     Eigen::Matrix<T, Eigen::Dynamic, 1> ht1;
+
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> outs_delayed;
     Eigen::Matrix<T, Eigen::Dynamic, 1> zVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> rVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> cVec;
@@ -115,8 +144,16 @@ private:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class GRULayerT
 {
     using b_type = Eigen::Matrix<T, out_sizet, 1>;
@@ -126,6 +163,10 @@ class GRULayerT
     using in_type = Eigen::Matrix<T, in_sizet, 1>;
     using out_type = Eigen::Matrix<T, out_sizet, 1>;
 
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<out_type, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -154,11 +195,14 @@ public:
     /** Performs forward propagation for this layer. */
     inline void forward(const in_type& ins) noexcept
     {
-        zVec.noalias() = sigmoid(wVec_z * ins + uVec_z * outs + bVec_z);
-        rVec.noalias() = sigmoid(wVec_r * ins + uVec_r * outs + bVec_r);
+        zVec.noalias() = wVec_z * ins + uVec_z * outs + bVec_z;
+        zVec = MathsProvider::sigmoid(zVec);
+
+        rVec.noalias() = wVec_r * ins + uVec_r * outs + bVec_r;
+        rVec = MathsProvider::sigmoid(rVec);
 
         cVec.noalias() = wVec_c * ins + rVec.cwiseProduct(uVec_c * outs + bVec_c1) + bVec_c0;
-        cVec = cVec.array().tanh();
+        cVec = MathsProvider::tanh(cVec);
 
         computeOutput();
     }
@@ -170,6 +214,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -177,6 +228,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -184,6 +242,13 @@ public:
      */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /**
+     * Sets the layer bias from a weights view.
+     * 
+     * The bias view must have size weights[2][3 * out_size]
+     */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     Eigen::Map<out_type, RTNeuralEigenAlignment> outs;
 
 private:
@@ -200,34 +265,25 @@ private:
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
     computeOutput() noexcept
     {
-        outs_delayed[delayWriteIdx] = (out_type::Ones() - zVec).cwiseProduct(cVec) + zVec.cwiseProduct(outs);
+        outs_delayed.writeFrame() = (out_type::Ones() - zVec).cwiseProduct(cVec) + zVec.cwiseProduct(outs);
 
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(outs_delayed, outs);
     }
 
     template <typename OutVec, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<out_type>& delayVec, OutVec& out, int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, OutVec& out) noexcept
     {
-        out = delayVec[0];
-
-        for(int j = 0; j < delayWriteIndex; ++j)
-            delayVec[j] = delayVec[j + 1];
+        out = delayBuffer.read(delayOffset);
+        delayBuffer.advance();
     }
 
     template <typename OutVec, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<out_type>& delayVec, OutVec& out, int delayWriteIndex) noexcept
-    {
-        out = delayPlus1Mult * delayVec[0] + delayMult * delayVec[1];
-
-        for(int j = 0; j < delayWriteIndex; ++j)
-            delayVec[j] = delayVec[j + 1];
-    }
-
-    static inline out_type sigmoid(const out_type& x) noexcept
+    processDelay(delay_type& delayBuffer, OutVec& out) noexcept
     {
-        return (T)1 / (((T)-1 * x.array()).array().exp() + (T)1);
+        out = delayPlus1Mult * delayBuffer.read(delayOffset) + delayMult * delayBuffer.read(delayOffset - 1);
+        delayBuffer.advance();
     }
 
     // kernel weights
@@ -251,8 +307,8 @@ private:
     out_type cVec;
 
     // needed for delays when doing sample rate correction
-    std::vector<out_type> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     T delayMult = (T)1;
     T delayPlus1Mult = (T)0;
 };
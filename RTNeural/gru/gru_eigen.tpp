@@ -5,8 +5,8 @@
 namespace RTNeural
 {
 
-template <typename T>
-GRULayer<T>::GRULayer(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
 {
     wVec_z = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, in_size);
@@ -28,26 +28,33 @@ GRULayer<T>::GRULayer(int in_size, int out_size)
     ones = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Ones(out_size, 1);
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(std::initializer_list<int> sizes)
-    : GRULayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(std::initializer_list<int> sizes)
+    : GRULayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(const GRULayer<T>& other)
-    : GRULayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(const GRULayer<T, MathsProvider>& other)
+    : GRULayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-GRULayer<T>& GRULayer<T>::operator=(const GRULayer<T>& other)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>& GRULayer<T, MathsProvider>::operator=(const GRULayer<T, MathsProvider>& other)
 {
-    return *this = GRULayer<T>(other);
+    return *this = GRULayer<T, MathsProvider>(other);
 }
 
-template <typename T>
-void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -60,8 +67,22 @@ void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setWVals(T** wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            wVec_z(k, i) = wVals(i, k);
+            wVec_r(k, i) = wVals(i, k + Layer<T>::out_size);
+            wVec_c(k, i) = wVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(T** wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -74,8 +95,8 @@ void GRULayer<T>::setWVals(T** wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -88,8 +109,22 @@ void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(T** uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            uVec_z(k, i) = uVals(i, k);
+            uVec_r(k, i) = uVals(i, k + Layer<T>::out_size);
+            uVec_c(k, i) = uVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(T** uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -102,8 +137,8 @@ void GRULayer<T>::setUVals(T** uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -116,8 +151,22 @@ void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(T** bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            bVec_z(k, i) = bVals(i, k);
+            bVec_r(k, i) = bVals(i, k + Layer<T>::out_size);
+            bVec_c(k, i) = bVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(T** bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -130,8 +179,8 @@ void GRULayer<T>::setBVals(T** bVals)
     }
 }
 
-template <typename T>
-T GRULayer<T>::getWVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getWVal(int i, int k) const noexcept
 {
     Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> set = wVec_z;
     if(k > 2 * Layer<T>::out_size)
@@ -142,8 +191,8 @@ T GRULayer<T>::getWVal(int i, int k) const noexcept
     return set(k % Layer<T>::out_size, i);
 }
 
-template <typename T>
-T GRULayer<T>::getUVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getUVal(int i, int k) const noexcept
 {
     Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> set = uVec_z;
     if(k > 2 * Layer<T>::out_size)
@@ -154,8 +203,8 @@ T GRULayer<T>::getUVal(int i, int k) const noexcept
     return set(k % Layer<T>::out_size, i);
 }
 
-template <typename T>
-T GRULayer<T>::getBVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getBVal(int i, int k) const noexcept
 {
     Eigen::Matrix<T, Eigen::Dynamic, 2> set = bVec_z;
     if(k > 2 * Layer<T>::out_size)
@@ -167,8 +216,8 @@ T GRULayer<T>::getBVal(int i, int k) const noexcept
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::GRULayerT()
     : outs(outs_internal)
 {
     wVec_z = k_type::Zero();
@@ -187,39 +236,38 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& vec : outs_delayed)
-            vec = out_type::Zero();
+        outs_delayed.reset(out_type::Zero());
     }
 
     // reset output state
@@ -227,8 +275,8 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
 }
 
 // kernel weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < in_size; ++i)
     {
@@ -241,9 +289,23 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            wVec_z(k, i) = wVals(i, k);
+            wVec_r(k, i) = wVals(i, k + out_size);
+            wVec_c(k, i) = wVals(i, k + out_size * 2);
+        }
+    }
+}
+
 // recurrent weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -256,9 +318,23 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            uVec_z(k, i) = uVals(i, k);
+            uVec_r(k, i) = uVals(i, k + out_size);
+            uVec_c(k, i) = uVals(i, k + out_size * 2);
+        }
+    }
+}
+
 // biases
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
@@ -269,6 +345,18 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int k = 0; k < out_size; ++k)
+    {
+        bVec_z(k) = bVals(0, k) + bVals(1, k);
+        bVec_r(k) = bVals(0, k + out_size) + bVals(1, k + out_size);
+        bVec_c0(k) = bVals(0, k + 2 * out_size);
+        bVec_c1(k) = bVals(1, k + 2 * out_size);
+    }
+}
+
 } // namespace RTNeural
 
 #endif // RTNEURAL_USE_EIGEN
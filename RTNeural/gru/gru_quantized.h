@@ -0,0 +1,338 @@
+#ifndef GRUQUANTIZED_H_INCLUDED
+#define GRUQUANTIZED_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * quantized kernel and recurrent weights.
+ *
+ * The weights are stored as `QType` (int8_t or int16_t), with one
+ * scale per gate output. On each call to `forward()`, the inputs
+ * and the previous hidden state are quantized to `QType`, and the
+ * matrix products are accumulated in integers (int32 for int8, and
+ * int64 for int16). The gate nonlinearities, biases, and hidden
+ * state are computed in floating-point.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename QType = int8_t>
+class QuantizedGRULayer final : public Layer<T>
+{
+public:
+    /** Constructs a quantized GRU layer for a given input and output size. */
+    QuantizedGRULayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , W((size_t)(3 * out_size * in_size), (QType)0)
+        , W_scales((size_t)(3 * out_size), (T)1)
+        , U((size_t)(3 * out_size * out_size), (QType)0)
+        , U_scales((size_t)(3 * out_size), (T)1)
+        , bias((size_t)(2 * 3 * out_size), (T)0)
+        , ht1((size_t)out_size, (T)0)
+        , quantized_ins((size_t)in_size, (QType)0)
+        , quantized_ht1((size_t)out_size, (QType)0)
+    {
+    }
+
+    QuantizedGRULayer(std::initializer_list<int> sizes)
+        : QuantizedGRULayer(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Resets the state of the GRU. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gru"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        const auto in_scale = quantization_detail::quantizeVector(input, quantized_ins.data(), in_size);
+        const auto h_scale = quantization_detail::quantizeVector(ht1.data(), quantized_ht1.data(), out_size);
+
+        const auto kernel = [&](int row) {
+            return (T)quantization_detail::dot(&W[(size_t)(row * in_size)], quantized_ins.data(), in_size) * (W_scales[(size_t)row] * in_scale);
+        };
+        const auto recurrent = [&](int row) {
+            return (T)quantization_detail::dot(&U[(size_t)(row * out_size)], quantized_ht1.data(), out_size) * (U_scales[(size_t)row] * h_scale);
+        };
+
+        const auto* b0 = bias.data();
+        const auto* b1 = bias.data() + 3 * out_size;
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto z = quantization_detail::sigmoid(kernel(i) + recurrent(i) + b0[i] + b1[i]);
+            const auto r = quantization_detail::sigmoid(kernel(i + out_size) + recurrent(i + out_size) + b0[i + out_size] + b1[i + out_size]);
+            const auto c = std::tanh(kernel(i + 2 * out_size) + r * (recurrent(i + 2 * out_size) + b1[i + 2 * out_size]) + b0[i + 2 * out_size]);
+            h[i] = ((T)1 - z) * c + z * ht1[(size_t)i];
+        }
+
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        quantization_detail::quantizeChannels<T>([&wVals](int k, int i) { return wVals[(size_t)i][(size_t)k]; },
+            3 * Layer<T>::out_size, Layer<T>::in_size, W.data(), W_scales.data());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights array must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(T** wVals)
+    {
+        quantization_detail::quantizeChannels<T>([wVals](int k, int i) { return wVals[i][k]; },
+            3 * Layer<T>::out_size, Layer<T>::in_size, W.data(), W_scales.data());
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        quantization_detail::quantizeChannels<T>([&uVals](int k, int i) { return uVals[(size_t)i][(size_t)k]; },
+            3 * Layer<T>::out_size, Layer<T>::out_size, U.data(), U_scales.data());
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights array must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(T** uVals)
+    {
+        quantization_detail::quantizeChannels<T>([uVals](int k, int i) { return uVals[i][k]; },
+            3 * Layer<T>::out_size, Layer<T>::out_size, U.data(), U_scales.data());
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * Layer<T>::out_size, bias.begin() + i * 3 * Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias array must have size weights[2][3 * out_size]
+     */
+    void setBVals(T** bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[i], bVals[i] + 3 * Layer<T>::out_size, bias.begin() + i * 3 * Layer<T>::out_size);
+    }
+
+    /** Returns the (dequantized) kernel weight for the given indices. */
+    T getWVal(int i, int k) const noexcept
+    {
+        return (T)W[(size_t)(k * Layer<T>::in_size + i)] * W_scales[(size_t)k];
+    }
+
+    /** Returns the (dequantized) recurrent weight for the given indices. */
+    T getUVal(int i, int k) const noexcept
+    {
+        return (T)U[(size_t)(k * Layer<T>::out_size + i)] * U_scales[(size_t)k];
+    }
+
+    /** Returns the bias value for the given indices. */
+    T getBVal(int i, int k) const noexcept
+    {
+        return bias[(size_t)(i * 3 * Layer<T>::out_size + k)];
+    }
+
+private:
+    // weights[3 * out_size][in_size] and [3 * out_size][out_size], for the z, r, and c gates
+    std::vector<QType> W;
+    std::vector<T> W_scales;
+    std::vector<QType> U;
+    std::vector<T> U_scales;
+    std::vector<T> bias; // bias[2][3 * out_size]
+
+    std::vector<T> ht1;
+    std::vector<QType> quantized_ins;
+    std::vector<QType> quantized_ht1;
+};
+
+//====================================================
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * quantized kernel and recurrent weights.
+ *
+ * See QuantizedGRULayer for details about the quantization.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename QType = int8_t>
+class QuantizedGRULayerT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    QuantizedGRULayerT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(W), std::end(W), (QType)0);
+        std::fill(std::begin(W_scales), std::end(W_scales), (T)1);
+        std::fill(std::begin(U), std::end(U), (QType)0);
+        std::fill(std::begin(U_scales), std::end(U_scales), (T)1);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    void reset()
+    {
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        const auto in_scale = quantization_detail::quantizeVector(input, quantized_ins, in_size);
+        const auto h_scale = quantization_detail::quantizeVector(scalar_outs, quantized_ht1, out_size);
+
+        const auto kernel = [&](int row) {
+            return (T)quantization_detail::dot(W + row * in_size, quantized_ins, in_size) * (W_scales[row] * in_scale);
+        };
+        const auto recurrent = [&](int row) {
+            return (T)quantization_detail::dot(U + row * out_size, quantized_ht1, out_size) * (U_scales[row] * h_scale);
+        };
+
+        const auto* b0 = bias;
+        const auto* b1 = bias + 3 * out_size;
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto z = quantization_detail::sigmoid(kernel(i) + recurrent(i) + b0[i] + b1[i]);
+            const auto r = quantization_detail::sigmoid(kernel(i + out_size) + recurrent(i + out_size) + b0[i + out_size] + b1[i + out_size]);
+            const auto c = std::tanh(kernel(i + 2 * out_size) + r * (recurrent(i + 2 * out_size) + b1[i + 2 * out_size]) + b0[i + 2 * out_size]);
+
+            // the previous state has already been quantized, so it can be updated in place
+            scalar_outs[i] = ((T)1 - z) * c + z * scalar_outs[i];
+        }
+
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        quantization_detail::quantizeChannels<T>([&wVals](int k, int i) { return wVals[(size_t)i][(size_t)k]; },
+            3 * out_size, in_size, W, W_scales);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        quantization_detail::quantizeChannels<T>([&uVals](int k, int i) { return uVals[(size_t)i][(size_t)k]; },
+            3 * out_size, out_size, U, U_scales);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * out_size, bias + i * 3 * out_size);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // weights[3 * out_size][in_size] and [3 * out_size][out_size], for the z, r, and c gates
+    QType W[3 * out_size * in_size];
+    T W_scales[3 * out_size];
+    QType U[3 * out_size * out_size];
+    T U_scales[3 * out_size];
+    T bias[2 * 3 * out_size];
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+    QType quantized_ins[in_size];
+    QType quantized_ht1[out_size];
+
+    // the hidden state, padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // GRUQUANTIZED_H_INCLUDED
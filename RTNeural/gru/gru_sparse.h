@@ -0,0 +1,342 @@
+#ifndef GRUSPARSE_H_INCLUDED
+#define GRUSPARSE_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+#include "../sparse/sparse.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace sparse_detail
+{
+    /**
+     * Computes the GRU outputs from the gate products.
+     * The kernel products (including the kernel bias) and recurrent
+     * products have size [3 * out_size], for the z, r, and c gates.
+     */
+    template <typename T>
+    inline void gruOutputs(const T* kernel, const T* recurrent, const T* recurrentBias, const T* ht1, T* h, int out_size) noexcept
+    {
+        const auto* b1 = recurrentBias;
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto z = quantization_detail::sigmoid(kernel[i] + recurrent[i] + b1[i]);
+            const auto r = quantization_detail::sigmoid(kernel[i + out_size] + recurrent[i + out_size] + b1[i + out_size]);
+            const auto c = std::tanh(kernel[i + 2 * out_size] + r * (recurrent[i + 2 * out_size] + b1[i + 2 * out_size]));
+            h[i] = ((T)1 - z) * c + z * ht1[i];
+        }
+    }
+} // namespace sparse_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights.
+ *
+ * The recurrent weight matrix (U) is divided into blocks of
+ * block_rows x block_cols weights, and only the blocks that
+ * contain a non-zero weight are stored and multiplied (see
+ * SparseDense). This is useful for pruned networks, where the
+ * recurrent matrix product takes most of the processing time.
+ * The kernel weights are stored as a dense matrix, by column.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int block_rows = 1, int block_cols = 4>
+class SparseGRULayer final : public Layer<T>
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+public:
+    /** Constructs a sparse GRU layer for a given input and output size. */
+    SparseGRULayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , num_block_rows(ceil_div(3 * out_size, block_rows))
+        , W((size_t)(3 * out_size * in_size), (T)0)
+        , row_ptr((size_t)(num_block_rows + 1), 0)
+        , bias((size_t)(2 * 3 * out_size), (T)0)
+        , ht1((size_t)(ceil_div(out_size, block_cols) * block_cols), (T)0)
+        , kernel_outs((size_t)(3 * out_size), (T)0)
+        , recurrent_outs((size_t)(num_block_rows * block_rows), (T)0)
+    {
+    }
+
+    SparseGRULayer(std::initializer_list<int> sizes)
+        : SparseGRULayer(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Resets the state of the GRU. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gru"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        std::copy(bias.begin(), bias.begin() + 3 * out_size, kernel_outs.begin());
+        kernels.multiplyAddColumns(W.data(), 3 * out_size, in_size, input, kernel_outs.data());
+
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr.data(), col_idx.data(), U.data(),
+            num_block_rows, ht1.data(), recurrent_outs.data());
+
+        sparse_detail::gruOutputs(kernel_outs.data(), recurrent_outs.data(), bias.data() + 3 * out_size, ht1.data(), h, out_size);
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < Layer<T>::in_size; ++i)
+            std::copy(wVals[(size_t)i].begin(), wVals[(size_t)i].begin() + 3 * Layer<T>::out_size, W.begin() + i * 3 * Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        const auto getWeight = [&uVals](int row, int col) { return uVals[(size_t)col][(size_t)row]; };
+        const auto numBlocks = sparse_detail::countBlocks<block_rows, block_cols>(getWeight, 3 * Layer<T>::out_size, Layer<T>::out_size);
+        col_idx.resize((size_t)numBlocks);
+        U.resize((size_t)(numBlocks * block_rows * block_cols));
+        sparse_detail::packBlocks<T, block_rows, block_cols>(getWeight, 3 * Layer<T>::out_size, Layer<T>::out_size,
+            row_ptr.data(), col_idx.data(), U.data());
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * Layer<T>::out_size, bias.begin() + i * 3 * Layer<T>::out_size);
+    }
+
+    /** Returns the kernel weight for the given indices. */
+    T getWVal(int i, int k) const noexcept
+    {
+        return W[(size_t)(i * 3 * Layer<T>::out_size + k)];
+    }
+
+    /** Returns the recurrent weight for the given indices. */
+    T getUVal(int i, int k) const noexcept
+    {
+        const auto br = k / block_rows;
+        for(int b = row_ptr[(size_t)br]; b < row_ptr[(size_t)br + 1]; ++b)
+        {
+            if(col_idx[(size_t)b] == i / block_cols)
+                return U[(size_t)((b * block_rows + k % block_rows) * block_cols + i % block_cols)];
+        }
+
+        return (T)0;
+    }
+
+    /** Returns the bias value for the given indices. */
+    T getBVal(int i, int k) const noexcept
+    {
+        return bias[(size_t)(i * 3 * Layer<T>::out_size + k)];
+    }
+
+    /** Returns the number of recurrent weight blocks that are stored. */
+    int getNumBlocks() const noexcept { return (int)col_idx.size(); }
+
+private:
+    const int num_block_rows;
+
+    // kernel weights[in_size][3 * out_size], for the z, r, and c gates
+    std::vector<T> W;
+    dispatch::LayerKernels kernels;
+
+    // block-sparse recurrent weights[3 * out_size][out_size]
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<T> U;
+
+    std::vector<T> bias; // bias[2][3 * out_size]
+
+    std::vector<T> ht1; // padded to a whole number of block columns
+    std::vector<T> kernel_outs;
+    std::vector<T> recurrent_outs;
+};
+
+//====================================================
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * block-sparse recurrent weights.
+ *
+ * The number of non-zero blocks is only known once the weights
+ * are loaded, so the layer has space for every block of the
+ * recurrent weight matrix, but only the non-zero blocks are
+ * multiplied.
+ *
+ * See SparseGRULayer for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, int block_rows = 1, int block_cols = 4>
+class SparseGRULayerT
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+    static constexpr auto num_block_rows = ceil_div(3 * out_sizet, block_rows);
+    static constexpr auto num_block_cols = ceil_div(out_sizet, block_cols);
+    static constexpr auto max_blocks = num_block_rows * num_block_cols;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    SparseGRULayerT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(W), std::end(W), (T)0);
+        std::fill(std::begin(row_ptr), std::end(row_ptr), 0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(recurrent_outs), std::end(recurrent_outs), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+
+        std::copy(bias, bias + 3 * out_size, kernel_outs);
+        kernels.multiplyAddColumns(W, 3 * out_size, in_size, input, kernel_outs);
+
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr, col_idx, U, num_block_rows, ht1, recurrent_outs);
+
+        sparse_detail::gruOutputs(kernel_outs, recurrent_outs, bias + 3 * out_size, ht1, scalar_outs, out_size);
+        std::copy(scalar_outs, scalar_outs + out_size, ht1);
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+            std::copy(wVals[(size_t)i].begin(), wVals[(size_t)i].begin() + 3 * out_size, W + i * 3 * out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        num_blocks = sparse_detail::packBlocks<T, block_rows, block_cols>([&uVals](int row, int col) { return uVals[(size_t)col][(size_t)row]; },
+            3 * out_size, out_size, row_ptr, col_idx, U);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * out_size, bias + i * 3 * out_size);
+    }
+
+    /** Returns the number of non-zero recurrent weight blocks. */
+    int getNumBlocks() const noexcept { return num_blocks; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // kernel weights[in_size][3 * out_size], for the z, r, and c gates
+    T W alignas(RTNEURAL_DEFAULT_ALIGNMENT)[3 * out_size * in_size];
+    dispatch::LayerKernels kernels;
+
+    // block-sparse recurrent weights[3 * out_size][out_size]
+    int row_ptr[num_block_rows + 1];
+    int col_idx[max_blocks];
+    T U alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_blocks * block_rows * block_cols];
+    int num_blocks = 0;
+
+    T bias[2 * 3 * out_size];
+
+    T ht1 alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_block_cols * block_cols]; // padded to a whole number of block columns
+    T kernel_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[3 * out_size];
+    T recurrent_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_block_rows * block_rows];
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // GRUSPARSE_H_INCLUDED
@@ -14,8 +14,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class GRULayer : public Layer<T>
 {
 public:
@@ -27,7 +31,19 @@ public:
     virtual ~GRULayer();
 
     /** Resets the state of the GRU. */
-    void reset() override { std::fill(ht1.begin(), ht1.end(), (T)0); }
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        outs_delayed.reset();
+    }
+
+    /**
+     * Prepares the GRU to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
 
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "gru"; }
@@ -45,23 +61,26 @@ public:
 
         vAdd(zVec.data(), zWeights.b[0].data(), zVec.data(), Layer<T>::out_size);
         vAdd(zVec.data(), zWeights.b[1].data(), zVec.data(), Layer<T>::out_size);
-        sigmoid(zVec.data(), zVec.data(), Layer<T>::out_size);
+        vApply(zVec.data(), zVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
 
         vAdd(rVec.data(), rWeights.b[0].data(), rVec.data(), Layer<T>::out_size);
         vAdd(rVec.data(), rWeights.b[1].data(), rVec.data(), Layer<T>::out_size);
-        sigmoid(rVec.data(), rVec.data(), Layer<T>::out_size);
+        vApply(rVec.data(), rVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
 
         vAdd(cTmp.data(), cWeights.b[1].data(), cTmp.data(), Layer<T>::out_size);
         vProd(cTmp.data(), rVec.data(), cTmp.data(), Layer<T>::out_size);
         vAdd(cTmp.data(), cVec.data(), cVec.data(), Layer<T>::out_size);
         vAdd(cVec.data(), cWeights.b[0].data(), cVec.data(), Layer<T>::out_size);
-        tanh(cVec.data(), cVec.data(), Layer<T>::out_size);
+        vApply(cVec.data(), cVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::tanh(x); });
 
         vSub(ones.data(), zVec.data(), h, Layer<T>::out_size);
         vProd(h, cVec.data(), h, Layer<T>::out_size);
         vProd(zVec.data(), ht1.data(), prod_out.data(), Layer<T>::out_size);
         vAdd(h, prod_out.data(), h, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+            outs_delayed.process(h);
+
         vCopy(h, ht1.data(), Layer<T>::out_size);
     }
 
@@ -93,6 +112,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -100,6 +126,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -107,6 +140,13 @@ public:
      */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /**
+     * Sets the layer bias from a weights view.
+     * 
+     * The bias view must have size weights[2][3 * out_size]
+     */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     /** Returns the kernel weight for the given indices. */
     T getWVal(int i, int k) const noexcept;
 
@@ -117,11 +157,14 @@ public:
     T getBVal(int i, int k) const noexcept;
 
 protected:
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
     using vec2_type = std::vector<vec_type>;
 
     vec_type ht1;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     struct WeightSet
     {
         WeightSet(int in_size, int out_size);
@@ -155,8 +198,16 @@ protected:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class GRULayerT
 {
     using v_type = xsimd::simd_type<T>;
@@ -164,6 +215,10 @@ class GRULayerT
     static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
     static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
 
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<std::array<v_type, v_out_size>, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -198,19 +253,19 @@ public:
         recurrent_mat_mul(outs, Uz, zt);
         kernel_mat_mul(ins, Wz, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            zt[i] = sigmoid(zt[i] + bz[i] + kernel_outs[i]);
+            zt[i] = MathsProvider::sigmoid(zt[i] + bz[i] + kernel_outs[i]);
 
         // compute rt
         recurrent_mat_mul(outs, Ur, rt);
         kernel_mat_mul(ins, Wr, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            rt[i] = sigmoid(rt[i] + br[i] + kernel_outs[i]);
+            rt[i] = MathsProvider::sigmoid(rt[i] + br[i] + kernel_outs[i]);
 
         // compute h_hat
         recurrent_mat_mul(outs, Uh, ct);
         kernel_mat_mul(ins, Wh, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            ht[i] = xsimd::tanh(xsimd::fma(rt[i], ct[i] + bh1[i], bh0[i] + kernel_outs[i]));
+            ht[i] = MathsProvider::tanh(xsimd::fma(rt[i], ct[i] + bh1[i], bh0[i] + kernel_outs[i]));
 
         computeOutput();
     }
@@ -223,17 +278,17 @@ public:
         // compute zt
         recurrent_mat_mul(outs, Uz, zt);
         for(int i = 0; i < v_out_size; ++i)
-            zt[i] = sigmoid(xsimd::fma(Wz_1[i], ins[0], zt[i] + bz[i]));
+            zt[i] = MathsProvider::sigmoid(xsimd::fma(Wz_1[i], ins[0], zt[i] + bz[i]));
 
         // compute rt
         recurrent_mat_mul(outs, Ur, rt);
         for(int i = 0; i < v_out_size; ++i)
-            rt[i] = sigmoid(xsimd::fma(Wr_1[i], ins[0], rt[i] + br[i]));
+            rt[i] = MathsProvider::sigmoid(xsimd::fma(Wr_1[i], ins[0], rt[i] + br[i]));
 
         // compute h_hat
         recurrent_mat_mul(outs, Uh, ct);
         for(int i = 0; i < v_out_size; ++i)
-            ht[i] = xsimd::tanh(xsimd::fma(rt[i], ct[i] + bh1[i], xsimd::fma(Wh_1[i], ins[0], bh0[i])));
+            ht[i] = MathsProvider::tanh(xsimd::fma(rt[i], ct[i] + bh1[i], xsimd::fma(Wh_1[i], ins[0], bh0[i])));
 
         computeOutput();
     }
@@ -245,6 +300,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -252,6 +314,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -259,6 +328,13 @@ public:
      */
     void setBVals(const std::vector<std::vector<T>>& bVals);
 
+    /**
+     * Sets the layer bias from a weights view.
+     * 
+     * The bias view must have size weights[2][3 * out_size]
+     */
+    void setBVals(const WeightsView<T, 2>& bVals);
+
     v_type outs[v_out_size];
 
 private:
@@ -275,37 +351,32 @@ private:
     computeOutput() noexcept
     {
         for(int i = 0; i < v_out_size; ++i)
-            outs_delayed[delayWriteIdx][i] = xsimd::fma((v_type((T)1.0) - zt[i]), ht[i], zt[i] * outs[i]);
+            outs_delayed.writeFrame()[i] = xsimd::fma((v_type((T)1.0) - zt[i]), ht[i], zt[i] * outs[i]);
 
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(outs_delayed, outs);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<std::array<v_type, v_out_size>>& delayVec, v_type (&out)[v_out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, v_type (&out)[v_out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
         for(int i = 0; i < v_out_size; ++i)
-            out[i] = delayVec[0][i];
+            out[i] = delayed[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < v_out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<std::array<v_type, v_out_size>>& delayVec, v_type (&out)[v_out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, v_type (&out)[v_out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
+        const auto& delayedMinus1 = delayBuffer.read(delayOffset - 1);
         for(int i = 0; i < v_out_size; ++i)
-            out[i] = delayPlus1Mult * delayVec[0][i] + delayMult * delayVec[1][i];
+            out[i] = delayPlus1Mult * delayed[i] + delayMult * delayedMinus1[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < v_out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     static inline void recurrent_mat_mul(const v_type (&vec)[v_out_size], const v_type (&mat)[out_size][v_out_size], v_type (&out)[v_out_size]) noexcept
@@ -342,11 +413,6 @@ private:
         }
     }
 
-    static inline v_type sigmoid(v_type x) noexcept
-    {
-        return (T)1.0 / ((T)1.0 + xsimd::exp(-x));
-    }
-
     // kernel weights
     v_type Wz[in_size][v_out_size];
     v_type Wr[in_size][v_out_size];
@@ -376,8 +442,8 @@ private:
     v_type ht[v_out_size];
 
     // needed for delays when doing sample rate correction
-    std::vector<std::array<v_type, v_out_size>> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     v_type delayMult = (T)1;
     v_type delayPlus1Mult = (T)0;
 };
@@ -3,8 +3,8 @@
 namespace RTNeural
 {
 
-template <typename T>
-GRULayer<T>::GRULayer(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
     , zWeights(in_size, out_size)
     , rWeights(in_size, out_size)
@@ -22,29 +22,29 @@ GRULayer<T>::GRULayer(int in_size, int out_size)
     ones.resize(out_size, (T)1);
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(std::initializer_list<int> sizes)
-    : GRULayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(std::initializer_list<int> sizes)
+    : GRULayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-GRULayer<T>::GRULayer(const GRULayer<T>& other)
-    : GRULayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::GRULayer(const GRULayer<T, MathsProvider>& other)
+    : GRULayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-GRULayer<T>& GRULayer<T>::operator=(const GRULayer<T>& other)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>& GRULayer<T, MathsProvider>::operator=(const GRULayer<T, MathsProvider>& other)
 {
-    return *this = GRULayer<T>(other);
+    return *this = GRULayer<T, MathsProvider>(other);
 }
 
-template <typename T>
-GRULayer<T>::~GRULayer() = default;
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::~GRULayer() = default;
 
-template <typename T>
-GRULayer<T>::WeightSet::WeightSet(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
     : out_size(out_size)
 {
     W = vec2_type(out_size, vec_type(in_size, (T)0));
@@ -54,11 +54,18 @@ GRULayer<T>::WeightSet::WeightSet(int in_size, int out_size)
     b[1].resize(out_size, (T)0);
 }
 
-template <typename T>
-GRULayer<T>::WeightSet::~WeightSet() = default;
+template <typename T, typename MathsProvider>
+GRULayer<T, MathsProvider>::WeightSet::~WeightSet() = default;
 
-template <typename T>
-void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -71,8 +78,22 @@ void GRULayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setWVals(T** wVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.W[k][i] = wVals(i, k);
+            rWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setWVals(T** wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -85,8 +106,8 @@ void GRULayer<T>::setWVals(T** wVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -99,8 +120,22 @@ void GRULayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setUVals(T** uVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.U[k][i] = uVals(i, k);
+            rWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setUVals(T** uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -113,8 +148,8 @@ void GRULayer<T>::setUVals(T** uVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -127,8 +162,22 @@ void GRULayer<T>::setBVals(const std::vector<std::vector<T>>& bVals)
     }
 }
 
-template <typename T>
-void GRULayer<T>::setBVals(T** bVals)
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            zWeights.b[i][k] = bVals(i, k);
+            rWeights.b[i][k] = bVals(i, k + Layer<T>::out_size);
+            cWeights.b[i][k] = bVals(i, k + Layer<T>::out_size * 2);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void GRULayer<T, MathsProvider>::setBVals(T** bVals)
 {
     for(int i = 0; i < 2; ++i)
     {
@@ -141,8 +190,8 @@ void GRULayer<T>::setBVals(T** bVals)
     }
 }
 
-template <typename T>
-T GRULayer<T>::getWVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getWVal(int i, int k) const noexcept
 {
     T** set = zWeights.W;
     if(k > 2 * Layer<T>::out_size)
@@ -159,8 +208,8 @@ T GRULayer<T>::getWVal(int i, int k) const noexcept
     return set[i][k];
 }
 
-template <typename T>
-T GRULayer<T>::getUVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getUVal(int i, int k) const noexcept
 {
     T** set = zWeights.U;
     if(k > 2 * Layer<T>::out_size)
@@ -177,8 +226,8 @@ T GRULayer<T>::getUVal(int i, int k) const noexcept
     return set[i][k];
 }
 
-template <typename T>
-T GRULayer<T>::getBVal(int i, int k) const noexcept
+template <typename T, typename MathsProvider>
+T GRULayer<T, MathsProvider>::getBVal(int i, int k) const noexcept
 {
     T** set = zWeights.b;
     if(k > 2 * Layer<T>::out_size)
@@ -196,8 +245,8 @@ T GRULayer<T>::getBVal(int i, int k) const noexcept
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::GRULayerT()
 {
     for(int i = 0; i < v_out_size; ++i)
     {
@@ -244,39 +293,38 @@ GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::GRULayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& vec : outs_delayed)
-            std::fill(vec.begin(), vec.end(), v_type {});
+        outs_delayed.reset({});
     }
 
     // reset output state
@@ -285,8 +333,8 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
 }
 
 // kernel weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -306,9 +354,30 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            Wz[k][i / v_size] = set_value(Wz[k][i / v_size], i % v_size, wVals(k, i));
+            Wr[k][i / v_size] = set_value(Wr[k][i / v_size], i % v_size, wVals(k, i + out_size));
+            Wh[k][i / v_size] = set_value(Wh[k][i / v_size], i % v_size, wVals(k, i + 2 * out_size));
+        }
+    }
+
+    for(int j = 0; j < out_size; ++j)
+    {
+        Wz_1[j / v_size] = set_value(Wz_1[j / v_size], j % v_size, wVals(0, j));
+        Wr_1[j / v_size] = set_value(Wr_1[j / v_size], j % v_size, wVals(0, j + out_size));
+        Wh_1[j / v_size] = set_value(Wh_1[j / v_size], j % v_size, wVals(0, j + 2 * out_size));
+    }
+}
+
 // recurrent weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -321,9 +390,23 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            Uz[k][i / v_size] = set_value(Uz[k][i / v_size], i % v_size, uVals(k, i));
+            Ur[k][i / v_size] = set_value(Ur[k][i / v_size], i % v_size, uVals(k, i + out_size));
+            Uh[k][i / v_size] = set_value(Uh[k][i / v_size], i % v_size, uVals(k, i + 2 * out_size));
+        }
+    }
+}
+
 // biases
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<std::vector<T>>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<std::vector<T>>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
@@ -334,4 +417,16 @@ void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vect
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void GRULayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const WeightsView<T, 2>& bVals)
+{
+    for(int k = 0; k < out_size; ++k)
+    {
+        bz[k / v_size] = set_value(bz[k / v_size], k % v_size, bVals(0, k) + bVals(1, k));
+        br[k / v_size] = set_value(br[k / v_size], k % v_size, bVals(0, k + out_size) + bVals(1, k + out_size));
+        bh0[k / v_size] = set_value(bh0[k / v_size], k % v_size, bVals(0, k + 2 * out_size));
+        bh1[k / v_size] = set_value(bh1[k / v_size], k % v_size, bVals(1, k + 2 * out_size));
+    }
+}
+
 } // namespace RTNeural
@@ -0,0 +1,303 @@
+#ifndef HALFPRECISION_H_INCLUDED
+#define HALFPRECISION_H_INCLUDED
+
+#include "../common.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace half_precision_detail
+{
+    /** The number of weights that are widened to float at a time. */
+    constexpr int block_size = 8;
+
+    /** Holds a block of weights, widened to float (in a vector register, if possible, see lanes_detail). */
+    template <typename F, bool is_vector = lanes_detail::LaneVector<F, block_size>::is_vector>
+    struct FloatBlock
+    {
+        using type = F[block_size];
+    };
+
+    template <typename F>
+    struct FloatBlock<F, true>
+    {
+        using type = typename lanes_detail::LaneVector<F, block_size>::type;
+    };
+
+    using float_block_type = FloatBlock<float>::type;
+
+    inline uint32_t floatToBits(float x) noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(float));
+        return bits;
+    }
+
+    inline float bitsToFloat(uint32_t bits) noexcept
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(float));
+        return x;
+    }
+
+    /** Converts a float to IEEE 754 half-precision, with round-to-nearest-even. */
+    inline uint16_t floatToHalfBits(float value) noexcept
+    {
+        auto x = floatToBits(value);
+        const auto sign = (uint16_t)((x >> 16) & 0x8000u);
+        x &= 0x7FFFFFFFu;
+
+        if(x >= 0x7F800000u) // infinity or NaN (NaNs stay quiet NaNs)
+            return (uint16_t)(sign | 0x7C00u | (x > 0x7F800000u ? 0x0200u : 0u));
+
+        if(x >= 0x477FF000u) // rounds to a value larger than the largest half (65504)
+            return (uint16_t)(sign | 0x7C00u);
+
+        if(x < 0x38800000u) // smaller than the smallest normal half (2^-14)
+        {
+            if(x <= 0x33000000u) // rounds to zero (2^-25 is a tie, which rounds to even)
+                return sign;
+
+            const auto exponent = x >> 23;
+            const auto mantissa = (x & 0x007FFFFFu) | 0x00800000u;
+            const auto shift = 126u - exponent;
+            const auto halfway = 1u << (shift - 1u);
+            const auto remainder = mantissa & ((1u << shift) - 1u);
+
+            auto halfMantissa = mantissa >> shift;
+            if(remainder > halfway || (remainder == halfway && (halfMantissa & 1u)))
+                ++halfMantissa;
+
+            return (uint16_t)(sign | halfMantissa);
+        }
+
+        // re-bias the exponent from 127 to 15, and round the mantissa from 23 to 10 bits
+        auto half = (x - 0x38000000u) >> 13;
+        const auto remainder = x & 0x1FFFu;
+        if(remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            ++half;
+
+        return (uint16_t)(sign | half);
+    }
+
+    /** Converts an IEEE 754 half-precision value to float (this conversion is exact). */
+    inline float halfBitsToFloat(uint16_t half) noexcept
+    {
+        const auto sign = (uint32_t)(half & 0x8000u) << 16;
+        const auto exponent = (uint32_t)(half >> 10) & 0x1Fu;
+        auto mantissa = (uint32_t)half & 0x03FFu;
+
+        if(exponent == 0x1Fu) // infinity or NaN
+            return bitsToFloat(sign | 0x7F800000u | (mantissa << 13));
+
+        if(exponent != 0u)
+            return bitsToFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+
+        if(mantissa == 0u)
+            return bitsToFloat(sign);
+
+        // subnormal half, which is a normal float
+        auto floatExponent = 113u;
+        while((mantissa & 0x0400u) == 0u)
+        {
+            mantissa <<= 1;
+            --floatExponent;
+        }
+
+        return bitsToFloat(sign | (floatExponent << 23) | ((mantissa & 0x03FFu) << 13));
+    }
+
+    /** Converts a float to bfloat16, with round-to-nearest-even. */
+    inline uint16_t floatToBFloat16Bits(float value) noexcept
+    {
+        const auto x = floatToBits(value);
+        if((x & 0x7FFFFFFFu) > 0x7F800000u) // NaN (keep it a quiet NaN)
+            return (uint16_t)((x >> 16) | 0x0040u);
+
+        return (uint16_t)((x + 0x7FFFu + ((x >> 16) & 1u)) >> 16);
+    }
+
+    /** Converts a bfloat16 value to float (this conversion is exact). */
+    inline float bFloat16BitsToFloat(uint16_t bits) noexcept
+    {
+        return bitsToFloat((uint32_t)bits << 16);
+    }
+} // namespace half_precision_detail
+#endif // DOXYGEN
+
+/**
+ * IEEE 754 half-precision (fp16) storage type.
+ *
+ * Values are only stored in half-precision: they are converted
+ * to float for any computation. When compiling with F16C support
+ * (e.g. `-mf16c`), the hardware conversion instructions are used.
+ */
+struct Float16
+{
+    uint16_t bits;
+
+    /** Returns the half-precision value nearest to x. */
+    static inline Float16 fromFloat(float x) noexcept
+    {
+#if defined(__F16C__)
+        return { (uint16_t)_cvtss_sh(x, 0) }; // round to nearest even
+#else
+        return { half_precision_detail::floatToHalfBits(x) };
+#endif
+    }
+
+    /** Returns this value as a float. */
+    inline float toFloat() const noexcept
+    {
+#if defined(__F16C__)
+        return _cvtsh_ss(bits);
+#else
+        return half_precision_detail::halfBitsToFloat(bits);
+#endif
+    }
+
+    /** Widens 8 consecutive values to float. */
+    static inline void toFloat8(const Float16* in, half_precision_detail::float_block_type& out) noexcept
+    {
+#if defined(__F16C__)
+        const auto widened = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+        std::memcpy(&out, &widened, sizeof(out));
+#else
+        for(int k = 0; k < 8; ++k)
+            out[k] = in[k].toFloat();
+#endif
+    }
+};
+
+/**
+ * bfloat16 storage type (the upper 16 bits of a float).
+ *
+ * bfloat16 has the same range as float, with 8 bits of
+ * precision (compared to 11 bits for Float16).
+ */
+struct BFloat16
+{
+    uint16_t bits;
+
+    /** Returns the bfloat16 value nearest to x. */
+    static inline BFloat16 fromFloat(float x) noexcept
+    {
+        return { half_precision_detail::floatToBFloat16Bits(x) };
+    }
+
+    /** Returns this value as a float. */
+    inline float toFloat() const noexcept
+    {
+        return half_precision_detail::bFloat16BitsToFloat(bits);
+    }
+
+    /** Widens 8 consecutive values to float. */
+    static inline void toFloat8(const BFloat16* in, half_precision_detail::float_block_type& out) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        // shift the bits of each value into the upper half of a 32-bit lane
+        using bits16_type = lanes_detail::LaneVector<uint16_t, 8>::type;
+        using bits32_type = lanes_detail::LaneVector<uint32_t, 8>::type;
+
+        bits16_type bits;
+        std::memcpy(&bits, in, sizeof(bits));
+        const auto widened = __builtin_convertvector(bits, bits32_type) << 16;
+        std::memcpy(&out, &widened, sizeof(out));
+#else
+        for(int k = 0; k < 8; ++k)
+            out[k] = in[k].toFloat();
+#endif
+    }
+};
+
+#ifndef DOXYGEN
+namespace half_precision_detail
+{
+    /** Converts a floating-point value to a half-precision storage type. */
+    template <typename HalfType, typename T>
+    inline HalfType fromFloat(T x) noexcept
+    {
+        return HalfType::fromFloat((float)x);
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    /** Returns the dot product of a vector of half-precision weights and a vector of inputs, with vector lanes. */
+    template <typename HalfType, typename T>
+    inline T dot(const HalfType* weights, const T* x, int size, std::true_type) noexcept
+    {
+        using lanes_type = typename lanes_detail::LaneVector<T, block_size>::type;
+
+        lanes_type acc {};
+        lanes_type xLanes;
+        float_block_type weightsBlock;
+
+        int k = 0;
+        for(; k + block_size <= size; k += block_size)
+        {
+            HalfType::toFloat8(weights + k, weightsBlock);
+            std::memcpy(&xLanes, x + k, sizeof(lanes_type));
+            acc += __builtin_convertvector(weightsBlock, lanes_type) * xLanes;
+        }
+
+        T sum = acc[0];
+        for(int j = 1; j < block_size; ++j)
+            sum += acc[j];
+
+        for(; k < size; ++k)
+            sum += (T)weights[k].toFloat() * x[k];
+
+        return sum;
+    }
+#endif
+
+    /** Returns the dot product of a vector of half-precision weights and a vector of inputs, with scalar lanes. */
+    template <typename HalfType, typename T>
+    inline T dot(const HalfType* weights, const T* x, int size, std::false_type) noexcept
+    {
+        T acc[block_size] {};
+        float_block_type weightsBlock;
+
+        int k = 0;
+        for(; k + block_size <= size; k += block_size)
+        {
+            HalfType::toFloat8(weights + k, weightsBlock);
+            for(int j = 0; j < block_size; ++j)
+                acc[j] += (T)weightsBlock[j] * x[k + j];
+        }
+
+        T sum = acc[0];
+        for(int j = 1; j < block_size; ++j)
+            sum += acc[j];
+
+        for(; k < size; ++k)
+            sum += (T)weights[k].toFloat() * x[k];
+
+        return sum;
+    }
+
+    /**
+     * Returns the dot product of a vector of half-precision weights with a
+     * vector of inputs. The weights are widened to float in blocks of 8
+     * (in a vector register, with GCC and Clang), and the products are
+     * accumulated with type T, with one accumulator per lane. The lanes
+     * are only added together at the end.
+     */
+    template <typename HalfType, typename T>
+    inline T dot(const HalfType* weights, const T* x, int size) noexcept
+    {
+        return dot(weights, x, size, std::integral_constant<bool, lanes_detail::LaneVector<T, block_size>::is_vector> {});
+    }
+} // namespace half_precision_detail
+#endif // DOXYGEN
+
+} // namespace RTNeural
+
+#endif // HALFPRECISION_H_INCLUDED
@@ -0,0 +1,1028 @@
+#ifndef HALFPRECISIONLAYERS_H_INCLUDED
+#define HALFPRECISIONLAYERS_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+#include "half_precision.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer,
+ * with half-precision weights and no activation.
+ *
+ * The weights are stored as `HalfType` (Float16 or BFloat16),
+ * which uses half the memory of float weights. The weights are
+ * widened to float as they are used, and the computation is done
+ * with type T.
+ */
+template <typename T, typename HalfType = Float16>
+class HalfDense final : public Layer<T>
+{
+public:
+    /** Constructs a half-precision dense layer for a given input and output size. */
+    HalfDense(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , weights((size_t)(in_size * out_size), HalfType::fromFloat(0.0f))
+        , bias((size_t)out_size, (T)0)
+    {
+    }
+
+    HalfDense(std::initializer_list<int> sizes)
+        : HalfDense(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            out[i] = bias[(size_t)i] + half_precision_detail::dot(&weights[(size_t)(i * in_size)], input, in_size);
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[(size_t)(i * Layer<T>::in_size + k)] = half_precision_detail::fromFloat<HalfType>(newWeights[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < Layer<T>::in_size; ++k)
+                weights[(size_t)(i * Layer<T>::in_size + k)] = half_precision_detail::fromFloat<HalfType>(newWeights[i][k]);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the (widened) weight connecting input k to output i. */
+    T getWeight(int i, int k) const noexcept
+    {
+        return (T)weights[(size_t)(i * Layer<T>::in_size + k)].toFloat();
+    }
+
+    /** Returns the bias value for output i. */
+    T getBias(int i) const noexcept { return bias[(size_t)i]; }
+
+private:
+    std::vector<HalfType> weights; // weights[out_size][in_size]
+    std::vector<T> bias;
+};
+
+//====================================================
+/**
+ * Static implementation of a fully-connected (dense) layer,
+ * with half-precision weights and no activation.
+ *
+ * See HalfDense for details.
+ */
+template <typename T, int in_sizet, int out_sizet, typename HalfType = Float16>
+class HalfDenseT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    HalfDenseT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "dense"; }
+
+    /** Returns false since dense is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Reset is a no-op, since Dense does not have state. */
+    void reset() { }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        for(int i = 0; i < out_size; ++i)
+            scalar_outs[i] = bias[i] + half_precision_detail::dot(weights + i * in_size, input, in_size);
+
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer weights from a given vector.
+     *
+     * The dimension of the weights vector must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(const std::vector<std::vector<T>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i * in_size + k] = half_precision_detail::fromFloat<HalfType>(newWeights[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer weights from a given array.
+     *
+     * The dimension of the weights array must be
+     * weights[out_size][in_size]
+     */
+    void setWeights(T** newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                weights[i * in_size + k] = half_precision_detail::fromFloat<HalfType>(newWeights[i][k]);
+    }
+
+    /**
+     * Sets the layer bias from a given array of size
+     * bias[out_size]
+     */
+    void setBias(const T* b)
+    {
+        std::copy(b, b + out_size, bias);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    HalfType weights[out_size * in_size]; // weights[out_size][in_size]
+    T bias[out_size];
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a 1-dimensional convolution layer
+ * with half-precision weights, no activation, and no stride.
+ *
+ * The weights are stored as `HalfType` (Float16 or BFloat16),
+ * and are widened to float as they are used. The layer state
+ * is stored with type T.
+ *
+ * This implementation was designed to be used for "temporal
+ * convolution", so the input to each call to `forward()` should
+ * be one frame of the input signal.
+ */
+template <typename T, typename HalfType = Float16>
+class HalfConv1D final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a half-precision convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param out_size: the output size for the layer
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    HalfConv1D(int in_size, int out_size, int kernel_size, int dilation)
+        : Layer<T>(in_size, out_size)
+        , kernel_size(kernel_size)
+        , dilation_rate(dilation)
+        , state_size((kernel_size - 1) * dilation + 1)
+        , weights((size_t)(out_size * kernel_size * in_size), HalfType::fromFloat(0.0f))
+        , bias((size_t)out_size, (T)0)
+        , state((size_t)(2 * state_size * in_size), (T)0)
+    {
+    }
+
+    HalfConv1D(std::initializer_list<int> sizes)
+        : HalfConv1D(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+    {
+    }
+
+    /** Resets the layer state. */
+    void reset() override
+    {
+        std::fill(state.begin(), state.end(), (T)0);
+        state_ptr = 0;
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv1d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+
+        // insert the new input frame into the double-buffered state
+        std::copy(input, input + in_size, &state[(size_t)(state_ptr * in_size)]);
+        std::copy(input, input + in_size, &state[(size_t)((state_ptr + state_size) * in_size)]);
+
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+        {
+            const auto* channel_weights = &weights[(size_t)(i * kernel_size * in_size)];
+
+            T sum = bias[(size_t)i];
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                const auto tap = state_ptr + j * dilation_rate;
+                sum += half_precision_detail::dot(channel_weights + j * in_size, &state[(size_t)(tap * in_size)], in_size);
+            }
+
+            out[i] = sum;
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size][kernel_size]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& newWeights)
+    {
+        const auto in_size = Layer<T>::in_size;
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[(size_t)((i * kernel_size + j) * in_size + k)] = half_precision_detail::fromFloat<HalfType>(newWeights[(size_t)i][(size_t)k][(size_t)j]);
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    /** Returns the (widened) weight for a given output, input, and kernel index. */
+    T getWeight(int outIndex, int inIndex, int kernelIndex) const noexcept
+    {
+        return (T)weights[(size_t)((outIndex * kernel_size + kernelIndex) * Layer<T>::in_size + inIndex)].toFloat();
+    }
+
+private:
+    const int kernel_size;
+    const int dilation_rate;
+    const int state_size;
+
+    // weights[out_size][kernel_size][in_size], with the most recent input at kernel index 0
+    std::vector<HalfType> weights;
+    std::vector<T> bias;
+
+    // state[2 * state_size][in_size]
+    std::vector<T> state;
+    int state_ptr = 0;
+};
+
+//====================================================
+/**
+ * Static implementation of a 1-dimensional convolution layer
+ * with half-precision weights, no activation, and no stride.
+ *
+ * See HalfConv1D for details.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param out_sizet: the output size for the layer
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ */
+template <typename T, int in_sizet, int out_sizet, int kernel_size, int dilation_rate, typename HalfType = Float16>
+class HalfConv1DT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+    static constexpr auto state_size = (kernel_size - 1) * dilation_rate + 1;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    HalfConv1DT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(weights), std::end(weights), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset()
+    {
+        std::fill(std::begin(state), std::end(state), (T)0);
+        state_ptr = 0;
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        // insert the new input frame into the double-buffered state
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+        std::copy(input, input + in_size, state + state_ptr * in_size);
+        std::copy(input, input + in_size, state + (state_ptr + state_size) * in_size);
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto* channel_weights = weights + i * kernel_size * in_size;
+
+            T sum = bias[i];
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                const auto tap = state_ptr + j * dilation_rate;
+                sum += half_precision_detail::dot(channel_weights + j * in_size, state + tap * in_size, in_size);
+            }
+
+            scalar_outs[i] = sum;
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[out_size][in_size][kernel_size]
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& newWeights)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < in_size; ++k)
+                for(int j = 0; j < kernel_size; ++j)
+                    weights[(i * kernel_size + j) * in_size + k] = half_precision_detail::fromFloat<HalfType>(newWeights[(size_t)i][(size_t)k][(size_t)j]);
+    }
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[out_size]
+     */
+    void setBias(const std::vector<T>& biasVals)
+    {
+        std::copy(biasVals.begin(), biasVals.begin() + out_size, bias);
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // weights[out_size][kernel_size][in_size], with the most recent input at kernel index 0
+    HalfType weights[out_size * kernel_size * in_size];
+    T bias[out_size];
+
+    // state[2 * state_size][in_size]
+    T state[2 * state_size * in_size];
+    int state_ptr = 0;
+
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * half-precision kernel and recurrent weights.
+ *
+ * The weights are stored as `HalfType` (Float16 or BFloat16),
+ * and are widened to float as they are used. The biases and
+ * the recurrent state are stored with type T.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename HalfType = Float16>
+class HalfGRULayer final : public Layer<T>
+{
+public:
+    /** Constructs a half-precision GRU layer for a given input and output size. */
+    HalfGRULayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , W((size_t)(3 * out_size * in_size), HalfType::fromFloat(0.0f))
+        , U((size_t)(3 * out_size * out_size), HalfType::fromFloat(0.0f))
+        , bias((size_t)(2 * 3 * out_size), (T)0)
+        , ht1((size_t)out_size, (T)0)
+    {
+    }
+
+    HalfGRULayer(std::initializer_list<int> sizes)
+        : HalfGRULayer(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Resets the state of the GRU. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gru"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        const auto kernel = [&](int row) { return half_precision_detail::dot(&W[(size_t)(row * in_size)], input, in_size); };
+        const auto recurrent = [&](int row) { return half_precision_detail::dot(&U[(size_t)(row * out_size)], ht1.data(), out_size); };
+
+        const auto* b0 = bias.data();
+        const auto* b1 = bias.data() + 3 * out_size;
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto z = quantization_detail::sigmoid(kernel(i) + recurrent(i) + b0[i] + b1[i]);
+            const auto r = quantization_detail::sigmoid(kernel(i + out_size) + recurrent(i + out_size) + b0[i + out_size] + b1[i + out_size]);
+            const auto c = std::tanh(kernel(i + 2 * out_size) + r * (recurrent(i + 2 * out_size) + b1[i + 2 * out_size]) + b0[i + 2 * out_size]);
+            h[i] = ((T)1 - z) * c + z * ht1[(size_t)i];
+        }
+
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < Layer<T>::in_size; ++i)
+            for(int k = 0; k < 3 * Layer<T>::out_size; ++k)
+                W[(size_t)(k * Layer<T>::in_size + i)] = half_precision_detail::fromFloat<HalfType>(wVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < 3 * Layer<T>::out_size; ++k)
+                U[(size_t)(k * Layer<T>::out_size + i)] = half_precision_detail::fromFloat<HalfType>(uVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * Layer<T>::out_size, bias.begin() + i * 3 * Layer<T>::out_size);
+    }
+
+    /** Returns the (widened) kernel weight for the given indices. */
+    T getWVal(int i, int k) const noexcept
+    {
+        return (T)W[(size_t)(k * Layer<T>::in_size + i)].toFloat();
+    }
+
+    /** Returns the (widened) recurrent weight for the given indices. */
+    T getUVal(int i, int k) const noexcept
+    {
+        return (T)U[(size_t)(k * Layer<T>::out_size + i)].toFloat();
+    }
+
+    /** Returns the bias value for the given indices. */
+    T getBVal(int i, int k) const noexcept
+    {
+        return bias[(size_t)(i * 3 * Layer<T>::out_size + k)];
+    }
+
+private:
+    // weights[3 * out_size][in_size] and [3 * out_size][out_size], for the z, r, and c gates
+    std::vector<HalfType> W;
+    std::vector<HalfType> U;
+    std::vector<T> bias; // bias[2][3 * out_size]
+
+    std::vector<T> ht1;
+};
+
+//====================================================
+/**
+ * Static implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, and
+ * half-precision kernel and recurrent weights.
+ *
+ * See HalfGRULayer for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename HalfType = Float16>
+class HalfGRULayerT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    HalfGRULayerT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(W), std::end(W), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(U), std::end(U), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "gru"; }
+
+    /** Returns false since GRU is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the GRU. */
+    void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+
+        const auto kernel = [&](int row) { return half_precision_detail::dot(W + row * in_size, input, in_size); };
+        const auto recurrent = [&](int row) { return half_precision_detail::dot(U + row * out_size, ht1, out_size); };
+
+        const auto* b0 = bias;
+        const auto* b1 = bias + 3 * out_size;
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto z = quantization_detail::sigmoid(kernel(i) + recurrent(i) + b0[i] + b1[i]);
+            const auto r = quantization_detail::sigmoid(kernel(i + out_size) + recurrent(i + out_size) + b0[i + out_size] + b1[i + out_size]);
+            const auto c = std::tanh(kernel(i + 2 * out_size) + r * (recurrent(i + 2 * out_size) + b1[i + 2 * out_size]) + b0[i + 2 * out_size]);
+            scalar_outs[i] = ((T)1 - z) * c + z * ht1[i];
+        }
+
+        std::copy(scalar_outs, scalar_outs + out_size, ht1);
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][3 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+            for(int k = 0; k < 3 * out_size; ++k)
+                W[k * in_size + i] = half_precision_detail::fromFloat<HalfType>(wVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][3 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < 3 * out_size; ++k)
+                U[k * out_size + i] = half_precision_detail::fromFloat<HalfType>(uVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[2][3 * out_size]
+     */
+    void setBVals(const std::vector<std::vector<T>>& bVals)
+    {
+        for(int i = 0; i < 2; ++i)
+            std::copy(bVals[(size_t)i].begin(), bVals[(size_t)i].begin() + 3 * out_size, bias + i * 3 * out_size);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // weights[3 * out_size][in_size] and [3 * out_size][out_size], for the z, r, and c gates
+    HalfType W[3 * out_size * in_size];
+    HalfType U[3 * out_size * out_size];
+    T bias[2 * 3 * out_size];
+
+    T ht1[out_size];
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, and half-precision kernel
+ * and recurrent weights.
+ *
+ * The weights are stored as `HalfType` (Float16 or BFloat16),
+ * and are widened to float as they are used. The biases and
+ * the hidden and cell states are stored with type T.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, typename HalfType = Float16>
+class HalfLSTMLayer final : public Layer<T>
+{
+public:
+    /** Constructs a half-precision LSTM layer for a given input and output size. */
+    HalfLSTMLayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , W((size_t)(4 * out_size * in_size), HalfType::fromFloat(0.0f))
+        , U((size_t)(4 * out_size * out_size), HalfType::fromFloat(0.0f))
+        , bias((size_t)(4 * out_size), (T)0)
+        , ht1((size_t)out_size, (T)0)
+        , ct1((size_t)out_size, (T)0)
+    {
+    }
+
+    HalfLSTMLayer(std::initializer_list<int> sizes)
+        : HalfLSTMLayer(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Resets the state of the LSTM. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        std::fill(ct1.begin(), ct1.end(), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        const auto gate = [&](int row) {
+            return half_precision_detail::dot(&W[(size_t)(row * in_size)], input, in_size)
+                + half_precision_detail::dot(&U[(size_t)(row * out_size)], ht1.data(), out_size)
+                + bias[(size_t)row];
+        };
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto iGate = quantization_detail::sigmoid(gate(i));
+            const auto fGate = quantization_detail::sigmoid(gate(i + out_size));
+            const auto cGate = std::tanh(gate(i + 2 * out_size));
+            const auto oGate = quantization_detail::sigmoid(gate(i + 3 * out_size));
+
+            ct1[(size_t)i] = fGate * ct1[(size_t)i] + iGate * cGate;
+            h[i] = oGate * std::tanh(ct1[(size_t)i]);
+        }
+
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < Layer<T>::in_size; ++i)
+            for(int k = 0; k < 4 * Layer<T>::out_size; ++k)
+                W[(size_t)(k * Layer<T>::in_size + i)] = half_precision_detail::fromFloat<HalfType>(wVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            for(int k = 0; k < 4 * Layer<T>::out_size; ++k)
+                U[(size_t)(k * Layer<T>::out_size + i)] = half_precision_detail::fromFloat<HalfType>(uVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the (widened) kernel weight for the given indices. */
+    T getWVal(int i, int k) const noexcept
+    {
+        return (T)W[(size_t)(k * Layer<T>::in_size + i)].toFloat();
+    }
+
+    /** Returns the (widened) recurrent weight for the given indices. */
+    T getUVal(int i, int k) const noexcept
+    {
+        return (T)U[(size_t)(k * Layer<T>::out_size + i)].toFloat();
+    }
+
+private:
+    // weights[4 * out_size][in_size] and [4 * out_size][out_size], for the i, f, c, and o gates
+    std::vector<HalfType> W;
+    std::vector<HalfType> U;
+    std::vector<T> bias;
+
+    std::vector<T> ht1;
+    std::vector<T> ct1;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, and half-precision kernel
+ * and recurrent weights.
+ *
+ * See HalfLSTMLayer for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, typename HalfType = Float16>
+class HalfLSTMLayerT
+{
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    HalfLSTMLayerT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(W), std::end(W), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(U), std::end(U), HalfType::fromFloat(0.0f));
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(ct1), std::end(ct1), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+
+        const auto gate = [&](int row) {
+            return half_precision_detail::dot(W + row * in_size, input, in_size)
+                + half_precision_detail::dot(U + row * out_size, ht1, out_size)
+                + bias[row];
+        };
+
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto iGate = quantization_detail::sigmoid(gate(i));
+            const auto fGate = quantization_detail::sigmoid(gate(i + out_size));
+            const auto cGate = std::tanh(gate(i + 2 * out_size));
+            const auto oGate = quantization_detail::sigmoid(gate(i + 3 * out_size));
+
+            ct1[i] = fGate * ct1[i] + iGate * cGate;
+            scalar_outs[i] = oGate * std::tanh(ct1[i]);
+        }
+
+        std::copy(scalar_outs, scalar_outs + out_size, ht1);
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+            for(int k = 0; k < 4 * out_size; ++k)
+                W[k * in_size + i] = half_precision_detail::fromFloat<HalfType>(wVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        for(int i = 0; i < out_size; ++i)
+            for(int k = 0; k < 4 * out_size; ++k)
+                U[k * out_size + i] = half_precision_detail::fromFloat<HalfType>(uVals[(size_t)i][(size_t)k]);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * out_size, bias);
+    }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // weights[4 * out_size][in_size] and [4 * out_size][out_size], for the i, f, c, and o gates
+    HalfType W[4 * out_size * in_size];
+    HalfType U[4 * out_size * out_size];
+    T bias[4 * out_size];
+
+    T ht1[out_size];
+    T ct1[out_size];
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // HALFPRECISIONLAYERS_H_INCLUDED
@@ -4,7 +4,7 @@
 #if RTNEURAL_USE_EIGEN
 #include "lstm_eigen.h"
 #include "lstm_eigen.tpp"
-#elif RTNEURAL_USE_XSIMD
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
 #include "lstm_xsimd.h"
 #include "lstm_xsimd.tpp"
 #elif RTNEURAL_USE_ACCELERATE
@@ -25,8 +25,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class LSTMLayer final : public Layer<T>
 {
 public:
@@ -40,6 +44,14 @@ public:
     /** Resets the state of the LSTM. */
     void reset() override;
 
+    /**
+     * Prepares the LSTM to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
@@ -48,12 +60,18 @@ public:
     {
         for(int i = 0; i < Layer<T>::out_size; ++i)
         {
-            fVec[i] = sigmoid(vMult(fWeights.W[i], input, Layer<T>::in_size) + vMult(fWeights.U[i], ht1, Layer<T>::out_size) + fWeights.b[i]);
-            iVec[i] = sigmoid(vMult(iWeights.W[i], input, Layer<T>::in_size) + vMult(iWeights.U[i], ht1, Layer<T>::out_size) + iWeights.b[i]);
-            oVec[i] = sigmoid(vMult(oWeights.W[i], input, Layer<T>::in_size) + vMult(oWeights.U[i], ht1, Layer<T>::out_size) + oWeights.b[i]);
-            ctVec[i] = std::tanh(vMult(cWeights.W[i], input, Layer<T>::in_size) + vMult(cWeights.U[i], ht1, Layer<T>::out_size) + cWeights.b[i]);
+            fVec[i] = MathsProvider::sigmoid(vMult(fWeights.W[i], input, Layer<T>::in_size) + vMult(fWeights.U[i], ht1, Layer<T>::out_size) + fWeights.b[i]);
+            iVec[i] = MathsProvider::sigmoid(vMult(iWeights.W[i], input, Layer<T>::in_size) + vMult(iWeights.U[i], ht1, Layer<T>::out_size) + iWeights.b[i]);
+            oVec[i] = MathsProvider::sigmoid(vMult(oWeights.W[i], input, Layer<T>::in_size) + vMult(oWeights.U[i], ht1, Layer<T>::out_size) + oWeights.b[i]);
+            ctVec[i] = MathsProvider::tanh(vMult(cWeights.W[i], input, Layer<T>::in_size) + vMult(cWeights.U[i], ht1, Layer<T>::out_size) + cWeights.b[i]);
             cVec[i] = fVec[i] * ct1[i] + iVec[i] * ctVec[i];
-            h[i] = oVec[i] * std::tanh(cVec[i]);
+            h[i] = oVec[i] * MathsProvider::tanh(cVec[i]);
+        }
+
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(cVec);
+            outs_delayed.process(h);
         }
 
         std::copy(cVec, cVec + Layer<T>::out_size, ct1);
@@ -67,6 +85,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -74,6 +99,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -85,6 +117,10 @@ protected:
     T* ht1;
     T* ct1;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> ct_delayed;
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     /** Struct to hold layer weights (used internally) */
     struct WeightSet
     {
@@ -117,10 +153,22 @@ protected:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class LSTMLayerT
 {
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<std::array<T, out_sizet>, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -155,19 +203,19 @@ public:
         recurrent_mat_mul(outs, Uf, ft);
         kernel_mat_mul(ins, Wf, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            ft[i] = sigmoid(ft[i] + bf[i] + kernel_outs[i]);
+            ft[i] = MathsProvider::sigmoid(ft[i] + bf[i] + kernel_outs[i]);
 
         // compute it
         recurrent_mat_mul(outs, Ui, it);
         kernel_mat_mul(ins, Wi, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            it[i] = sigmoid(it[i] + bi[i] + kernel_outs[i]);
+            it[i] = MathsProvider::sigmoid(it[i] + bi[i] + kernel_outs[i]);
 
         // compute ot
         recurrent_mat_mul(outs, Uo, ot);
         kernel_mat_mul(ins, Wo, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            ot[i] = sigmoid(ot[i] + bo[i] + kernel_outs[i]);
+            ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_outs[i]);
 
         computeOutputs(ins);
     }
@@ -180,17 +228,17 @@ public:
         // compute ft
         recurrent_mat_mul(outs, Uf, ft);
         for(int i = 0; i < out_size; ++i)
-            ft[i] = sigmoid(ft[i] + bf[i] + (Wf_1[i] * ins[0]));
+            ft[i] = MathsProvider::sigmoid(ft[i] + bf[i] + (Wf_1[i] * ins[0]));
 
         // compute it
         recurrent_mat_mul(outs, Ui, it);
         for(int i = 0; i < out_size; ++i)
-            it[i] = sigmoid(it[i] + bi[i] + (Wi_1[i] * ins[0]));
+            it[i] = MathsProvider::sigmoid(it[i] + bi[i] + (Wi_1[i] * ins[0]));
 
         // compute ot
         recurrent_mat_mul(outs, Uo, ot);
         for(int i = 0; i < out_size; ++i)
-            ot[i] = sigmoid(ot[i] + bo[i] + (Wo_1[i] * ins[0]));
+            ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + (Wo_1[i] * ins[0]));
 
         computeOutputs(ins);
     }
@@ -202,6 +250,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -209,6 +264,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -230,10 +292,10 @@ private:
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
     computeOutputs(const T (&ins)[in_size]) noexcept
     {
-        computeOutputsInternal(ins, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
+        computeOutputsInternal(ins, ct_delayed.writeFrame(), outs_delayed.writeFrame());
 
-        processDelay(ct_delayed, ct, delayWriteIdx);
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(ct_delayed, ct);
+        processDelay(outs_delayed, outs);
     }
 
     template <typename VecType, int N = in_size>
@@ -244,11 +306,11 @@ private:
         recurrent_mat_mul(outs, Uc, ht);
         kernel_mat_mul(ins, Wc, kernel_outs);
         for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * std::tanh(ht[i] + bc[i] + kernel_outs[i]) + ft[i] * ct[i];
+            ctVec[i] = it[i] * MathsProvider::tanh(ht[i] + bc[i] + kernel_outs[i]) + ft[i] * ct[i];
 
         // compute output
         for(int i = 0; i < out_size; ++i)
-            outsVec[i] = ot[i] * std::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
     }
 
     template <typename VecType, int N = in_size>
@@ -258,51 +320,44 @@ private:
         // compute ct
         recurrent_mat_mul(outs, Uc, ht);
         for(int i = 0; i < out_size; ++i)
-            ctVec[i] = it[i] * std::tanh(ht[i] + bc[i] + (Wc_1[i] * ins[0])) + ft[i] * ct[i];
+            ctVec[i] = it[i] * MathsProvider::tanh(ht[i] + bc[i] + (Wc_1[i] * ins[0])) + ft[i] * ct[i];
 
         // compute output
         for(int i = 0; i < out_size; ++i)
-            outsVec[i] = ot[i] * std::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, T (&out)[out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
         for(int i = 0; i < out_size; ++i)
-            out[i] = delayVec[0][i];
+            out[i] = delayed[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<std::array<T, out_size>>& delayVec, T (&out)[out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, T (&out)[out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
+        const auto& delayedMinus1 = delayBuffer.read(delayOffset - 1);
         for(int i = 0; i < out_size; ++i)
-            out[i] = delayPlus1Mult * delayVec[0][i] + delayMult * delayVec[1][i];
+            out[i] = delayPlus1Mult * delayed[i] + delayMult * delayedMinus1[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
-    static inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size]) noexcept
+    inline void recurrent_mat_mul(const T (&vec)[out_size], const T (&mat)[out_size][out_size], T (&out)[out_size]) const noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + out_size, vec, (T)0);
+        kernels.matVec(&mat[0][0], out_size, out_size, vec, out);
     }
 
-    static inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size]) noexcept
+    inline void kernel_mat_mul(const T (&vec)[in_size], const T (&mat)[out_size][in_size], T (&out)[out_size]) const noexcept
     {
-        for(int j = 0; j < out_size; ++j)
-            out[j] = std::inner_product(mat[j], mat[j] + in_size, vec, (T)0);
+        kernels.matVec(&mat[0][0], out_size, in_size, vec, out);
     }
 
     // kernel weights
@@ -337,10 +392,12 @@ private:
     T ht alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
     T ct alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
 
+    dispatch::LayerKernels kernels;
+
     // needed for delays when doing sample rate correction
-    std::vector<std::array<T, out_size>> ct_delayed;
-    std::vector<std::array<T, out_size>> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type ct_delayed;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     T delayMult = (T)1;
     T delayPlus1Mult = (T)0;
 };
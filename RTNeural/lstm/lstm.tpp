@@ -3,10 +3,10 @@
 namespace RTNeural
 {
 
-#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_ACCELERATE
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT && !RTNEURAL_USE_ACCELERATE
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
     , fWeights(in_size, out_size)
     , iWeights(in_size, out_size)
@@ -23,28 +23,28 @@ LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
     cVec = new T[out_size];
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(std::initializer_list<int> sizes)
-    : LSTMLayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(std::initializer_list<int> sizes)
+    : LSTMLayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(const LSTMLayer& other)
-    : LSTMLayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(const LSTMLayer& other)
+    : LSTMLayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-LSTMLayer<T>& LSTMLayer<T>::operator=(const LSTMLayer<T>& other)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>& LSTMLayer<T, MathsProvider>::operator=(const LSTMLayer<T, MathsProvider>& other)
 {
     if(&other != this)
-        *this = LSTMLayer<T>(other);
+        *this = LSTMLayer<T, MathsProvider>(other);
     return *this;
 }
 
-template <typename T>
-LSTMLayer<T>::~LSTMLayer()
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::~LSTMLayer()
 {
     delete[] ht1;
     delete[] ct1;
@@ -56,15 +56,25 @@ LSTMLayer<T>::~LSTMLayer()
     delete[] cVec;
 }
 
-template <typename T>
-void LSTMLayer<T>::reset()
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::reset()
 {
     std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
     std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    ct_delayed.reset();
+    outs_delayed.reset();
 }
 
-template <typename T>
-LSTMLayer<T>::WeightSet::WeightSet(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    ct_delayed.prepare(Layer<T>::out_size, delaySamples);
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
     : out_size(out_size)
 {
     W = new T*[out_size];
@@ -78,8 +88,8 @@ LSTMLayer<T>::WeightSet::WeightSet(int in_size, int out_size)
     }
 }
 
-template <typename T>
-LSTMLayer<T>::WeightSet::~WeightSet()
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::WeightSet::~WeightSet()
 {
     delete[] b;
 
@@ -93,8 +103,8 @@ LSTMLayer<T>::WeightSet::~WeightSet()
     delete[] U;
 }
 
-template <typename T>
-void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -108,8 +118,23 @@ void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.W[k][i] = wVals(i, k);
+            fWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+            oWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -123,8 +148,23 @@ void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.U[k][i] = uVals(i, k);
+            fWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+            oWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < Layer<T>::out_size; ++k)
     {
@@ -136,8 +176,8 @@ void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::LSTMLayerT()
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -184,44 +224,39 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& x : ct_delayed)
-            std::fill(x.begin(), x.end(), T {});
-
-        for(auto& x : outs_delayed)
-            std::fill(x.begin(), x.end(), T {});
+        ct_delayed.reset({});
+        outs_delayed.reset({});
     }
 
     // reset output state
@@ -232,8 +267,8 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < in_size; ++i)
     {
@@ -255,8 +290,31 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vec
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Wi[j][i] = wVals(i, j);
+            Wf[j][i] = wVals(i, j + out_size);
+            Wc[j][i] = wVals(i, j + 2 * out_size);
+            Wo[j][i] = wVals(i, j + 3 * out_size);
+        }
+    }
+
+    for(int j = 0; j < out_size; ++j)
+    {
+        Wi_1[j] = wVals(0, j);
+        Wf_1[j] = wVals(0, j + out_size);
+        Wc_1[j] = wVals(0, j + 2 * out_size);
+        Wo_1[j] = wVals(0, j + 3 * out_size);
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -270,8 +328,23 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vec
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<T>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int j = 0; j < out_size; ++j)
+        {
+            Ui[j][i] = uVals(i, j);
+            Uf[j][i] = uVals(i, j + out_size);
+            Uc[j][i] = uVals(i, j + 2 * out_size);
+            Uo[j][i] = uVals(i, j + 3 * out_size);
+        }
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
@@ -282,6 +355,6 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vec
     }
 }
 
-#endif // !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD
+#endif // !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT
 
 } // namespace RTNeural
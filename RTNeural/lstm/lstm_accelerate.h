@@ -21,6 +21,14 @@ public:
     /** Resets the state of the LSTM. */
     void reset() override;
 
+    /**
+     * Prepares the LSTM to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
@@ -33,9 +41,15 @@ public:
     /** Sets the layer kernel weights. */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /** Sets the layer kernel weights from a weights view. */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /** Sets the layer recurrent weights. */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /** Sets the layer recurrent weights from a weights view. */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /** Sets the layer biases. */
     void setBVals(const std::vector<T>& bVals);
 
@@ -88,6 +102,12 @@ protected:
         vvtanhf(h, cVec, &dim_int);
         vDSP_vmul(h, 1, oVec, 1, h, 1, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(cVec);
+            outs_delayed.process(h);
+        }
+
         cblas_scopy(Layer<T>::out_size, cVec, 1, ct1, 1);
         cblas_scopy(Layer<T>::out_size, h, 1, ht1, 1);
     }
@@ -140,6 +160,12 @@ protected:
         vvtanh(h, cVec, &dim_int);
         vDSP_vmulD(h, 1, oVec, 1, h, 1, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(cVec);
+            outs_delayed.process(h);
+        }
+
         cblas_dcopy((int)Layer<T>::out_size, cVec, 1, ct1, 1);
         cblas_dcopy((int)Layer<T>::out_size, h, 1, ht1, 1);
     }
@@ -147,6 +173,10 @@ protected:
     T* ht1;
     T* ct1;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> ct_delayed;
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     struct WeightSet
     {
         WeightSet(int in_size, int out_size);
@@ -57,6 +57,16 @@ void LSTMLayer<T>::reset()
 {
     std::fill(ht1, ht1 + Layer<T>::out_size, (T)0);
     std::fill(ct1, ct1 + Layer<T>::out_size, (T)0);
+    ct_delayed.reset();
+    outs_delayed.reset();
+}
+
+template <typename T>
+void LSTMLayer<T>::prepare(T delaySamples)
+{
+    ct_delayed.prepare(Layer<T>::out_size, delaySamples);
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
 }
 
 template <typename T>
@@ -104,6 +114,21 @@ void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
+template <typename T>
+void LSTMLayer<T>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.W[k][i] = wVals(i, k);
+            fWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+            oWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
 template <typename T>
 void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
@@ -119,6 +144,21 @@ void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
+template <typename T>
+void LSTMLayer<T>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.U[k][i] = uVals(i, k);
+            fWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+            oWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
 template <typename T>
 void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
 {
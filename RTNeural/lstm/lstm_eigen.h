@@ -14,8 +14,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class LSTMLayer : public Layer<T>
 {
 public:
@@ -32,6 +36,14 @@ public:
     /** Resets the state of the LSTM. */
     void reset() override;
 
+    /**
+     * Prepares the LSTM to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
+
     /** Performs forward propagation for this layer. */
     inline void forward(const T* input, T* h) noexcept override
     {
@@ -43,16 +55,22 @@ public:
         oVec.noalias() = Wo * inVec + Uo * ht1 + bo;
 
         ctVec.noalias() = Wc * inVec + Uc * ht1 + bc;
-        ctVec = ctVec.array().tanh();
+        ctVec = MathsProvider::tanh(ctVec);
 
-        sigmoid(fVec);
-        sigmoid(iVec);
-        sigmoid(oVec);
+        fVec = MathsProvider::sigmoid(fVec);
+        iVec = MathsProvider::sigmoid(iVec);
+        oVec = MathsProvider::sigmoid(oVec);
 
         cVec.noalias() = fVec.cwiseProduct(ct1) + iVec.cwiseProduct(ctVec);
-        ht1 = cVec.array().tanh();
+        ht1 = MathsProvider::tanh(cVec);
         ht1 = oVec.cwiseProduct(ht1);
 
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(cVec.data());
+            outs_delayed.process(ht1.data());
+        }
+
         ct1 = cVec;
         std::copy(ht1.data(), ht1.data() + Layer<T>::out_size, h);
     }
@@ -64,6 +82,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -71,6 +96,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -101,6 +133,10 @@ private:
     Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
     Eigen::Matrix<T, Eigen::Dynamic, 1> ht1;
     Eigen::Matrix<T, Eigen::Dynamic, 1> ct1;
+
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> ct_delayed;
+    SampleRateCorrectionDelay<T> outs_delayed;
 };
 
 //====================================================
@@ -111,8 +147,16 @@ private:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class LSTMLayerT
 {
     using b_type = Eigen::Matrix<T, out_sizet, 1>;
@@ -122,6 +166,10 @@ class LSTMLayerT
     using in_type = Eigen::Matrix<T, in_sizet, 1>;
     using out_type = Eigen::Matrix<T, out_sizet, 1>;
 
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<out_type, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -162,9 +210,9 @@ public:
         oVec.noalias() += Uo * outs;
         oVec.noalias() += Wo * ins;
 
-        fVec = sigmoid(fVec);
-        iVec = sigmoid(iVec);
-        oVec = sigmoid(oVec);
+        fVec = MathsProvider::sigmoid(fVec);
+        iVec = MathsProvider::sigmoid(iVec);
+        oVec = MathsProvider::sigmoid(oVec);
 
         computeOutputs(ins);
     }
@@ -176,6 +224,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -183,6 +238,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -206,10 +268,10 @@ private:
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
     computeOutputs(const in_type& ins) noexcept
     {
-        computeOutputsInternal(ins, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
+        computeOutputsInternal(ins, ct_delayed.writeFrame(), outs_delayed.writeFrame());
 
-        processDelay(ct_delayed, cVec, delayWriteIdx);
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(ct_delayed, cVec);
+        processDelay(outs_delayed, outs);
     }
 
     template <typename VecType1, typename VecType2>
@@ -219,37 +281,28 @@ private:
         ctVec.noalias() += Uc * outs;
         ctVec.noalias() += Wc * ins;
 
-        ctVec = ctVec.array().tanh();
+        ctVec = MathsProvider::tanh(ctVec);
         cVecLocal = fVec.cwiseProduct(cVec);
         cVecLocal.noalias() += iVec.cwiseProduct(ctVec);
 
-        outsVec = cVecLocal.array().tanh();
+        outsVec = MathsProvider::tanh(cVecLocal);
         outsVec = oVec.cwiseProduct(outsVec);
     }
 
     template <typename OutVec, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<out_type>& delayVec, OutVec& out, int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, OutVec& out) noexcept
     {
-        out = delayVec[0];
-
-        for(int j = 0; j < delayWriteIndex; ++j)
-            delayVec[j] = delayVec[j + 1];
+        out = delayBuffer.read(delayOffset);
+        delayBuffer.advance();
     }
 
     template <typename OutVec, SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<out_type>& delayVec, OutVec& out, int delayWriteIndex) noexcept
-    {
-        out = delayPlus1Mult * delayVec[0] + delayMult * delayVec[1];
-
-        for(int j = 0; j < delayWriteIndex; ++j)
-            delayVec[j] = delayVec[j + 1];
-    }
-
-    static inline out_type sigmoid(const out_type& x) noexcept
+    processDelay(delay_type& delayBuffer, OutVec& out) noexcept
     {
-        return (T)1 / (((T)-1 * x.array()).array().exp() + (T)1);
+        out = delayPlus1Mult * delayBuffer.read(delayOffset) + delayMult * delayBuffer.read(delayOffset - 1);
+        delayBuffer.advance();
     }
 
     // kernel weights
@@ -278,9 +331,9 @@ private:
     out_type cVec;
 
     // needed for delays when doing sample rate correction
-    std::vector<out_type> ct_delayed;
-    std::vector<out_type> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type ct_delayed;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     T delayMult = (T)1;
     T delayPlus1Mult = (T)0;
 };
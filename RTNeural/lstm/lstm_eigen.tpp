@@ -3,8 +3,8 @@
 namespace RTNeural
 {
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
 {
     Wf = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, in_size);
@@ -33,33 +33,43 @@ LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
     ct1 = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(out_size, 1);
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(std::initializer_list<int> sizes)
-    : LSTMLayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(std::initializer_list<int> sizes)
+    : LSTMLayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(const LSTMLayer& other)
-    : LSTMLayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(const LSTMLayer& other)
+    : LSTMLayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-LSTMLayer<T>& LSTMLayer<T>::operator=(const LSTMLayer<T>& other)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>& LSTMLayer<T, MathsProvider>::operator=(const LSTMLayer<T, MathsProvider>& other)
 {
-    return *this = LSTMLayer<T>(other);
+    return *this = LSTMLayer<T, MathsProvider>(other);
 }
 
-template <typename T>
-void LSTMLayer<T>::reset()
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::reset()
 {
     std::fill(ht1.data(), ht1.data() + Layer<T>::out_size, (T)0);
     std::fill(ct1.data(), ct1.data() + Layer<T>::out_size, (T)0);
+    ct_delayed.reset();
+    outs_delayed.reset();
 }
 
-template <typename T>
-void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    ct_delayed.prepare(Layer<T>::out_size, delaySamples);
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -73,8 +83,23 @@ void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            Wi(k, i) = wVals(i, k);
+            Wf(k, i) = wVals(i, k + Layer<T>::out_size);
+            Wc(k, i) = wVals(i, k + Layer<T>::out_size * 2);
+            Wo(k, i) = wVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -88,8 +113,23 @@ void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            Ui(k, i) = uVals(i, k);
+            Uf(k, i) = uVals(i, k + Layer<T>::out_size);
+            Uc(k, i) = uVals(i, k + Layer<T>::out_size * 2);
+            Uo(k, i) = uVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < Layer<T>::out_size; ++k)
     {
@@ -101,8 +141,8 @@ void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::LSTMLayerT()
     : outs(outs_internal)
 {
     Wf = k_type::Zero();
@@ -123,44 +163,39 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& x : ct_delayed)
-            x = out_type::Zero();
-
-        for(auto& x : outs_delayed)
-            x = out_type::Zero();
+        ct_delayed.reset(out_type::Zero());
+        outs_delayed.reset(out_type::Zero());
     }
 
     // reset output state
@@ -169,8 +204,8 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
 }
 
 // kernel weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < in_size; ++i)
     {
@@ -184,9 +219,24 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vec
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < in_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            Wi(k, i) = wVals(i, k);
+            Wf(k, i) = wVals(i, k + out_size);
+            Wc(k, i) = wVals(i, k + out_size * 2);
+            Wo(k, i) = wVals(i, k + out_size * 3);
+        }
+    }
+}
+
 // recurrent weights
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -200,9 +250,24 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vec
     }
 }
 
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            Ui(k, i) = uVals(i, k);
+            Uf(k, i) = uVals(i, k + out_size);
+            Uc(k, i) = uVals(i, k + out_size * 2);
+            Uo(k, i) = uVals(i, k + out_size * 3);
+        }
+    }
+}
+
 // biases
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<T>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
@@ -0,0 +1,339 @@
+#ifndef LSTMSPARSE_H_INCLUDED
+#define LSTMSPARSE_H_INCLUDED
+
+#include "../Layer.h"
+#include "../quantization/quantization.h"
+#include "../sparse/sparse.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace sparse_detail
+{
+    /**
+     * Computes the LSTM outputs and cell state from the gate
+     * products, which have size [4 * out_size], for the i, f,
+     * c, and o gates.
+     */
+    template <typename T>
+    inline void lstmOutputs(const T* gates, T* ct1, T* h, int out_size) noexcept
+    {
+        for(int i = 0; i < out_size; ++i)
+        {
+            const auto iGate = quantization_detail::sigmoid(gates[i]);
+            const auto fGate = quantization_detail::sigmoid(gates[i + out_size]);
+            const auto cGate = std::tanh(gates[i + 2 * out_size]);
+            const auto oGate = quantization_detail::sigmoid(gates[i + 3 * out_size]);
+
+            ct1[i] = fGate * ct1[i] + iGate * cGate;
+            h[i] = oGate * std::tanh(ct1[i]);
+        }
+    }
+} // namespace sparse_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, and block-sparse recurrent
+ * weights.
+ *
+ * The recurrent weight matrix (U) is divided into blocks of
+ * block_rows x block_cols weights, and only the blocks that
+ * contain a non-zero weight are stored and multiplied (see
+ * SparseDense). The kernel weights are stored as a dense matrix,
+ * by column.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int block_rows = 1, int block_cols = 4>
+class SparseLSTMLayer final : public Layer<T>
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+public:
+    /** Constructs a sparse LSTM layer for a given input and output size. */
+    SparseLSTMLayer(int in_size, int out_size)
+        : Layer<T>(in_size, out_size)
+        , num_block_rows(ceil_div(4 * out_size, block_rows))
+        , W((size_t)(4 * out_size * in_size), (T)0)
+        , row_ptr((size_t)(num_block_rows + 1), 0)
+        , bias((size_t)(4 * out_size), (T)0)
+        , ht1((size_t)(ceil_div(out_size, block_cols) * block_cols), (T)0)
+        , ct1((size_t)out_size, (T)0)
+        , gate_outs((size_t)(num_block_rows * block_rows), (T)0)
+    {
+    }
+
+    SparseLSTMLayer(std::initializer_list<int> sizes)
+        : SparseLSTMLayer(*sizes.begin(), *(sizes.begin() + 1))
+    {
+    }
+
+    /** Resets the state of the LSTM. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        std::fill(ct1.begin(), ct1.end(), (T)0);
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr.data(), col_idx.data(), U.data(),
+            num_block_rows, ht1.data(), gate_outs.data());
+
+        for(int row = 0; row < 4 * out_size; ++row)
+            gate_outs[(size_t)row] += bias[(size_t)row];
+        kernels.multiplyAddColumns(W.data(), 4 * out_size, in_size, input, gate_outs.data());
+
+        sparse_detail::lstmOutputs(gate_outs.data(), ct1.data(), h, out_size);
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < Layer<T>::in_size; ++i)
+            std::copy(wVals[(size_t)i].begin(), wVals[(size_t)i].begin() + 4 * Layer<T>::out_size, W.begin() + i * 4 * Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        const auto getWeight = [&uVals](int row, int col) { return uVals[(size_t)col][(size_t)row]; };
+        const auto numBlocks = sparse_detail::countBlocks<block_rows, block_cols>(getWeight, 4 * Layer<T>::out_size, Layer<T>::out_size);
+        col_idx.resize((size_t)numBlocks);
+        U.resize((size_t)(numBlocks * block_rows * block_cols));
+        sparse_detail::packBlocks<T, block_rows, block_cols>(getWeight, 4 * Layer<T>::out_size, Layer<T>::out_size,
+            row_ptr.data(), col_idx.data(), U.data());
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * Layer<T>::out_size, bias.begin());
+    }
+
+    /** Returns the kernel weight for the given indices. */
+    T getWVal(int i, int k) const noexcept
+    {
+        return W[(size_t)(i * 4 * Layer<T>::out_size + k)];
+    }
+
+    /** Returns the recurrent weight for the given indices. */
+    T getUVal(int i, int k) const noexcept
+    {
+        const auto br = k / block_rows;
+        for(int b = row_ptr[(size_t)br]; b < row_ptr[(size_t)br + 1]; ++b)
+        {
+            if(col_idx[(size_t)b] == i / block_cols)
+                return U[(size_t)((b * block_rows + k % block_rows) * block_cols + i % block_cols)];
+        }
+
+        return (T)0;
+    }
+
+    /** Returns the number of recurrent weight blocks that are stored. */
+    int getNumBlocks() const noexcept { return (int)col_idx.size(); }
+
+private:
+    const int num_block_rows;
+
+    // kernel weights[in_size][4 * out_size], for the i, f, c, and o gates
+    std::vector<T> W;
+    dispatch::LayerKernels kernels;
+
+    // block-sparse recurrent weights[4 * out_size][out_size]
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<T> U;
+
+    std::vector<T> bias;
+
+    std::vector<T> ht1; // padded to a whole number of block columns
+    std::vector<T> ct1;
+    std::vector<T> gate_outs;
+};
+
+//====================================================
+/**
+ * Static implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, and block-sparse recurrent
+ * weights.
+ *
+ * The number of non-zero blocks is only known once the weights
+ * are loaded, so the layer has space for every block of the
+ * recurrent weight matrix, but only the non-zero blocks are
+ * multiplied.
+ *
+ * See SparseLSTMLayer for details.
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T, int in_sizet, int out_sizet, int block_rows = 1, int block_cols = 4>
+class SparseLSTMLayerT
+{
+    static_assert(block_rows > 0 && block_cols > 0, "Block dimensions must be positive!");
+
+    using inputs_type = quantization_detail::StaticInputs<T, in_sizet>;
+    static constexpr auto num_block_rows = ceil_div(4 * out_sizet, block_rows);
+    static constexpr auto num_block_cols = ceil_div(out_sizet, block_cols);
+    static constexpr auto max_blocks = num_block_rows * num_block_cols;
+
+public:
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = out_sizet;
+
+    SparseLSTMLayerT()
+#if RTNEURAL_USE_EIGEN
+        : outs(outs_internal)
+#endif
+    {
+        std::fill(std::begin(W), std::end(W), (T)0);
+        std::fill(std::begin(row_ptr), std::end(row_ptr), 0);
+        std::fill(std::begin(bias), std::end(bias), (T)0);
+        std::fill(std::begin(gate_outs), std::end(gate_outs), (T)0);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "lstm"; }
+
+    /** Returns false since LSTM is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the state of the LSTM. */
+    void reset()
+    {
+        std::fill(std::begin(ht1), std::end(ht1), (T)0);
+        std::fill(std::begin(ct1), std::end(ct1), (T)0);
+        std::fill(std::begin(scalar_outs), std::end(scalar_outs), (T)0);
+        storeOutputs();
+    }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const typename inputs_type::type& ins) noexcept
+    {
+        const auto* input = inputs_type::getData(ins, scalar_ins);
+
+        sparse_detail::multiply<T, block_rows, block_cols>(row_ptr, col_idx, U, num_block_rows, ht1, gate_outs);
+
+        for(int row = 0; row < 4 * out_size; ++row)
+            gate_outs[row] += bias[row];
+        kernels.multiplyAddColumns(W, 4 * out_size, in_size, input, gate_outs);
+
+        sparse_detail::lstmOutputs(gate_outs, ct1, scalar_outs, out_size);
+        std::copy(scalar_outs, scalar_outs + out_size, ht1);
+        storeOutputs();
+    }
+
+    /**
+     * Sets the layer kernel weights.
+     *
+     * The weights vector must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const std::vector<std::vector<T>>& wVals)
+    {
+        for(int i = 0; i < in_size; ++i)
+            std::copy(wVals[(size_t)i].begin(), wVals[(size_t)i].begin() + 4 * out_size, W + i * 4 * out_size);
+    }
+
+    /**
+     * Sets the layer recurrent weights.
+     *
+     * The weights vector must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const std::vector<std::vector<T>>& uVals)
+    {
+        num_blocks = sparse_detail::packBlocks<T, block_rows, block_cols>([&uVals](int row, int col) { return uVals[(size_t)col][(size_t)row]; },
+            4 * out_size, out_size, row_ptr, col_idx, U);
+    }
+
+    /**
+     * Sets the layer bias.
+     *
+     * The bias vector must have size weights[4 * out_size]
+     */
+    void setBVals(const std::vector<T>& bVals)
+    {
+        std::copy(bVals.begin(), bVals.begin() + 4 * out_size, bias);
+    }
+
+    /** Returns the number of non-zero recurrent weight blocks. */
+    int getNumBlocks() const noexcept { return num_blocks; }
+
+#if RTNEURAL_USE_EIGEN
+    Eigen::Map<Eigen::Matrix<T, out_size, 1>, RTNeuralEigenAlignment> outs;
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+    xsimd::simd_type<T> outs[ceil_div(out_size, (int)xsimd::simd_type<T>::size)];
+#else
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+private:
+    /** Copies the scalar outputs to the output type used by the current backend. */
+    inline void storeOutputs() noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        std::copy(scalar_outs, scalar_outs + out_size, outs.data());
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        constexpr auto v_size = (int)xsimd::simd_type<T>::size;
+        for(int i = 0; i < ceil_div(out_size, v_size); ++i)
+            outs[i] = xsimd::load_aligned(scalar_outs + i * v_size);
+#else
+        std::copy(scalar_outs, scalar_outs + out_size, outs);
+#endif
+    }
+
+#if RTNEURAL_USE_EIGEN
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+#endif
+
+    // kernel weights[in_size][4 * out_size], for the i, f, c, and o gates
+    T W alignas(RTNEURAL_DEFAULT_ALIGNMENT)[4 * out_size * in_size];
+    dispatch::LayerKernels kernels;
+
+    // block-sparse recurrent weights[4 * out_size][out_size]
+    int row_ptr[num_block_rows + 1];
+    int col_idx[max_blocks];
+    T U alignas(RTNEURAL_DEFAULT_ALIGNMENT)[max_blocks * block_rows * block_cols];
+    int num_blocks = 0;
+
+    T bias[4 * out_size];
+
+    T ht1 alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_block_cols * block_cols]; // padded to a whole number of block columns
+    T ct1[out_size];
+    T gate_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[num_block_rows * block_rows];
+    T scalar_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[inputs_type::scratch_size];
+
+    // padded to a whole number of SIMD vectors, for the largest vector size (16 floats)
+    T scalar_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ceil_div(out_size, 16) * 16];
+};
+
+} // namespace RTNeural
+
+#endif // LSTMSPARSE_H_INCLUDED
@@ -15,8 +15,12 @@ namespace RTNeural
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
  */
-template <typename T>
+template <typename T, typename MathsProvider = DefaultMathsProvider>
 class LSTMLayer : public Layer<T>
 {
 public:
@@ -30,6 +34,14 @@ public:
     /** Resets the state of the LSTM. */
     void reset() override;
 
+    /**
+     * Prepares the LSTM to process with a given delay length, for
+     * sample-rate correction (see SampleRateCorrectionMode). Integer
+     * delay lengths are used without interpolation, and non-integer
+     * delay lengths use linear interpolation.
+     */
+    void prepare(T delaySamples) override;
+
     /** Returns the name of this layer. */
     std::string getName() const noexcept override { return "lstm"; }
 
@@ -45,24 +57,30 @@ public:
         }
 
         vAdd(fVec.data(), fWeights.b.data(), fVec.data(), Layer<T>::out_size);
-        sigmoid(fVec.data(), fVec.data(), Layer<T>::out_size);
+        vApply(fVec.data(), fVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
 
         vAdd(iVec.data(), iWeights.b.data(), iVec.data(), Layer<T>::out_size);
-        sigmoid(iVec.data(), iVec.data(), Layer<T>::out_size);
+        vApply(iVec.data(), iVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
 
         vAdd(oVec.data(), oWeights.b.data(), oVec.data(), Layer<T>::out_size);
-        sigmoid(oVec.data(), oVec.data(), Layer<T>::out_size);
+        vApply(oVec.data(), oVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::sigmoid(x); });
 
         vAdd(ctVec.data(), cWeights.b.data(), ctVec.data(), Layer<T>::out_size);
-        tanh(ctVec.data(), ctVec.data(), Layer<T>::out_size);
+        vApply(ctVec.data(), ctVec.data(), Layer<T>::out_size, [](const auto& x) { return MathsProvider::tanh(x); });
 
         vProd(fVec.data(), ct1.data(), cVec.data(), Layer<T>::out_size);
         vProd(iVec.data(), ctVec.data(), prod_out.data(), Layer<T>::out_size);
         vAdd(cVec.data(), prod_out.data(), cVec.data(), Layer<T>::out_size);
 
-        tanh(cVec.data(), h, Layer<T>::out_size);
+        vApply(cVec.data(), h, Layer<T>::out_size, [](const auto& x) { return MathsProvider::tanh(x); });
         vProd(h, oVec.data(), h, Layer<T>::out_size);
 
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(cVec.data());
+            outs_delayed.process(h);
+        }
+
         vCopy(cVec.data(), ct1.data(), Layer<T>::out_size);
         vCopy(h, ht1.data(), Layer<T>::out_size);
     }
@@ -74,6 +92,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -81,6 +106,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -89,12 +121,16 @@ public:
     void setBVals(const std::vector<T>& bVals);
 
 protected:
-    using vec_type = std::vector<T, xsimd::aligned_allocator<T>>;
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
     using vec2_type = std::vector<vec_type>;
 
     vec_type ht1;
     vec_type ct1;
 
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> ct_delayed;
+    SampleRateCorrectionDelay<T> outs_delayed;
+
     struct WeightSet
     {
         WeightSet(int in_size, int out_size);
@@ -129,8 +165,16 @@ protected:
  * To ensure that the recurrent state is initialized to zero,
  * please make sure to call `reset()` before your first call to
  * the `forward()` method.
+ *
+ * The `MathsProvider` template argument can be used to choose
+ * the implementation of the tanh and sigmoid functions
+ * (see DefaultMathsProvider).
+ *
+ * The `maxDelaySamples` template argument is the longest delay
+ * (in samples) that the layer can be prepared with, when doing
+ * sample-rate correction.
  */
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr = SampleRateCorrectionMode::None, typename MathsProvider = DefaultMathsProvider, int maxDelaySamples = RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY>
 class LSTMLayerT
 {
     using v_type = xsimd::simd_type<T>;
@@ -138,6 +182,10 @@ class LSTMLayerT
     static constexpr auto v_in_size = ceil_div(in_sizet, v_size);
     static constexpr auto v_out_size = ceil_div(out_sizet, v_size);
 
+    // circular buffer for delays when doing sample rate correction
+    static constexpr auto delay_capacity = sampleRateCorrectionDelayCapacity(sampleRateCorr, maxDelaySamples);
+    using delay_type = DelayBuffer<std::array<v_type, v_out_size>, delay_capacity>;
+
 public:
     static constexpr auto in_size = in_sizet;
     static constexpr auto out_size = out_sizet;
@@ -172,19 +220,19 @@ public:
         recurrent_mat_mul(outs, Uf, ft);
         kernel_mat_mul(ins, Wf, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            ft[i] = sigmoid(ft[i] + bf[i] + kernel_outs[i]);
+            ft[i] = MathsProvider::sigmoid(ft[i] + bf[i] + kernel_outs[i]);
 
         // compute it
         recurrent_mat_mul(outs, Ui, it);
         kernel_mat_mul(ins, Wi, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            it[i] = sigmoid(it[i] + bi[i] + kernel_outs[i]);
+            it[i] = MathsProvider::sigmoid(it[i] + bi[i] + kernel_outs[i]);
 
         // compute ot
         recurrent_mat_mul(outs, Uo, ot);
         kernel_mat_mul(ins, Wo, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            ot[i] = sigmoid(ot[i] + bo[i] + kernel_outs[i]);
+            ot[i] = MathsProvider::sigmoid(ot[i] + bo[i] + kernel_outs[i]);
 
         computeOutputs(ins);
     }
@@ -197,17 +245,17 @@ public:
         // compute ft
         recurrent_mat_mul(outs, Uf, ft);
         for(int i = 0; i < v_out_size; ++i)
-            ft[i] = sigmoid(xsimd::fma(Wf_1[i], ins[0], ft[i] + bf[i]));
+            ft[i] = MathsProvider::sigmoid(xsimd::fma(Wf_1[i], ins[0], ft[i] + bf[i]));
 
         // compute it
         recurrent_mat_mul(outs, Ui, it);
         for(int i = 0; i < v_out_size; ++i)
-            it[i] = sigmoid(xsimd::fma(Wi_1[i], ins[0], it[i] + bi[i]));
+            it[i] = MathsProvider::sigmoid(xsimd::fma(Wi_1[i], ins[0], it[i] + bi[i]));
 
         // compute ot
         recurrent_mat_mul(outs, Uo, ot);
         for(int i = 0; i < v_out_size; ++i)
-            ot[i] = sigmoid(xsimd::fma(Wo_1[i], ins[0], ot[i] + bo[i]));
+            ot[i] = MathsProvider::sigmoid(xsimd::fma(Wo_1[i], ins[0], ot[i] + bo[i]));
 
         computeOutputs(ins);
     }
@@ -219,6 +267,13 @@ public:
      */
     void setWVals(const std::vector<std::vector<T>>& wVals);
 
+    /**
+     * Sets the layer kernel weights from a weights view.
+     * 
+     * The weights view must have size weights[in_size][4 * out_size]
+     */
+    void setWVals(const WeightsView<T, 2>& wVals);
+
     /**
      * Sets the layer recurrent weights.
      * 
@@ -226,6 +281,13 @@ public:
      */
     void setUVals(const std::vector<std::vector<T>>& uVals);
 
+    /**
+     * Sets the layer recurrent weights from a weights view.
+     * 
+     * The weights view must have size weights[out_size][4 * out_size]
+     */
+    void setUVals(const WeightsView<T, 2>& uVals);
+
     /**
      * Sets the layer bias.
      * 
@@ -247,10 +309,10 @@ private:
     inline std::enable_if_t<srCorr != SampleRateCorrectionMode::None, void>
     computeOutputs(const v_type (&ins)[v_in_size]) noexcept
     {
-        computeOutputsInternal(ins, ct_delayed[delayWriteIdx], outs_delayed[delayWriteIdx]);
+        computeOutputsInternal(ins, ct_delayed.writeFrame(), outs_delayed.writeFrame());
 
-        processDelay(ct_delayed, ct, delayWriteIdx);
-        processDelay(outs_delayed, outs, delayWriteIdx);
+        processDelay(ct_delayed, ct);
+        processDelay(outs_delayed, outs);
     }
 
     template <typename VecType, int N = in_size>
@@ -261,11 +323,11 @@ private:
         recurrent_mat_mul(outs, Uc, ht);
         kernel_mat_mul(ins, Wc, kernel_outs);
         for(int i = 0; i < v_out_size; ++i)
-            ctVec[i] = xsimd::fma(it[i], xsimd::tanh(ht[i] + bc[i] + kernel_outs[i]), ft[i] * ct[i]);
+            ctVec[i] = xsimd::fma(it[i], MathsProvider::tanh(ht[i] + bc[i] + kernel_outs[i]), ft[i] * ct[i]);
 
         // compute output
         for(int i = 0; i < v_out_size; ++i)
-            outsVec[i] = ot[i] * xsimd::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
     }
 
     template <typename VecType, int N = in_size>
@@ -275,39 +337,34 @@ private:
         // compute ct
         recurrent_mat_mul(outs, Uc, ht);
         for(int i = 0; i < v_out_size; ++i)
-            ctVec[i] = xsimd::fma(it[i], xsimd::tanh(xsimd::fma(Wc_1[i], ins[0], ht[i] + bc[i])), ft[i] * ct[i]);
+            ctVec[i] = xsimd::fma(it[i], MathsProvider::tanh(xsimd::fma(Wc_1[i], ins[0], ht[i] + bc[i])), ft[i] * ct[i]);
 
         // compute output
         for(int i = 0; i < v_out_size; ++i)
-            outsVec[i] = ot[i] * xsimd::tanh(ctVec[i]);
+            outsVec[i] = ot[i] * MathsProvider::tanh(ctVec[i]);
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-    processDelay(std::vector<std::array<v_type, v_out_size>>& delayVec, v_type (&out)[v_out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, v_type (&out)[v_out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
         for(int i = 0; i < v_out_size; ++i)
-            out[i] = delayVec[0][i];
+            out[i] = delayed[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < v_out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     template <SampleRateCorrectionMode srCorr = sampleRateCorr>
     inline std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-    processDelay(std::vector<std::array<v_type, v_out_size>>& delayVec, v_type (&out)[v_out_size], int delayWriteIndex) noexcept
+    processDelay(delay_type& delayBuffer, v_type (&out)[v_out_size]) noexcept
     {
+        const auto& delayed = delayBuffer.read(delayOffset);
+        const auto& delayedMinus1 = delayBuffer.read(delayOffset - 1);
         for(int i = 0; i < v_out_size; ++i)
-            out[i] = delayPlus1Mult * delayVec[0][i] + delayMult * delayVec[1][i];
+            out[i] = delayPlus1Mult * delayed[i] + delayMult * delayedMinus1[i];
 
-        for(int j = 0; j < delayWriteIndex; ++j)
-        {
-            for(int i = 0; i < v_out_size; ++i)
-                delayVec[j][i] = delayVec[j + 1][i];
-        }
+        delayBuffer.advance();
     }
 
     static inline void recurrent_mat_mul(const v_type (&vec)[v_out_size], const v_type (&mat)[out_size][v_out_size], v_type (&out)[v_out_size]) noexcept
@@ -344,11 +401,6 @@ private:
         }
     }
 
-    static inline v_type sigmoid(v_type x) noexcept
-    {
-        return (T)1.0 / ((T)1.0 + xsimd::exp(-x));
-    }
-
     // kernel weights
     v_type Wf[in_size][v_out_size];
     v_type Wi[in_size][v_out_size];
@@ -382,9 +434,9 @@ private:
     v_type ct[v_out_size];
 
     // needed for delays when doing sample rate correction
-    std::vector<std::array<v_type, v_out_size>> ct_delayed;
-    std::vector<std::array<v_type, v_out_size>> outs_delayed;
-    int delayWriteIdx = 0;
+    delay_type ct_delayed;
+    delay_type outs_delayed;
+    int delayOffset = 0;
     v_type delayMult = (T)1;
     v_type delayPlus1Mult = (T)0;
 };
@@ -3,8 +3,8 @@
 namespace RTNeural
 {
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(int in_size, int out_size)
     : Layer<T>(in_size, out_size)
     , fWeights(in_size, out_size)
     , iWeights(in_size, out_size)
@@ -24,36 +24,46 @@ LSTMLayer<T>::LSTMLayer(int in_size, int out_size)
     prod_out.resize(out_size, (T)0);
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(std::initializer_list<int> sizes)
-    : LSTMLayer<T>(*sizes.begin(), *(sizes.begin() + 1))
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(std::initializer_list<int> sizes)
+    : LSTMLayer<T, MathsProvider>(*sizes.begin(), *(sizes.begin() + 1))
 {
 }
 
-template <typename T>
-LSTMLayer<T>::LSTMLayer(const LSTMLayer& other)
-    : LSTMLayer<T>(other.in_size, other.out_size)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::LSTMLayer(const LSTMLayer& other)
+    : LSTMLayer<T, MathsProvider>(other.in_size, other.out_size)
 {
 }
 
-template <typename T>
-LSTMLayer<T>& LSTMLayer<T>::operator=(const LSTMLayer<T>& other)
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>& LSTMLayer<T, MathsProvider>::operator=(const LSTMLayer<T, MathsProvider>& other)
 {
-    return *this = LSTMLayer<T>(other);
+    return *this = LSTMLayer<T, MathsProvider>(other);
 }
 
-template <typename T>
-LSTMLayer<T>::~LSTMLayer() = default;
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::~LSTMLayer() = default;
 
-template <typename T>
-void LSTMLayer<T>::reset()
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::reset()
 {
     std::fill(ht1.begin(), ht1.end(), (T)0);
     std::fill(ct1.begin(), ct1.end(), (T)0);
+    ct_delayed.reset();
+    outs_delayed.reset();
 }
 
-template <typename T>
-LSTMLayer<T>::WeightSet::WeightSet(int in_size, int out_size)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::prepare(T delaySamples)
+{
+    ct_delayed.prepare(Layer<T>::out_size, delaySamples);
+    outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+    reset();
+}
+
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::WeightSet::WeightSet(int in_size, int out_size)
     : out_size(out_size)
 {
     W = vec2_type(out_size, vec_type(in_size, (T)0));
@@ -61,11 +71,11 @@ LSTMLayer<T>::WeightSet::WeightSet(int in_size, int out_size)
     b.resize(out_size, (T)0);
 }
 
-template <typename T>
-LSTMLayer<T>::WeightSet::~WeightSet() = default;
+template <typename T, typename MathsProvider>
+LSTMLayer<T, MathsProvider>::WeightSet::~WeightSet() = default;
 
-template <typename T>
-void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < Layer<T>::in_size; ++i)
     {
@@ -79,8 +89,23 @@ void LSTMLayer<T>::setWVals(const std::vector<std::vector<T>>& wVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < Layer<T>::in_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.W[k][i] = wVals(i, k);
+            fWeights.W[k][i] = wVals(i, k + Layer<T>::out_size);
+            cWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 2);
+            oWeights.W[k][i] = wVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < Layer<T>::out_size; ++i)
     {
@@ -94,8 +119,23 @@ void LSTMLayer<T>::setUVals(const std::vector<std::vector<T>>& uVals)
     }
 }
 
-template <typename T>
-void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+    {
+        for(int k = 0; k < Layer<T>::out_size; ++k)
+        {
+            iWeights.U[k][i] = uVals(i, k);
+            fWeights.U[k][i] = uVals(i, k + Layer<T>::out_size);
+            cWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 2);
+            oWeights.U[k][i] = uVals(i, k + Layer<T>::out_size * 3);
+        }
+    }
+}
+
+template <typename T, typename MathsProvider>
+void LSTMLayer<T, MathsProvider>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < Layer<T>::out_size; ++k)
     {
@@ -107,8 +147,8 @@ void LSTMLayer<T>::setBVals(const std::vector<T>& bVals)
 }
 
 //====================================================
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::LSTMLayerT()
 {
     for(int i = 0; i < v_out_size; ++i)
     {
@@ -158,44 +198,39 @@ LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::LSTMLayerT()
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::NoInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(int delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(int delaySamples)
 {
-    delayWriteIdx = delaySamples - 1;
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = delaySamples - 1;
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
 template <SampleRateCorrectionMode srCorr>
 std::enable_if_t<srCorr == SampleRateCorrectionMode::LinInterp, void>
-LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::prepare(T delaySamples)
+LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::prepare(T delaySamples)
 {
     const auto delayOffFactor = delaySamples - std::floor(delaySamples);
     delayMult = (T)1 - delayOffFactor;
     delayPlus1Mult = delayOffFactor;
 
-    delayWriteIdx = (int)std::ceil(delaySamples) - (int)std::ceil(delayOffFactor);
-    ct_delayed.resize(delayWriteIdx + 1, {});
-    outs_delayed.resize(delayWriteIdx + 1, {});
+    assert(delaySamples <= (T)maxDelaySamples && "Delay length is longer than the maxDelaySamples template argument!");
+    delayOffset = (int)std::floor(delaySamples);
 
     reset();
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::reset()
 {
     if(sampleRateCorr != SampleRateCorrectionMode::None)
     {
-        for(auto& x : ct_delayed)
-            std::fill(x.begin(), x.end(), v_type {});
-
-        for(auto& x : outs_delayed)
-            std::fill(x.begin(), x.end(), v_type {});
+        ct_delayed.reset({});
+        outs_delayed.reset({});
     }
 
     // reset output state
@@ -206,8 +241,8 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::reset()
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vector<std::vector<T>>& wVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const std::vector<std::vector<T>>& wVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -229,8 +264,31 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setWVals(const std::vec
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vector<std::vector<T>>& uVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setWVals(const WeightsView<T, 2>& wVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            Wi[k][i / v_size] = set_value(Wi[k][i / v_size], i % v_size, wVals(k, i));
+            Wf[k][i / v_size] = set_value(Wf[k][i / v_size], i % v_size, wVals(k, i + out_size));
+            Wc[k][i / v_size] = set_value(Wc[k][i / v_size], i % v_size, wVals(k, i + 2 * out_size));
+            Wo[k][i / v_size] = set_value(Wo[k][i / v_size], i % v_size, wVals(k, i + 3 * out_size));
+        }
+    }
+
+    for(int j = 0; j < out_size; ++j)
+    {
+        Wi_1[j / v_size] = set_value(Wi_1[j / v_size], j % v_size, wVals(0, j));
+        Wf_1[j / v_size] = set_value(Wf_1[j / v_size], j % v_size, wVals(0, j + out_size));
+        Wc_1[j / v_size] = set_value(Wc_1[j / v_size], j % v_size, wVals(0, j + 2 * out_size));
+        Wo_1[j / v_size] = set_value(Wo_1[j / v_size], j % v_size, wVals(0, j + 3 * out_size));
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const std::vector<std::vector<T>>& uVals)
 {
     for(int i = 0; i < out_size; ++i)
     {
@@ -244,8 +302,23 @@ void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setUVals(const std::vec
     }
 }
 
-template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr>
-void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr>::setBVals(const std::vector<T>& bVals)
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setUVals(const WeightsView<T, 2>& uVals)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < out_size; ++k)
+        {
+            Ui[k][i / v_size] = set_value(Ui[k][i / v_size], i % v_size, uVals(k, i));
+            Uf[k][i / v_size] = set_value(Uf[k][i / v_size], i % v_size, uVals(k, i + out_size));
+            Uc[k][i / v_size] = set_value(Uc[k][i / v_size], i % v_size, uVals(k, i + 2 * out_size));
+            Uo[k][i / v_size] = set_value(Uo[k][i / v_size], i % v_size, uVals(k, i + 3 * out_size));
+        }
+    }
+}
+
+template <typename T, int in_sizet, int out_sizet, SampleRateCorrectionMode sampleRateCorr, typename MathsProvider, int maxDelaySamples>
+void LSTMLayerT<T, in_sizet, out_sizet, sampleRateCorr, MathsProvider, maxDelaySamples>::setBVals(const std::vector<T>& bVals)
 {
     for(int k = 0; k < out_size; ++k)
     {
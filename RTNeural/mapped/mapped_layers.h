@@ -0,0 +1,382 @@
+#ifndef MAPPEDLAYERS_H_INCLUDED
+#define MAPPEDLAYERS_H_INCLUDED
+
+#include "../Layer.h"
+#include "../gru/gru_sparse.h"
+#include "../lstm/lstm_sparse.h"
+#include <memory>
+#include <vector>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+namespace mapped_detail
+{
+    /**
+     * Computes y += A * x, where A has size [rows][cols], and is
+     * stored by column (as A[cols][rows]). This is the same as a
+     * column-major matrix, which is Eigen's default storage order,
+     * so with the Eigen backend the weights are multiplied in place
+     * by Eigen, and otherwise by the layer's kernels.
+     */
+    template <typename T>
+    inline void multiplyAdd([[maybe_unused]] const dispatch::LayerKernels& kernels, const T* A, int rows, int cols, const T* x, T* y) noexcept
+    {
+#if RTNEURAL_USE_EIGEN
+        using MatrixType = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+        using VectorType = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+        Eigen::Map<VectorType>(y, rows).noalias() += Eigen::Map<const MatrixType>(A, rows, cols) * Eigen::Map<const VectorType>(x, cols);
+#else
+        kernels.multiplyAddColumns(A, rows, cols, x, y);
+#endif
+    }
+} // namespace mapped_detail
+#endif // DOXYGEN
+
+/**
+ * Dynamic implementation of a fully-connected (dense) layer,
+ * with no activation, which uses weights that are stored
+ * somewhere else (for example in a memory-mapped binary model
+ * file), instead of copying them into the layer.
+ *
+ * The weights must have size weights[in_size][out_size]
+ * (a column-major [out_size][in_size] matrix), and the bias
+ * must have size bias[out_size]. The `storage` pointer is
+ * held by the layer, to keep the weights alive for as long
+ * as the layer is.
+ */
+template <typename T>
+class MappedDense final : public Layer<T>
+{
+public:
+    /** Constructs a mapped dense layer for a given input and output size, and the given weights. */
+    MappedDense(int in_size, int out_size, const T* weights, const T* bias, std::shared_ptr<const void> storage)
+        : Layer<T>(in_size, out_size)
+        , weights(weights)
+        , bias(bias)
+        , storage(std::move(storage))
+    {
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "dense"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        std::copy(bias, bias + Layer<T>::out_size, out);
+        mapped_detail::multiplyAdd(kernels, weights, Layer<T>::out_size, Layer<T>::in_size, input, out);
+    }
+
+private:
+    const T* weights; // weights[in_size][out_size]
+    const T* bias;
+    dispatch::LayerKernels kernels;
+    std::shared_ptr<const void> storage;
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a 1-dimensional convolution layer,
+ * with no activation and no stride, which uses weights that are
+ * stored somewhere else (see MappedDense).
+ *
+ * The weights must have size weights[kernel_size][in_size][out_size],
+ * with the most recent input at kernel index 0, and the bias must
+ * have size bias[out_size].
+ */
+template <typename T>
+class MappedConv1D final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a mapped convolution layer for the given dimensions and weights.
+     *
+     * @param in_size: the input size for the layer
+     * @param out_size: the output size for the layer
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    MappedConv1D(int in_size, int out_size, int kernel_size, int dilation,
+        const T* weights, const T* bias, std::shared_ptr<const void> storage)
+        : Layer<T>(in_size, out_size)
+        , kernel_size(kernel_size)
+        , dilation_rate(dilation)
+        , state_size((kernel_size - 1) * dilation + 1)
+        , weights(weights)
+        , bias(bias)
+        , storage(std::move(storage))
+        , state((size_t)(2 * state_size * in_size), (T)0)
+    {
+    }
+
+    /** Resets the layer state. */
+    void reset() override
+    {
+        std::fill(state.begin(), state.end(), (T)0);
+        state_ptr = 0;
+        tapDelay.reset();
+    }
+
+    /**
+     * Prepares the layer to process data at `sampleRateRatio` times the
+     * sample rate that the layer was trained at (see Conv1D::prepare()).
+     *
+     * This method may allocate memory, so it should not be called
+     * from a real-time context.
+     */
+    void prepare(T sampleRateRatio) override
+    {
+        useSampleRateCorrection = kernel_size > 1 && sampleRateRatio != (T)1;
+        if(useSampleRateCorrection)
+        {
+            tapDelay.prepare(Layer<T>::in_size, kernel_size, dilation_rate, sampleRateRatio);
+            taps.resize((size_t)(kernel_size * Layer<T>::in_size), (T)0);
+        }
+
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "conv1d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* out) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        if(useSampleRateCorrection)
+        {
+            // the interpolated taps have the same [kernel_size][in_size] layout as the weights
+            tapDelay.push(input);
+            tapDelay.gather(taps.data());
+
+            std::copy(bias, bias + out_size, out);
+            mapped_detail::multiplyAdd(kernels, weights, out_size, kernel_size * in_size, taps.data(), out);
+            return;
+        }
+
+        // insert the new input frame into the double-buffered state
+        std::copy(input, input + in_size, &state[(size_t)(state_ptr * in_size)]);
+        std::copy(input, input + in_size, &state[(size_t)((state_ptr + state_size) * in_size)]);
+
+        std::copy(bias, bias + out_size, out);
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            const auto tap = state_ptr + j * dilation_rate;
+            mapped_detail::multiplyAdd(kernels, weights + j * in_size * out_size, out_size, in_size, &state[(size_t)(tap * in_size)], out);
+        }
+
+        state_ptr = (state_ptr == 0 ? state_size - 1 : state_ptr - 1); // iterate state pointer in reverse
+    }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+private:
+    const int kernel_size;
+    const int dilation_rate;
+    const int state_size;
+
+    const T* weights; // weights[kernel_size][in_size][out_size]
+    const T* bias;
+    dispatch::LayerKernels kernels;
+    std::shared_ptr<const void> storage;
+
+    // state[2 * state_size][in_size]
+    std::vector<T> state;
+    int state_ptr = 0;
+
+    // needed for fractional dilation when doing sample rate correction
+    bool useSampleRateCorrection = false;
+    FractionalDilationDelay<T> tapDelay;
+    std::vector<T> taps;
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a gated recurrent unit (GRU) layer
+ * with tanh activation and sigmoid recurrent activation, which
+ * uses weights that are stored somewhere else (see MappedDense).
+ *
+ * The weights are in the same layout as the json model format:
+ * the kernel weights must have size W[in_size][3 * out_size],
+ * the recurrent weights must have size U[out_size][3 * out_size],
+ * and the biases must have size bias[2][3 * out_size].
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T>
+class MappedGRULayer final : public Layer<T>
+{
+public:
+    /** Constructs a mapped GRU layer for a given input and output size, and the given weights. */
+    MappedGRULayer(int in_size, int out_size, const T* W, const T* U, const T* bias, std::shared_ptr<const void> storage)
+        : Layer<T>(in_size, out_size)
+        , W(W)
+        , U(U)
+        , bias(bias)
+        , storage(std::move(storage))
+        , ht1((size_t)out_size, (T)0)
+        , kernel_outs((size_t)(3 * out_size), (T)0)
+        , recurrent_outs((size_t)(3 * out_size), (T)0)
+    {
+    }
+
+    /** Resets the state of the GRU. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        outs_delayed.reset();
+    }
+
+    /**
+     * Prepares the GRU to process with a given delay length, for
+     * sample-rate correction (see GRULayer::prepare()).
+     */
+    void prepare(T delaySamples) override
+    {
+        outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "gru"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        std::copy(bias, bias + 3 * out_size, kernel_outs.begin());
+        mapped_detail::multiplyAdd(kernels, W, 3 * out_size, in_size, input, kernel_outs.data());
+
+        std::fill(recurrent_outs.begin(), recurrent_outs.end(), (T)0);
+        mapped_detail::multiplyAdd(kernels, U, 3 * out_size, out_size, ht1.data(), recurrent_outs.data());
+
+        sparse_detail::gruOutputs(kernel_outs.data(), recurrent_outs.data(), bias + 3 * out_size, ht1.data(), h, out_size);
+
+        if(outs_delayed.isActive())
+            outs_delayed.process(h);
+
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+private:
+    const T* W; // W[in_size][3 * out_size]
+    const T* U; // U[out_size][3 * out_size]
+    const T* bias; // bias[2][3 * out_size]
+    dispatch::LayerKernels kernels;
+    std::shared_ptr<const void> storage;
+
+    std::vector<T> ht1;
+    std::vector<T> kernel_outs;
+    std::vector<T> recurrent_outs;
+
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> outs_delayed;
+};
+
+//====================================================
+/**
+ * Dynamic implementation of a LSTM layer with tanh activation
+ * and sigmoid recurrent activation, which uses weights that are
+ * stored somewhere else (see MappedDense).
+ *
+ * The weights are in the same layout as the json model format:
+ * the kernel weights must have size W[in_size][4 * out_size],
+ * the recurrent weights must have size U[out_size][4 * out_size],
+ * and the bias must have size bias[4 * out_size].
+ *
+ * To ensure that the recurrent state is initialized to zero,
+ * please make sure to call `reset()` before your first call to
+ * the `forward()` method.
+ */
+template <typename T>
+class MappedLSTMLayer final : public Layer<T>
+{
+public:
+    /** Constructs a mapped LSTM layer for a given input and output size, and the given weights. */
+    MappedLSTMLayer(int in_size, int out_size, const T* W, const T* U, const T* bias, std::shared_ptr<const void> storage)
+        : Layer<T>(in_size, out_size)
+        , W(W)
+        , U(U)
+        , bias(bias)
+        , storage(std::move(storage))
+        , ht1((size_t)out_size, (T)0)
+        , ct1((size_t)out_size, (T)0)
+        , gate_outs((size_t)(4 * out_size), (T)0)
+    {
+    }
+
+    /** Resets the state of the LSTM. */
+    void reset() override
+    {
+        std::fill(ht1.begin(), ht1.end(), (T)0);
+        std::fill(ct1.begin(), ct1.end(), (T)0);
+        ct_delayed.reset();
+        outs_delayed.reset();
+    }
+
+    /**
+     * Prepares the LSTM to process with a given delay length, for
+     * sample-rate correction (see LSTMLayer::prepare()).
+     */
+    void prepare(T delaySamples) override
+    {
+        ct_delayed.prepare(Layer<T>::out_size, delaySamples);
+        outs_delayed.prepare(Layer<T>::out_size, delaySamples);
+        reset();
+    }
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "lstm"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        const auto in_size = Layer<T>::in_size;
+        const auto out_size = Layer<T>::out_size;
+
+        std::copy(bias, bias + 4 * out_size, gate_outs.begin());
+        mapped_detail::multiplyAdd(kernels, W, 4 * out_size, in_size, input, gate_outs.data());
+        mapped_detail::multiplyAdd(kernels, U, 4 * out_size, out_size, ht1.data(), gate_outs.data());
+
+        sparse_detail::lstmOutputs(gate_outs.data(), ct1.data(), h, out_size);
+
+        if(outs_delayed.isActive())
+        {
+            ct_delayed.process(ct1.data());
+            outs_delayed.process(h);
+        }
+
+        std::copy(h, h + out_size, ht1.begin());
+    }
+
+private:
+    const T* W; // W[in_size][4 * out_size]
+    const T* U; // U[out_size][4 * out_size]
+    const T* bias; // bias[4 * out_size]
+    dispatch::LayerKernels kernels;
+    std::shared_ptr<const void> storage;
+
+    std::vector<T> ht1;
+    std::vector<T> ct1;
+    std::vector<T> gate_outs;
+
+    // needed for delays when doing sample rate correction
+    SampleRateCorrectionDelay<T> ct_delayed;
+    SampleRateCorrectionDelay<T> outs_delayed;
+};
+
+} // namespace RTNeural
+
+#endif // MAPPEDLAYERS_H_INCLUDED
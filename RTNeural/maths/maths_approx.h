@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace RTNeural
+{
+#ifndef DOXYGEN
+/**
+ * Constants and scalar kernels shared by the approximate maths
+ * providers in each backend (see PadeMathsProvider,
+ * PolynomialMathsProvider, and BitTrickMathsProvider).
+ */
+namespace maths_detail
+{
+    /** Describes the IEEE-754 layout of a floating-point type. */
+    template <typename T>
+    struct FloatTraits;
+
+    template <>
+    struct FloatTraits<float>
+    {
+        using int_type = int32_t;
+        static constexpr int mantissa_bits = 23;
+        static constexpr int exponent_bias = 127;
+
+        /** Inputs to exp() are clamped to [-exp_limit, exp_limit], to keep the result finite and normal. */
+        static constexpr float exp_limit = 87.0f;
+
+        /** Polynomial degree needed for a full-precision exp() after range reduction. */
+        static constexpr int exp_poly_degree = 7;
+    };
+
+    template <>
+    struct FloatTraits<double>
+    {
+        using int_type = int64_t;
+        static constexpr int mantissa_bits = 52;
+        static constexpr int exponent_bias = 1023;
+
+        /** Inputs to exp() are clamped to [-exp_limit, exp_limit], to keep the result finite and normal. */
+        static constexpr double exp_limit = 708.0;
+
+        /** Polynomial degree needed for a full-precision exp() after range reduction. */
+        static constexpr int exp_poly_degree = 11;
+    };
+
+    constexpr double log2e = 1.4426950408889634;
+
+    // ln(2), split into a high part (exactly representable) and a low
+    // part, so that the range reduction x - k * ln(2) stays accurate.
+    constexpr double ln2_hi = 0.693359375;
+    constexpr double ln2_lo = -2.1219444005469058e-4;
+
+    // Schraudolph's shift, which minimises the RMS relative error of the bit-trick exp()
+    constexpr double bit_trick_shift = 0.0579848;
+
+    /** Returns 2^mantissa_bits as a floating-point value. */
+    template <typename T>
+    constexpr T mantissa_scale() noexcept
+    {
+        return (T)((typename FloatTraits<T>::int_type)1 << FloatTraits<T>::mantissa_bits);
+    }
+
+    /** Returns 1 / n! */
+    template <typename T>
+    constexpr T inv_factorial(int n) noexcept
+    {
+        auto result = (T)1;
+        for(int i = 2; i <= n; ++i)
+            result /= (T)i;
+        return result;
+    }
+
+    /** Clamps the input to exp() to the range where the result is finite and normal. */
+    template <typename T>
+    static inline T clamp_exp_input(T x) noexcept
+    {
+        constexpr auto limit = FloatTraits<T>::exp_limit;
+        return x > limit ? limit : (x < -limit ? -limit : x);
+    }
+
+    /** Returns 2^k, for an integer-valued k, by constructing the exponent bits directly. */
+    template <typename T>
+    static inline T pow2i(T k) noexcept
+    {
+        using int_type = typename FloatTraits<T>::int_type;
+        const auto bits = ((int_type)k + (int_type)FloatTraits<T>::exponent_bias) * ((int_type)1 << FloatTraits<T>::mantissa_bits);
+
+        T result;
+        std::memcpy(&result, &bits, sizeof(T));
+        return result;
+    }
+
+    /** Degree-5 polynomial approximation of exp(r) for |r| <= ln(2) / 2. */
+    template <typename T>
+    static inline T exp_poly_kernel(T r) noexcept
+    {
+        return (T)1 + r * ((T)1 + r * ((T)1 / (T)2 + r * ((T)1 / (T)6 + r * ((T)1 / (T)24 + r * ((T)1 / (T)120)))));
+    }
+
+    /** [3/3] Pade approximation of exp(r) for |r| <= ln(2) / 2. */
+    template <typename T>
+    static inline T exp_pade_kernel(T r) noexcept
+    {
+        const auto r2 = r * r;
+        const auto p = r * ((T)60 + r2);
+        const auto q = (T)120 + (T)12 * r2;
+        return (q + p) / (q - p);
+    }
+
+    /** Computes exp(x) = 2^k * exp(r), using the given kernel to approximate exp(r). */
+    template <typename T, typename KernelFunc>
+    static inline T exp_range_reduced(T x, KernelFunc&& kernel) noexcept
+    {
+        x = clamp_exp_input(x);
+        const auto k = std::floor(x * (T)log2e + (T)0.5);
+        const auto r = x - k * (T)ln2_hi - k * (T)ln2_lo;
+        return kernel(r) * pow2i(k);
+    }
+
+    /**
+     * Schraudolph's exp() approximation: the scaled input is written
+     * straight into the exponent and mantissa bits of the result, so
+     * the mantissa is a linear interpolation between powers of two.
+     */
+    template <typename T>
+    static inline T exp_bit_trick(T x) noexcept
+    {
+        using int_type = typename FloatTraits<T>::int_type;
+        constexpr auto scale = mantissa_scale<T>();
+        constexpr auto offset = ((T)FloatTraits<T>::exponent_bias - (T)bit_trick_shift) * scale;
+        const auto bits = (int_type)(clamp_exp_input(x) * ((T)log2e * scale) + offset);
+
+        T result;
+        std::memcpy(&result, &bits, sizeof(T));
+        return result;
+    }
+} // namespace maths_detail
+#endif // DOXYGEN
+} // namespace RTNeural
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "maths_approx.h"
+#include <Eigen/Dense>
+
+namespace RTNeural
+{
+/**
+ * Default maths provider, which uses the (exact) array functions
+ * from Eigen.
+ *
+ * A maths provider is passed as a template argument to the templated
+ * recurrent and activation layers (e.g. GRULayerT, TanhActivationT),
+ * and must implement static `tanh()`, `sigmoid()`, and `exp()` methods
+ * for the scalar or vector type used by the current backend. Custom
+ * maths providers can be used to trade some accuracy for speed.
+ */
+struct DefaultMathsProvider
+{
+    template <typename Matrix>
+    static inline auto tanh(const Matrix& x) noexcept
+    {
+        return x.array().tanh();
+    }
+
+    template <typename Matrix>
+    static inline auto sigmoid(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        return (T)1 / (((T)-1 * x.array()).array().exp() + (T)1);
+    }
+
+    template <typename Matrix>
+    static inline auto exp(const Matrix& x) noexcept
+    {
+        return x.array().exp();
+    }
+};
+
+#ifndef DOXYGEN
+namespace maths_detail
+{
+    /** Reinterprets the bits of an integer array as an array of floating-point values. */
+    template <typename ArrayType, typename IntArrayType>
+    static inline ArrayType bit_cast_array(const IntArrayType& bits) noexcept
+    {
+        ArrayType result(bits.rows(), bits.cols());
+        std::memcpy(result.data(), bits.data(), sizeof(typename ArrayType::Scalar) * (size_t)bits.size());
+        return result;
+    }
+
+    /** Returns 2^k, for an integer-valued array k, by constructing the exponent bits directly. */
+    template <typename ArrayType>
+    static inline typename ArrayType::PlainArray pow2i_vec(const ArrayType& k) noexcept
+    {
+        using T = typename ArrayType::Scalar;
+        using int_type = typename FloatTraits<T>::int_type;
+        using int_array_type = Eigen::Array<int_type, ArrayType::RowsAtCompileTime, ArrayType::ColsAtCompileTime>;
+
+        const int_array_type bits = (k.template cast<int_type>() + (int_type)FloatTraits<T>::exponent_bias) * ((int_type)1 << FloatTraits<T>::mantissa_bits);
+        return bit_cast_array<typename ArrayType::PlainArray>(bits);
+    }
+
+    /** Clamps the input to exp() to the range where the result is finite and normal. */
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray clamp_exp_input_vec(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        constexpr auto limit = FloatTraits<T>::exp_limit;
+        return x.array().min(limit).max(-limit);
+    }
+
+    /** Computes exp(x) = 2^k * exp(r), using the given kernel to approximate exp(r). */
+    template <typename Matrix, typename KernelFunc>
+    static inline typename Matrix::PlainArray exp_range_reduced_vec(const Matrix& x, KernelFunc&& kernel) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        using array_type = typename Matrix::PlainArray;
+
+        const array_type xc = clamp_exp_input_vec(x);
+        const array_type k = (xc * (T)log2e + (T)0.5).floor();
+        const array_type r = xc - k * (T)ln2_hi - k * (T)ln2_lo;
+        return kernel(r) * pow2i_vec(k);
+    }
+
+    /** Base class for maths providers that compute tanh() and sigmoid() from their own exp(). */
+    template <typename ExpProvider>
+    struct ExpBasedMathsProvider
+    {
+        template <typename Matrix>
+        static inline typename Matrix::PlainArray tanh(const Matrix& x) noexcept
+        {
+            using T = typename Matrix::Scalar;
+            return (T)1 - (T)2 / (ExpProvider::exp((T)2 * x.array()) + (T)1);
+        }
+
+        template <typename Matrix>
+        static inline typename Matrix::PlainArray sigmoid(const Matrix& x) noexcept
+        {
+            using T = typename Matrix::Scalar;
+            return (T)1 / (ExpProvider::exp((T)-1 * x.array()) + (T)1);
+        }
+    };
+} // namespace maths_detail
+#endif // DOXYGEN
+
+/**
+ * Maths provider using Pade approximations: tanh() uses a [7/6] Pade
+ * approximant, sigmoid() is computed from tanh(), and exp() uses a
+ * [3/3] Pade approximant after range reduction.
+ */
+struct PadeMathsProvider
+{
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray tanh(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        using array_type = typename Matrix::PlainArray;
+
+        constexpr auto clamp = (T)5.7;
+        const array_type xc = x.array().min(clamp).max(-clamp);
+        const array_type x2 = xc.square();
+
+        const array_type numerator = xc * ((T)2027025 + x2 * ((T)270270 + x2 * ((T)6930 + (T)36 * x2)));
+        const array_type denominator = (T)2027025 + x2 * ((T)945945 + x2 * ((T)51975 + x2 * ((T)630 + x2)));
+        return numerator / denominator;
+    }
+
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray sigmoid(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        return (T)0.5 + (T)0.5 * tanh((T)0.5 * x.array());
+    }
+
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray exp(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        using array_type = typename Matrix::PlainArray;
+        return maths_detail::exp_range_reduced_vec(x, [](const array_type& r) -> array_type
+            {
+                const array_type r2 = r.square();
+                const array_type p = r * ((T)60 + r2);
+                const array_type q = (T)120 + (T)12 * r2;
+                return (q + p) / (q - p);
+            });
+    }
+};
+
+/**
+ * Maths provider using a degree-5 polynomial approximation of exp()
+ * after range reduction. tanh() and sigmoid() are computed from exp().
+ */
+struct PolynomialMathsProvider : maths_detail::ExpBasedMathsProvider<PolynomialMathsProvider>
+{
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray exp(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        using array_type = typename Matrix::PlainArray;
+        return maths_detail::exp_range_reduced_vec(x, [](const array_type& r) -> array_type
+            { return (T)1 + r * ((T)1 + r * ((T)1 / (T)2 + r * ((T)1 / (T)6 + r * ((T)1 / (T)24 + r * ((T)1 / (T)120))))); });
+    }
+};
+
+/**
+ * Maths provider using Schraudolph's bit-manipulation approximation
+ * of exp(), which is very fast, but only accurate to a few percent.
+ * tanh() and sigmoid() are computed from exp().
+ */
+struct BitTrickMathsProvider : maths_detail::ExpBasedMathsProvider<BitTrickMathsProvider>
+{
+    template <typename Matrix>
+    static inline typename Matrix::PlainArray exp(const Matrix& x) noexcept
+    {
+        using T = typename Matrix::Scalar;
+        using traits = maths_detail::FloatTraits<T>;
+        using int_type = typename traits::int_type;
+        using int_array_type = Eigen::Array<int_type, Matrix::RowsAtCompileTime, Matrix::ColsAtCompileTime>;
+
+        constexpr auto scale = maths_detail::mantissa_scale<T>();
+        constexpr auto offset = ((T)traits::exponent_bias - (T)maths_detail::bit_trick_shift) * scale;
+        const int_array_type bits = (maths_detail::clamp_exp_input_vec(x) * ((T)maths_detail::log2e * scale) + offset).template cast<int_type>();
+        return maths_detail::bit_cast_array<typename Matrix::PlainArray>(bits);
+    }
+};
+} // namespace RTNeural
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "maths_approx.h"
+
+namespace RTNeural
+{
+/**
+ * Default maths provider, which uses the (exact) functions from the
+ * standard library.
+ *
+ * A maths provider is passed as a template argument to the templated
+ * recurrent and activation layers (e.g. GRULayerT, TanhActivationT),
+ * and must implement static `tanh()`, `sigmoid()`, and `exp()` methods
+ * for the scalar or vector type used by the current backend. Custom
+ * maths providers can be used to trade some accuracy for speed.
+ */
+struct DefaultMathsProvider
+{
+    template <typename T>
+    static inline T tanh(T x) noexcept
+    {
+        return std::tanh(x);
+    }
+
+    template <typename T>
+    static inline T sigmoid(T x) noexcept
+    {
+        return (T)1 / ((T)1 + std::exp(-x));
+    }
+
+    template <typename T>
+    static inline T exp(T x) noexcept
+    {
+        return std::exp(x);
+    }
+};
+
+#ifndef DOXYGEN
+namespace maths_detail
+{
+    /** Base class for maths providers that compute tanh() and sigmoid() from their own exp(). */
+    template <typename ExpProvider>
+    struct ExpBasedMathsProvider
+    {
+        template <typename T>
+        static inline T tanh(T x) noexcept
+        {
+            return (T)1 - (T)2 / (ExpProvider::exp((T)2 * x) + (T)1);
+        }
+
+        template <typename T>
+        static inline T sigmoid(T x) noexcept
+        {
+            return (T)1 / ((T)1 + ExpProvider::exp(-x));
+        }
+    };
+} // namespace maths_detail
+#endif // DOXYGEN
+
+/**
+ * Maths provider using Pade approximations: tanh() uses a [7/6] Pade
+ * approximant, sigmoid() is computed from tanh(), and exp() uses a
+ * [3/3] Pade approximant after range reduction.
+ */
+struct PadeMathsProvider
+{
+    template <typename T>
+    static inline T tanh(T x) noexcept
+    {
+        return tanh_approx(x);
+    }
+
+    template <typename T>
+    static inline T sigmoid(T x) noexcept
+    {
+        return (T)0.5 + (T)0.5 * tanh_approx((T)0.5 * x);
+    }
+
+    template <typename T>
+    static inline T exp(T x) noexcept
+    {
+        return maths_detail::exp_range_reduced(x, [](T r)
+            { return maths_detail::exp_pade_kernel(r); });
+    }
+};
+
+/**
+ * Maths provider using a degree-5 polynomial approximation of exp()
+ * after range reduction. tanh() and sigmoid() are computed from exp().
+ */
+struct PolynomialMathsProvider : maths_detail::ExpBasedMathsProvider<PolynomialMathsProvider>
+{
+    template <typename T>
+    static inline T exp(T x) noexcept
+    {
+        return maths_detail::exp_range_reduced(x, [](T r)
+            { return maths_detail::exp_poly_kernel(r); });
+    }
+};
+
+/**
+ * Maths provider using Schraudolph's bit-manipulation approximation
+ * of exp(), which is very fast, but only accurate to a few percent.
+ * tanh() and sigmoid() are computed from exp().
+ */
+struct BitTrickMathsProvider : maths_detail::ExpBasedMathsProvider<BitTrickMathsProvider>
+{
+    template <typename T>
+    static inline T exp(T x) noexcept
+    {
+        return maths_detail::exp_bit_trick(x);
+    }
+};
+} // namespace RTNeural
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "maths_approx.h"
+#if RTNEURAL_USE_VECTOR_EXT
+#include "../vector_ext/vector_ext.h"
+#else
+#include <xsimd/xsimd.hpp>
+#endif
+
+namespace RTNeural
+{
+#ifndef DOXYGEN
+/**
+ * Vectorized maths kernels, shared by the XSIMD layers. All constants
+ * are compile-time constants, so the kernels don't need any static
+ * initialization.
+ */
+namespace maths_detail
+{
+    /** Clamps the input to exp() to the range where the result is finite and normal. */
+    template <typename B>
+    static inline B clamp_exp_input_vec(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+        constexpr auto limit = FloatTraits<T>::exp_limit;
+        return xsimd::clip(x, B(-limit), B(limit));
+    }
+
+    /**
+     * Computes exp(x) = 2^k * exp(r), using the given kernel to approximate exp(r).
+     * The range reduction r = x - k * ln(2) uses fused multiply-adds, with ln(2)
+     * split into two parts.
+     */
+    template <typename B, typename KernelFunc>
+    static inline B exp_range_reduced_vec(const B& x, KernelFunc&& kernel) noexcept
+    {
+        using T = typename B::value_type;
+
+        const auto xc = clamp_exp_input_vec(x);
+        const auto k = xsimd::floor(xsimd::fma(xc, B((T)log2e), B((T)0.5)));
+        const auto r = xsimd::fnma(k, B((T)ln2_lo), xsimd::fnma(k, B((T)ln2_hi), xc));
+        return xsimd::ldexp(kernel(r), xsimd::to_int(k));
+    }
+
+    /** Evaluates the Taylor series of exp(r), from the n-th term up to the given degree, using Horner's method. */
+    template <typename B, int n, int degree>
+    struct ExpTaylorSeries
+    {
+        static inline B eval(const B& r) noexcept
+        {
+            constexpr auto coeff = inv_factorial<typename B::value_type>(n);
+            return xsimd::fma(ExpTaylorSeries<B, n + 1, degree>::eval(r), r, B(coeff));
+        }
+    };
+
+    template <typename B, int degree>
+    struct ExpTaylorSeries<B, degree, degree>
+    {
+        static inline B eval(const B&) noexcept
+        {
+            constexpr auto coeff = inv_factorial<typename B::value_type>(degree);
+            return B(coeff);
+        }
+    };
+
+    /** Full-precision exp(), without the special-case handling of xsimd::exp(). */
+    template <typename B>
+    static inline B exp_vec(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+        return exp_range_reduced_vec(x, [](const B& r)
+            { return ExpTaylorSeries<B, 0, FloatTraits<T>::exp_poly_degree>::eval(r); });
+    }
+
+    template <typename B>
+    static inline B sigmoid_vec(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+        return (T)1 / ((T)1 + exp_vec(-x));
+    }
+
+    template <typename B>
+    static inline B elu_vec(const B& x, typename B::value_type alpha) noexcept
+    {
+        using T = typename B::value_type;
+        return xsimd::select(x > (T)0, x, alpha * (exp_vec(x) - (T)1));
+    }
+
+    /** [7/6] Pade approximation of tanh(). */
+    template <typename B>
+    static inline B tanh_pade_vec(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+
+        constexpr auto clamp = (T)5.7;
+        const auto xc = xsimd::clip(x, B(-clamp), B(clamp));
+        const auto x2 = xc * xc;
+
+        const auto numerator = xc * ((T)2027025 + x2 * ((T)270270 + x2 * ((T)6930 + (T)36 * x2)));
+        const auto denominator = (T)2027025 + x2 * ((T)945945 + x2 * ((T)51975 + x2 * ((T)630 + x2)));
+        return numerator / denominator;
+    }
+
+    /** Returns the largest lane of a batch. */
+    template <typename B>
+    static inline typename B::value_type reduce_max_vec(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+
+        T lanes alignas(alignof(B))[B::size];
+        xsimd::store_aligned(lanes, x);
+
+        auto max_value = lanes[0];
+        for(size_t i = 1; i < B::size; ++i)
+            max_value = lanes[i] > max_value ? lanes[i] : max_value;
+        return max_value;
+    }
+
+    /** Base class for maths providers that compute tanh() and sigmoid() from their own exp(). */
+    template <typename ExpProvider>
+    struct ExpBasedMathsProvider
+    {
+        template <typename B>
+        static inline B tanh(const B& x) noexcept
+        {
+            using T = typename B::value_type;
+            return (T)1 - (T)2 / (ExpProvider::exp((T)2 * x) + (T)1);
+        }
+
+        template <typename B>
+        static inline B sigmoid(const B& x) noexcept
+        {
+            using T = typename B::value_type;
+            return (T)1 / ((T)1 + ExpProvider::exp(-x));
+        }
+    };
+} // namespace maths_detail
+#endif // DOXYGEN
+
+/**
+ * Default maths provider, which uses xsimd::tanh(), and a
+ * full-precision vectorized exp() for exp() and sigmoid().
+ *
+ * A maths provider is passed as a template argument to the templated
+ * recurrent and activation layers (e.g. GRULayerT, TanhActivationT),
+ * and must implement static `tanh()`, `sigmoid()`, and `exp()` methods
+ * for the scalar or vector type used by the current backend. Custom
+ * maths providers can be used to trade some accuracy for speed.
+ */
+struct DefaultMathsProvider
+{
+    template <typename B>
+    static inline B tanh(const B& x) noexcept
+    {
+        return xsimd::tanh(x);
+    }
+
+    template <typename B>
+    static inline B sigmoid(const B& x) noexcept
+    {
+        return maths_detail::sigmoid_vec(x);
+    }
+
+    template <typename B>
+    static inline B exp(const B& x) noexcept
+    {
+        return maths_detail::exp_vec(x);
+    }
+};
+
+/**
+ * Maths provider using Pade approximations: tanh() uses a [7/6] Pade
+ * approximant, sigmoid() is computed from tanh(), and exp() uses a
+ * [3/3] Pade approximant after range reduction.
+ */
+struct PadeMathsProvider
+{
+    template <typename B>
+    static inline B tanh(const B& x) noexcept
+    {
+        return maths_detail::tanh_pade_vec(x);
+    }
+
+    template <typename B>
+    static inline B sigmoid(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+        return (T)0.5 + (T)0.5 * tanh((T)0.5 * x);
+    }
+
+    template <typename B>
+    static inline B exp(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+        return maths_detail::exp_range_reduced_vec(x, [](const B& r)
+            {
+                const auto r2 = r * r;
+                const auto p = r * ((T)60 + r2);
+                const auto q = (T)120 + (T)12 * r2;
+                return (q + p) / (q - p);
+            });
+    }
+};
+
+/**
+ * Maths provider using a degree-5 polynomial approximation of exp()
+ * after range reduction. tanh() and sigmoid() are computed from exp().
+ */
+struct PolynomialMathsProvider : maths_detail::ExpBasedMathsProvider<PolynomialMathsProvider>
+{
+    template <typename B>
+    static inline B exp(const B& x) noexcept
+    {
+        return maths_detail::exp_range_reduced_vec(x, [](const B& r)
+            { return maths_detail::ExpTaylorSeries<B, 0, 5>::eval(r); });
+    }
+};
+
+/**
+ * Maths provider using Schraudolph's approximation of exp(), which
+ * is very fast, but only accurate to a few percent. tanh() and
+ * sigmoid() are computed from exp().
+ *
+ * Instead of writing into the floating-point bits directly, the
+ * vectorized version computes the same piecewise-linear mantissa,
+ * and scales it by the integer part of the exponent with ldexp().
+ */
+struct BitTrickMathsProvider : maths_detail::ExpBasedMathsProvider<BitTrickMathsProvider>
+{
+    template <typename B>
+    static inline B exp(const B& x) noexcept
+    {
+        using T = typename B::value_type;
+
+        const auto y = maths_detail::clamp_exp_input_vec(x) * (T)maths_detail::log2e - (T)maths_detail::bit_trick_shift;
+        const auto k = xsimd::floor(y);
+        return xsimd::ldexp((T)1 + (y - k), xsimd::to_int(k));
+    }
+};
+} // namespace RTNeural
@@ -2,10 +2,25 @@
 
 #include "../modules/json/json.hpp"
 #include "Model.h"
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+// Set to 0 to load the layer weights on the calling thread, even if more threads are requested.
+#ifndef RTNEURAL_PARALLEL_LOADING
+#define RTNEURAL_PARALLEL_LOADING 1
+#endif
+
+#if RTNEURAL_PARALLEL_LOADING
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace RTNeural
 {
@@ -18,33 +33,259 @@ namespace json_parser
             std::cout << str << std::endl;
     }
 
-    /** Loads weights for a Dense (or DenseT) layer from a json representation of the layer weights. */
-    template <typename T, typename DenseType>
-    void loadDense(DenseType& dense, const nlohmann::json& weights)
+    namespace detail
     {
-        // load weights
-        std::vector<std::vector<T>> denseWeights(dense.out_size);
-        for(auto& w : denseWeights)
-            w.resize(dense.in_size, (T)0);
+        template <typename T>
+        void flattenWeights(const nlohmann::json& weights, const int* sizes, const std::ptrdiff_t* strides, int num_dims, T* data)
+        {
+            int i = 0;
+            for(const auto& w : weights)
+            {
+                if(i >= sizes[0])
+                    break;
+
+                if(num_dims == 1)
+                    data[i] = w.get<T>();
+                else
+                    flattenWeights(w, sizes + 1, strides + 1, num_dims - 1, data + i * strides[0]);
+                ++i;
+            }
+        }
+
+        /**
+         * Copies a json array of weights into a flat buffer, and returns
+         * a row-major view of the buffer with the given dimensions.
+         * Any weights missing from the json array are set to zero.
+         */
+        template <typename T, int num_dims>
+        WeightsView<T, num_dims> flattenWeights(const nlohmann::json& weights, const int (&sizes)[num_dims], std::vector<T>& buffer)
+        {
+            int total_size = 1;
+            for(int d = 0; d < num_dims; ++d)
+                total_size *= sizes[d];
+            buffer.assign((size_t)total_size, (T)0);
+
+            const auto view = WeightsView<T, num_dims>::rowMajor(buffer.data(), sizes);
+            flattenWeights(weights, view.sizes, view.strides, num_dims, buffer.data());
+            return view;
+        }
+
+        template <typename T>
+        std::vector<std::vector<T>> toNestedVectors(const WeightsView<T, 2>& view)
+        {
+            std::vector<std::vector<T>> weights((size_t)view.size(0));
+            for(int i = 0; i < view.size(0); ++i)
+            {
+                weights[i].resize((size_t)view.size(1));
+                for(int j = 0; j < view.size(1); ++j)
+                    weights[i][j] = view(i, j);
+            }
+
+            return weights;
+        }
+
+        template <typename T>
+        std::vector<std::vector<std::vector<T>>> toNestedVectors(const WeightsView<T, 3>& view)
+        {
+            std::vector<std::vector<std::vector<T>>> weights((size_t)view.size(0));
+            for(int i = 0; i < view.size(0); ++i)
+            {
+                weights[i].resize((size_t)view.size(1));
+                for(int j = 0; j < view.size(1); ++j)
+                {
+                    weights[i][j].resize((size_t)view.size(2));
+                    for(int k = 0; k < view.size(2); ++k)
+                        weights[i][j][k] = view(i, j, k);
+                }
+            }
+
+            return weights;
+        }
+
+        template <typename T>
+        std::vector<std::vector<std::vector<std::vector<T>>>> toNestedVectors(const WeightsView<T, 4>& view)
+        {
+            std::vector<std::vector<std::vector<std::vector<T>>>> weights((size_t)view.size(0));
+            for(int i = 0; i < view.size(0); ++i)
+            {
+                weights[i].resize((size_t)view.size(1));
+                for(int j = 0; j < view.size(1); ++j)
+                {
+                    weights[i][j].resize((size_t)view.size(2));
+                    for(int k = 0; k < view.size(2); ++k)
+                    {
+                        weights[i][j][k].resize((size_t)view.size(3));
+                        for(int m = 0; m < view.size(3); ++m)
+                            weights[i][j][k][m] = view(i, j, k, m);
+                    }
+                }
+            }
+
+            return weights;
+        }
+
+        /** A weight tensor, with its values stored contiguously in row-major order. */
+        template <typename T>
+        struct Tensor
+        {
+            std::vector<size_t> shape;
+            std::vector<T> values;
+
+            template <int num_dims>
+            bool hasShape(const int (&sizes)[num_dims]) const
+            {
+                if(shape.size() != (size_t)num_dims)
+                    return false;
+
+                for(int d = 0; d < num_dims; ++d)
+                    if(shape[(size_t)d] != (size_t)sizes[d])
+                        return false;
+
+                return true;
+            }
+
+            /** Returns true if the tensor has a value for every element of its shape. */
+            bool isComplete() const
+            {
+                size_t numValues = 1;
+                for(auto dim : shape)
+                    numValues *= dim;
+                return numValues == values.size();
+            }
+        };
+
+        /**
+         * The layer loaders below can read the layer weights either from a json array,
+         * or from a list of tensors (see parseJsonStreaming()). getWeights() returns
+         * a row-major view of one of the weights, with the given dimensions.
+         *
+         * Weights from json are copied into the buffer, and any weights missing from
+         * the json array are set to zero. Tensors are viewed without copying, so they
+         * must have exactly the given dimensions.
+         */
+        template <typename T, int num_dims>
+        WeightsView<T, num_dims> getWeights(const nlohmann::json& weights, size_t idx, const int (&sizes)[num_dims], std::vector<T>& buffer)
+        {
+            return flattenWeights<T>(idx < weights.size() ? weights[idx] : nlohmann::json::array(), sizes, buffer);
+        }
+
+        template <typename T, int num_dims>
+        WeightsView<T, num_dims> getWeights(const std::vector<Tensor<T>>& weights, size_t idx, const int (&sizes)[num_dims], std::vector<T>& /*buffer*/)
+        {
+            if(idx >= weights.size() || !weights[idx].hasShape(sizes))
+                throw std::invalid_argument("Layer weights " + std::to_string(idx) + " have the wrong dimensions!");
+
+            return WeightsView<T, num_dims>::rowMajor(weights[idx].values.data(), sizes);
+        }
+
+        /** Returns a copy of one of the one-dimensional weights (e.g. a bias vector). */
+        template <typename T, typename WeightsType>
+        std::vector<T> getVector(const WeightsType& weights, size_t idx, int size)
+        {
+            std::vector<T> buffer;
+            const auto view = getWeights<T>(weights, idx, { size }, buffer);
+            if(view.data != buffer.data())
+                buffer.assign(view.data, view.data + size);
+            return buffer;
+        }
+
+        /** Returns the size of a dimension of one of the weights, or zero if the weights don't have that dimension. */
+        inline int getWeightsSize(const nlohmann::json& weights, size_t idx, int dim)
+        {
+            if(idx >= weights.size())
+                return 0;
+
+            const auto* w = &weights[idx];
+            for(int d = 0; d < dim; ++d)
+            {
+                if(!w->is_array() || w->empty())
+                    return 0;
+                w = &w->front();
+            }
+
+            return w->is_array() ? (int)w->size() : 0;
+        }
+
+        template <typename T>
+        int getWeightsSize(const std::vector<Tensor<T>>& weights, size_t idx, int dim)
+        {
+            if(idx >= weights.size() || (size_t)dim >= weights[idx].shape.size())
+                return 0;
+
+            return (int)weights[idx].shape[(size_t)dim];
+        }
 
-        auto layerWeights = weights[0];
-        for(size_t i = 0; i < layerWeights.size(); ++i)
+        /**
+         * The setters below pass a weights view directly to the layer
+         * if the layer can be loaded from a weights view, and otherwise
+         * fall back to nested std::vectors.
+         */
+        template <typename LayerType, typename T, int num_dims>
+        auto setWeights(LayerType& layer, const WeightsView<T, num_dims>& w, int) -> decltype(layer.setWeights(w), void())
         {
-            auto lw = layerWeights[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                denseWeights[j][i] = lw[j].get<T>();
+            layer.setWeights(w);
         }
 
-        dense.setWeights(denseWeights);
+        template <typename LayerType, typename T, int num_dims>
+        void setWeights(LayerType& layer, const WeightsView<T, num_dims>& w, long)
+        {
+            layer.setWeights(toNestedVectors(w));
+        }
+
+        template <typename LayerType, typename T>
+        auto setWVals(LayerType& layer, const WeightsView<T, 2>& w, int) -> decltype(layer.setWVals(w), void())
+        {
+            layer.setWVals(w);
+        }
+
+        template <typename LayerType, typename T>
+        void setWVals(LayerType& layer, const WeightsView<T, 2>& w, long)
+        {
+            layer.setWVals(toNestedVectors(w));
+        }
+
+        template <typename LayerType, typename T>
+        auto setUVals(LayerType& layer, const WeightsView<T, 2>& w, int) -> decltype(layer.setUVals(w), void())
+        {
+            layer.setUVals(w);
+        }
+
+        template <typename LayerType, typename T>
+        void setUVals(LayerType& layer, const WeightsView<T, 2>& w, long)
+        {
+            layer.setUVals(toNestedVectors(w));
+        }
+
+        template <typename LayerType, typename T>
+        auto setBVals(LayerType& layer, const WeightsView<T, 2>& w, int) -> decltype(layer.setBVals(w), void())
+        {
+            layer.setBVals(w);
+        }
+
+        template <typename LayerType, typename T>
+        void setBVals(LayerType& layer, const WeightsView<T, 2>& w, long)
+        {
+            layer.setBVals(toNestedVectors(w));
+        }
+    } // namespace detail
+
+    /** Loads weights for a Dense (or DenseT) layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename DenseType, typename WeightsType = nlohmann::json>
+    void loadDense(DenseType& dense, const WeightsType& weights)
+    {
+        // load weights (the json kernel has dimensions [in_size][out_size])
+        std::vector<T> kernel;
+        const auto kernelView = detail::getWeights<T>(weights, 0, { dense.in_size, dense.out_size }, kernel);
+        detail::setWeights(dense, kernelView.transposed(), 0);
 
         // load biases
-        std::vector<T> denseBias = weights[1].get<std::vector<T>>();
+        std::vector<T> denseBias = detail::getVector<T>(weights, 1, dense.out_size);
         dense.setBias(denseBias.data());
     }
 
-    /** Creates a Dense layer from a json representation of the layer weights. */
-    template <typename T>
-    std::unique_ptr<Dense<T>> createDense(int in_size, int out_size, const nlohmann::json& weights)
+    /** Creates a Dense layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<Dense<T>> createDense(int in_size, int out_size, const WeightsType& weights)
     {
         auto dense = std::make_unique<Dense<T>>(in_size, out_size);
         loadDense<T>(*dense.get(), weights);
@@ -70,49 +311,41 @@ namespace json_parser
         return true;
     }
 
-    /** Loads weights for a Conv1D (or Conv1DT) layer from a json representation of the layer weights. */
-    template <typename T, typename Conv1DType>
-    void loadConv1D(Conv1DType& conv, int kernel_size, int /*dilation*/, const nlohmann::json& weights)
+    /** Loads weights for a Conv1D (or Conv1DT) layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename Conv1DType, typename WeightsType = nlohmann::json>
+    void loadConv1D(Conv1DType& conv, int kernel_size, int /*dilation*/, const WeightsType& weights)
     {
-        // load weights
-        std::vector<std::vector<std::vector<T>>> convWeights(conv.out_size);
-        for(auto& wIn : convWeights)
-        {
-            wIn.resize(conv.in_size);
-
-            for(auto& w : wIn)
-                w.resize(kernel_size, (T)0);
-        }
-
-        auto layerWeights = weights[0];
-        for(size_t i = 0; i < layerWeights.size(); ++i)
-        {
-            auto lw = layerWeights[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-            {
-                auto l = lw[j];
-                for(size_t k = 0; k < l.size(); ++k)
-                    convWeights[k][j][kernel_size - 1 - i] = l[k].get<T>();
-            }
-        }
-
-        conv.setWeights(convWeights);
+        // load weights (the json kernel has dimensions [kernel_size][in_size][out_size],
+        // with the kernel taps in reverse order)
+        std::vector<T> kernel;
+        const auto kernelView = detail::getWeights<T>(weights, 0, { kernel_size, conv.in_size, conv.out_size }, kernel);
+        detail::setWeights(conv, kernelView.transposed(0, 2).reversed(2), 0);
 
         // load biases
-        std::vector<T> convBias = weights[1].get<std::vector<T>>();
+        std::vector<T> convBias = detail::getVector<T>(weights, 1, conv.out_size);
         conv.setBias(convBias);
     }
 
-    /** Creates a Conv1D layer from a json representation of the layer weights. */
-    template <typename T>
+    /** Creates a Conv1D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
     std::unique_ptr<Conv1D<T>> createConv1D(int in_size, int out_size,
-        int kernel_size, int dilation, const nlohmann::json& weights)
+        int kernel_size, int dilation, const WeightsType& weights)
     {
         auto conv = std::make_unique<Conv1D<T>>(in_size, out_size, kernel_size, dilation);
         loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
         return std::move(conv);
     }
 
+    /** Creates a StridedConv1D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<StridedConv1D<T>> createStridedConv1D(int in_size, int out_size,
+        int kernel_size, int dilation, int stride, const WeightsType& weights)
+    {
+        auto conv = std::make_unique<StridedConv1D<T>>(in_size, out_size, kernel_size, dilation, stride);
+        loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
+        return std::move(conv);
+    }
+
     /** Checks that a Conv1D (or Conv1DT) layer has the given dimensions. */
     template <typename T, typename Conv1DType>
     bool checkConv1D(const Conv1DType& conv, const std::string& type, int layerDims,
@@ -145,59 +378,164 @@ namespace json_parser
         return true;
     }
 
-    /** Loads weights for a GRULayer (or GRULayerT) from a json representation of the layer weights. */
-    template <typename T, typename GRUType>
-    void loadGRU(GRUType& gru, const nlohmann::json& weights)
+    /**
+     * Loads weights for a TransposedConv1D (or TransposedConv1DT) layer from a json representation of the layer weights
+     * (or from weight tensors).
+     *
+     * The kernel is expected in the PyTorch `ConvTranspose1d` layout: [in_size][num_filters_out][kernel_size]
+     */
+    template <typename T, typename TransposedConv1DType, typename WeightsType = nlohmann::json>
+    void loadTransposedConv1D(TransposedConv1DType& conv, const WeightsType& weights)
     {
-        // load kernel weights
-        std::vector<std::vector<T>> kernelWeights(gru.in_size);
-        for(auto& w : kernelWeights)
-            w.resize(3 * gru.out_size, (T)0);
+        // load weights (reordered to [num_filters_out][in_size][kernel_size])
+        std::vector<T> kernel;
+        const auto kernelView = detail::getWeights<T>(weights, 0, { conv.in_size, conv.getNumFiltersOut(), conv.getKernelSize() }, kernel);
+        conv.setWeights(detail::toNestedVectors(kernelView.transposed(0, 1)));
+
+        // load biases
+        std::vector<T> convBias = detail::getVector<T>(weights, 1, conv.getNumFiltersOut());
+        conv.setBias(convBias);
+    }
+
+    /** Creates a TransposedConv1D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<TransposedConv1D<T>> createTransposedConv1D(int in_size, int num_filters_out,
+        int kernel_size, int stride, const WeightsType& weights)
+    {
+        auto conv = std::make_unique<TransposedConv1D<T>>(in_size, num_filters_out, kernel_size, stride);
+        loadTransposedConv1D<T>(*conv.get(), weights);
+        return std::move(conv);
+    }
 
-        auto layerWeights = weights[0];
-        for(size_t i = 0; i < layerWeights.size(); ++i)
+    /** Checks that a TransposedConv1D (or TransposedConv1DT) layer has the given dimensions. */
+    template <typename T, typename TransposedConv1DType>
+    bool checkTransposedConv1D(const TransposedConv1DType& conv, const std::string& type, int layerDims,
+        int kernel_size, int stride, const bool debug)
+    {
+        if(type != "transposed-conv1d")
         {
-            auto lw = layerWeights[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                kernelWeights[i][j] = lw[j].get<T>();
+            debug_print("Wrong layer type! Expected: TransposedConv1D", debug);
+            return false;
         }
 
-        gru.setWVals(kernelWeights);
+        if(layerDims != conv.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(conv.out_size), debug);
+            return false;
+        }
 
-        // load recurrent weights
-        std::vector<std::vector<T>> recurrentWeights(gru.out_size);
-        for(auto& w : recurrentWeights)
-            w.resize(3 * gru.out_size, (T)0);
+        if(kernel_size != conv.getKernelSize())
+        {
+            debug_print("Wrong kernel size! Expected: " + std::to_string(conv.getKernelSize()), debug);
+            return false;
+        }
 
-        auto layerWeights2 = weights[1];
-        for(size_t i = 0; i < layerWeights2.size(); ++i)
+        if(stride != conv.getStride())
         {
-            auto lw = layerWeights2[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                recurrentWeights[i][j] = lw[j].get<T>();
+            debug_print("Wrong stride! Expected: " + std::to_string(conv.getStride()), debug);
+            return false;
         }
 
-        gru.setUVals(recurrentWeights);
+        return true;
+    }
+
+    /**
+     * Loads weights for a Conv2D (or Conv2DT) layer from a json representation of the layer weights
+     * (or from weight tensors).
+     *
+     * The kernel is expected in the Keras layout: [kernel_size_time][kernel_size_feature][num_filters_in][num_filters_out]
+     */
+    template <typename T, typename Conv2DType, typename WeightsType = nlohmann::json>
+    void loadConv2D(Conv2DType& conv, const WeightsType& weights)
+    {
+        // load weights (reordered to [num_filters_out][num_filters_in][kernel_size_time][kernel_size_feature],
+        // with the time taps in reverse order)
+        std::vector<T> kernel;
+        const auto kernelView = detail::getWeights<T>(weights, 0,
+            { conv.getKernelSizeTime(), conv.getKernelSizeFeature(), conv.getNumFiltersIn(), conv.getNumFiltersOut() }, kernel);
+        conv.setWeights(detail::toNestedVectors(kernelView.transposed(0, 3).transposed(1, 2).transposed(2, 3).reversed(2)));
 
         // load biases
-        std::vector<std::vector<T>> gruBias(2);
-        for(auto& b : gruBias)
-            b.resize(3 * gru.out_size, (T)0);
+        std::vector<T> convBias = detail::getVector<T>(weights, 1, conv.getNumFiltersOut());
+        conv.setBias(convBias);
+    }
+
+    /** Creates a Conv2D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<Conv2D<T>> createConv2D(int num_filters_in, int num_filters_out, int num_features_in,
+        int kernel_size_time, int kernel_size_feature, int dilation, int stride, bool valid_pad, const WeightsType& weights)
+    {
+        auto conv = std::make_unique<Conv2D<T>>(num_filters_in, num_filters_out, num_features_in,
+            kernel_size_time, kernel_size_feature, dilation, stride, valid_pad);
+        loadConv2D<T>(*conv.get(), weights);
+        return std::move(conv);
+    }
+
+    /** Checks that a Conv2D (or Conv2DT) layer has the given dimensions. */
+    template <typename T, typename Conv2DType>
+    bool checkConv2D(const Conv2DType& conv, const std::string& type, int layerDims,
+        int kernel_size_time, int kernel_size_feature, int dilation_rate, int stride, bool valid_pad, const bool debug)
+    {
+        if(type != "conv2d")
+        {
+            debug_print("Wrong layer type! Expected: Conv2D", debug);
+            return false;
+        }
+
+        if(layerDims != conv.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(conv.out_size), debug);
+            return false;
+        }
+
+        if(kernel_size_time != conv.getKernelSizeTime() || kernel_size_feature != conv.getKernelSizeFeature())
+        {
+            debug_print("Wrong kernel size! Expected: " + std::to_string(conv.getKernelSizeTime())
+                    + "x" + std::to_string(conv.getKernelSizeFeature()),
+                debug);
+            return false;
+        }
+
+        if(dilation_rate != conv.getDilationRate())
+        {
+            debug_print("Wrong dilation_rate! Expected: " + std::to_string(conv.getDilationRate()), debug);
+            return false;
+        }
+
+        if(stride != conv.getStride())
+        {
+            debug_print("Wrong stride! Expected: " + std::to_string(conv.getStride()), debug);
+            return false;
+        }
 
-        auto layerBias = weights[2];
-        for(size_t i = 0; i < layerBias.size(); ++i)
+        if(valid_pad != conv.isValidPad())
         {
-            auto lw = layerBias[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                gruBias[i][j] = lw[j].get<T>();
+            debug_print("Wrong padding! Expected: " + std::string(conv.isValidPad() ? "valid" : "same"), debug);
+            return false;
         }
 
-        gru.setBVals(gruBias);
+        return true;
     }
 
-    /** Creates a GRULayer from a json representation of the layer weights. */
-    template <typename T>
-    std::unique_ptr<GRULayer<T>> createGRU(int in_size, int out_size, const nlohmann::json& weights)
+    /** Loads weights for a GRULayer (or GRULayerT) from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename GRUType, typename WeightsType = nlohmann::json>
+    void loadGRU(GRUType& gru, const WeightsType& weights)
+    {
+        std::vector<T> buffer;
+
+        // load kernel weights
+        detail::setWVals(gru, detail::getWeights<T>(weights, 0, { gru.in_size, 3 * gru.out_size }, buffer), 0);
+
+        // load recurrent weights
+        detail::setUVals(gru, detail::getWeights<T>(weights, 1, { gru.out_size, 3 * gru.out_size }, buffer), 0);
+
+        // load biases
+        detail::setBVals(gru, detail::getWeights<T>(weights, 2, { 2, 3 * gru.out_size }, buffer), 0);
+    }
+
+    /** Creates a GRULayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<GRULayer<T>> createGRU(int in_size, int out_size, const WeightsType& weights)
     {
         auto gru = std::make_unique<GRULayer<T>>(in_size, out_size);
         loadGRU<T>(*gru.get(), weights);
@@ -223,48 +561,26 @@ namespace json_parser
         return true;
     }
 
-    /** Loads weights for a LSTMLayer (or LSTMLayerT) from a json representation of the layer weights. */
-    template <typename T, typename LSTMType>
-    void loadLSTM(LSTMType& lstm, const nlohmann::json& weights)
+    /** Loads weights for a LSTMLayer (or LSTMLayerT) from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename LSTMType, typename WeightsType = nlohmann::json>
+    void loadLSTM(LSTMType& lstm, const WeightsType& weights)
     {
-        // load kernel weights
-        std::vector<std::vector<T>> kernelWeights(lstm.in_size);
-        for(auto& w : kernelWeights)
-            w.resize(4 * lstm.out_size, (T)0);
+        std::vector<T> buffer;
 
-        auto layerWeights = weights[0];
-        for(size_t i = 0; i < layerWeights.size(); ++i)
-        {
-            auto lw = layerWeights[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                kernelWeights[i][j] = lw[j].get<T>();
-        }
-
-        lstm.setWVals(kernelWeights);
+        // load kernel weights
+        detail::setWVals(lstm, detail::getWeights<T>(weights, 0, { lstm.in_size, 4 * lstm.out_size }, buffer), 0);
 
         // load recurrent weights
-        std::vector<std::vector<T>> recurrentWeights(lstm.out_size);
-        for(auto& w : recurrentWeights)
-            w.resize(4 * lstm.out_size, (T)0);
-
-        auto layerWeights2 = weights[1];
-        for(size_t i = 0; i < layerWeights2.size(); ++i)
-        {
-            auto lw = layerWeights2[i];
-            for(size_t j = 0; j < lw.size(); ++j)
-                recurrentWeights[i][j] = lw[j].get<T>();
-        }
-
-        lstm.setUVals(recurrentWeights);
+        detail::setUVals(lstm, detail::getWeights<T>(weights, 1, { lstm.out_size, 4 * lstm.out_size }, buffer), 0);
 
         // load biases
-        std::vector<T> lstmBias = weights[2].get<std::vector<T>>();
+        std::vector<T> lstmBias = detail::getVector<T>(weights, 2, 4 * lstm.out_size);
         lstm.setBVals(lstmBias);
     }
 
-    /** Creates a LSTMLayer from a json representation of the layer weights. */
-    template <typename T>
-    std::unique_ptr<LSTMLayer<T>> createLSTM(int in_size, int out_size, const nlohmann::json& weights)
+    /** Creates a LSTMLayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<LSTMLayer<T>> createLSTM(int in_size, int out_size, const WeightsType& weights)
     {
         auto lstm = std::make_unique<LSTMLayer<T>>(in_size, out_size);
         loadLSTM<T>(*lstm.get(), weights);
@@ -290,6 +606,86 @@ namespace json_parser
         return true;
     }
 
+    /**
+     * Loads weights for a WaveNetBlock (or WaveNetBlockT) from a json representation of the layer weights
+     * (or from weight tensors).
+     *
+     * The weights are expected in the following order:
+     * - convolution kernel: [kernel_size][channels][2 * channels]
+     * - convolution bias: [2 * channels]
+     * - projection kernel: [channels][channels + skip_channels]
+     * - projection bias: [channels + skip_channels]
+     */
+    template <typename T, typename WaveNetType, typename WeightsType = nlohmann::json>
+    void loadWaveNetBlock(WaveNetType& block, const WeightsType& weights)
+    {
+        const auto channels = block.getChannels();
+        std::vector<T> buffer;
+
+        // load convolution weights (reordered to [2 * channels][channels][kernel_size],
+        // with the kernel taps in reverse order)
+        const auto convView = detail::getWeights<T>(weights, 0, { block.getKernelSize(), channels, 2 * channels }, buffer);
+        block.setConvWeights(detail::toNestedVectors(convView.transposed(0, 2).reversed(2)));
+
+        std::vector<T> convBias = detail::getVector<T>(weights, 1, 2 * channels);
+        block.setConvBias(convBias);
+
+        // load residual/skip projection weights
+        const auto projView = detail::getWeights<T>(weights, 2, { channels, block.out_size }, buffer);
+        block.setProjectionWeights(detail::toNestedVectors(projView.transposed()));
+
+        std::vector<T> projBias = detail::getVector<T>(weights, 3, block.out_size);
+        block.setProjectionBias(projBias);
+    }
+
+    /** Creates a WaveNetBlock from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<WaveNetBlock<T>> createWaveNetBlock(int in_size, int channels,
+        int kernel_size, int dilation, const WeightsType& weights)
+    {
+        auto block = std::make_unique<WaveNetBlock<T>>(channels, in_size - channels, kernel_size, dilation);
+        loadWaveNetBlock<T>(*block.get(), weights);
+        return std::move(block);
+    }
+
+    /** Checks that a WaveNetBlock (or WaveNetBlockT) has the given dimensions. */
+    template <typename T, typename WaveNetType>
+    bool checkWaveNetBlock(const WaveNetType& block, const std::string& type, int layerDims,
+        int channels, int kernel_size, int dilation_rate, const bool debug)
+    {
+        if(type != "wavenet-block")
+        {
+            debug_print("Wrong layer type! Expected: WaveNetBlock", debug);
+            return false;
+        }
+
+        if(layerDims != block.out_size)
+        {
+            debug_print("Wrong layer size! Expected: " + std::to_string(block.out_size), debug);
+            return false;
+        }
+
+        if(channels != block.getChannels())
+        {
+            debug_print("Wrong number of channels! Expected: " + std::to_string(block.getChannels()), debug);
+            return false;
+        }
+
+        if(kernel_size != block.getKernelSize())
+        {
+            debug_print("Wrong kernel size! Expected: " + std::to_string(block.getKernelSize()), debug);
+            return false;
+        }
+
+        if(dilation_rate != block.getDilationRate())
+        {
+            debug_print("Wrong dilation_rate! Expected: " + std::to_string(block.getDilationRate()), debug);
+            return false;
+        }
+
+        return true;
+    }
+
     /** Creates an activation layer of a given type. */
     template <typename T>
     std::unique_ptr<Activation<T>>
@@ -313,6 +709,50 @@ namespace json_parser
         return {};
     }
 
+    /** Creates a lookup-table activation layer, with the table size and range from a json representation. */
+    template <typename T, typename LUTFunction>
+    std::unique_ptr<Activation<T>> createLUTActivation(int dims, const nlohmann::json& lutConfig)
+    {
+        auto tableSize = 1024;
+        auto minInput = LUTFunction::defaultMinInput();
+        auto maxInput = LUTFunction::defaultMaxInput();
+
+        if(lutConfig.is_object())
+        {
+            if(lutConfig.contains("size"))
+                tableSize = lutConfig["size"].get<int>();
+
+            if(lutConfig.contains("range"))
+            {
+                minInput = lutConfig["range"].front().get<T>();
+                maxInput = lutConfig["range"].back().get<T>();
+            }
+        }
+
+        return std::make_unique<LUTActivation<T, LUTFunction>>(dims, tableSize, minInput, maxInput);
+    }
+
+    /**
+     * Creates a lookup-table activation layer of a given type.
+     * Returns nullptr for activation types that don't have a
+     * lookup-table implementation.
+     */
+    template <typename T>
+    std::unique_ptr<Activation<T>>
+    createLUTActivation(const std::string& activationType, int dims, const nlohmann::json& lutConfig)
+    {
+        if(activationType == "tanh")
+            return createLUTActivation<T, lut_detail::TanhLUTFunction<T>>(dims, lutConfig);
+
+        if(activationType == "sigmoid")
+            return createLUTActivation<T, lut_detail::SigmoidLUTFunction<T>>(dims, lutConfig);
+
+        if(activationType == "elu")
+            return createLUTActivation<T, lut_detail::ELuLUTFunction<T>>(dims, lutConfig);
+
+        return {};
+    }
+
     /** Checks that an Activation layer has the given dimensions */
     template <typename LayerType>
     bool checkActivation(const LayerType& actLayer, const std::string& activationType, int dims, const bool debug)
@@ -332,82 +772,755 @@ namespace json_parser
         return true;
     }
 
-    /** Creates a neural network model from a json stream. */
-    template <typename T>
-    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const bool debug = false)
+    /**
+     * Returns the quantization type that a layer in the json representation
+     * has opted in to, with a "quantization" field that is either a string
+     * (e.g. "int8"), or an object with a "type" field. Returns an empty
+     * string if the layer is not quantized.
+     */
+    inline std::string getQuantizationType(const nlohmann::json& l)
     {
-        auto shape = parent["in_shape"];
-        auto layers = parent["layers"];
+        if(!l.contains("quantization"))
+            return {};
 
-        if(!shape.is_array() || !layers.is_array())
+        const auto& quantization = l["quantization"];
+        if(quantization.is_string())
+            return quantization.get<std::string>();
+
+        if(quantization.is_object() && quantization.contains("type"))
+            return quantization["type"].get<std::string>();
+
+        return {};
+    }
+
+    /** Returns true if a layer in the json representation has opted in to int8 weights. */
+    inline bool isQuantizedInt8(const nlohmann::json& l)
+    {
+        return getQuantizationType(l) == "int8";
+    }
+
+    /**
+     * Returns the weight storage type that a layer in the json representation
+     * has opted in to, with a "weight_storage" field of "fp16" or "bf16".
+     * Returns an empty string if the layer stores its weights with the model
+     * type.
+     */
+    inline std::string getWeightStorageType(const nlohmann::json& l)
+    {
+        if(!l.contains("weight_storage") || !l["weight_storage"].is_string())
             return {};
 
-        const auto nDims = shape.back().get<int>();
-        debug_print("# dimensions: " + std::to_string(nDims), debug);
+        return l["weight_storage"].get<std::string>();
+    }
 
-        auto model = std::make_unique<Model<T>>(nDims);
+#ifndef DOXYGEN
+    namespace detail
+    {
+        /** Multiplies the innermost dimension of a quantized kernel by the per-channel scales. */
+        inline void dequantizeKernel(nlohmann::json& kernel, const nlohmann::json& scales)
+        {
+            if(!kernel.is_array() || kernel.empty())
+                return;
 
-        for(const auto& l : layers)
+            if(!kernel.front().is_number())
+            {
+                for(auto& k : kernel)
+                    dequantizeKernel(k, scales);
+                return;
+            }
+
+            for(size_t j = 0; j < kernel.size(); ++j)
+                kernel[j] = kernel[j].get<double>() * scales[j].get<double>();
+        }
+
+        /** Zeroes the weights where a pruning mask is zero. The mask must have the same shape as the weights. */
+        inline void applyPruningMask(nlohmann::json& weights, const nlohmann::json& mask)
+        {
+            if(!weights.is_array() || !mask.is_array())
+                return;
+
+            for(size_t j = 0; j < std::min(weights.size(), mask.size()); ++j)
+            {
+                if(weights[j].is_array())
+                    applyPruningMask(weights[j], mask[j]);
+                else if(mask[j].is_number() && mask[j].get<double>() == 0.0)
+                    weights[j] = 0.0;
+            }
+        }
+
+        /** Multiplies the innermost dimension of a quantized kernel tensor by the per-channel scales. */
+        template <typename T>
+        void dequantizeKernel(Tensor<T>& kernel, const nlohmann::json& scales)
         {
-            const auto type = l["type"].get<std::string>();
-            debug_print("Layer: " + type, debug);
+            if(kernel.shape.empty() || kernel.shape.back() == 0 || !scales.is_array())
+                return;
+
+            const auto numChannels = std::min(kernel.shape.back(), scales.size());
+            std::vector<double> channelScales(numChannels);
+            for(size_t j = 0; j < numChannels; ++j)
+                channelScales[j] = scales[j].get<double>();
+
+            for(size_t i = 0; i < kernel.values.size(); i += kernel.shape.back())
+                for(size_t j = 0; j < numChannels; ++j)
+                    kernel.values[i + j] = (T)((double)kernel.values[i + j] * channelScales[j]);
+        }
+
+        /** Zeroes the weights in a tensor where a pruning mask is zero. Masks with a different shape are ignored. */
+        template <typename T>
+        void applyPruningMask(Tensor<T>& weights, const Tensor<T>& mask)
+        {
+            if(mask.shape != weights.shape)
+                return;
+
+            for(size_t j = 0; j < weights.values.size(); ++j)
+                if(mask.values[j] == (T)0)
+                    weights.values[j] = (T)0;
+        }
+    } // namespace detail
+#endif // DOXYGEN
+
+    /**
+     * Returns the weights for a layer from its json representation.
+     *
+     * Layers that were exported with int8 weights (`"quantization": { "type": "int8", "scales": [...] }`)
+     * store the kernel weights as integers, with one scale for each output channel (the last kernel
+     * dimension). The kernel weights for these layers are returned as floating-point values, so that
+     * they can be loaded into any layer type.
+     *
+     * Pruned layers may also have a "pruning_masks" field, with one mask (or null) for each
+     * of the layer weights. The weights are set to zero wherever the mask is zero.
+     */
+    inline nlohmann::json getLayerWeights(const nlohmann::json& l)
+    {
+        auto weights = l["weights"];
+        if(l.contains("quantization") && l["quantization"].is_object() && l["quantization"].contains("scales"))
+            detail::dequantizeKernel(weights[0], l["quantization"]["scales"]);
+
+        if(l.contains("pruning_masks") && l["pruning_masks"].is_array())
+        {
+            const auto& masks = l["pruning_masks"];
+            for(size_t i = 0; i < std::min(weights.size(), masks.size()); ++i)
+                detail::applyPruningMask(weights[i], masks[i]);
+        }
+
+        return weights;
+    }
+
+    /** Creates a QuantizedDense layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<QuantizedDense<T>> createQuantizedDense(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto dense = std::make_unique<QuantizedDense<T>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Creates a QuantizedConv1D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<QuantizedConv1D<T>> createQuantizedConv1D(int in_size, int out_size,
+        int kernel_size, int dilation, const WeightsType& weights)
+    {
+        auto conv = std::make_unique<QuantizedConv1D<T>>(in_size, out_size, kernel_size, dilation);
+        loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
+        return std::move(conv);
+    }
+
+    /** Creates a QuantizedGRULayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename QType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<QuantizedGRULayer<T, QType>> createQuantizedGRU(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto gru = std::make_unique<QuantizedGRULayer<T, QType>>(in_size, out_size);
+        loadGRU<T>(*gru.get(), weights);
+        return std::move(gru);
+    }
+
+    /** Creates a QuantizedLSTMLayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename QType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<QuantizedLSTMLayer<T, QType>> createQuantizedLSTM(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto lstm = std::make_unique<QuantizedLSTMLayer<T, QType>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights);
+        return std::move(lstm);
+    }
+
+    /** Creates a HalfDense layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename HalfType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<HalfDense<T, HalfType>> createHalfDense(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto dense = std::make_unique<HalfDense<T, HalfType>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Creates a HalfConv1D layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename HalfType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<HalfConv1D<T, HalfType>> createHalfConv1D(int in_size, int out_size,
+        int kernel_size, int dilation, const WeightsType& weights)
+    {
+        auto conv = std::make_unique<HalfConv1D<T, HalfType>>(in_size, out_size, kernel_size, dilation);
+        loadConv1D<T>(*conv.get(), kernel_size, dilation, weights);
+        return std::move(conv);
+    }
+
+    /** Creates a HalfGRULayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename HalfType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<HalfGRULayer<T, HalfType>> createHalfGRU(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto gru = std::make_unique<HalfGRULayer<T, HalfType>>(in_size, out_size);
+        loadGRU<T>(*gru.get(), weights);
+        return std::move(gru);
+    }
+
+    /** Creates a HalfLSTMLayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename HalfType, typename WeightsType = nlohmann::json>
+    std::unique_ptr<HalfLSTMLayer<T, HalfType>> createHalfLSTM(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto lstm = std::make_unique<HalfLSTMLayer<T, HalfType>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights);
+        return std::move(lstm);
+    }
+
+    /**
+     * Returns the fraction of (1x4) blocks in the kernel of a dense layer that
+     * contain a non-zero weight, from a json representation of the layer weights.
+     */
+    inline double getDenseBlockDensity(const nlohmann::json& weights)
+    {
+        const auto& kernel = weights[0]; // kernel[in_size][out_size]
+        if(!kernel.is_array() || kernel.empty())
+            return 1.0;
+
+        return sparse_detail::blockDensity<1, 4>([&kernel](int i, int k) { return kernel[(size_t)k][(size_t)i].get<double>(); },
+            (int)kernel[0].size(), (int)kernel.size());
+    }
+
+#ifndef DOXYGEN
+    namespace detail
+    {
+        /** Returns the fraction of (1x4) blocks in a two-dimensional weight tensor [cols][rows] that contain a non-zero weight. */
+        template <typename T>
+        double getBlockDensity(const std::vector<Tensor<T>>& weights, size_t idx)
+        {
+            if(idx >= weights.size() || weights[idx].shape.size() != 2)
+                return 1.0;
+
+            const auto& w = weights[idx];
+            return sparse_detail::blockDensity<1, 4>([&w](int i, int k) { return (double)w.values[(size_t)k * w.shape[1] + (size_t)i]; },
+                (int)w.shape[1], (int)w.shape[0]);
+        }
+    } // namespace detail
+#endif // DOXYGEN
+
+    /** Returns the fraction of (1x4) blocks in the kernel of a dense layer that contain a non-zero weight, from weight tensors. */
+    template <typename T>
+    double getDenseBlockDensity(const std::vector<detail::Tensor<T>>& weights)
+    {
+        return detail::getBlockDensity(weights, 0);
+    }
+
+    /** Creates a SparseDense layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<SparseDense<T>> createSparseDense(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto dense = std::make_unique<SparseDense<T>>(in_size, out_size);
+        loadDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /**
+     * Loads weights for a LowRankDense (or LowRankDenseT) layer from a json representation of the layer weights
+     * (or from weight tensors).
+     *
+     * The weights are expected in the following order:
+     * - first factor: [in_size][rank]
+     * - second factor: [rank][out_size]
+     * - bias: [out_size]
+     */
+    template <typename T, typename DenseType, typename WeightsType = nlohmann::json>
+    void loadLowRankDense(DenseType& dense, const WeightsType& weights)
+    {
+        const auto rank = dense.getRank();
+        std::vector<T> buffer;
+
+        const auto vView = detail::getWeights<T>(weights, 0, { dense.in_size, rank }, buffer);
+        dense.setVWeights(detail::toNestedVectors(vView.transposed()));
+
+        const auto uView = detail::getWeights<T>(weights, 1, { rank, dense.out_size }, buffer);
+        dense.setUWeights(detail::toNestedVectors(uView.transposed()));
+
+        std::vector<T> denseBias = detail::getVector<T>(weights, 2, dense.out_size);
+        dense.setBias(denseBias.data());
+    }
+
+    /** Creates a LowRankDense layer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<LowRankDense<T>> createLowRankDense(int in_size, int out_size, int rank, const WeightsType& weights)
+    {
+        auto dense = std::make_unique<LowRankDense<T>>(in_size, out_size, rank);
+        loadLowRankDense<T>(*dense.get(), weights);
+        return std::move(dense);
+    }
+
+    /** Checks that a LowRankDense (or LowRankDenseT) layer has the given dimensions. */
+    template <typename T, typename DenseType>
+    bool checkLowRankDense(const DenseType& dense, const std::string& type, int layerDims, int rank, const bool debug)
+    {
+        if(!checkDense<T>(dense, type, layerDims, debug))
+            return false;
+
+        if(rank != dense.getRank())
+        {
+            debug_print("Wrong layer rank! Expected: " + std::to_string(dense.getRank()), debug);
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Returns the fraction of (1x4) blocks in the recurrent weights of a GRU or LSTM
+     * layer that contain a non-zero weight, from a json representation of the layer weights.
+     */
+    inline double getRecurrentBlockDensity(const nlohmann::json& weights)
+    {
+        const auto& recurrent = weights[1]; // recurrent[out_size][num_gates * out_size]
+        if(!recurrent.is_array() || recurrent.empty())
+            return 1.0;
+
+        return sparse_detail::blockDensity<1, 4>([&recurrent](int i, int k) { return recurrent[(size_t)k][(size_t)i].get<double>(); },
+            (int)recurrent[0].size(), (int)recurrent.size());
+    }
+
+    /** Returns the fraction of (1x4) blocks in the recurrent weights of a GRU or LSTM layer that contain a non-zero weight, from weight tensors. */
+    template <typename T>
+    double getRecurrentBlockDensity(const std::vector<detail::Tensor<T>>& weights)
+    {
+        return detail::getBlockDensity(weights, 1);
+    }
+
+    /** Creates a SparseGRULayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<SparseGRULayer<T>> createSparseGRU(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto gru = std::make_unique<SparseGRULayer<T>>(in_size, out_size);
+        loadGRU<T>(*gru.get(), weights);
+        return std::move(gru);
+    }
+
+    /** Creates a SparseLSTMLayer from a json representation of the layer weights (or from weight tensors). */
+    template <typename T, typename WeightsType = nlohmann::json>
+    std::unique_ptr<SparseLSTMLayer<T>> createSparseLSTM(int in_size, int out_size, const WeightsType& weights)
+    {
+        auto lstm = std::make_unique<SparseLSTMLayer<T>>(in_size, out_size);
+        loadLSTM<T>(*lstm.get(), weights);
+        return std::move(lstm);
+    }
 
-            const auto layerShape = l["shape"];
-            const auto layerDims = layerShape.back().get<int>();
-            debug_print("  Dims: " + std::to_string(layerDims), debug);
+    /**
+     * Creates a layer from its json representation, with the layer weights (as a json
+     * array, or as weight tensors) passed separately, and adds it (and its activation)
+     * to a model. Any quantization scales and pruning masks must already have been
+     * applied to the weights.
+     */
+    template <typename T, typename WeightsType>
+    void parseLayer(Model<T>& model, const nlohmann::json& l, const WeightsType& weights, const bool debug)
+    {
+        const auto type = l["type"].get<std::string>();
+        debug_print("Layer: " + type, debug);
+
+        const auto layerShape = l["shape"];
+        const auto layerDims = layerShape.back().get<int>();
+        debug_print("  Dims: " + std::to_string(layerDims), debug);
+
+        const auto quantization = getQuantizationType(l);
+        const auto quantized = quantization == "int8";
+        if(!quantization.empty())
+            debug_print("  quantization: " + quantization, debug);
+
+        // quantized layers take precedence over half-precision weight storage
+        const auto weightStorage = quantization.empty() ? getWeightStorageType(l) : std::string {};
+        if(!weightStorage.empty())
+            debug_print("  weight storage: " + weightStorage, debug);
 
-            const auto weights = l["weights"];
+        auto add_activation = [=](Model<T>& _model, const nlohmann::json& _l, int activationDims = -1) {
+            if(activationDims < 0)
+                activationDims = layerDims;
 
-            auto add_activation = [=](std::unique_ptr<Model<T>>& _model, const nlohmann::json& _l) {
-                if(_l.contains("activation"))
+            if(_l.contains("activation"))
+            {
+                const auto activationType = _l["activation"].get<std::string>();
+                if(!activationType.empty())
                 {
-                    const auto activationType = _l["activation"].get<std::string>();
-                    if(!activationType.empty())
+                    debug_print("  activation: " + activationType, debug);
+
+                    // layers can opt in to lookup-table activations with an "activation_lut"
+                    // field, which is either `true`, or an object with the table "size" and "range".
+                    std::unique_ptr<Activation<T>> activation;
+                    if(_l.contains("activation_lut") && _l["activation_lut"] != false)
                     {
-                        debug_print("  activation: " + activationType, debug);
-                        auto activation = createActivation<T>(activationType, layerDims);
-                        _model->addLayer(activation.release());
+                        debug_print("  activation lookup table: " + _l["activation_lut"].dump(), debug);
+                        activation = createLUTActivation<T>(activationType, activationDims, _l["activation_lut"]);
                     }
+
+                    if(activation == nullptr)
+                        activation = createActivation<T>(activationType, activationDims);
+
+                    _model.addLayer(activation.release());
                 }
-            };
+            }
+        };
+
+        if(type == "dense" || type == "time-distributed-dense")
+        {
+            // layers with a "rank" field store the weights as two low-rank factors
+            if(l.contains("rank"))
+            {
+                const auto rank = l["rank"].get<int>();
+                debug_print("  rank: " + std::to_string(rank), debug);
+
+                auto dense = createLowRankDense<T>(model.getNextInSize(), layerDims, rank, weights);
+                model.addLayer(dense.release());
+            }
+            else if(quantized)
+            {
+                auto dense = createQuantizedDense<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(dense.release());
+            }
+            else if(weightStorage == "fp16")
+            {
+                auto dense = createHalfDense<T, Float16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(dense.release());
+            }
+            else if(weightStorage == "bf16")
+            {
+                auto dense = createHalfDense<T, BFloat16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(dense.release());
+            }
+            else if(getDenseBlockDensity(weights) < RTNEURAL_SPARSE_DENSITY_THRESHOLD)
+            {
+                // mostly-zero (e.g. pruned) weights are faster to process with a sparse layer
+                debug_print("  using sparse weights", debug);
+                auto dense = createSparseDense<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(dense.release());
+            }
+            else
+            {
+                auto dense = createDense<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(dense.release());
+            }
+
+            add_activation(model, l);
+        }
+        else if(type == "conv1d")
+        {
+            const auto kernel_size = l["kernel_size"].back().get<int>();
+            const auto dilation = l["dilation"].back().get<int>();
+            const auto stride = l.contains("strides") ? l["strides"].back().get<int>() : 1;
 
-            if(type == "dense" || type == "time-distributed-dense")
+            if(stride > 1)
+            {
+                if(quantized || !weightStorage.empty())
+                    debug_print("  int8 and half-precision weights are not supported for strided convolutions, using floating-point weights", debug);
+
+                auto conv = createStridedConv1D<T>(model.getNextInSize(), layerDims, kernel_size, dilation, stride, weights);
+                model.addLayer(conv.release());
+            }
+            else if(quantized)
+            {
+                auto conv = createQuantizedConv1D<T>(model.getNextInSize(), layerDims, kernel_size, dilation, weights);
+                model.addLayer(conv.release());
+            }
+            else if(weightStorage == "fp16")
+            {
+                auto conv = createHalfConv1D<T, Float16>(model.getNextInSize(), layerDims, kernel_size, dilation, weights);
+                model.addLayer(conv.release());
+            }
+            else if(weightStorage == "bf16")
             {
-                auto dense = createDense<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(dense.release());
-                add_activation(model, l);
+                auto conv = createHalfConv1D<T, BFloat16>(model.getNextInSize(), layerDims, kernel_size, dilation, weights);
+                model.addLayer(conv.release());
             }
-            else if(type == "conv1d")
+            else
             {
-                const auto kernel_size = l["kernel_size"].back().get<int>();
-                const auto dilation = l["dilation"].back().get<int>();
+                auto conv = createConv1D<T>(model.getNextInSize(), layerDims, kernel_size, dilation, weights);
+                model.addLayer(conv.release());
+            }
 
-                auto conv = createConv1D<T>(model->getNextInSize(), layerDims, kernel_size, dilation, weights);
-                model->addLayer(conv.release());
-                add_activation(model, l);
+            add_activation(model, l);
+        }
+        else if(type == "transposed-conv1d")
+        {
+            const auto kernel_size = l["kernel_size"].back().get<int>();
+            const auto stride = l["strides"].back().get<int>();
+
+            // the layer shape includes all of the output frames, but the
+            // activation runs once for each output frame
+            auto conv = createTransposedConv1D<T>(model.getNextInSize(), layerDims / stride, kernel_size, stride, weights);
+            model.addLayer(conv.release());
+            add_activation(model, l, layerDims / stride);
+        }
+        else if(type == "conv2d")
+        {
+            const auto kernel_size_time = l["kernel_size"].front().get<int>();
+            const auto kernel_size_feature = l["kernel_size"].back().get<int>();
+            const auto dilation = l["dilation"].front().get<int>();
+            const auto stride = l["strides"].back().get<int>();
+            const auto valid_pad = l["padding"].get<std::string>() == "valid";
+            const auto num_filters_in = detail::getWeightsSize(weights, 0, 2);
+            const auto num_filters_out = detail::getWeightsSize(weights, 1, 0);
+            if(num_filters_in <= 0)
+                throw std::invalid_argument("Conv2D layer has no kernel weights!");
+
+            const auto num_features_in = model.getNextInSize() / num_filters_in;
+
+            auto conv = createConv2D<T>(num_filters_in, num_filters_out, num_features_in,
+                kernel_size_time, kernel_size_feature, dilation, stride, valid_pad, weights);
+            model.addLayer(conv.release());
+            add_activation(model, l);
+        }
+        else if(type == "gru")
+        {
+            // recurrent layers can be quantized with int8 or int16 weights
+            if(quantization == "int8")
+            {
+                auto gru = createQuantizedGRU<T, int8_t>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+            else if(quantization == "int16")
+            {
+                auto gru = createQuantizedGRU<T, int16_t>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+            else if(weightStorage == "fp16")
+            {
+                auto gru = createHalfGRU<T, Float16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+            else if(weightStorage == "bf16")
+            {
+                auto gru = createHalfGRU<T, BFloat16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+            else if(getRecurrentBlockDensity(weights) < RTNEURAL_SPARSE_DENSITY_THRESHOLD)
+            {
+                debug_print("  using sparse recurrent weights", debug);
+                auto gru = createSparseGRU<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+            else
+            {
+                auto gru = createGRU<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(gru.release());
+            }
+        }
+        else if(type == "lstm")
+        {
+            if(quantization == "int8")
+            {
+                auto lstm = createQuantizedLSTM<T, int8_t>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
+            }
+            else if(quantization == "int16")
+            {
+                auto lstm = createQuantizedLSTM<T, int16_t>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
+            }
+            else if(weightStorage == "fp16")
+            {
+                auto lstm = createHalfLSTM<T, Float16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
+            }
+            else if(weightStorage == "bf16")
+            {
+                auto lstm = createHalfLSTM<T, BFloat16>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
             }
-            else if(type == "gru")
+            else if(getRecurrentBlockDensity(weights) < RTNEURAL_SPARSE_DENSITY_THRESHOLD)
             {
-                auto gru = createGRU<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(gru.release());
+                debug_print("  using sparse recurrent weights", debug);
+                auto lstm = createSparseLSTM<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
             }
-            else if(type == "lstm")
+            else
             {
-                auto lstm = createLSTM<T>(model->getNextInSize(), layerDims, weights);
-                model->addLayer(lstm.release());
+                auto lstm = createLSTM<T>(model.getNextInSize(), layerDims, weights);
+                model.addLayer(lstm.release());
             }
         }
+        else if(type == "wavenet-block")
+        {
+            const auto channels = l["channels"].get<int>();
+            const auto kernel_size = l["kernel_size"].back().get<int>();
+            const auto dilation = l["dilation"].back().get<int>();
+
+            auto block = createWaveNetBlock<T>(model.getNextInSize(), channels, kernel_size, dilation, weights);
+            model.addLayer(block.release());
+        }
+    }
+
+    /** Creates a layer from its json representation, and adds it (and its activation) to a model. */
+    template <typename T>
+    void parseLayer(Model<T>& model, const nlohmann::json& l, const bool debug = false)
+    {
+        parseLayer<T>(model, l, getLayerWeights(l), debug);
+    }
+
+#ifndef DOXYGEN
+    namespace detail
+    {
+#if RTNEURAL_PARALLEL_LOADING
+        /** Returns the number of threads to use for a number of tasks (numThreads <= 0 uses one thread per core). */
+        inline int getNumThreads(int numThreads, size_t numTasks)
+        {
+            if(numThreads <= 0)
+                numThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+            return std::max(std::min(numThreads, (int)numTasks), 1);
+        }
+
+        /**
+         * Runs a list of tasks on a small pool of threads (including the calling
+         * thread), and returns once all of the tasks have finished. If any of the
+         * tasks throws an exception, the first exception is re-thrown afterwards.
+         */
+        inline void runTasks(const std::vector<std::function<void()>>& tasks, int numThreads)
+        {
+            std::atomic<size_t> nextTask { 0 };
+            std::exception_ptr exception;
+            std::mutex exceptionMutex;
+
+            auto worker = [&] {
+                for(auto taskIdx = nextTask++; taskIdx < tasks.size(); taskIdx = nextTask++)
+                {
+                    try
+                    {
+                        tasks[taskIdx]();
+                    }
+                    catch(...)
+                    {
+                        std::lock_guard<std::mutex> lock(exceptionMutex);
+                        if(exception == nullptr)
+                            exception = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for(int i = 1; i < getNumThreads(numThreads, tasks.size()); ++i)
+                threads.emplace_back(worker);
+
+            worker();
+            for(auto& thread : threads)
+                thread.join();
+
+            if(exception != nullptr)
+                std::rethrow_exception(exception);
+        }
+#else
+        /** Runs a list of tasks on the calling thread, since parallel loading is disabled. */
+        inline void runTasks(const std::vector<std::function<void()>>& tasks, int /*numThreads*/)
+        {
+            for(const auto& task : tasks)
+                task();
+        }
+#endif
+
+        /** Returns true if the output size of a layer always matches the layer shape. */
+        inline bool hasShapeOutSize(const std::string& type)
+        {
+            return type == "dense" || type == "time-distributed-dense" || type == "conv1d" || type == "gru" || type == "lstm";
+        }
+
+        /**
+         * Loads the layers of a model concurrently, with each layer (and its activation) loaded
+         * into a separate model, and then adds the layers to the model in order. The input size
+         * of each layer is taken from the shape of the previous layer, so layers following other
+         * layer types (and any layers where the input size turns out to be wrong) are loaded
+         * once the previous layers have been added.
+         */
+        template <typename T>
+        void parseLayersParallel(Model<T>& model, const nlohmann::json& layers, int numThreads)
+        {
+            std::vector<std::unique_ptr<Model<T>>> layerModels(layers.size());
+            std::vector<std::function<void()>> tasks;
+            tasks.reserve(layers.size());
+
+            for(size_t i = 0; i < layers.size(); ++i)
+            {
+                int in_size = model.getNextInSize();
+                if(i > 0)
+                {
+                    const auto& prevLayer = layers[i - 1];
+                    if(!hasShapeOutSize(prevLayer["type"].get<std::string>()))
+                        continue;
+
+                    in_size = prevLayer["shape"].back().get<int>();
+                }
+
+                layerModels[i] = std::make_unique<Model<T>>(in_size);
+                tasks.push_back([&layerModel = *layerModels[i], &l = layers[i]] { parseLayer<T>(layerModel, l); });
+            }
+
+            runTasks(tasks, numThreads);
+
+            for(size_t i = 0; i < layers.size(); ++i)
+            {
+                if(layerModels[i] == nullptr || layerModels[i]->getInSize() != model.getNextInSize())
+                {
+                    parseLayer<T>(model, layers[i]);
+                    continue;
+                }
+
+                // the layers are now owned by the model
+                for(auto* layer : layerModels[i]->layers)
+                    model.addLayer(layer);
+                layerModels[i]->layers.clear();
+            }
+        }
+    } // namespace detail
+#endif // DOXYGEN
+
+    /**
+     * Creates a neural network model from a json stream.
+     *
+     * The layer weights can be loaded concurrently, on up to `numThreads`
+     * threads (or one thread per core, if `numThreads` is zero), which
+     * reduces the loading time for large models. Debug messages are only
+     * printed when the layers are loaded on a single thread.
+     */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJson(const nlohmann::json& parent, const bool debug = false, const int numThreads = 1)
+    {
+        const auto& shape = parent["in_shape"];
+        const auto& layers = parent["layers"];
+
+        if(!shape.is_array() || !layers.is_array())
+            return {};
+
+        const auto nDims = shape.back().get<int>();
+        debug_print("# dimensions: " + std::to_string(nDims), debug);
+
+        auto model = std::make_unique<Model<T>>(nDims);
+
+        if(numThreads != 1 && !debug && layers.size() > 1)
+        {
+            detail::parseLayersParallel<T>(*model, layers, numThreads);
+            return model;
+        }
+
+        for(const auto& l : layers)
+            parseLayer<T>(*model, l, debug);
 
-        return std::move(model);
+        return model;
     }
 
-    /** Creates a neural network model from a json stream. */
+    /** Creates a neural network model from a json stream (see above). */
     template <typename T>
-    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const bool debug = false)
+    std::unique_ptr<Model<T>> parseJson(std::ifstream& jsonStream, const bool debug = false, const int numThreads = 1)
     {
         nlohmann::json parent;
         jsonStream >> parent;
-        return parseJson<T>(parent, debug);
+        return parseJson<T>(parent, debug, numThreads);
     }
 
 } // namespace json_parser
@@ -0,0 +1,941 @@
+#pragma once
+
+#include <cerrno>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include "model_loader.h"
+
+namespace RTNeural
+{
+namespace json_parser
+{
+#ifndef DOXYGEN
+    namespace streaming_detail
+    {
+        /** Marks a tensor dimension, or array level, that has not been read yet. */
+        constexpr size_t notSet = (size_t)-1;
+
+        using detail::Tensor;
+
+        /**
+         * A json reader, which reads a json stream in fixed-size chunks, and passes
+         * each value to a nlohmann::json SAX handler (see nlohmann::json::json_sax_t)
+         * as soon as it is read.
+         *
+         * This is much faster than nlohmann::json::sax_parse() for model files,
+         * which are mostly made up of long arrays of numbers, since numbers are
+         * converted straight from the stream buffer, without going through a
+         * token string.
+         */
+        template <typename Handler, bool singlePrecision = false>
+        class JsonReader
+        {
+        public:
+            JsonReader(std::istream& jsonStream, Handler& jsonHandler)
+                : stream(jsonStream)
+                , handler(jsonHandler)
+                , buffer(bufferSize)
+                , decimalPoint(*std::localeconv()->decimal_point)
+            {
+            }
+
+            /** Reads a json value from the stream, and returns false if the json is invalid. */
+            bool parse()
+            {
+                if(!parseValue(0))
+                    return false;
+
+                skipWhitespace();
+                const auto c = peek();
+                return c == EOF || unexpected(c, "the end of the json");
+            }
+
+            /** Returns the number of bytes that have been read from the stream. */
+            size_t getPosition() const noexcept { return bytesRead - (size_t)(end - pos); }
+
+        private:
+            static constexpr size_t bufferSize = 1 << 16;
+            static constexpr int maxDepth = 512;
+            static constexpr size_t maxNumberLength = 64;
+            static constexpr std::size_t unknownSize = (std::size_t)-1; // the number of elements is not known in advance
+
+            bool refill()
+            {
+                if(!stream.good())
+                    return false;
+
+                stream.read(buffer.data(), (std::streamsize)buffer.size());
+                const auto count = (size_t)stream.gcount();
+                bytesRead += count;
+                pos = buffer.data();
+                end = pos + count;
+                return count > 0;
+            }
+
+            int peek()
+            {
+                if(pos == end && !refill())
+                    return EOF;
+
+                return (unsigned char)*pos;
+            }
+
+            /**
+             * Reports a syntax error to the handler, with the byte offset in the stream
+             * (like nlohmann::json's parser does), and returns false.
+             */
+            bool syntaxError(const std::string& message)
+            {
+                const auto position = getPosition();
+                const auto error = nlohmann::detail::parse_error::create(101, position, "syntax error while parsing json - " + message, nullptr);
+                handler.parse_error(position, std::string {}, error);
+                return false;
+            }
+
+            /** Reports an unexpected character (or the end of the stream) as a syntax error, and returns false. */
+            bool unexpected(int c, const char* expected)
+            {
+                if(c == EOF)
+                    return syntaxError(std::string("unexpected end of input; expected ") + expected);
+                if(c < 0x20)
+                    return syntaxError(std::string("unexpected control character; expected ") + expected);
+
+                return syntaxError(std::string("unexpected '") + (char)c + "'; expected " + expected);
+            }
+
+            int get()
+            {
+                const auto c = peek();
+                if(c != EOF)
+                    ++pos;
+                return c;
+            }
+
+            void skipWhitespace()
+            {
+                for(auto c = peek(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = peek())
+                    ++pos;
+            }
+
+            bool parseValue(int depth)
+            {
+                if(depth > maxDepth)
+                    return syntaxError("the json is nested more than " + std::to_string(maxDepth) + " levels deep");
+
+                skipWhitespace();
+                switch(peek())
+                {
+                case EOF:
+                    return unexpected(EOF, "a json value");
+                case '{':
+                    return parseObject(depth);
+                case '[':
+                    return parseArray(depth);
+                case '"':
+                {
+                    std::string value;
+                    return parseString(value) && handler.string(value);
+                }
+                case 't':
+                    return parseLiteral("true") && handler.boolean(true);
+                case 'f':
+                    return parseLiteral("false") && handler.boolean(false);
+                case 'n':
+                    return parseLiteral("null") && handler.null();
+                default:
+                {
+                    bool result;
+                    if(parseBufferedNumber(result))
+                        return result;
+
+                    return parseNumber();
+                }
+                }
+            }
+
+            bool parseObject(int depth)
+            {
+                get(); // '{'
+                if(!handler.start_object(unknownSize))
+                    return false;
+
+                skipWhitespace();
+                if(peek() == '}')
+                {
+                    get();
+                    return handler.end_object();
+                }
+
+                std::string key;
+                while(true)
+                {
+                    skipWhitespace();
+                    if(!parseString(key) || !handler.key(key))
+                        return false;
+
+                    skipWhitespace();
+                    const auto separator = get();
+                    if(separator != ':')
+                        return unexpected(separator, "':'");
+                    if(!parseValue(depth + 1))
+                        return false;
+
+                    skipWhitespace();
+                    const auto c = get();
+                    if(c == '}')
+                        return handler.end_object();
+                    if(c != ',')
+                        return unexpected(c, "',' or '}'");
+                }
+            }
+
+            bool parseArray(int depth)
+            {
+                get(); // '['
+                if(!handler.start_array(unknownSize))
+                    return false;
+
+                skipWhitespace();
+                if(peek() == ']')
+                {
+                    get();
+                    return handler.end_array();
+                }
+
+                while(true)
+                {
+                    if(!parseValue(depth + 1))
+                        return false;
+
+                    skipWhitespace();
+                    const auto c = get();
+                    if(c == ']')
+                        return handler.end_array();
+                    if(c != ',')
+                        return unexpected(c, "',' or ']'");
+                }
+            }
+
+            bool parseLiteral(const char* literal)
+            {
+                for(const auto* l = literal; *l != '\0'; ++l)
+                    if(get() != *l)
+                        return syntaxError(std::string("invalid literal; expected '") + literal + "'");
+
+                return true;
+            }
+
+            bool parseString(std::string& value)
+            {
+                value.clear();
+                const auto quote = get();
+                if(quote != '"')
+                    return unexpected(quote, "a string");
+
+                while(true)
+                {
+                    auto c = get();
+                    if(c == '"')
+                        return true;
+                    if(c == EOF)
+                        return syntaxError("unterminated string");
+                    if(c < 0x20)
+                        return syntaxError("control characters must be escaped in strings");
+
+                    if(c == '\\')
+                    {
+                        c = get();
+                        switch(c)
+                        {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            break;
+                        case 'b':
+                            c = '\b';
+                            break;
+                        case 'f':
+                            c = '\f';
+                            break;
+                        case 'n':
+                            c = '\n';
+                            break;
+                        case 'r':
+                            c = '\r';
+                            break;
+                        case 't':
+                            c = '\t';
+                            break;
+                        case 'u':
+                            if(!parseCodePoint(value))
+                                return syntaxError("invalid unicode escape sequence in string");
+                            continue;
+                        default:
+                            return syntaxError("invalid escape sequence in string");
+                        }
+                    }
+
+                    value.push_back((char)c);
+                }
+            }
+
+            /** Reads a "\uXXXX" escape sequence (and a low surrogate, if needed), and appends the code point as UTF-8. */
+            bool parseCodePoint(std::string& value)
+            {
+                auto readHex = [this](uint32_t& result) {
+                    result = 0;
+                    for(int i = 0; i < 4; ++i)
+                    {
+                        const auto c = get();
+                        result <<= 4;
+                        if(c >= '0' && c <= '9')
+                            result |= (uint32_t)(c - '0');
+                        else if(c >= 'a' && c <= 'f')
+                            result |= (uint32_t)(c - 'a' + 10);
+                        else if(c >= 'A' && c <= 'F')
+                            result |= (uint32_t)(c - 'A' + 10);
+                        else
+                            return false;
+                    }
+                    return true;
+                };
+
+                uint32_t codePoint;
+                if(!readHex(codePoint))
+                    return false;
+
+                if(codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                {
+                    uint32_t lowSurrogate;
+                    if(get() != '\\' || get() != 'u' || !readHex(lowSurrogate) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+                        return false;
+
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                }
+
+                if(codePoint < 0x80)
+                {
+                    value.push_back((char)codePoint);
+                }
+                else if(codePoint < 0x800)
+                {
+                    value.push_back((char)(0xC0 | (codePoint >> 6)));
+                    value.push_back((char)(0x80 | (codePoint & 0x3F)));
+                }
+                else if(codePoint < 0x10000)
+                {
+                    value.push_back((char)(0xE0 | (codePoint >> 12)));
+                    value.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+                    value.push_back((char)(0x80 | (codePoint & 0x3F)));
+                }
+                else
+                {
+                    value.push_back((char)(0xF0 | (codePoint >> 18)));
+                    value.push_back((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+                    value.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+                    value.push_back((char)(0x80 | (codePoint & 0x3F)));
+                }
+
+                return true;
+            }
+
+            static constexpr int maxFastExponent = 22;
+            static constexpr int maxMantissaDigits = 19; // the most decimal digits that always fit in a uint64_t
+            static constexpr uint64_t maxExactMantissa = (uint64_t)1 << 53;
+
+            /** Returns true if mantissa * 10^exponent can be converted without strtod() (see parseNumber()). */
+            static bool isExact(uint64_t mantissa, int numDigits, int exponent) noexcept
+            {
+                return numDigits <= maxMantissaDigits && exponent >= -maxFastExponent && exponent <= maxFastExponent
+                    && (singlePrecision || mantissa <= maxExactMantissa);
+            }
+
+            static double toDouble(uint64_t mantissa, int exponent) noexcept
+            {
+                static constexpr double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+                return exponent < 0 ? (double)mantissa / powersOf10[-exponent] : (double)mantissa * powersOf10[exponent];
+            }
+
+            /**
+             * Reads a floating-point number straight from the stream buffer, which is the
+             * common case for model weights. Returns false, without reading anything, if
+             * the number might continue past the end of the buffer, or if it is not a
+             * floating-point number that can be converted without strtod(), in which case
+             * the number should be read with parseNumber().
+             */
+            bool parseBufferedNumber(bool& result)
+            {
+                auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+                const char* p = pos;
+                const auto negative = p != end && *p == '-';
+                if(negative)
+                    ++p;
+
+                if(p == end || !isDigit(*p))
+                    return false;
+
+                uint64_t mantissa = 0;
+                int numDigits = 0;
+                int exponent = 0;
+                auto addDigit = [&](char c) {
+                    if(mantissa > 0 || c != '0')
+                    {
+                        if(++numDigits <= maxMantissaDigits)
+                            mantissa = mantissa * 10 + (uint64_t)(c - '0');
+                    }
+                };
+
+                // integer part (no leading zeros)
+                if(*p == '0')
+                    ++p;
+                else
+                    for(; p != end && isDigit(*p); ++p)
+                        addDigit(*p);
+
+                // fraction
+                if(p == end || *p != '.')
+                    return false;
+
+                const auto* fractionStart = ++p;
+                for(; p != end && isDigit(*p); ++p, --exponent)
+                    addDigit(*p);
+
+                if(p == fractionStart)
+                    return false;
+
+                // exponent
+                if(p != end && (*p == 'e' || *p == 'E'))
+                {
+                    ++p;
+                    const auto negativeExponent = p != end && *p == '-';
+                    if(p != end && (*p == '-' || *p == '+'))
+                        ++p;
+
+                    const auto* exponentStart = p;
+                    int explicitExponent = 0;
+                    for(; p != end && isDigit(*p); ++p)
+                        explicitExponent = std::min(explicitExponent * 10 + (*p - '0'), 100000);
+
+                    if(p == exponentStart)
+                        return false;
+
+                    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                }
+
+                if(p == end || !isExact(mantissa, numDigits, exponent))
+                    return false;
+
+                pos = p;
+                const auto value = toDouble(mantissa, exponent);
+                result = handler.number_float(negative ? -value : value, noString);
+                return true;
+            }
+
+            /**
+             * Reads a number. Floating-point numbers are converted without strtod() when the
+             * mantissa and exponent are small enough for the result to be exact (see Clinger,
+             * "How to Read Floating Point Numbers Accurately"). When the values are only needed
+             * in single precision, larger mantissas are allowed, since the double-precision
+             * rounding error is much smaller than a float ulp.
+             */
+            bool parseNumber()
+            {
+                // the number is also copied into a null-terminated buffer, in case strtod() is needed
+                // (numbers that don't fit in the stack buffer are copied to a heap buffer instead)
+                char shortNumber[maxNumberLength + 1];
+                size_t length = 0;
+                auto accept = [&](int c) {
+                    if(length < maxNumberLength)
+                    {
+                        shortNumber[length] = (char)c;
+                    }
+                    else
+                    {
+                        if(length == maxNumberLength)
+                            longNumber.assign(shortNumber, length);
+                        longNumber.push_back((char)c);
+                    }
+
+                    ++length;
+                    ++pos;
+                };
+
+                auto peekDigit = [this] {
+                    const auto c = peek();
+                    return (c >= '0' && c <= '9') ? c - '0' : -1;
+                };
+
+                uint64_t mantissa = 0;
+                int numDigits = 0;
+                int exponent = 0;
+                auto acceptDigit = [&](int digit, bool fraction) {
+                    if(mantissa > 0 || digit > 0)
+                    {
+                        if(++numDigits <= maxMantissaDigits)
+                            mantissa = mantissa * 10 + (uint64_t)digit;
+                    }
+
+                    if(fraction)
+                        exponent--;
+
+                    accept('0' + digit);
+                };
+
+                const auto negative = peek() == '-';
+                if(negative)
+                    accept('-');
+
+                // integer part
+                auto digit = peekDigit();
+                if(digit == 0)
+                {
+                    accept('0');
+                }
+                else if(digit > 0)
+                {
+                    for(; digit >= 0; digit = peekDigit())
+                        acceptDigit(digit, false);
+                }
+                else
+                {
+                    return unexpected(peek(), negative ? "a digit" : "a json value");
+                }
+
+                // fraction
+                bool isFloat = false;
+                if(peek() == '.')
+                {
+                    isFloat = true;
+                    accept(decimalPoint); // strtod() uses the decimal point from the current locale
+                    if(peekDigit() < 0)
+                        return unexpected(peek(), "a digit after the decimal point");
+
+                    for(digit = peekDigit(); digit >= 0; digit = peekDigit())
+                        acceptDigit(digit, true);
+                }
+
+                // exponent
+                if(peek() == 'e' || peek() == 'E')
+                {
+                    isFloat = true;
+                    accept('e');
+
+                    const auto negativeExponent = peek() == '-';
+                    if(negativeExponent || peek() == '+')
+                        accept(peek());
+
+                    if(peekDigit() < 0)
+                        return unexpected(peek(), "a digit in the exponent");
+
+                    int explicitExponent = 0;
+                    for(digit = peekDigit(); digit >= 0; digit = peekDigit())
+                    {
+                        explicitExponent = std::min(explicitExponent * 10 + digit, 100000);
+                        accept('0' + digit);
+                    }
+
+                    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                }
+
+                const char* number = shortNumber;
+                if(length <= maxNumberLength)
+                    shortNumber[length] = '\0';
+                else
+                    number = longNumber.c_str();
+
+                char* numberEnd = nullptr;
+                if(isFloat)
+                {
+                    if(isExact(mantissa, numDigits, exponent))
+                    {
+                        const auto value = toDouble(mantissa, exponent);
+                        return handler.number_float(negative ? -value : value, noString);
+                    }
+
+                    const auto value = std::strtod(number, &numberEnd);
+                    if(numberEnd != number + length)
+                        return syntaxError("invalid number '" + std::string(number) + "'");
+
+                    return handler.number_float(value, noString);
+                }
+
+                errno = 0;
+                if(negative)
+                {
+                    const auto value = std::strtoll(number, &numberEnd, 10);
+                    if(errno != 0 || numberEnd != number + length)
+                        return syntaxError("integer '" + std::string(number) + "' is out of range");
+
+                    return handler.number_integer(value);
+                }
+
+                const auto value = std::strtoull(number, &numberEnd, 10);
+                if(errno != 0 || numberEnd != number + length)
+                    return syntaxError("integer '" + std::string(number) + "' is out of range");
+
+                return handler.number_unsigned(value);
+            }
+
+            std::istream& stream;
+            Handler& handler;
+
+            std::vector<char> buffer;
+            const char* pos = nullptr;
+            const char* end = nullptr;
+            size_t bytesRead = 0;
+
+            const char decimalPoint;
+            std::string longNumber;
+            nlohmann::json::string_t noString; // the handler isn't given the text of each number
+        };
+
+        /**
+         * A SAX handler (see nlohmann::json::json_sax_t), that builds a model
+         * while the json is being parsed.
+         *
+         * The weights (and pruning masks) of each layer are collected into
+         * contiguous tensors, rather than a json DOM, and the layer is created
+         * from views of those tensors as soon as its json object is complete,
+         * so only one layer's weights are held in memory at a time. The other
+         * layer fields are small, and are kept as json.
+         */
+        template <typename T>
+        class StreamingModelParser final : public nlohmann::json::json_sax_t
+        {
+        public:
+            using json = nlohmann::json;
+
+            explicit StreamingModelParser(bool debugMode)
+                : debug(debugMode)
+            {
+            }
+
+            bool null() override
+            {
+                // a null pruning mask leaves the weights unchanged
+                if(currentTensors != nullptr && containers.size() == tensorsDepth)
+                {
+                    currentTensors->emplace_back();
+                    return true;
+                }
+
+                return addValue(nullptr);
+            }
+
+            bool boolean(bool val) override { return addValue(val); }
+            bool number_integer(json::number_integer_t val) override { return addNumber(val); }
+            bool number_unsigned(json::number_unsigned_t val) override { return addNumber(val); }
+            bool number_float(json::number_float_t val, const json::string_t&) override { return addNumber(val); }
+            bool string(json::string_t& val) override { return addValue(val); }
+            bool binary(json::binary_t&) override { return false; } // only used by the binary json formats
+
+            bool key(json::string_t& val) override
+            {
+                currentKey = val;
+                return true;
+            }
+
+            bool start_object(std::size_t) override
+            {
+                if(currentTensors != nullptr)
+                    return false;
+
+                if(containers.empty())
+                {
+                    // the root object
+                    root = json::object();
+                    containers.push_back(&root);
+                }
+                else if(inLayers && containers.size() == 2)
+                {
+                    // a layer object
+                    layer = json::object();
+                    tensors.clear();
+                    masks.clear();
+                    containers.push_back(&layer);
+                }
+                else
+                {
+                    containers.push_back(addChild(json::object()));
+                }
+
+                return containers.back() != nullptr;
+            }
+
+            bool end_object() override
+            {
+                if(inLayers && containers.size() == 3)
+                    if(!addLayer())
+                        return false;
+
+                containers.pop_back();
+                return true;
+            }
+
+            bool start_array(std::size_t) override
+            {
+                if(currentTensors != nullptr)
+                {
+                    const auto level = containers.size() - tensorsDepth;
+                    if(level == 0)
+                    {
+                        currentTensors->emplace_back();
+                        valueLevel = notSet;
+                    }
+                    else
+                    {
+                        if(valueLevel != notSet && level > valueLevel)
+                            return false; // arrays and numbers at the same level
+
+                        counts[level - 1]++;
+                    }
+
+                    counts.resize(level + 1);
+                    counts[level] = 0;
+                    containers.push_back(nullptr);
+                    return true;
+                }
+
+                if(containers.size() == 1 && currentKey == "layers")
+                {
+                    inLayers = true;
+                    containers.push_back(nullptr);
+                    return true;
+                }
+
+                if(inLayers && containers.size() == 3 && (currentKey == "weights" || currentKey == "pruning_masks"))
+                {
+                    currentTensors = currentKey == "weights" ? &tensors : &masks;
+                    tensorsDepth = containers.size() + 1;
+                    containers.push_back(nullptr);
+                    return true;
+                }
+
+                if(containers.empty() || containers.back() == nullptr)
+                    return false;
+
+                containers.push_back(addChild(json::array()));
+                return true;
+            }
+
+            bool end_array() override
+            {
+                if(currentTensors != nullptr)
+                {
+                    if(containers.size() == tensorsDepth)
+                    {
+                        currentTensors = nullptr;
+                    }
+                    else
+                    {
+                        // the size of each dimension is taken from the first array at
+                        // that level, and every other array must have the same size
+                        const auto level = containers.size() - tensorsDepth - 1;
+                        auto& tensor = currentTensors->back();
+                        if(tensor.shape.size() <= level)
+                            tensor.shape.resize(level + 1, notSet);
+
+                        if(tensor.shape[level] == notSet)
+                            tensor.shape[level] = counts[level];
+                        else if(tensor.shape[level] != counts[level])
+                            return false;
+
+                        if(level == 0 && !tensor.isComplete())
+                            return false;
+                    }
+                }
+                else if(inLayers && containers.size() == 2)
+                {
+                    inLayers = false;
+                }
+
+                containers.pop_back();
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+            {
+                // the message includes the byte offset of the error
+                debug_print(ex.what(), debug);
+                return false;
+            }
+
+            /** Returns the model, once the json has been parsed. */
+            std::unique_ptr<Model<T>> getModel()
+            {
+                if(!error && model == nullptr && createModel())
+                    error = !addPendingLayers();
+
+                if(error)
+                    return {};
+
+                return std::move(model);
+            }
+
+        private:
+            /** Adds a value to the current json container. */
+            bool addValue(json&& value)
+            {
+                if(currentTensors != nullptr || containers.empty() || containers.back() == nullptr)
+                    return false;
+
+                addChild(std::move(value));
+                return true;
+            }
+
+            template <typename NumberType>
+            bool addNumber(NumberType value)
+            {
+                if(currentTensors == nullptr)
+                    return addValue(value);
+
+                if(containers.size() == tensorsDepth)
+                    return false; // weight tensors must be arrays
+
+                const auto level = containers.size() - tensorsDepth - 1;
+                if(valueLevel == notSet)
+                    valueLevel = level;
+                else if(valueLevel != level)
+                    return false; // numbers must all be at the innermost level
+
+                counts[level]++;
+                currentTensors->back().values.push_back((T)value);
+                return true;
+            }
+
+            /** Adds a value to the current json container, and returns a pointer to the new value. */
+            json* addChild(json&& value)
+            {
+                auto* parent = containers.back();
+                if(parent->is_object())
+                    return &((*parent)[currentKey] = std::move(value));
+
+                parent->push_back(std::move(value));
+                return &parent->back();
+            }
+
+            bool createModel()
+            {
+                if(!root.contains("in_shape") || !root["in_shape"].is_array())
+                    return false;
+
+                const auto nDims = root["in_shape"].back().get<int>();
+                debug_print("# dimensions: " + std::to_string(nDims), debug);
+                model = std::make_unique<Model<T>>(nDims);
+                return true;
+            }
+
+            /** Adds the layer that was just parsed to the model, or stores it until the input shape is known. */
+            bool addLayer()
+            {
+                pendingLayers.push_back({ std::move(layer), std::move(tensors), std::move(masks) });
+                if(model == nullptr && !createModel())
+                    return true;
+
+                error = !addPendingLayers();
+                return !error;
+            }
+
+            bool addPendingLayers()
+            {
+                for(auto& pending : pendingLayers)
+                {
+                    if(!createLayer(pending))
+                        return false;
+                }
+
+                pendingLayers.clear();
+                return true;
+            }
+
+            struct PendingLayer
+            {
+                json config;
+                std::vector<Tensor<T>> weights;
+                std::vector<Tensor<T>> masks;
+            };
+
+            bool createLayer(PendingLayer& pending)
+            {
+                const auto& l = pending.config;
+                if(!l.contains("type") || !l.contains("shape"))
+                    return false;
+
+                // (see getLayerWeights())
+                auto& weights = pending.weights;
+                if(!weights.empty() && l.contains("quantization") && l["quantization"].is_object() && l["quantization"].contains("scales"))
+                    detail::dequantizeKernel(weights[0], l["quantization"]["scales"]);
+
+                for(size_t i = 0; i < std::min(weights.size(), pending.masks.size()); ++i)
+                    detail::applyPruningMask(weights[i], pending.masks[i]);
+
+                try
+                {
+                    parseLayer<T>(*model, l, weights, debug);
+                }
+                catch(const std::exception& e)
+                {
+                    debug_print(std::string("Unable to load layer: ") + e.what(), debug);
+                    return false;
+                }
+
+                // the layer has its own copy of the weights now
+                weights = {};
+                pending.masks = {};
+                return true;
+            }
+
+            const bool debug;
+
+            json root;
+            json layer;
+            std::vector<json*> containers; // the open json containers (nullptr for the layers, weights, and mask arrays)
+            std::string currentKey;
+
+            bool inLayers = false;
+            std::vector<Tensor<T>> tensors;
+            std::vector<Tensor<T>> masks;
+            std::vector<Tensor<T>>* currentTensors = nullptr; // the tensors being read (weights or masks), if any
+            size_t tensorsDepth = 0;
+            std::vector<size_t> counts; // the number of elements in the open arrays of the current tensor
+            size_t valueLevel = notSet; // the array level of the numbers in the current tensor
+
+            std::unique_ptr<Model<T>> model;
+            std::vector<PendingLayer> pendingLayers;
+            bool error = false;
+        };
+    } // namespace streaming_detail
+#endif // DOXYGEN
+
+    /**
+     * Creates a neural network model from a json stream, without
+     * loading the whole json document into memory.
+     *
+     * The model is built while the json is parsed, and the weights
+     * of each layer are collected directly into contiguous arrays,
+     * which are passed to the layers as weight views, so this is
+     * faster, and uses much less memory, than parseJson() for large
+     * models. All of the layer types and options that parseJson()
+     * supports are supported, but the weights must have exactly the
+     * dimensions that the layer expects. Returns nullptr if the json
+     * could not be parsed.
+     */
+    template <typename T>
+    std::unique_ptr<Model<T>> parseJsonStreaming(std::istream& jsonStream, const bool debug = false)
+    {
+        streaming_detail::StreamingModelParser<T> parser(debug);
+        streaming_detail::JsonReader<streaming_detail::StreamingModelParser<T>, (sizeof(T) < sizeof(double))> reader(jsonStream, parser);
+        if(!reader.parse())
+        {
+            debug_print("Unable to load the model from the json stream", debug);
+            return {};
+        }
+
+        return parser.getModel();
+    }
+
+} // namespace json_parser
+} // namespace RTNeural
@@ -0,0 +1,178 @@
+#ifndef QUANTIZATION_H_INCLUDED
+#define QUANTIZATION_H_INCLUDED
+
+#include "../common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+/**
+ * Utilities for symmetric integer quantization, used by the
+ * quantized layers (e.g. QuantizedDense, QuantizedGRULayer).
+ *
+ * A quantized value q represents the real value q * scale.
+ * The quantized range is symmetric ([-127, 127] for int8, and
+ * [-32767, 32767] for int16). The products of two int8 values
+ * are accumulated in an int32_t, which can hold up to 2^31 / 127^2
+ * (about 133,000) products without overflowing, and the products
+ * of two int16 values are accumulated in an int64_t.
+ */
+namespace quantization_detail
+{
+    /** Properties of the integer types that can be used for quantized values. */
+    template <typename QType>
+    struct QuantizedTypeTraits;
+
+    template <>
+    struct QuantizedTypeTraits<int8_t>
+    {
+        using accum_type = int32_t;
+        static constexpr int32_t maxValue() noexcept { return 127; }
+    };
+
+    template <>
+    struct QuantizedTypeTraits<int16_t>
+    {
+        using accum_type = int64_t;
+        static constexpr int32_t maxValue() noexcept { return 32767; }
+    };
+
+    /** Returns the quantization scale for values with the given maximum magnitude. */
+    template <typename QType, typename T>
+    inline T getScale(T maxAbs) noexcept
+    {
+        return maxAbs > (T)0 ? maxAbs / (T)QuantizedTypeTraits<QType>::maxValue() : (T)1;
+    }
+
+    /**
+     * Quantizes a value, with rounding (half away from zero) and saturation.
+     * The value is saturated before it is converted to an integer, so that
+     * infinite or out-of-range values are well-defined. NaN is quantized to zero.
+     */
+    template <typename QType, typename T>
+    inline QType quantize(T x, T invScale) noexcept
+    {
+        constexpr auto q_max = (T)QuantizedTypeTraits<QType>::maxValue();
+        const auto scaled = x * invScale;
+        if(std::isnan(scaled))
+            return (QType)0;
+
+        const auto clamped = std::max(-q_max, std::min(q_max, scaled));
+        return (QType)(int32_t)(clamped + (clamped < (T)0 ? (T)-0.5 : (T)0.5));
+    }
+
+    /**
+     * Quantizes a vector of values, with a scale chosen from the largest
+     * value in the vector, and returns the quantization scale. If all of
+     * the values are zero, the returned scale is zero.
+     */
+    template <typename T, typename QType>
+    inline T quantizeVector(const T* x, QType* qx, int size) noexcept
+    {
+        T maxAbs = (T)0;
+        for(int k = 0; k < size; ++k)
+            maxAbs = std::max(maxAbs, std::abs(x[k]));
+
+        if(!(maxAbs > (T)0))
+        {
+            for(int k = 0; k < size; ++k)
+                qx[k] = (QType)0;
+            return (T)0;
+        }
+
+        constexpr auto q_max = (T)QuantizedTypeTraits<QType>::maxValue();
+        const auto invScale = q_max / maxAbs;
+        for(int k = 0; k < size; ++k)
+            qx[k] = quantize<QType>(x[k], invScale);
+
+        return maxAbs / q_max;
+    }
+
+    /**
+     * Quantizes a set of weights with per-output-channel scales.
+     *
+     * @param getWeight: returns the weight for a given output channel and weight index
+     * @param qWeights: the quantized weights, laid out as qWeights[num_channels][channel_size]
+     * @param scales: the quantization scale for each output channel
+     */
+    template <typename T, typename WeightFunc, typename QType>
+    void quantizeChannels(WeightFunc&& getWeight, int num_channels, int channel_size, QType* qWeights, T* scales)
+    {
+        for(int i = 0; i < num_channels; ++i)
+        {
+            T maxAbs = (T)0;
+            for(int k = 0; k < channel_size; ++k)
+                maxAbs = std::max(maxAbs, (T)std::abs(getWeight(i, k)));
+
+            scales[i] = getScale<QType>(maxAbs);
+            const auto invScale = (T)1 / scales[i];
+            for(int k = 0; k < channel_size; ++k)
+                qWeights[i * channel_size + k] = quantize<QType>((T)getWeight(i, k), invScale);
+        }
+    }
+
+    /**
+     * Returns the dot product of two quantized vectors, using the accumulator
+     * type for the quantized type. This loop is simple enough for compilers
+     * to vectorize with multiply-add instructions for packed integers.
+     */
+    template <typename QType>
+    inline typename QuantizedTypeTraits<QType>::accum_type dot(const QType* a, const QType* b, int size) noexcept
+    {
+        using accum_type = typename QuantizedTypeTraits<QType>::accum_type;
+
+        accum_type acc = 0;
+        for(int k = 0; k < size; ++k)
+            acc += (accum_type)a[k] * (accum_type)b[k];
+        return acc;
+    }
+
+    /** Scalar sigmoid function, used by the quantized recurrent layers. */
+    template <typename T>
+    inline T sigmoid(T x) noexcept
+    {
+        return (T)1 / ((T)1 + std::exp(-x));
+    }
+
+    /**
+     * The input type used by the static layers for the current backend,
+     * and a way to access the inputs as a contiguous array of scalars.
+     */
+    template <typename T, int in_size>
+    struct StaticInputs
+    {
+#if RTNEURAL_USE_EIGEN
+        using type = Eigen::Matrix<T, in_size, 1>;
+        static constexpr int scratch_size = 1;
+
+        static inline const T* getData(const type& ins, T*) noexcept { return ins.data(); }
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+        using v_type = xsimd::simd_type<T>;
+        static constexpr auto v_size = (int)v_type::size;
+        static constexpr auto v_in_size = ceil_div(in_size, v_size);
+        using type = v_type[v_in_size];
+        static constexpr int scratch_size = v_in_size * v_size;
+
+        static inline const T* getData(const type& ins, T* scratch) noexcept
+        {
+            for(int k = 0; k < v_in_size; ++k)
+                xsimd::store_aligned(scratch + k * v_size, ins[k]);
+            return scratch;
+        }
+#else
+        using type = T[in_size];
+        static constexpr int scratch_size = 1;
+
+        static inline const T* getData(const type& ins, T*) noexcept { return ins; }
+#endif
+    };
+} // namespace quantization_detail
+#endif // DOXYGEN
+
+} // namespace RTNeural
+
+#endif // QUANTIZATION_H_INCLUDED
@@ -0,0 +1,189 @@
+#ifndef SPARSE_H_INCLUDED
+#define SPARSE_H_INCLUDED
+
+#include "../common.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "../dispatch/layer_kernels.h"
+
+/**
+ * The block density below which the json parser loads dense layers
+ * as SparseDense layers. The density is the fraction of (1x4) weight
+ * blocks that contain at least one non-zero weight.
+ */
+#ifndef RTNEURAL_SPARSE_DENSITY_THRESHOLD
+#define RTNEURAL_SPARSE_DENSITY_THRESHOLD 0.3
+#endif
+
+namespace RTNeural
+{
+
+#ifndef DOXYGEN
+/**
+ * Utilities for block-sparse matrices, stored in block compressed
+ * sparse row (BSR) format.
+ *
+ * A matrix with `rows` rows and `cols` columns is divided into blocks
+ * of block_rows x block_cols weights (the matrix is zero-padded up to
+ * a whole number of blocks). Only the blocks with a non-zero weight are
+ * stored:
+ * - row_ptr[num_block_rows + 1]: the index of the first block in each block row
+ * - col_idx[num_blocks]: the block column of each block
+ * - values[num_blocks][block_rows][block_cols]: the weights in each block
+ *
+ * Each block is a small dense matrix, so the inner loops have a fixed
+ * size, which compilers can unroll and vectorize.
+ */
+namespace sparse_detail
+{
+    /** Returns true if the block at the given block row and column contains a non-zero weight. */
+    template <int block_rows, int block_cols, typename WeightFunc>
+    bool isNonZeroBlock(WeightFunc&& getWeight, int rows, int cols, int blockRow, int blockCol)
+    {
+        for(int r = blockRow * block_rows; r < std::min((blockRow + 1) * block_rows, rows); ++r)
+            for(int c = blockCol * block_cols; c < std::min((blockCol + 1) * block_cols, cols); ++c)
+                if(getWeight(r, c) != 0)
+                    return true;
+
+        return false;
+    }
+
+    /** Returns the number of non-zero blocks in a matrix. */
+    template <int block_rows, int block_cols, typename WeightFunc>
+    int countBlocks(WeightFunc&& getWeight, int rows, int cols)
+    {
+        int numBlocks = 0;
+        for(int br = 0; br < ceil_div(rows, block_rows); ++br)
+            for(int bc = 0; bc < ceil_div(cols, block_cols); ++bc)
+                numBlocks += isNonZeroBlock<block_rows, block_cols>(getWeight, rows, cols, br, bc) ? 1 : 0;
+
+        return numBlocks;
+    }
+
+    /** Returns the fraction of blocks in a matrix that contain a non-zero weight. */
+    template <int block_rows, int block_cols, typename WeightFunc>
+    double blockDensity(WeightFunc&& getWeight, int rows, int cols)
+    {
+        const auto totalBlocks = ceil_div(rows, block_rows) * ceil_div(cols, block_cols);
+        if(totalBlocks == 0)
+            return 1.0;
+
+        return (double)countBlocks<block_rows, block_cols>(getWeight, rows, cols) / (double)totalBlocks;
+    }
+
+    /**
+     * Packs the non-zero blocks of a matrix, and returns the number of blocks.
+     * The arrays must have space for all of the non-zero blocks (see countBlocks()).
+     */
+    template <typename T, int block_rows, int block_cols, typename WeightFunc>
+    int packBlocks(WeightFunc&& getWeight, int rows, int cols, int* row_ptr, int* col_idx, T* values)
+    {
+        int numBlocks = 0;
+        for(int br = 0; br < ceil_div(rows, block_rows); ++br)
+        {
+            row_ptr[br] = numBlocks;
+            for(int bc = 0; bc < ceil_div(cols, block_cols); ++bc)
+            {
+                if(!isNonZeroBlock<block_rows, block_cols>(getWeight, rows, cols, br, bc))
+                    continue;
+
+                auto* block = values + numBlocks * block_rows * block_cols;
+                for(int r = 0; r < block_rows; ++r)
+                {
+                    for(int c = 0; c < block_cols; ++c)
+                    {
+                        const auto row = br * block_rows + r;
+                        const auto col = bc * block_cols + c;
+                        block[r * block_cols + c] = (row < rows && col < cols) ? (T)getWeight(row, col) : (T)0;
+                    }
+                }
+
+                col_idx[numBlocks++] = bc;
+            }
+        }
+
+        row_ptr[ceil_div(rows, block_rows)] = numBlocks;
+        return numBlocks;
+    }
+
+    /** Computes y = A * x for a block-sparse matrix A, with the block columns held in a vector register. */
+    template <typename T, int block_rows, int block_cols>
+    inline void multiply(const int* row_ptr, const int* col_idx, const T* values, int num_block_rows, const T* x, T* y, std::true_type) noexcept
+    {
+        using lanes_type = typename lanes_detail::LaneVector<T, block_cols>::type;
+
+        for(int br = 0; br < num_block_rows; ++br)
+        {
+            lanes_type acc[block_rows] {};
+            for(int b = row_ptr[br]; b < row_ptr[br + 1]; ++b)
+            {
+                lanes_type xLanes, wLanes;
+                std::memcpy(&xLanes, x + col_idx[b] * block_cols, sizeof(lanes_type));
+
+                const auto* block = values + b * block_rows * block_cols;
+                for(int r = 0; r < block_rows; ++r)
+                {
+                    std::memcpy(&wLanes, block + r * block_cols, sizeof(lanes_type));
+                    acc[r] += wLanes * xLanes;
+                }
+            }
+
+            for(int r = 0; r < block_rows; ++r)
+            {
+                T sum = acc[r][0];
+                for(int c = 1; c < block_cols; ++c)
+                    sum += acc[r][c];
+                y[br * block_rows + r] = sum;
+            }
+        }
+    }
+
+    /** Computes y = A * x for a block-sparse matrix A, with an array of scalar lanes. */
+    template <typename T, int block_rows, int block_cols>
+    inline void multiply(const int* row_ptr, const int* col_idx, const T* values, int num_block_rows, const T* x, T* y, std::false_type) noexcept
+    {
+        for(int br = 0; br < num_block_rows; ++br)
+        {
+            T acc[block_rows * block_cols] {};
+            for(int b = row_ptr[br]; b < row_ptr[br + 1]; ++b)
+            {
+                const auto* block = values + b * block_rows * block_cols;
+                const auto* xBlock = x + col_idx[b] * block_cols;
+                for(int r = 0; r < block_rows; ++r)
+                    for(int c = 0; c < block_cols; ++c)
+                        acc[r * block_cols + c] += block[r * block_cols + c] * xBlock[c];
+            }
+
+            for(int r = 0; r < block_rows; ++r)
+            {
+                T sum = acc[r * block_cols];
+                for(int c = 1; c < block_cols; ++c)
+                    sum += acc[r * block_cols + c];
+                y[br * block_rows + r] = sum;
+            }
+        }
+    }
+
+    /**
+     * Computes y = A * x for a block-sparse matrix A.
+     * x must be zero-padded to a whole number of block columns,
+     * and y must have space for a whole number of block rows.
+     *
+     * Each row keeps one accumulator per block column (lane) across
+     * all of its blocks, so the multiply-adds are element-wise, and the
+     * lanes are only added together once per row.
+     */
+    template <typename T, int block_rows, int block_cols>
+    inline void multiply(const int* row_ptr, const int* col_idx, const T* values, int num_block_rows, const T* x, T* y) noexcept
+    {
+        multiply<T, block_rows, block_cols>(row_ptr, col_idx, values, num_block_rows, x, y,
+            std::integral_constant<bool, lanes_detail::LaneVector<T, block_cols>::is_vector> {});
+    }
+} // namespace sparse_detail
+#endif // DOXYGEN
+
+} // namespace RTNeural
+
+#endif // SPARSE_H_INCLUDED
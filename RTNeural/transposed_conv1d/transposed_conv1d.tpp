@@ -0,0 +1,126 @@
+#include "transposed_conv1d.h"
+
+namespace RTNeural
+{
+
+#if !RTNEURAL_USE_EIGEN && !RTNEURAL_USE_XSIMD && !RTNEURAL_USE_VECTOR_EXT
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(int in_size, int num_filters_out, int kernel_size, int stride)
+    : Layer<T>(in_size, stride * num_filters_out)
+    , num_filters_out(num_filters_out)
+    , kernel_size(kernel_size)
+    , stride(stride)
+    , num_taps(ceil_div(kernel_size, stride))
+    , state_size(ceil_div(kernel_size, stride) - 1)
+{
+    phase_taps.resize(stride, 0);
+    for(int p = 0; p < stride; ++p)
+        phase_taps[p] = p < kernel_size ? ceil_div(kernel_size - p, stride) : 0;
+
+    phaseWeights = std::vector<std::vector<T>>(stride * num_taps, std::vector<T>(num_filters_out * in_size, (T)0));
+    bias.resize(num_filters_out, (T)0);
+    state.resize(2 * state_size * in_size, (T)0);
+}
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(std::initializer_list<int> sizes)
+    : TransposedConv1D<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+{
+}
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(const TransposedConv1D<T>& other)
+    : TransposedConv1D<T>(other.in_size, other.num_filters_out, other.kernel_size, other.stride)
+{
+    *this = other;
+}
+
+template <typename T>
+TransposedConv1D<T>& TransposedConv1D<T>::operator=(const TransposedConv1D<T>& other)
+{
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && num_filters_out == other.num_filters_out
+        && kernel_size == other.kernel_size && stride == other.stride);
+
+    phaseWeights = other.phaseWeights;
+    bias = other.bias;
+    state = other.state;
+    state_ptr = other.state_ptr;
+
+    return *this;
+}
+
+template <typename T>
+void TransposedConv1D<T>::reset()
+{
+    state_ptr = 0;
+    std::fill(state.begin(), state.end(), (T)0);
+}
+
+template <typename T>
+void TransposedConv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < Layer<T>::in_size; ++ci)
+            for(int k = 0; k < kernel_size; ++k)
+                phaseWeights[(k % stride) * num_taps + k / stride][co * Layer<T>::in_size + ci] = weights[co][ci][k];
+}
+
+template <typename T>
+void TransposedConv1D<T>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = biasVals[co];
+}
+
+//====================================================
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::TransposedConv1DT()
+{
+    for(int p = 0; p < stride; ++p)
+        for(int j = 0; j < num_taps; ++j)
+            for(int co = 0; co < num_filters_out; ++co)
+                for(int ci = 0; ci < in_size; ++ci)
+                    weights[p][j][co][ci] = (T)0.0;
+
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = (T)0.0;
+
+    for(int i = 0; i < out_size; ++i)
+        outs[i] = (T)0.0;
+
+    reset();
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::reset()
+{
+    state_ptr = 0;
+    for(int i = 0; i < state_alloc_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            state[i][k] = (T)0.0;
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < in_size; ++ci)
+            for(int k = 0; k < kernel_size; ++k)
+                weights[k % stride][k / stride][co][ci] = ws[co][ci][k];
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias[co] = biasVals[co];
+}
+
+#endif
+
+} // namespace RTNeural
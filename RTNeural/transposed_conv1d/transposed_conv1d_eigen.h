@@ -0,0 +1,251 @@
+#ifndef TRANSPOSEDCONV1DEIGEN_H_INCLUDED
+#define TRANSPOSEDCONV1DEIGEN_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a streaming 1-dimensional transposed
+ * convolution (learned upsampling) layer with no activation.
+ *
+ * For each input frame, the layer produces `stride` output frames,
+ * laid out as `outs[stride][num_filters_out]`, so the layer output
+ * size is `stride * num_filters_out`. The layer uses a polyphase
+ * decomposition: output phase `p` only evaluates the kernel taps
+ * `p, p + stride, p + 2 * stride, ...`, instead of convolving a
+ * zero-stuffed input. In a `Model`, the following layers run once
+ * for each output frame.
+ *
+ * The layer has a "state" made up of past inputs to the layer.
+ * To ensure that the state is initialized to zero, please make
+ * sure to call `reset()` before your first call to the `forward()` method.
+ */
+template <typename T>
+class TransposedConv1D : public Layer<T>
+{
+public:
+    /**
+     * Constructs a transposed convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param num_filters_out: the number of output filters (channels) for each output frame
+     * @param kernel_size: the size of the convolution kernel
+     * @param stride: the upsampling factor of the layer
+     */
+    TransposedConv1D(int in_size, int num_filters_out, int kernel_size, int stride);
+    TransposedConv1D(std::initializer_list<int> sizes);
+    TransposedConv1D(const TransposedConv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    TransposedConv1D& operator=(const TransposedConv1D& other);
+    virtual ~TransposedConv1D() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "transposed-conv1d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
+            input, Layer<T>::in_size, 1);
+
+        for(int p = 0; p < stride; ++p)
+        {
+            auto y = outVec.segment(p * num_filters_out, num_filters_out);
+            y = bias;
+
+            for(int j = 0; j < phase_taps[p]; ++j)
+            {
+                if(j == 0)
+                    y.noalias() += phaseWeights[p * num_taps] * inVec;
+                else
+                    y.noalias() += phaseWeights[p * num_taps + j] * state.col(state_ptr + state_size - j);
+            }
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            state.col(state_ptr) = inVec;
+            state.col(state_ptr + state_size) = inVec;
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+
+        std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[num_filters_out][in_size][kernel_size].
+     * Unlike `Conv1D`, the kernel is not reversed in time, so kernel index `k`
+     * contributes to output sample `n * stride + k` for input frame `n`.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of output filters for each output frame. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the upsampling factor of the layer. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns the number of output frames the layer produces for each input frame. */
+    int getUpsamplingFactor() const noexcept override { return stride; }
+
+private:
+    const int num_filters_out;
+    const int kernel_size;
+    const int stride;
+    const int num_taps;
+    const int state_size;
+
+    std::vector<int> phase_taps;
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> phaseWeights;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> bias;
+
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> state;
+    int state_ptr = 0;
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
+};
+
+//====================================================
+/**
+ * Static implementation of a streaming 1-dimensional transposed
+ * convolution (learned upsampling) layer with no activation.
+ *
+ * For each input frame, the layer produces `stride` output frames,
+ * laid out as `outs[stride][num_filters_out]`. See `TransposedConv1D`
+ * for more information. Since a `ModelT` passes the whole output to the
+ * next layer, this layer must be the last layer in a `ModelT`, apart
+ * from element-wise activations (which is checked at compile-time).
+ *
+ * To ensure that the state is initialized to zero, please make sure
+ * to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param num_filters_out_t: the number of output filters (channels) for each output frame
+ * @param kernel_size: the size of the convolution kernel
+ * @param stride: the upsampling factor of the layer
+ */
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+class TransposedConv1DT
+{
+    static constexpr auto num_taps = ceil_div(kernel_size, stride);
+    static constexpr auto state_size = num_taps - 1;
+    static constexpr auto state_alloc_size = state_size > 0 ? 2 * state_size : 1;
+
+    /** Returns the number of kernel taps used by a given output phase. */
+    static constexpr int phaseTaps(int phase) noexcept
+    {
+        return phase < kernel_size ? ceil_div(kernel_size - phase, stride) : 0;
+    }
+
+public:
+    static constexpr auto num_filters_out = num_filters_out_t;
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = stride * num_filters_out;
+
+private:
+    using in_vec_type = Eigen::Matrix<T, in_size, 1>;
+    using out_vec_type = Eigen::Matrix<T, out_size, 1>;
+    using bias_type = Eigen::Matrix<T, num_filters_out, 1>;
+    using state_type = Eigen::Matrix<T, in_size, state_alloc_size>;
+    using weights_type = Eigen::Matrix<T, num_filters_out, in_size>;
+
+public:
+    TransposedConv1DT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "transposed-conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const in_vec_type& ins) noexcept
+    {
+        for(int p = 0; p < stride; ++p)
+        {
+            auto y = outs.template segment<num_filters_out>(p * num_filters_out);
+            y = bias;
+
+            for(int j = 0; j < phaseTaps(p); ++j)
+            {
+                if(j == 0)
+                    y.noalias() += weights[p][0] * ins;
+                else
+                    y.noalias() += weights[p][j] * state.col(state_ptr + state_size - j);
+            }
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            state.col(state_ptr) = ins;
+            state.col(state_ptr + state_size) = ins;
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[num_filters_out][in_size][kernel_size].
+     * Unlike `Conv1DT`, the kernel is not reversed in time, so kernel index `k`
+     * contributes to output sample `n * stride + k` for input frame `n`.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of output filters for each output frame. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the upsampling factor of the layer. */
+    int getStride() const noexcept { return stride; }
+
+    Eigen::Map<out_vec_type, RTNeuralEigenAlignment> outs;
+
+private:
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    state_type state;
+    int state_ptr = 0;
+
+    weights_type weights[stride][num_taps];
+    bias_type bias;
+};
+
+} // namespace RTNeural
+
+#endif // TRANSPOSEDCONV1DEIGEN_H_INCLUDED
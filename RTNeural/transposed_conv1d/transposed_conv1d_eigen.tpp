@@ -0,0 +1,121 @@
+#include "transposed_conv1d_eigen.h"
+
+namespace RTNeural
+{
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(int in_size, int num_filters_out, int kernel_size, int stride)
+    : Layer<T>(in_size, stride * num_filters_out)
+    , num_filters_out(num_filters_out)
+    , kernel_size(kernel_size)
+    , stride(stride)
+    , num_taps(ceil_div(kernel_size, stride))
+    , state_size(ceil_div(kernel_size, stride) - 1)
+{
+    phase_taps.resize(stride, 0);
+    for(int p = 0; p < stride; ++p)
+        phase_taps[p] = p < kernel_size ? ceil_div(kernel_size - p, stride) : 0;
+
+    phaseWeights.resize(stride * num_taps);
+    for(auto& w : phaseWeights)
+        w = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(num_filters_out, in_size);
+
+    bias = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(num_filters_out, 1);
+    state = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(in_size, 2 * state_size);
+    inVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(in_size, 1);
+    outVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(stride * num_filters_out, 1);
+}
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(std::initializer_list<int> sizes)
+    : TransposedConv1D<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+{
+}
+
+template <typename T>
+TransposedConv1D<T>::TransposedConv1D(const TransposedConv1D<T>& other)
+    : TransposedConv1D<T>(other.in_size, other.num_filters_out, other.kernel_size, other.stride)
+{
+    *this = other;
+}
+
+template <typename T>
+TransposedConv1D<T>& TransposedConv1D<T>::operator=(const TransposedConv1D<T>& other)
+{
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && num_filters_out == other.num_filters_out
+        && kernel_size == other.kernel_size && stride == other.stride);
+
+    phaseWeights = other.phaseWeights;
+    bias = other.bias;
+    state = other.state;
+    state_ptr = other.state_ptr;
+
+    return *this;
+}
+
+template <typename T>
+void TransposedConv1D<T>::reset()
+{
+    state_ptr = 0;
+    state.setZero();
+}
+
+template <typename T>
+void TransposedConv1D<T>::setWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < Layer<T>::in_size; ++ci)
+            for(int k = 0; k < kernel_size; ++k)
+                phaseWeights[(k % stride) * num_taps + k / stride](co, ci) = weights[co][ci][k];
+}
+
+template <typename T>
+void TransposedConv1D<T>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias(co) = biasVals[co];
+}
+
+//====================================================
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::TransposedConv1DT()
+    : outs(outs_internal)
+{
+    for(int p = 0; p < stride; ++p)
+        for(int j = 0; j < num_taps; ++j)
+            weights[p][j] = weights_type::Zero();
+
+    bias = bias_type::Zero();
+    outs = out_vec_type::Zero();
+
+    reset();
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::reset()
+{
+    state_ptr = 0;
+    state = state_type::Zero();
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::setWeights(const std::vector<std::vector<std::vector<T>>>& ws)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        for(int ci = 0; ci < in_size; ++ci)
+            for(int k = 0; k < kernel_size; ++k)
+                weights[k % stride][k / stride](co, ci) = ws[co][ci][k];
+}
+
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+void TransposedConv1DT<T, in_sizet, num_filters_out_t, kernel_size, stride>::setBias(const std::vector<T>& biasVals)
+{
+    for(int co = 0; co < num_filters_out; ++co)
+        bias(co) = biasVals[co];
+}
+
+} // namespace RTNeural
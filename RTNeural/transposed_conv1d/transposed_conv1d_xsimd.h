@@ -0,0 +1,266 @@
+#ifndef TRANSPOSEDCONV1DXSIMD_H_INCLUDED
+#define TRANSPOSEDCONV1DXSIMD_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a streaming 1-dimensional transposed
+ * convolution (learned upsampling) layer with no activation.
+ *
+ * For each input frame, the layer produces `stride` output frames,
+ * laid out as `outs[stride][num_filters_out]`, so the layer output
+ * size is `stride * num_filters_out`. The layer uses a polyphase
+ * decomposition: output phase `p` only evaluates the kernel taps
+ * `p, p + stride, p + 2 * stride, ...`, instead of convolving a
+ * zero-stuffed input. In a `Model`, the following layers run once
+ * for each output frame.
+ *
+ * The layer has a "state" made up of past inputs to the layer.
+ * To ensure that the state is initialized to zero, please make
+ * sure to call `reset()` before your first call to the `forward()` method.
+ */
+template <typename T>
+class TransposedConv1D : public Layer<T>
+{
+public:
+    /**
+     * Constructs a transposed convolution layer for the given dimensions.
+     *
+     * @param in_size: the input size for the layer
+     * @param num_filters_out: the number of output filters (channels) for each output frame
+     * @param kernel_size: the size of the convolution kernel
+     * @param stride: the upsampling factor of the layer
+     */
+    TransposedConv1D(int in_size, int num_filters_out, int kernel_size, int stride);
+    TransposedConv1D(std::initializer_list<int> sizes);
+    TransposedConv1D(const TransposedConv1D& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    TransposedConv1D& operator=(const TransposedConv1D& other);
+    virtual ~TransposedConv1D() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "transposed-conv1d"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        for(int p = 0; p < stride; ++p)
+        {
+            auto* y = &h[p * num_filters_out];
+            std::copy(bias.begin(), bias.end(), y);
+
+            for(int j = 0; j < phase_taps[p]; ++j)
+            {
+                const auto* x = j == 0 ? input : &state[(state_ptr + state_size - j) * Layer<T>::in_size];
+                const auto& w = phaseWeights[p * num_taps + j];
+                for(int co = 0; co < num_filters_out; ++co)
+                    y[co] += vMult(x, w[co].data(), prod_state.data(), Layer<T>::in_size);
+            }
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            std::copy(input, input + Layer<T>::in_size, &state[state_ptr * Layer<T>::in_size]);
+            std::copy(input, input + Layer<T>::in_size, &state[(state_ptr + state_size) * Layer<T>::in_size]);
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[num_filters_out][in_size][kernel_size].
+     * Unlike `Conv1D`, the kernel is not reversed in time, so kernel index `k`
+     * contributes to output sample `n * stride + k` for input frame `n`.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of output filters for each output frame. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the upsampling factor of the layer. */
+    int getStride() const noexcept { return stride; }
+
+    /** Returns the number of output frames the layer produces for each input frame. */
+    int getUpsamplingFactor() const noexcept override { return stride; }
+
+private:
+    const int num_filters_out;
+    const int kernel_size;
+    const int stride;
+    const int num_taps;
+    const int state_size;
+
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
+    using vec2_type = std::vector<vec_type>;
+    using vec3_type = std::vector<vec2_type>;
+
+    std::vector<int> phase_taps;
+    vec3_type phaseWeights;
+    vec_type bias;
+
+    vec_type state;
+    int state_ptr = 0;
+
+    vec_type prod_state;
+};
+
+//====================================================
+/**
+ * Static implementation of a streaming 1-dimensional transposed
+ * convolution (learned upsampling) layer with no activation.
+ *
+ * For each input frame, the layer produces `stride` output frames,
+ * laid out as `outs[stride][num_filters_out]`. See `TransposedConv1D`
+ * for more information. Since a `ModelT` passes the whole output to the
+ * next layer, this layer must be the last layer in a `ModelT`, apart
+ * from element-wise activations (which is checked at compile-time).
+ *
+ * To ensure that the state is initialized to zero, please make sure
+ * to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param in_sizet: the input size for the layer
+ * @param num_filters_out_t: the number of output filters (channels) for each output frame
+ * @param kernel_size: the size of the convolution kernel
+ * @param stride: the upsampling factor of the layer
+ */
+template <typename T, int in_sizet, int num_filters_out_t, int kernel_size, int stride>
+class TransposedConv1DT
+{
+    static constexpr auto num_taps = ceil_div(kernel_size, stride);
+    static constexpr auto state_size = num_taps - 1;
+    static constexpr auto state_alloc_size = state_size > 0 ? 2 * state_size : 1;
+
+    /** Returns the number of kernel taps used by a given output phase. */
+    static constexpr int phaseTaps(int phase) noexcept
+    {
+        return phase < kernel_size ? ceil_div(kernel_size - phase, stride) : 0;
+    }
+
+public:
+    static constexpr auto num_filters_out = num_filters_out_t;
+    static constexpr auto in_size = in_sizet;
+    static constexpr auto out_size = stride * num_filters_out;
+
+private:
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_in_size = ceil_div(in_size, v_size);
+    static constexpr auto v_out_size = ceil_div(out_size, v_size);
+    static constexpr auto v_filters_out_size = ceil_div(num_filters_out, v_size);
+
+public:
+    TransposedConv1DT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "transposed-conv1d"; }
+
+    /** Returns false since convolution is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const v_type (&ins)[v_in_size]) noexcept
+    {
+        for(int k = 0; k < v_in_size; ++k)
+            ins[k].store_aligned(&ins_scalar[k * v_size]);
+
+        for(int p = 0; p < stride; ++p)
+        {
+            for(int i = 0; i < v_filters_out_size; ++i)
+                acc[i] = bias[i];
+
+            // broadcast each input across the output filters
+            for(int j = 0; j < phaseTaps(p); ++j)
+            {
+                const T* x = j == 0 ? &ins_scalar[0] : &state[state_ptr + state_size - j][0];
+                for(int ci = 0; ci < in_size; ++ci)
+                {
+                    const v_type xv((T)x[ci]);
+                    for(int i = 0; i < v_filters_out_size; ++i)
+                        acc[i] = xsimd::fma(xv, weights[p][j][ci][i], acc[i]);
+                }
+            }
+
+            for(int i = 0; i < v_filters_out_size; ++i)
+                acc[i].store_aligned(&acc_scalar[i * v_size]);
+            std::copy(acc_scalar, acc_scalar + num_filters_out, &outs_scalar[p * num_filters_out]);
+        }
+
+        // insert input into double-buffered state
+        if(state_size > 0)
+        {
+            std::copy(ins_scalar, ins_scalar + in_size, state[state_ptr]);
+            std::copy(ins_scalar, ins_scalar + in_size, state[state_ptr + state_size]);
+            state_ptr = (state_ptr == state_size - 1 ? 0 : state_ptr + 1);
+        }
+
+        for(int i = 0; i < v_out_size; ++i)
+            outs[i] = xsimd::load_aligned(&outs_scalar[i * v_size]);
+    }
+
+    /**
+     * Sets the layer weights.
+     *
+     * The weights vector must have size weights[num_filters_out][in_size][kernel_size].
+     * Unlike `Conv1DT`, the kernel is not reversed in time, so kernel index `k`
+     * contributes to output sample `n * stride + k` for input frame `n`.
+     */
+    void setWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the layer biases.
+     *
+     * The bias vector must have size bias[num_filters_out]
+     */
+    void setBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of output filters for each output frame. */
+    int getNumFiltersOut() const noexcept { return num_filters_out; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the upsampling factor of the layer. */
+    int getStride() const noexcept { return stride; }
+
+    v_type outs[v_out_size];
+
+private:
+    T ins_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_in_size * v_size];
+    T outs_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_out_size * v_size];
+    T acc_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_filters_out_size * v_size];
+    v_type acc[v_filters_out_size];
+
+    T state alignas(RTNEURAL_DEFAULT_ALIGNMENT)[state_alloc_size][in_size];
+    int state_ptr = 0;
+
+    v_type weights[stride][num_taps][in_size][v_filters_out_size];
+    v_type bias[v_filters_out_size];
+};
+
+} // namespace RTNeural
+
+#endif // TRANSPOSEDCONV1DXSIMD_H_INCLUDED
@@ -0,0 +1,446 @@
+#pragma once
+
+#if ! defined(__GNUC__) && ! defined(__clang__)
+#error "The vector extension backend (RTNEURAL_USE_VECTOR_EXT) requires GCC or Clang!"
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "../maths/maths_approx.h"
+
+/**
+ * The width of the vector registers used by the vector extension
+ * backend, in bytes. By default, this is chosen from the instruction
+ * set that the compiler is targeting.
+ */
+#ifndef RTNEURAL_VECTOR_EXT_BYTES
+#if defined(__AVX512F__)
+#define RTNEURAL_VECTOR_EXT_BYTES 64
+#elif defined(__AVX__)
+#define RTNEURAL_VECTOR_EXT_BYTES 32
+#else
+#define RTNEURAL_VECTOR_EXT_BYTES 16
+#endif
+#endif
+
+namespace RTNeural
+{
+/**
+ * A small SIMD library, built on the GCC/Clang vector extensions,
+ * with no dependencies outside of the C++ standard library.
+ *
+ * The library implements the subset of the xsimd API that is used
+ * by RTNeural, so that the XSIMD layers can be compiled with either
+ * library. The compiler generates the instructions for the target
+ * architecture (e.g. SSE, AVX, AVX-512, NEON).
+ */
+namespace vector_ext
+{
+#ifndef DOXYGEN
+    namespace detail
+    {
+        template <typename T>
+        struct register_traits
+        {
+            typedef T type __attribute__((vector_size(RTNEURAL_VECTOR_EXT_BYTES)));
+        };
+
+        template <std::size_t Size>
+        struct int_of_size;
+
+        template <>
+        struct int_of_size<4>
+        {
+            using type = int32_t;
+        };
+
+        template <>
+        struct int_of_size<8>
+        {
+            using type = int64_t;
+        };
+
+        /** The signed integer type with the same size as T. */
+        template <typename T>
+        using as_int_t = typename int_of_size<sizeof(T)>::type;
+
+        template <typename I>
+        struct float_of_int;
+
+        template <>
+        struct float_of_int<int32_t>
+        {
+            using type = float;
+        };
+
+        template <>
+        struct float_of_int<int64_t>
+        {
+            using type = double;
+        };
+    } // namespace detail
+#endif // DOXYGEN
+
+    /** A vector of boolean values, as the result of comparing two batches. */
+    template <typename T>
+    struct batch_bool
+    {
+        using register_type = typename detail::register_traits<detail::as_int_t<T>>::type;
+
+        friend batch_bool operator&(const batch_bool& a, const batch_bool& b) noexcept { return { a.data & b.data }; }
+        friend batch_bool operator|(const batch_bool& a, const batch_bool& b) noexcept { return { a.data | b.data }; }
+        friend batch_bool operator~(const batch_bool& a) noexcept { return { ~a.data }; }
+
+        register_type data;
+    };
+
+    /** A vector of values, filling one vector register. */
+    template <typename T>
+    struct batch
+    {
+        using value_type = T;
+        using register_type = typename detail::register_traits<T>::type;
+        using batch_bool_type = batch_bool<T>;
+
+        static constexpr std::size_t size = RTNEURAL_VECTOR_EXT_BYTES / sizeof(T);
+
+        batch() = default;
+
+        /** Creates a batch with all lanes set to the same value. */
+        batch(T value) noexcept
+        {
+            for(std::size_t i = 0; i < size; ++i)
+                data[i] = value;
+        }
+
+        explicit batch(const register_type& reg) noexcept
+            : data(reg)
+        {
+        }
+
+        void store_aligned(T* mem) const noexcept
+        {
+            std::memcpy(__builtin_assume_aligned(mem, RTNEURAL_VECTOR_EXT_BYTES), &data, sizeof(data));
+        }
+
+        void store_unaligned(T* mem) const noexcept
+        {
+            std::memcpy(mem, &data, sizeof(data));
+        }
+
+        T get(std::size_t idx) const noexcept { return data[idx]; }
+
+        batch& operator+=(const batch& other) noexcept { data += other.data; return *this; }
+        batch& operator-=(const batch& other) noexcept { data -= other.data; return *this; }
+        batch& operator*=(const batch& other) noexcept { data *= other.data; return *this; }
+        batch& operator/=(const batch& other) noexcept { data /= other.data; return *this; }
+
+        // These operators are "hidden friends", so that scalar arguments
+        // are implicitly converted to batches, like in xsimd.
+        friend batch operator+(const batch& a, const batch& b) noexcept { return batch(a.data + b.data); }
+        friend batch operator-(const batch& a, const batch& b) noexcept { return batch(a.data - b.data); }
+        friend batch operator*(const batch& a, const batch& b) noexcept { return batch(a.data * b.data); }
+        friend batch operator/(const batch& a, const batch& b) noexcept { return batch(a.data / b.data); }
+        friend batch operator-(const batch& a) noexcept { return batch(-a.data); }
+
+        friend batch_bool<T> operator<(const batch& a, const batch& b) noexcept { return { a.data < b.data }; }
+        friend batch_bool<T> operator<=(const batch& a, const batch& b) noexcept { return { a.data <= b.data }; }
+        friend batch_bool<T> operator>(const batch& a, const batch& b) noexcept { return { a.data > b.data }; }
+        friend batch_bool<T> operator>=(const batch& a, const batch& b) noexcept { return { a.data >= b.data }; }
+        friend batch_bool<T> operator==(const batch& a, const batch& b) noexcept { return { a.data == b.data }; }
+        friend batch_bool<T> operator!=(const batch& a, const batch& b) noexcept { return { a.data != b.data }; }
+
+        register_type data;
+    };
+
+    template <typename T>
+    constexpr std::size_t batch<T>::size;
+
+    /** The batch type for a given value type. */
+    template <typename T>
+    using simd_type = batch<T>;
+
+    // The loops that load batches always check that a whole batch fits in the
+    // range, but when a range is stored in a small array (like the input of a
+    // layer with in_size == 1), GCC can't tell that, and warns about the batch
+    // loads on the paths that it can't rule out (even if the loop is guarded
+    // by an extra `size >= batch::size` check). The loads are never out of
+    // bounds, so the warning is disabled for the load functions only.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+
+    template <typename T>
+    static inline batch<T> load_aligned(const T* mem) noexcept
+    {
+        batch<T> result;
+        std::memcpy(&result.data, __builtin_assume_aligned(mem, RTNEURAL_VECTOR_EXT_BYTES), sizeof(result.data));
+        return result;
+    }
+
+    template <typename T>
+    static inline batch<T> load_unaligned(const T* mem) noexcept
+    {
+        batch<T> result;
+        std::memcpy(&result.data, mem, sizeof(result.data));
+        return result;
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    template <typename T>
+    static inline void store_aligned(T* mem, const batch<T>& x) noexcept
+    {
+        x.store_aligned(mem);
+    }
+
+    template <typename T>
+    static inline void store_unaligned(T* mem, const batch<T>& x) noexcept
+    {
+        x.store_unaligned(mem);
+    }
+
+    /** Returns the lanes of `a` where the mask is true, and the lanes of `b` elsewhere. */
+    template <typename T>
+    static inline batch<T> select(const batch_bool<T>& mask, const batch<T>& a, const batch<T>& b) noexcept
+    {
+        using int_register = typename batch_bool<T>::register_type;
+        using float_register = typename batch<T>::register_type;
+        const auto bits = ((int_register)a.data & mask.data) | ((int_register)b.data & ~mask.data);
+        return batch<T>((float_register)bits);
+    }
+
+    /** Returns a * b + c */
+    template <typename T>
+    static inline batch<T> fma(const batch<T>& a, const batch<T>& b, const batch<T>& c) noexcept
+    {
+        return batch<T>(a.data * b.data + c.data);
+    }
+
+    /** Returns c - a * b */
+    template <typename T>
+    static inline batch<T> fnma(const batch<T>& a, const batch<T>& b, const batch<T>& c) noexcept
+    {
+        return batch<T>(c.data - a.data * b.data);
+    }
+
+    template <typename T>
+    static inline batch<T> max(const batch<T>& a, const batch<T>& b) noexcept
+    {
+        return select(a > b, a, b);
+    }
+
+    template <typename T>
+    static inline batch<T> min(const batch<T>& a, const batch<T>& b) noexcept
+    {
+        return select(a < b, a, b);
+    }
+
+    // scalar versions, for the remainder of xsimd::transform()
+    template <typename T>
+    static inline T max(const T& a, const T& b) noexcept
+    {
+        return a > b ? a : b;
+    }
+
+    template <typename T>
+    static inline T min(const T& a, const T& b) noexcept
+    {
+        return a < b ? a : b;
+    }
+
+    template <typename T>
+    static inline batch<T> clip(const batch<T>& x, const batch<T>& lo, const batch<T>& hi) noexcept
+    {
+        return min(max(x, lo), hi);
+    }
+
+    template <typename T>
+    static inline batch<T> abs(const batch<T>& x) noexcept
+    {
+        using int_type = detail::as_int_t<T>;
+        using int_register = typename batch_bool<T>::register_type;
+        using float_register = typename batch<T>::register_type;
+        const auto sign_mask = batch<int_type>(std::numeric_limits<int_type>::max()).data;
+        return batch<T>((float_register)((int_register)x.data & sign_mask));
+    }
+
+    /** Converts each lane to an integer of the same size, rounding towards zero. */
+    template <typename T>
+    static inline batch<detail::as_int_t<T>> to_int(const batch<T>& x) noexcept
+    {
+        using int_register = typename batch<detail::as_int_t<T>>::register_type;
+        return batch<detail::as_int_t<T>>(__builtin_convertvector(x.data, int_register));
+    }
+
+    /** Converts each lane to a floating-point value of the same size. */
+    template <typename I>
+    static inline batch<typename detail::float_of_int<I>::type> to_float(const batch<I>& x) noexcept
+    {
+        using float_batch = batch<typename detail::float_of_int<I>::type>;
+        return float_batch(__builtin_convertvector(x.data, typename float_batch::register_type));
+    }
+
+    template <typename T>
+    static inline batch<T> floor(const batch<T>& x) noexcept
+    {
+        // values larger than 2^mantissa_bits are already integers (or inf/NaN)
+        const auto truncated = to_float(to_int(x));
+        const auto floored = select(truncated > x, truncated - (T)1, truncated);
+        return select(abs(x) < batch<T>(maths_detail::mantissa_scale<T>()), floored, x);
+    }
+
+    /**
+     * Returns x * 2^k, by constructing 2^k from its exponent bits. Unlike
+     * std::ldexp, 2^k must be a normal floating-point value.
+     */
+    template <typename T>
+    static inline batch<T> ldexp(const batch<T>& x, const batch<detail::as_int_t<T>>& k) noexcept
+    {
+        using int_type = detail::as_int_t<T>;
+        using traits = maths_detail::FloatTraits<T>;
+        using float_register = typename batch<T>::register_type;
+
+        const auto bias = batch<int_type>((int_type)traits::exponent_bias).data;
+        const auto shift = batch<int_type>((int_type)traits::mantissa_bits).data;
+        const auto bits = (k.data + bias) << shift;
+        return batch<T>(x.data * (float_register)bits);
+    }
+
+    /**
+     * exp(x), computed as 2^k * exp(r), with a Taylor series for exp(r).
+     * The input is clamped so that the result is always finite and normal.
+     */
+    template <typename T>
+    static inline batch<T> exp(const batch<T>& x) noexcept
+    {
+        constexpr auto limit = maths_detail::FloatTraits<T>::exp_limit;
+        const auto xc = clip(x, batch<T>(-limit), batch<T>(limit));
+        const auto k = floor(fma(xc, batch<T>((T)maths_detail::log2e), batch<T>((T)0.5)));
+        const auto r = fnma(k, batch<T>((T)maths_detail::ln2_lo), fnma(k, batch<T>((T)maths_detail::ln2_hi), xc));
+
+        constexpr auto degree = maths_detail::FloatTraits<T>::exp_poly_degree;
+        batch<T> poly(maths_detail::inv_factorial<T>(degree));
+        for(int n = degree - 1; n >= 0; --n)
+            poly = fma(poly, r, batch<T>(maths_detail::inv_factorial<T>(n)));
+
+        return ldexp(poly, to_int(k));
+    }
+
+    /** tanh(x) = sign(x) * (1 - 2 / (exp(2|x|) + 1)) */
+    template <typename T>
+    static inline batch<T> tanh(const batch<T>& x) noexcept
+    {
+        const auto abs_tanh = (T)1 - (T)2 / (exp((T)2 * abs(x)) + (T)1);
+        return select(x < (T)0, -abs_tanh, abs_tanh);
+    }
+
+    /** Returns the sum of the lanes of a batch. */
+    template <typename T>
+    static inline T reduce_add(const batch<T>& x) noexcept
+    {
+        auto sum = x.data[0];
+        for(std::size_t i = 1; i < batch<T>::size; ++i)
+            sum += x.data[i];
+        return sum;
+    }
+
+    /**
+     * Applies a binary function to two ranges, one batch at a time, and
+     * one value at a time for any remaining values (like xsimd::transform).
+     */
+    template <typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryFunc>
+    static inline void transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt out, BinaryFunc&& func) noexcept
+    {
+        using T = typename std::decay<decltype(*first1)>::type;
+        constexpr auto b_size = batch<T>::size;
+
+        const auto size = (std::size_t)(last1 - first1);
+        std::size_t i = 0;
+        for(; i + b_size <= size; i += b_size)
+            store_unaligned(&out[i], batch<T>(func(load_unaligned(&first1[i]), load_unaligned(&first2[i]))));
+
+        for(; i < size; ++i)
+            out[i] = func(first1[i], first2[i]);
+    }
+
+    /** Returns the sum of the values in a range, plus an initial value (like xsimd::reduce). */
+    template <typename InputIt, typename T>
+    static inline T reduce(InputIt first, InputIt last, T init) noexcept
+    {
+        constexpr auto b_size = batch<T>::size;
+
+        const auto size = (std::size_t)(last - first);
+        batch<T> sum((T)0);
+        std::size_t i = 0;
+        for(; i + b_size <= size; i += b_size)
+            sum += load_unaligned(&first[i]);
+
+        init += reduce_add(sum);
+        for(; i < size; ++i)
+            init += first[i];
+
+        return init;
+    }
+
+    /** An allocator that returns memory aligned to `Align` bytes. */
+    template <typename T, std::size_t Align = RTNEURAL_VECTOR_EXT_BYTES>
+    class aligned_allocator
+    {
+    public:
+        static_assert(Align > 0 && (Align & (Align - 1)) == 0, "Alignment must be a power of two!");
+
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Align>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <typename U>
+        aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            // over-allocate, and store the original pointer just before the aligned block
+            auto* raw = std::malloc(n * sizeof(T) + Align + sizeof(void*));
+            if(raw == nullptr)
+                throw std::bad_alloc();
+
+            const auto aligned = ((std::uintptr_t)raw + sizeof(void*) + Align - 1) & ~(std::uintptr_t)(Align - 1);
+            reinterpret_cast<void**>(aligned)[-1] = raw;
+            return reinterpret_cast<T*>(aligned);
+        }
+
+        void deallocate(T* ptr, std::size_t) noexcept
+        {
+            if(ptr != nullptr)
+                std::free(reinterpret_cast<void**>(ptr)[-1]);
+        }
+
+        template <typename U>
+        bool operator==(const aligned_allocator<U, Align>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const aligned_allocator<U, Align>&) const noexcept { return false; }
+    };
+} // namespace vector_ext
+
+/** With the vector extension backend, the XSIMD layers use the vector_ext library in place of xsimd. */
+namespace xsimd = vector_ext;
+} // namespace RTNeural
@@ -0,0 +1,292 @@
+#ifndef WAVENET_H_INCLUDED
+#define WAVENET_H_INCLUDED
+
+#if RTNEURAL_USE_EIGEN
+#include "wavenet_eigen.h"
+#include "wavenet_eigen.tpp"
+#elif RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
+#include "wavenet_xsimd.h"
+#include "wavenet_xsimd.tpp"
+#else
+#include "../Layer.h"
+#include "../common.h"
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * with `channels` residual channels followed by `skip_channels`
+ * skip channels:
+ * ```
+ * z = tanh(W_f * x + b_f) * sigmoid(W_g * x + b_g)
+ * out = in + W_p * z + b_p
+ * ```
+ * where `x` is the residual part of the input, and the convolution
+ * uses `kernel_size` taps spaced `dilation` samples apart. This way
+ * a full WaveNet can be expressed as a sequence of blocks, with the
+ * skip connections accumulating in the trailing channels.
+ *
+ * Similar to "Fast WaveNet", the layer state only stores the past
+ * residual inputs needed by the dilated taps. To ensure that the
+ * state is initialized to zero, please make sure to call `reset()`
+ * before your first call to the `forward()` method.
+ */
+template <typename T>
+class WaveNetBlock final : public Layer<T>
+{
+public:
+    /**
+     * Constructs a WaveNet block for the given dimensions.
+     *
+     * @param channels: the number of residual channels
+     * @param skip_channels: the number of skip channels
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    WaveNetBlock(int channels, int skip_channels, int kernel_size, int dilation);
+    WaveNetBlock(std::initializer_list<int> sizes);
+    WaveNetBlock(const WaveNetBlock& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    WaveNetBlock& operator=(const WaveNetBlock& other);
+    virtual ~WaveNetBlock() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "wavenet-block"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        // dilated convolution (current sample + past samples from the queue)
+        for(int i = 0; i < 2 * channels; ++i)
+            gate[i] = std::inner_product(input, input + channels, convWeights[0][i].data(), convBias[i]);
+
+        for(int j = 1; j < kernel_size; ++j)
+        {
+            const auto* x = &queue[(queue_ptr + queue_size - j * dilation_rate) * channels];
+            for(int i = 0; i < 2 * channels; ++i)
+                gate[i] += std::inner_product(x, x + channels, convWeights[j][i].data(), (T)0);
+        }
+
+        pushQueue(input);
+
+        // gated activation
+        for(int i = 0; i < channels; ++i)
+            z[i] = std::tanh(gate[i]) / ((T)1 + std::exp(-gate[channels + i]));
+
+        // residual/skip projection
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            h[i] = input[i] + std::inner_product(z.begin(), z.end(), projWeights[i].data(), projBias[i]);
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size],
+     * where the first `channels` outputs feed the tanh half of the gate,
+     * and the last `channels` outputs feed the sigmoid half. Kernel index 0
+     * corresponds to the most recent input sample.
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return Layer<T>::out_size - channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+private:
+    /** Inserts the residual input into the double-buffered queue. */
+    inline void pushQueue(const T* input) noexcept
+    {
+        if(queue_size == 0)
+            return;
+
+        std::copy(input, input + channels, &queue[queue_ptr * channels]);
+        std::copy(input, input + channels, &queue[(queue_ptr + queue_size) * channels]);
+        queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+    }
+
+    const int channels;
+    const int kernel_size;
+    const int dilation_rate;
+    const int queue_size;
+
+    std::vector<std::vector<std::vector<T>>> convWeights;
+    std::vector<T> convBias;
+    std::vector<std::vector<T>> projWeights;
+    std::vector<T> projBias;
+
+    std::vector<T> queue;
+    int queue_ptr = 0;
+
+    std::vector<T> gate;
+    std::vector<T> z;
+};
+
+//====================================================
+/**
+ * Static implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * see `WaveNetBlock` for more information.
+ *
+ * To ensure that the state is initialized to zero, please make
+ * sure to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param channels: the number of residual channels
+ * @param skip_channels: the number of skip channels
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ */
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+class WaveNetBlockT
+{
+    static constexpr auto queue_size = (kernel_size - 1) * dilation_rate;
+    static constexpr auto queue_alloc_size = queue_size > 0 ? 2 * queue_size : 1;
+
+public:
+    static constexpr auto in_size = channels + skip_channels;
+    static constexpr auto out_size = channels + skip_channels;
+
+    WaveNetBlockT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "wavenet-block"; }
+
+    /** Returns false since the WaveNet block is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T (&ins)[in_size]) noexcept
+    {
+        // dilated convolution (current sample + past samples from the queue)
+        for(int i = 0; i < 2 * channels; ++i)
+            gate[i] = std::inner_product(ins, ins + channels, conv_weights[0][i], conv_bias[i]);
+
+        for(int j = 1; j < kernel_size; ++j)
+        {
+            const auto* x = queue[queue_ptr + queue_size - j * dilation_rate];
+            for(int i = 0; i < 2 * channels; ++i)
+                gate[i] += std::inner_product(x, x + channels, conv_weights[j][i], (T)0);
+        }
+
+        if(queue_size > 0)
+        {
+            std::copy(ins, ins + channels, queue[queue_ptr]);
+            std::copy(ins, ins + channels, queue[queue_ptr + queue_size]);
+            queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+        }
+
+        // gated activation
+        for(int i = 0; i < channels; ++i)
+            z[i] = std::tanh(gate[i]) / ((T)1 + std::exp(-gate[channels + i]));
+
+        // residual/skip projection
+        for(int i = 0; i < out_size; ++i)
+            outs[i] = ins[i] + std::inner_product(z, z + channels, proj_weights[i], proj_bias[i]);
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size]
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return skip_channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    T outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+private:
+    T queue alignas(RTNEURAL_DEFAULT_ALIGNMENT)[queue_alloc_size][channels];
+    int queue_ptr = 0;
+
+    T conv_weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[kernel_size][2 * channels][channels];
+    T conv_bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[2 * channels];
+    T proj_weights alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size][channels];
+    T proj_bias alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    T gate alignas(RTNEURAL_DEFAULT_ALIGNMENT)[2 * channels];
+    T z alignas(RTNEURAL_DEFAULT_ALIGNMENT)[channels];
+};
+
+} // namespace RTNeural
+
+#endif
+
+#endif // WAVENET_H_INCLUDED
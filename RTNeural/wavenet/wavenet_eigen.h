@@ -0,0 +1,281 @@
+#ifndef WAVENETEIGEN_H_INCLUDED
+#define WAVENETEIGEN_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * with `channels` residual channels followed by `skip_channels`
+ * skip channels:
+ * ```
+ * z = tanh(W_f * x + b_f) * sigmoid(W_g * x + b_g)
+ * out = in + W_p * z + b_p
+ * ```
+ * where `x` is the residual part of the input, and the convolution
+ * uses `kernel_size` taps spaced `dilation` samples apart. This way
+ * a full WaveNet can be expressed as a sequence of blocks, with the
+ * skip connections accumulating in the trailing channels.
+ *
+ * Similar to "Fast WaveNet", the layer state only stores the past
+ * residual inputs needed by the dilated taps. To ensure that the
+ * state is initialized to zero, please make sure to call `reset()`
+ * before your first call to the `forward()` method.
+ */
+template <typename T>
+class WaveNetBlock : public Layer<T>
+{
+public:
+    /**
+     * Constructs a WaveNet block for the given dimensions.
+     *
+     * @param channels: the number of residual channels
+     * @param skip_channels: the number of skip channels
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    WaveNetBlock(int channels, int skip_channels, int kernel_size, int dilation);
+    WaveNetBlock(std::initializer_list<int> sizes);
+    WaveNetBlock(const WaveNetBlock& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    WaveNetBlock& operator=(const WaveNetBlock& other);
+    virtual ~WaveNetBlock() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "wavenet-block"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        inVec = Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, RTNeuralEigenAlignment>(
+            input, Layer<T>::in_size, 1);
+
+        // dilated convolution (current sample + past samples from the queue)
+        gateVec.noalias() = convWeights[0] * inVec.head(channels);
+        for(int j = 1; j < kernel_size; ++j)
+            gateVec.noalias() += convWeights[j] * queue.col(queue_ptr + queue_size - j * dilation_rate);
+        gateVec += convBias;
+
+        if(queue_size > 0)
+        {
+            queue.col(queue_ptr) = inVec.head(channels);
+            queue.col(queue_ptr + queue_size) = inVec.head(channels);
+            queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+        }
+
+        // gated activation
+        zVec = gateVec.head(channels).array().tanh()
+            / (((T)-1 * gateVec.tail(channels).array()).exp() + (T)1);
+
+        // residual/skip projection
+        outVec.noalias() = projWeights * zVec;
+        outVec += projBias + inVec;
+        std::copy(outVec.data(), outVec.data() + Layer<T>::out_size, h);
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size],
+     * where the first `channels` outputs feed the tanh half of the gate,
+     * and the last `channels` outputs feed the sigmoid half. Kernel index 0
+     * corresponds to the most recent input sample.
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return Layer<T>::out_size - channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+private:
+    const int channels;
+    const int kernel_size;
+    const int dilation_rate;
+    const int queue_size;
+
+    std::vector<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>> convWeights;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> convBias;
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> projWeights;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> projBias;
+
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> queue;
+    int queue_ptr = 0;
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1> inVec;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> gateVec;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> zVec;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> outVec;
+};
+
+//====================================================
+/**
+ * Static implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * see `WaveNetBlock` for more information.
+ *
+ * To ensure that the state is initialized to zero, please make
+ * sure to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param channels: the number of residual channels
+ * @param skip_channels: the number of skip channels
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ */
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+class WaveNetBlockT
+{
+    static constexpr auto queue_size = (kernel_size - 1) * dilation_rate;
+    static constexpr auto queue_alloc_size = queue_size > 0 ? 2 * queue_size : 1;
+
+    using in_vec_type = Eigen::Matrix<T, channels + skip_channels, 1>;
+    using gate_vec_type = Eigen::Matrix<T, 2 * channels, 1>;
+    using z_vec_type = Eigen::Matrix<T, channels, 1>;
+    using queue_type = Eigen::Matrix<T, channels, queue_alloc_size>;
+
+    using conv_weights_type = Eigen::Matrix<T, 2 * channels, channels>;
+    using proj_weights_type = Eigen::Matrix<T, channels + skip_channels, channels>;
+
+public:
+    static constexpr auto in_size = channels + skip_channels;
+    static constexpr auto out_size = channels + skip_channels;
+
+    WaveNetBlockT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "wavenet-block"; }
+
+    /** Returns false since the WaveNet block is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const in_vec_type& ins) noexcept
+    {
+        // dilated convolution (current sample + past samples from the queue)
+        gate.noalias() = conv_weights[0] * ins.template head<channels>();
+        for(int j = 1; j < kernel_size; ++j)
+            gate.noalias() += conv_weights[j] * queue.col(queue_ptr + queue_size - j * dilation_rate);
+        gate += conv_bias;
+
+        if(queue_size > 0)
+        {
+            queue.col(queue_ptr) = ins.template head<channels>();
+            queue.col(queue_ptr + queue_size) = ins.template head<channels>();
+            queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+        }
+
+        // gated activation
+        z = gate.template head<channels>().array().tanh()
+            / (((T)-1 * gate.template tail<channels>().array()).exp() + (T)1);
+
+        // residual/skip projection
+        outs.noalias() = proj_weights * z;
+        outs += proj_bias + ins;
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size]
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return skip_channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    Eigen::Map<in_vec_type, RTNeuralEigenAlignment> outs;
+
+private:
+    T outs_internal alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+
+    queue_type queue;
+    int queue_ptr = 0;
+
+    conv_weights_type conv_weights[kernel_size];
+    gate_vec_type conv_bias;
+    proj_weights_type proj_weights;
+    in_vec_type proj_bias;
+
+    gate_vec_type gate;
+    z_vec_type z;
+};
+
+} // namespace RTNeural
+
+#endif // WAVENETEIGEN_H_INCLUDED
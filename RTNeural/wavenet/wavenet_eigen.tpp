@@ -0,0 +1,155 @@
+#include "wavenet_eigen.h"
+
+namespace RTNeural
+{
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(int channels, int skip_channels, int kernel_size, int dilation)
+    : Layer<T>(channels + skip_channels, channels + skip_channels)
+    , channels(channels)
+    , kernel_size(kernel_size)
+    , dilation_rate(dilation)
+    , queue_size((kernel_size - 1) * dilation)
+{
+    convWeights.resize(kernel_size);
+    for(int j = 0; j < kernel_size; ++j)
+        convWeights[j] = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(2 * channels, channels);
+
+    convBias = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(2 * channels, 1);
+    projWeights = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(Layer<T>::out_size, channels);
+    projBias = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(Layer<T>::out_size, 1);
+
+    queue = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>::Zero(channels, 2 * queue_size);
+
+    inVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(Layer<T>::in_size, 1);
+    gateVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(2 * channels, 1);
+    zVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(channels, 1);
+    outVec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(Layer<T>::out_size, 1);
+}
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(std::initializer_list<int> sizes)
+    : WaveNetBlock<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+{
+}
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(const WaveNetBlock<T>& other)
+    : WaveNetBlock<T>(other.channels, other.getSkipChannels(), other.kernel_size, other.dilation_rate)
+{
+    *this = other;
+}
+
+template <typename T>
+WaveNetBlock<T>& WaveNetBlock<T>::operator=(const WaveNetBlock<T>& other)
+{
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && Layer<T>::out_size == other.out_size && channels == other.channels
+        && kernel_size == other.kernel_size && dilation_rate == other.dilation_rate);
+
+    convWeights = other.convWeights;
+    convBias = other.convBias;
+    projWeights = other.projWeights;
+    projBias = other.projBias;
+    queue = other.queue;
+    queue_ptr = other.queue_ptr;
+
+    return *this;
+}
+
+template <typename T>
+void WaveNetBlock<T>::reset()
+{
+    queue_ptr = 0;
+    queue.setZero();
+}
+
+template <typename T>
+void WaveNetBlock<T>::setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        for(int k = 0; k < channels; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                convWeights[j](i, k) = weights[i][k][j];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setConvBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        convBias(i) = biasVals[i];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setProjectionWeights(const std::vector<std::vector<T>>& weights)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < channels; ++k)
+            projWeights(i, k) = weights[i][k];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setProjectionBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        projBias(i) = biasVals[i];
+}
+
+//====================================================
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::WaveNetBlockT()
+    : outs(outs_internal)
+{
+    for(int j = 0; j < kernel_size; ++j)
+        conv_weights[j] = conv_weights_type::Zero();
+
+    conv_bias = gate_vec_type::Zero();
+    proj_weights = proj_weights_type::Zero();
+    proj_bias = in_vec_type::Zero();
+    outs = in_vec_type::Zero();
+
+    reset();
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::reset()
+{
+    queue_ptr = 0;
+    queue = queue_type::Zero();
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        for(int k = 0; k < channels; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                conv_weights[j](i, k) = weights[i][k][j];
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setConvBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        conv_bias(i) = biasVals[i];
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setProjectionWeights(const std::vector<std::vector<T>>& weights)
+{
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < channels; ++k)
+            proj_weights(i, k) = weights[i][k];
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setProjectionBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < out_size; ++i)
+        proj_bias(i) = biasVals[i];
+}
+
+} // namespace RTNeural
@@ -0,0 +1,329 @@
+#ifndef WAVENETXSIMD_H_INCLUDED
+#define WAVENETXSIMD_H_INCLUDED
+
+#include "../Layer.h"
+#include "../common.h"
+#include <vector>
+
+namespace RTNeural
+{
+
+/**
+ * Dynamic implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * with `channels` residual channels followed by `skip_channels`
+ * skip channels:
+ * ```
+ * z = tanh(W_f * x + b_f) * sigmoid(W_g * x + b_g)
+ * out = in + W_p * z + b_p
+ * ```
+ * where `x` is the residual part of the input, and the convolution
+ * uses `kernel_size` taps spaced `dilation` samples apart. This way
+ * a full WaveNet can be expressed as a sequence of blocks, with the
+ * skip connections accumulating in the trailing channels.
+ *
+ * Similar to "Fast WaveNet", the layer state only stores the past
+ * residual inputs needed by the dilated taps. To ensure that the
+ * state is initialized to zero, please make sure to call `reset()`
+ * before your first call to the `forward()` method.
+ */
+template <typename T>
+class WaveNetBlock : public Layer<T>
+{
+public:
+    /**
+     * Constructs a WaveNet block for the given dimensions.
+     *
+     * @param channels: the number of residual channels
+     * @param skip_channels: the number of skip channels
+     * @param kernel_size: the size of the convolution kernel
+     * @param dilation: the dilation rate to use for dilated convolution
+     */
+    WaveNetBlock(int channels, int skip_channels, int kernel_size, int dilation);
+    WaveNetBlock(std::initializer_list<int> sizes);
+    WaveNetBlock(const WaveNetBlock& other);
+
+    /** Copies the weights and state of a layer with the same dimensions. */
+    WaveNetBlock& operator=(const WaveNetBlock& other);
+    virtual ~WaveNetBlock() = default;
+
+    /** Resets the layer state. */
+    void reset() override;
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept override { return "wavenet-block"; }
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const T* input, T* h) noexcept override
+    {
+        // dilated convolution (current sample + past samples from the queue)
+        for(int i = 0; i < channels; ++i)
+        {
+            filt[i] = vMult(input, convWeights[0][i].data(), prod.data(), channels);
+            gate[i] = vMult(input, convWeights[0][channels + i].data(), prod.data(), channels);
+        }
+
+        for(int j = 1; j < kernel_size; ++j)
+        {
+            const auto* x = &queue[(queue_ptr + queue_size - j * dilation_rate) * channels];
+            for(int i = 0; i < channels; ++i)
+            {
+                filt[i] += vMult(x, convWeights[j][i].data(), prod.data(), channels);
+                gate[i] += vMult(x, convWeights[j][channels + i].data(), prod.data(), channels);
+            }
+        }
+
+        vAdd(filt.data(), convBias.data(), filt.data(), channels);
+        vAdd(gate.data(), &convBias[channels], gate.data(), channels);
+
+        pushQueue(input);
+
+        // gated activation
+        tanh(filt.data(), filt.data(), channels);
+        sigmoid(gate.data(), gate.data(), channels);
+        vProd(filt.data(), gate.data(), z.data(), channels);
+
+        // residual/skip projection
+        for(int i = 0; i < Layer<T>::out_size; ++i)
+            h[i] = vMult(z.data(), projWeights[i].data(), prod.data(), channels);
+
+        vAdd(h, projBias.data(), h, Layer<T>::out_size);
+        vAdd(h, input, h, Layer<T>::out_size);
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size],
+     * where the first `channels` outputs feed the tanh half of the gate,
+     * and the last `channels` outputs feed the sigmoid half. Kernel index 0
+     * corresponds to the most recent input sample.
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return Layer<T>::out_size - channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+private:
+    /** Inserts the residual input into the double-buffered queue. */
+    inline void pushQueue(const T* input) noexcept
+    {
+        if(queue_size == 0)
+            return;
+
+        std::copy(input, input + channels, &queue[queue_ptr * channels]);
+        std::copy(input, input + channels, &queue[(queue_ptr + queue_size) * channels]);
+        queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+    }
+
+    using vec_type = std::vector<T, xsimd::aligned_allocator<T, RTNEURAL_DEFAULT_ALIGNMENT>>;
+    using vec2_type = std::vector<vec_type>;
+    using vec3_type = std::vector<vec2_type>;
+
+    const int channels;
+    const int kernel_size;
+    const int dilation_rate;
+    const int queue_size;
+
+    vec3_type convWeights;
+    vec_type convBias;
+    vec2_type projWeights;
+    vec_type projBias;
+
+    vec_type queue;
+    int queue_ptr = 0;
+
+    vec_type filt;
+    vec_type gate;
+    vec_type z;
+    vec_type prod;
+};
+
+//====================================================
+/**
+ * Static implementation of a fused WaveNet residual block.
+ *
+ * The block combines a dilated causal convolution, a gated
+ * (tanh * sigmoid) activation, and a 1x1 residual/skip projection.
+ * The layer input and output are laid out as `[residual | skip]`,
+ * see `WaveNetBlock` for more information.
+ *
+ * To ensure that the state is initialized to zero, please make
+ * sure to call `reset()` before your first call to the `forward()` method.
+ *
+ * @param channels: the number of residual channels
+ * @param skip_channels: the number of skip channels
+ * @param kernel_size: the size of the convolution kernel
+ * @param dilation_rate: the dilation rate to use for dilated convolution
+ */
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+class WaveNetBlockT
+{
+    using v_type = xsimd::simd_type<T>;
+    static constexpr auto v_size = (int)v_type::size;
+    static constexpr auto v_io_size = ceil_div(channels + skip_channels, v_size);
+    static constexpr auto v_ch_size = ceil_div(channels, v_size);
+
+    static constexpr auto queue_size = (kernel_size - 1) * dilation_rate;
+    static constexpr auto queue_alloc_size = queue_size > 0 ? 2 * queue_size : 1;
+
+public:
+    static constexpr auto in_size = channels + skip_channels;
+    static constexpr auto out_size = channels + skip_channels;
+
+    WaveNetBlockT();
+
+    /** Returns the name of this layer. */
+    std::string getName() const noexcept { return "wavenet-block"; }
+
+    /** Returns false since the WaveNet block is not an activation layer. */
+    constexpr bool isActivation() const noexcept { return false; }
+
+    /** Resets the layer state. */
+    void reset();
+
+    /** Performs forward propagation for this layer. */
+    inline void forward(const v_type (&ins)[v_io_size]) noexcept
+    {
+        for(int k = 0; k < v_io_size; ++k)
+            ins[k].store_aligned(&ins_scalar[k * v_size]);
+
+        // dilated convolution (current sample + past samples from the queue)
+        for(int i = 0; i < v_ch_size; ++i)
+        {
+            filt[i] = filt_bias[i];
+            gate[i] = gate_bias[i];
+        }
+
+        for(int j = 0; j < kernel_size; ++j)
+        {
+            const T* x = j == 0 ? &ins_scalar[0] : &queue[queue_ptr + queue_size - j * dilation_rate][0];
+            for(int k = 0; k < channels; ++k)
+            {
+                for(int i = 0; i < v_ch_size; ++i)
+                {
+                    filt[i] += x[k] * filt_weights[j][k][i];
+                    gate[i] += x[k] * gate_weights[j][k][i];
+                }
+            }
+        }
+
+        if(queue_size > 0)
+        {
+            std::copy(ins_scalar, ins_scalar + channels, queue[queue_ptr]);
+            std::copy(ins_scalar, ins_scalar + channels, queue[queue_ptr + queue_size]);
+            queue_ptr = (queue_ptr == queue_size - 1 ? 0 : queue_ptr + 1);
+        }
+
+        // gated activation
+        for(int i = 0; i < v_ch_size; ++i)
+        {
+            auto z = xsimd::tanh(filt[i]) * maths_detail::sigmoid_vec(gate[i]);
+            z.store_aligned(&z_scalar[i * v_size]);
+        }
+
+        // residual/skip projection
+        for(int i = 0; i < v_io_size; ++i)
+            outs[i] = ins[i] + proj_bias[i];
+
+        for(int k = 0; k < channels; ++k)
+            for(int i = 0; i < v_io_size; ++i)
+                outs[i] += z_scalar[k] * proj_weights[k][i];
+    }
+
+    /**
+     * Sets the convolution weights.
+     *
+     * The weights vector must have size weights[2 * channels][channels][kernel_size]
+     */
+    void setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights);
+
+    /**
+     * Sets the convolution biases.
+     *
+     * The bias vector must have size bias[2 * channels]
+     */
+    void setConvBias(const std::vector<T>& biasVals);
+
+    /**
+     * Sets the residual/skip projection weights.
+     *
+     * The weights vector must have size weights[channels + skip_channels][channels]
+     */
+    void setProjectionWeights(const std::vector<std::vector<T>>& weights);
+
+    /**
+     * Sets the residual/skip projection biases.
+     *
+     * The bias vector must have size bias[channels + skip_channels]
+     */
+    void setProjectionBias(const std::vector<T>& biasVals);
+
+    /** Returns the number of residual channels. */
+    int getChannels() const noexcept { return channels; }
+
+    /** Returns the number of skip channels. */
+    int getSkipChannels() const noexcept { return skip_channels; }
+
+    /** Returns the size of the convolution kernel. */
+    int getKernelSize() const noexcept { return kernel_size; }
+
+    /** Returns the convolution dilation rate. */
+    int getDilationRate() const noexcept { return dilation_rate; }
+
+    v_type outs[v_io_size];
+
+private:
+    T queue[queue_alloc_size][channels];
+    int queue_ptr = 0;
+
+    v_type filt_weights[kernel_size][channels][v_ch_size];
+    v_type gate_weights[kernel_size][channels][v_ch_size];
+    v_type filt_bias[v_ch_size];
+    v_type gate_bias[v_ch_size];
+    v_type proj_weights[channels][v_io_size];
+    v_type proj_bias[v_io_size];
+
+    v_type filt[v_ch_size];
+    v_type gate[v_ch_size];
+
+    T ins_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_io_size * v_size];
+    T z_scalar alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_ch_size * v_size];
+};
+
+} // namespace RTNeural
+
+#endif // WAVENETXSIMD_H_INCLUDED
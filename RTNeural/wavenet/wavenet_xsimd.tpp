@@ -0,0 +1,192 @@
+#include "wavenet_xsimd.h"
+
+namespace RTNeural
+{
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(int channels, int skip_channels, int kernel_size, int dilation)
+    : Layer<T>(channels + skip_channels, channels + skip_channels)
+    , channels(channels)
+    , kernel_size(kernel_size)
+    , dilation_rate(dilation)
+    , queue_size((kernel_size - 1) * dilation)
+{
+    convWeights = vec3_type(kernel_size, vec2_type(2 * channels, vec_type(channels, (T)0)));
+    convBias.resize(2 * channels, (T)0);
+
+    projWeights = vec2_type(Layer<T>::out_size, vec_type(channels, (T)0));
+    projBias.resize(Layer<T>::out_size, (T)0);
+
+    queue.resize(2 * queue_size * channels, (T)0);
+
+    filt.resize(channels, (T)0);
+    gate.resize(channels, (T)0);
+    z.resize(channels, (T)0);
+    prod.resize(channels, (T)0);
+}
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(std::initializer_list<int> sizes)
+    : WaveNetBlock<T>(*sizes.begin(), *(sizes.begin() + 1), *(sizes.begin() + 2), *(sizes.begin() + 3))
+{
+}
+
+template <typename T>
+WaveNetBlock<T>::WaveNetBlock(const WaveNetBlock<T>& other)
+    : WaveNetBlock<T>(other.channels, other.getSkipChannels(), other.kernel_size, other.dilation_rate)
+{
+    *this = other;
+}
+
+template <typename T>
+WaveNetBlock<T>& WaveNetBlock<T>::operator=(const WaveNetBlock<T>& other)
+{
+    if(&other == this)
+        return *this;
+
+    // the layer dimensions are fixed, so layers can only be assigned from layers with the same dimensions
+    assert(Layer<T>::in_size == other.in_size && Layer<T>::out_size == other.out_size && channels == other.channels
+        && kernel_size == other.kernel_size && dilation_rate == other.dilation_rate);
+
+    convWeights = other.convWeights;
+    convBias = other.convBias;
+    projWeights = other.projWeights;
+    projBias = other.projBias;
+    queue = other.queue;
+    queue_ptr = other.queue_ptr;
+
+    return *this;
+}
+
+template <typename T>
+void WaveNetBlock<T>::reset()
+{
+    queue_ptr = 0;
+    std::fill(queue.begin(), queue.end(), (T)0);
+}
+
+template <typename T>
+void WaveNetBlock<T>::setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        for(int k = 0; k < channels; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                convWeights[j][i][k] = weights[i][k][j];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setConvBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < 2 * channels; ++i)
+        convBias[i] = biasVals[i];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setProjectionWeights(const std::vector<std::vector<T>>& weights)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        for(int k = 0; k < channels; ++k)
+            projWeights[i][k] = weights[i][k];
+}
+
+template <typename T>
+void WaveNetBlock<T>::setProjectionBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < Layer<T>::out_size; ++i)
+        projBias[i] = biasVals[i];
+}
+
+//====================================================
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::WaveNetBlockT()
+{
+    for(int j = 0; j < kernel_size; ++j)
+    {
+        for(int k = 0; k < channels; ++k)
+        {
+            for(int i = 0; i < v_ch_size; ++i)
+            {
+                filt_weights[j][k][i] = v_type((T)0.0);
+                gate_weights[j][k][i] = v_type((T)0.0);
+            }
+        }
+    }
+
+    for(int i = 0; i < v_ch_size; ++i)
+    {
+        filt_bias[i] = v_type((T)0.0);
+        gate_bias[i] = v_type((T)0.0);
+    }
+
+    for(int k = 0; k < channels; ++k)
+        for(int i = 0; i < v_io_size; ++i)
+            proj_weights[k][i] = v_type((T)0.0);
+
+    for(int i = 0; i < v_io_size; ++i)
+        proj_bias[i] = v_type((T)0.0);
+
+    for(int i = 0; i < v_io_size; ++i)
+        outs[i] = v_type((T)0.0);
+
+    reset();
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::reset()
+{
+    queue_ptr = 0;
+    for(int i = 0; i < queue_alloc_size; ++i)
+        for(int k = 0; k < channels; ++k)
+            queue[i][k] = (T)0.0;
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setConvWeights(const std::vector<std::vector<std::vector<T>>>& weights)
+{
+    for(int i = 0; i < channels; ++i)
+    {
+        for(int k = 0; k < channels; ++k)
+        {
+            for(int j = 0; j < kernel_size; ++j)
+            {
+                auto& wf = filt_weights[j][k][i / v_size];
+                wf = set_value(wf, i % v_size, weights[i][k][j]);
+
+                auto& wg = gate_weights[j][k][i / v_size];
+                wg = set_value(wg, i % v_size, weights[channels + i][k][j]);
+            }
+        }
+    }
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setConvBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < channels; ++i)
+    {
+        filt_bias[i / v_size] = set_value(filt_bias[i / v_size], i % v_size, biasVals[i]);
+        gate_bias[i / v_size] = set_value(gate_bias[i / v_size], i % v_size, biasVals[channels + i]);
+    }
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setProjectionWeights(const std::vector<std::vector<T>>& weights)
+{
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < channels; ++k)
+        {
+            auto& w = proj_weights[k][i / v_size];
+            w = set_value(w, i % v_size, weights[i][k]);
+        }
+    }
+}
+
+template <typename T, int channels, int skip_channels, int kernel_size, int dilation_rate>
+void WaveNetBlockT<T, channels, skip_channels, kernel_size, dilation_rate>::setProjectionBias(const std::vector<T>& biasVals)
+{
+    for(int i = 0; i < out_size; ++i)
+        proj_bias[i / v_size] = set_value(proj_bias[i / v_size], i % v_size, biasVals[i]);
+}
+
+} // namespace RTNeural
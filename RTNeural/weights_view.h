@@ -0,0 +1,85 @@
+#ifndef WEIGHTS_VIEW_H_INCLUDED
+#define WEIGHTS_VIEW_H_INCLUDED
+
+#include <cstddef>
+
+namespace RTNeural
+{
+
+/**
+ * A read-only view of layer weights that are stored in a flat buffer.
+ *
+ * The layout of the weights is described by the size and the stride
+ * (in elements) of each dimension, so weights can be passed to a layer
+ * in whatever order they are stored, including transposed, or with
+ * a dimension reversed (using a negative stride), without copying them.
+ *
+ * @param T: the weights type
+ * @param num_dims: the number of dimensions of the weights
+ */
+template <typename T, int num_dims>
+struct WeightsView
+{
+    static_assert(num_dims > 0, "Weights must have at least one dimension!");
+
+    const T* data = nullptr;
+    int sizes[num_dims] {};
+    std::ptrdiff_t strides[num_dims] {};
+
+    /** Returns a view of weights stored contiguously in row-major order. */
+    static WeightsView rowMajor(const T* data, const int (&sizes)[num_dims]) noexcept
+    {
+        WeightsView view;
+        view.data = data;
+        std::ptrdiff_t stride = 1;
+        for(int d = num_dims - 1; d >= 0; --d)
+        {
+            view.sizes[d] = sizes[d];
+            view.strides[d] = stride;
+            stride *= sizes[d];
+        }
+
+        return view;
+    }
+
+    /** Returns the size of one of the dimensions. */
+    int size(int dim) const noexcept { return sizes[dim]; }
+
+    /** Returns the weight at the given indices. */
+    template <typename... Indices>
+    const T& operator()(Indices... indices) const noexcept
+    {
+        static_assert(sizeof...(Indices) == num_dims, "Wrong number of indices!");
+
+        const std::ptrdiff_t idx[] = { (std::ptrdiff_t)indices... };
+        std::ptrdiff_t offset = 0;
+        for(int d = 0; d < num_dims; ++d)
+            offset += idx[d] * strides[d];
+
+        return data[offset];
+    }
+
+    /** Returns a view of the same weights with two dimensions swapped. */
+    WeightsView transposed(int dim1 = 0, int dim2 = 1) const noexcept
+    {
+        auto view = *this;
+        view.sizes[dim1] = sizes[dim2];
+        view.sizes[dim2] = sizes[dim1];
+        view.strides[dim1] = strides[dim2];
+        view.strides[dim2] = strides[dim1];
+        return view;
+    }
+
+    /** Returns a view of the same weights, with the order of one dimension reversed. */
+    WeightsView reversed(int dim) const noexcept
+    {
+        auto view = *this;
+        view.data = data + (sizes[dim] - 1) * strides[dim];
+        view.strides[dim] = -strides[dim];
+        return view;
+    }
+};
+
+} // namespace RTNeural
+
+#endif // WEIGHTS_VIEW_H_INCLUDED
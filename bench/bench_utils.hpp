@@ -6,6 +6,9 @@
 #if RTNEURAL_USE_XSIMD
 #include <xsimd/xsimd.hpp>
 using vec_type = std::vector<double, xsimd::aligned_allocator<double>>;
+#elif RTNEURAL_USE_VECTOR_EXT
+#include <RTNeural/vector_ext/vector_ext.h>
+using vec_type = std::vector<double, RTNeural::vector_ext::aligned_allocator<double>>;
 #elif RTNEURAL_USE_EIGEN
 #include <Eigen/Dense>
 using vec_type = std::vector<double, Eigen::aligned_allocator<double>>;
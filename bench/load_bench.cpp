@@ -0,0 +1,129 @@
+#include <RTNeural.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+/** Returns a json kernel with random weights. */
+nlohmann::json random_matrix(size_t rows, size_t cols, std::default_random_engine& generator)
+{
+    std::uniform_real_distribution<double> distribution(-0.1, 0.1);
+
+    auto matrix = nlohmann::json::array();
+    for(size_t i = 0; i < rows; ++i)
+    {
+        auto row = nlohmann::json::array();
+        for(size_t j = 0; j < cols; ++j)
+            row.push_back(distribution(generator));
+        matrix.push_back(std::move(row));
+    }
+
+    return matrix;
+}
+
+nlohmann::json make_layer(const std::string& type, size_t out_size, const std::string& activation, nlohmann::json&& weights)
+{
+    nlohmann::json layer;
+    layer["type"] = type;
+    layer["activation"] = activation;
+    layer["shape"] = { nullptr, nullptr, out_size };
+    layer["weights"] = std::move(weights);
+    return layer;
+}
+
+/** Creates a json model with large recurrent and dense layers. */
+nlohmann::json make_model(size_t size)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = nlohmann::json::array();
+    auto& layers = model["layers"];
+
+    layers.push_back(make_layer("dense", size, "tanh", { random_matrix(1, size, generator), random_matrix(1, size, generator)[0] }));
+    layers.push_back(make_layer("gru", size, "",
+        { random_matrix(size, 3 * size, generator), random_matrix(size, 3 * size, generator), random_matrix(2, 3 * size, generator) }));
+    layers.push_back(make_layer("lstm", size, "",
+        { random_matrix(size, 4 * size, generator), random_matrix(size, 4 * size, generator), random_matrix(1, 4 * size, generator)[0] }));
+    layers.push_back(make_layer("dense", size, "relu", { random_matrix(size, size, generator), random_matrix(1, size, generator)[0] }));
+    layers.push_back(make_layer("dense", 1, "", { random_matrix(size, 1, generator), random_matrix(1, 1, generator)[0] }));
+
+    return model;
+}
+
+template <typename LoadFunc>
+double runBench(const std::string& name, LoadFunc&& loadModel, int num_iterations)
+{
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    auto start = clock_t::now();
+    for(int i = 0; i < num_iterations; ++i)
+    {
+        auto model = loadModel();
+        if(model == nullptr)
+        {
+            std::cout << "Unable to load model with " << name << "!" << std::endl;
+            return 0.0;
+        }
+    }
+    auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count() / (double)num_iterations;
+
+    std::cout << name << ": " << duration * 1000.0 << " ms per model" << std::endl;
+    return duration;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t layer_size = argc > 1 ? (size_t)std::stoi(argv[1]) : 256;
+    constexpr int num_iterations = 10;
+
+    const std::string json_file = "load_bench_model.json";
+    const std::string binary_file = "load_bench_model.rtnb";
+
+    std::cout << "Creating model with " << layer_size << "-dimensional layers..." << std::endl;
+    {
+        const auto modelJson = make_model(layer_size);
+        std::ofstream jsonStream(json_file, std::ofstream::binary);
+        jsonStream << modelJson;
+
+        std::ofstream binaryStream(binary_file, std::ofstream::binary);
+        RTNeural::binary_parser::convertJson(modelJson, binaryStream);
+    }
+
+    std::cout << "Measuring model loading time..." << std::endl;
+    const auto jsonDur = runBench("json (DOM) parser", [&json_file] {
+        std::ifstream jsonStream(json_file, std::ifstream::binary);
+        return RTNeural::json_parser::parseJson<float>(jsonStream);
+    },
+        num_iterations);
+
+    const auto parallelDur = runBench("json (DOM) parser, parallel layer loading", [&json_file] {
+        std::ifstream jsonStream(json_file, std::ifstream::binary);
+        return RTNeural::json_parser::parseJson<float>(jsonStream, false, 0);
+    },
+        num_iterations);
+
+    const auto streamingDur = runBench("json streaming parser", [&json_file] {
+        std::ifstream jsonStream(json_file, std::ifstream::binary);
+        return RTNeural::json_parser::parseJsonStreaming<float>(jsonStream);
+    },
+        num_iterations);
+
+    const auto binaryDur = runBench("binary parser", [&binary_file] {
+        return RTNeural::binary_parser::parseBinary<float>(binary_file);
+    },
+        num_iterations);
+
+    std::cout << "Parallel layer loading is " << jsonDur / parallelDur << "x faster than the json parser" << std::endl;
+    std::cout << "Streaming parser is " << jsonDur / streamingDur << "x faster than the json parser" << std::endl;
+    std::cout << "Binary parser is " << jsonDur / binaryDur << "x faster than the json parser" << std::endl;
+
+    std::remove(json_file.c_str());
+    std::remove(binary_file.c_str());
+
+    return 0;
+}
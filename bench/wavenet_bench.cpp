@@ -0,0 +1,174 @@
+#include "bench_utils.hpp"
+#include "layer_creator.hpp"
+#include <RTNeural.h>
+#include <chrono>
+
+namespace
+{
+constexpr int channels = 16;
+constexpr int skip_channels = 8;
+constexpr int io_size = channels + skip_channels;
+constexpr int kernel_size = 3;
+const std::vector<int> dilations { 1, 2, 4, 8, 16, 32, 64, 128 };
+
+template <typename BlockType>
+void randomise_wavenet(BlockType& block)
+{
+    std::default_random_engine generator;
+    std::uniform_real_distribution<double> distribution(-0.25, 0.25);
+
+    std::vector<std::vector<std::vector<double>>> convWeights(2 * channels,
+        std::vector<std::vector<double>>(channels, std::vector<double>(kernel_size, 0.0)));
+    for(auto& wIn : convWeights)
+        for(auto& w : wIn)
+            for(auto& x : w)
+                x = distribution(generator);
+    block.setConvWeights(convWeights);
+
+    std::vector<double> convBias(2 * channels);
+    for(auto& x : convBias)
+        x = distribution(generator);
+    block.setConvBias(convBias);
+
+    std::vector<std::vector<double>> projWeights(io_size, std::vector<double>(channels, 0.0));
+    for(auto& w : projWeights)
+        for(auto& x : w)
+            x = distribution(generator);
+    block.setProjectionWeights(projWeights);
+
+    std::vector<double> projBias(io_size);
+    for(auto& x : projBias)
+        x = distribution(generator);
+    block.setProjectionBias(projBias);
+}
+
+/**
+ * A WaveNet block built by hand from separate Conv1D and Dense
+ * layers, with the gated activation and residual arithmetic
+ * done outside of the layers.
+ */
+struct HandBuiltBlock
+{
+    explicit HandBuiltBlock(int dilation)
+        : conv(channels, 2 * channels, kernel_size, dilation)
+        , proj(channels, io_size)
+    {
+        randomise_conv1d(conv, kernel_size);
+        randomise_dense(proj);
+        conv.reset();
+    }
+
+    void forward(const double* input, double* out)
+    {
+        conv.forward(input, gate.data());
+        for(int i = 0; i < channels; ++i)
+            z[i] = std::tanh(gate[i]) / (1.0 + std::exp(-gate[channels + i]));
+
+        proj.forward(z.data(), out);
+        for(int i = 0; i < io_size; ++i)
+            out[i] += input[i];
+    }
+
+    RTNeural::Conv1D<double> conv;
+    RTNeural::Dense<double> proj;
+    vec_type gate = vec_type(2 * channels, 0.0);
+    vec_type z = vec_type(channels, 0.0);
+};
+
+template <typename ProcessFunc>
+double runBench(ProcessFunc&& process, const std::vector<vec_type>& signal, double length_seconds)
+{
+    using clock_t = std::chrono::high_resolution_clock;
+    using second_t = std::chrono::duration<double>;
+
+    auto start = clock_t::now();
+    for(const auto& x : signal)
+        process(x.data());
+    auto duration = std::chrono::duration_cast<second_t>(clock_t::now() - start).count();
+
+    std::cout << "Processed " << length_seconds << " seconds of signal in "
+              << duration << " seconds" << std::endl;
+    std::cout << length_seconds / duration << "x real-time" << std::endl;
+
+    return duration;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto length_seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    std::cout << "Benchmarking WaveNet stack with " << dilations.size() << " blocks, "
+              << channels << " residual channels, " << skip_channels << " skip channels, "
+              << "and kernel size " << kernel_size << std::endl;
+
+    constexpr double sample_rate = 48000.0;
+    const auto n_samples = static_cast<size_t>(sample_rate * length_seconds);
+    const auto signal = generate_signal(n_samples, io_size);
+
+    // hand-built stack
+    double handBuiltDur = 0.0;
+    {
+        std::cout << "Measuring hand-built stack (Conv1D + gate + Dense)..." << std::endl;
+        std::vector<std::unique_ptr<HandBuiltBlock>> blocks;
+        for(auto d : dilations)
+            blocks.push_back(std::make_unique<HandBuiltBlock>(d));
+
+        vec_type x(io_size, 0.0), y(io_size, 0.0);
+        handBuiltDur = runBench([&](const double* input) {
+            std::copy(input, input + io_size, x.begin());
+            for(auto& block : blocks)
+            {
+                block->forward(x.data(), y.data());
+                std::swap(x, y);
+            }
+        },
+            signal, length_seconds);
+    }
+
+    // fused dynamic blocks
+    double fusedDur = 0.0;
+    {
+        std::cout << "Measuring fused WaveNetBlock stack..." << std::endl;
+        RTNeural::Model<double> model(io_size);
+        for(auto d : dilations)
+        {
+            auto block = std::make_unique<RTNeural::WaveNetBlock<double>>(channels, skip_channels, kernel_size, d);
+            randomise_wavenet(*block);
+            model.addLayer(block.release());
+        }
+        model.reset();
+
+        fusedDur = runBench([&](const double* input) { model.forward(input); }, signal, length_seconds);
+    }
+
+    std::cout << "Fused stack is " << handBuiltDur / fusedDur << "x faster!" << std::endl;
+
+#if MODELT_AVAILABLE
+    // fused templated blocks
+    double templatedDur = 0.0;
+    {
+        std::cout << "Measuring fused WaveNetBlockT stack..." << std::endl;
+        using namespace RTNeural;
+        ModelT<double, io_size, io_size,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 1>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 2>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 4>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 8>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 16>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 32>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 64>,
+            WaveNetBlockT<double, channels, skip_channels, kernel_size, 128>>
+            modelT;
+        modelt_detail::forEachInTuple([](auto& block, size_t) { randomise_wavenet(block); },
+            std::tie(modelT.get<0>(), modelT.get<1>(), modelT.get<2>(), modelT.get<3>(),
+                modelT.get<4>(), modelT.get<5>(), modelT.get<6>(), modelT.get<7>()));
+        modelT.reset();
+
+        templatedDur = runBench([&](const double* input) { modelT.forward(input); }, signal, length_seconds);
+    }
+
+    std::cout << "Fused templated stack is " << handBuiltDur / templatedDur << "x faster!" << std::endl;
+#endif
+
+    return 0;
+}
@@ -2,6 +2,7 @@ option(RTNEURAL_EIGEN "Use Eigen library for vector operations" OFF)
 option(RTNEURAL_XSIMD "Use xsimd library for vector operations" OFF)
 option(RTNEURAL_ACCELERATE "Use Accelerate library for vector operations (Apple only)" OFF)
 option(RTNEURAL_STL "Use STL for all operations" OFF)
+option(RTNEURAL_VECTOR_EXT "Use compiler vector extensions for vector operations (GCC/Clang only)" OFF)
 if(RTNEURAL_EIGEN)
     message(STATUS "RTNeural -- Using Eigen backend")
     target_compile_definitions(RTNeural PUBLIC RTNEURAL_USE_EIGEN=1)
@@ -17,6 +18,12 @@ elseif(RTNEURAL_ACCELERATE)
     message(STATUS "RTNeural -- Using Accelerate backend")
     target_compile_definitions(RTNeural PUBLIC RTNEURAL_USE_ACCELERATE=1)
     target_link_libraries(RTNeural PUBLIC "-framework Accelerate")
+elseif(RTNEURAL_VECTOR_EXT)
+    if(MSVC)
+        message(FATAL_ERROR "RTNeural -- The vector extension backend is only supported by GCC and Clang!")
+    endif()
+    message(STATUS "RTNeural -- Using vector extension backend")
+    target_compile_definitions(RTNeural PUBLIC RTNEURAL_USE_VECTOR_EXT=1)
 elseif(RTNEURAL_STL)
     message(STATUS "RTNeural -- Using STL backend")
 else()
@@ -0,0 +1,75 @@
+option(RTNEURAL_DISPATCH "Compile RTNeural's kernels for multiple instruction sets, and choose one at runtime" OFF)
+if(RTNEURAL_DISPATCH)
+    message(STATUS "RTNeural -- Configuring runtime instruction set dispatch...")
+    if(RTNEURAL_USE_AVX OR RTNEURAL_USE_AVX512)
+        message(FATAL_ERROR "RTNeural -- RTNEURAL_DISPATCH can not be used together with RTNEURAL_USE_AVX or RTNEURAL_USE_AVX512!")
+    endif()
+
+    # The dispatched kernels are the matrix-vector products used by the
+    # STL backend's dense, convolution, and recurrent layers, and by the
+    # backend-independent sparse and mapped layers. The other backends
+    # use their own kernels, which are only compiled for the baseline
+    # instruction set.
+    if(NOT RTNEURAL_STL OR RTNEURAL_EIGEN OR RTNEURAL_XSIMD OR RTNEURAL_ACCELERATE OR RTNEURAL_VECTOR_EXT)
+        message(WARNING "RTNeural -- With this backend, runtime dispatch is only used by the sparse and mapped layers! Use RTNEURAL_STL to dispatch the dense, convolution, and recurrent layers too.")
+    endif()
+
+    # Compiles the kernels for one instruction set, as an object library
+    # with its own compiler flags, and adds them to RTNeural. The kernels
+    # have internal linkage, so every instruction set gets its own copy,
+    # and only the instruction set's kernel table is exported.
+    function(rtneural_add_dispatch_isa isa_name isa_enum)
+        set(target_name RTNeural_dispatch_${isa_name})
+        add_library(${target_name} OBJECT RTNeural/dispatch/dispatch_kernels.cpp)
+        set_property(TARGET ${target_name} PROPERTY POSITION_INDEPENDENT_CODE ON)
+        if(NOT MSVC)
+            # don't let the compiler fuse multiply-adds on instruction sets with FMA,
+            # so that every instruction set gives the same results as the baseline
+            target_compile_options(${target_name} PRIVATE -ffp-contract=off)
+        endif()
+        target_compile_definitions(${target_name} PRIVATE
+            RTNEURAL_DISPATCH_ISA=::RTNeural::dispatch::InstructionSet::${isa_enum}
+            RTNEURAL_DISPATCH_NAMESPACE=isa_${isa_name}
+        )
+        target_compile_options(${target_name} PRIVATE ${ARGN})
+        target_sources(RTNeural PRIVATE $<TARGET_OBJECTS:${target_name}>)
+    endfunction()
+
+    # dispatch.cpp is already listed in RTNeural's sources (see RTNeural/CMakeLists.txt)
+    target_compile_definitions(RTNeural PUBLIC RTNEURAL_DISPATCH_ENABLED=1)
+
+    rtneural_add_dispatch_isa(baseline Baseline)
+
+    if(CMAKE_SYSTEM_PROCESSOR MATCHES "(x86_64)|(AMD64)|(amd64)|(i.86)|(x86)|(X86)")
+        include(CheckCXXCompilerFlag)
+        if(MSVC)
+            set(RTNEURAL_AVX2_FLAGS /arch:AVX2)
+            set(RTNEURAL_AVX512_FLAGS /arch:AVX512)
+        else()
+            set(RTNEURAL_AVX2_FLAGS -mavx2 -mfma)
+            set(RTNEURAL_AVX512_FLAGS -mavx2 -mfma -mavx512f -mavx512dq -mavx512vl -mavx512bw)
+        endif()
+
+        string(REPLACE ";" " " avx2_flags_string "${RTNEURAL_AVX2_FLAGS}")
+        CHECK_CXX_COMPILER_FLAG("${avx2_flags_string}" COMPILER_OPT_DISPATCH_AVX2_SUPPORTED)
+        if(COMPILER_OPT_DISPATCH_AVX2_SUPPORTED)
+            message(STATUS "RTNeural -- Adding AVX2 instruction set for runtime dispatch")
+            rtneural_add_dispatch_isa(avx2 AVX2 ${RTNEURAL_AVX2_FLAGS})
+            target_compile_definitions(RTNeural PRIVATE RTNEURAL_DISPATCH_AVX2=1)
+        else()
+            message(WARNING "RTNeural -- Unable to enable AVX2 flags for ${CMAKE_CXX_COMPILER_ID} compiler, so AVX2 will not be used for runtime dispatch!")
+        endif()
+
+        string(REPLACE ";" " " avx512_flags_string "${RTNEURAL_AVX512_FLAGS}")
+        CHECK_CXX_COMPILER_FLAG("${avx512_flags_string}" COMPILER_OPT_DISPATCH_AVX512_SUPPORTED)
+        if(COMPILER_OPT_DISPATCH_AVX512_SUPPORTED)
+            message(STATUS "RTNeural -- Adding AVX-512 instruction set for runtime dispatch")
+            rtneural_add_dispatch_isa(avx512 AVX512 ${RTNEURAL_AVX512_FLAGS})
+            target_compile_definitions(RTNeural PRIVATE RTNEURAL_DISPATCH_AVX512=1)
+        else()
+            message(WARNING "RTNeural -- Unable to enable AVX-512 flags for ${CMAKE_CXX_COMPILER_ID} compiler, so AVX-512 will not be used for runtime dispatch!")
+        endif()
+    else()
+        message(WARNING "RTNeural -- Runtime dispatch is only supported on x86 platforms (not ${CMAKE_SYSTEM_PROCESSOR}), so only the baseline instruction set will be used!")
+    endif()
+endif()
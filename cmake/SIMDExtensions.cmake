@@ -1,5 +1,28 @@
 option(RTNEURAL_USE_AVX "Enables AVX SIMD Support" OFF)
-if(NOT RTNEURAL_USE_AVX)
+option(RTNEURAL_USE_AVX512 "Enables AVX-512 SIMD Support" OFF)
+if(RTNEURAL_USE_AVX512)
+    message(STATUS "RTNeural -- Attempting to enable AVX-512...")
+
+    include(CheckCXXCompilerFlag)
+    if(MSVC)
+        set(RTNEURAL_AVX512_FLAGS /arch:AVX512)
+    else()
+        set(RTNEURAL_AVX512_FLAGS -mavx2 -mfma -mavx512f -mavx512dq -mavx512vl -mavx512bw)
+    endif()
+
+    string(REPLACE ";" " " avx512_flags_string "${RTNEURAL_AVX512_FLAGS}")
+    CHECK_CXX_COMPILER_FLAG("${avx512_flags_string}" COMPILER_OPT_ARCH_AVX512_SUPPORTED)
+    if(COMPILER_OPT_ARCH_AVX512_SUPPORTED)
+        message(STATUS "RTNeural -- AVX-512 flags enabled for ${CMAKE_CXX_COMPILER_ID} compiler!")
+        target_compile_options(RTNeural PUBLIC ${RTNEURAL_AVX512_FLAGS})
+        target_compile_definitions(RTNeural PUBLIC RTNEURAL_AVX_ENABLED=1)
+        target_compile_definitions(RTNeural PUBLIC RTNEURAL_AVX512_ENABLED=1)
+        target_compile_definitions(RTNeural PUBLIC RTNEURAL_DEFAULT_ALIGNMENT=64)
+    else()
+        message(STATUS "RTNeural -- Unable to enable AVX-512 flags for ${CMAKE_CXX_COMPILER_ID} compiler!")
+        target_compile_definitions(RTNeural PUBLIC RTNEURAL_DEFAULT_ALIGNMENT=16)
+    endif()
+elseif(NOT RTNEURAL_USE_AVX)
     target_compile_definitions(RTNeural PUBLIC RTNEURAL_DEFAULT_ALIGNMENT=16)
 else()
     message(STATUS "RTNeural -- Attempting to enable AVX...")
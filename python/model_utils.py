@@ -2,6 +2,7 @@ import numpy as np
 import tensorflow as tf
 from tensorflow import keras
 import json
+import struct
 from json import JSONEncoder
 
 class NumpyArrayEncoder(JSONEncoder):
@@ -10,7 +11,21 @@ class NumpyArrayEncoder(JSONEncoder):
             return obj.tolist()
         return JSONEncoder.default(self, obj)
 
-def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
+def quantize_int8(kernel):
+    """Quantizes a kernel to int8, with one scale for each output channel (the last kernel dimension)"""
+    reduce_axes = tuple(range(kernel.ndim - 1))
+    max_abs = np.max(np.abs(kernel), axis=reduce_axes)
+    scales = np.where(max_abs > 0.0, max_abs / 127.0, 1.0).astype(np.float64)
+    q_kernel = np.clip(np.round(kernel / scales), -127, 127).astype(np.int8)
+    return q_kernel, scales
+
+def factorize_low_rank(kernel, rank):
+    """Factorizes a dense kernel [in][out] into two kernels [in][rank] and [rank][out], using a truncated SVD"""
+    u, s, vt = np.linalg.svd(kernel, full_matrices=False)
+    sqrt_s = np.sqrt(s[:rank])
+    return u[:, :rank] * sqrt_s, sqrt_s[:, np.newaxis] * vt[:rank, :]
+
+def save_model_json(model, layers_to_skip=(keras.layers.InputLayer), activation_lut=None, quantize=None, weight_storage=None, low_rank=None):
     def get_layer_type(layer):
         if isinstance(layer, keras.layers.TimeDistributed):
             return 'time-distributed-dense'
@@ -27,6 +42,9 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
         if isinstance(layer, keras.layers.Conv1D):
             return 'conv1d'
 
+        if isinstance(layer, keras.layers.Conv2D):
+            return 'conv2d'
+
         return 'unknown'
 
     def get_layer_activation(layer):
@@ -62,9 +80,48 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
             "weights"    : layer.get_weights()
         }
 
+        # tanh, sigmoid, and elu activations can be evaluated from a lookup table in RTNeural
+        if activation_lut is not None and layer_dict["activation"] in ('tanh', 'sigmoid', 'elu'):
+            layer_dict["activation_lut"] = activation_lut
+
+        # dense layers can be stored as two low-rank factors, which RTNeural loads into
+        # LowRankDense layers, if the factors are smaller than the original kernel
+        if low_rank is not None and layer_dict["type"] in ('dense', 'time-distributed-dense'):
+            kernel = layer_dict["weights"][0]
+            in_size, out_size = kernel.shape
+            if low_rank * (in_size + out_size) < in_size * out_size:
+                v_kernel, u_kernel = factorize_low_rank(kernel, low_rank)
+                layer_dict["weights"] = [v_kernel, u_kernel] + layer_dict["weights"][1:]
+                layer_dict["rank"] = low_rank
+
+        # dense and conv1d layers can be stored with int8 kernel weights, which RTNeural
+        # loads into QuantizedDense and QuantizedConv1D layers
+        if quantize == 'int8' and layer_dict["type"] in ('dense', 'time-distributed-dense', 'conv1d') and "rank" not in layer_dict:
+            q_kernel, scales = quantize_int8(layer_dict["weights"][0])
+            layer_dict["weights"] = [q_kernel] + layer_dict["weights"][1:]
+            layer_dict["quantization"] = { "type": "int8", "scales": scales }
+
+        # recurrent layers are quantized when they are loaded, with int8 or int16 weights
+        if quantize in ('int8', 'int16') and layer_dict["type"] in ('gru', 'lstm'):
+            layer_dict["quantization"] = quantize
+
+        # dense, conv1d, and recurrent layers can store their weights as 'fp16' or 'bf16' in RTNeural
+        if weight_storage in ('fp16', 'bf16') and layer_dict["type"] in ('dense', 'time-distributed-dense', 'conv1d', 'gru', 'lstm') and "rank" not in layer_dict:
+            layer_dict["weight_storage"] = weight_storage
+
         if layer_dict["type"] == "conv1d":
             layer_dict["kernel_size"] = layer.kernel_size
             layer_dict["dilation"] = layer.dilation_rate
+            layer_dict["strides"] = layer.strides
+
+        if layer_dict["type"] == "conv2d":
+            # RTNeural treats each time step as a flat [features][filters] frame
+            out_shape = layer.output_shape
+            layer_dict["shape"] = [out_shape[0], out_shape[1], out_shape[2] * out_shape[3]]
+            layer_dict["kernel_size"] = layer.kernel_size
+            layer_dict["dilation"] = layer.dilation_rate
+            layer_dict["strides"] = layer.strides
+            layer_dict["padding"] = layer.padding
 
         return layer_dict
 
@@ -83,7 +140,68 @@ def save_model_json(model, layers_to_skip=(keras.layers.InputLayer)):
     model_dict["layers"] = layers
     return model_dict
 
-def save_model(model, filename, layers_to_skip=(keras.layers.InputLayer)):
-    model_dict = save_model_json(model, layers_to_skip)
+def save_model(model, filename, layers_to_skip=(keras.layers.InputLayer), activation_lut=None, quantize=None, weight_storage=None, low_rank=None):
+    model_dict = save_model_json(model, layers_to_skip, activation_lut, quantize, weight_storage, low_rank)
     with open(filename, 'w') as outfile:
         json.dump(model_dict, outfile, cls=NumpyArrayEncoder, indent=4)
+
+def save_model_binary(model, filename, layers_to_skip=(keras.layers.InputLayer)):
+    """Saves a model in the RTNeural binary format (see RTNeural/binary_model_loader.h)"""
+    model_dict = save_model_json(model, layers_to_skip)
+    layers = model_dict["layers"]
+
+    alignment = 64
+    header_size = 24
+    record_size = 128
+    offset = header_size + len(layers) * record_size
+
+    records = []
+    tensors = []
+    in_size = model_dict["in_shape"][-1]
+    for layer_dict in layers:
+        layer_type = layer_dict["type"]
+        weights = layer_dict["weights"]
+        out_size = layer_dict["shape"][-1]
+        activation = ''
+        kernel_size = 0
+        dilation = 0
+
+        # tensors are stored in the layout that the RTNeural layers compute with (see RTNeural/binary_model_loader.h)
+        if layer_type in ('dense', 'time-distributed-dense'):
+            layer_type = 'dense'
+            activation = layer_dict["activation"]
+            layer_tensors = [weights[0], weights[1]]
+        elif layer_type == 'conv1d':
+            if layer_dict["strides"][-1] > 1:
+                raise ValueError('Strided Conv1D layers are not supported by the binary format')
+            activation = layer_dict["activation"]
+            kernel_size = layer_dict["kernel_size"][-1]
+            dilation = layer_dict["dilation"][-1]
+            layer_tensors = [np.flip(weights[0], axis=0), weights[1]]
+        elif layer_type in ('gru', 'lstm'):
+            layer_tensors = weights[:3]
+        else:
+            raise ValueError(f'Layer type {layer_type} is not supported by the binary format')
+
+        tensor_offsets = [0] * 4
+        tensor_sizes = [0] * 4
+        for i, tensor in enumerate(layer_tensors):
+            data = np.ascontiguousarray(tensor, dtype='<f4').tobytes()
+            offset = (offset + alignment - 1) // alignment * alignment
+            tensor_offsets[i] = offset
+            tensor_sizes[i] = len(data) // 4
+            tensors.append((offset, data))
+            offset += len(data)
+
+        records.append(struct.pack('<24s16s4i2I4Q4Q', layer_type.encode(), activation.encode(), in_size, out_size,
+                                   kernel_size, dilation, len(layer_tensors), 0, *tensor_offsets, *tensor_sizes))
+        in_size = out_size
+
+    with open(filename, 'wb') as outfile:
+        # magic, byte-order marker, version, input size, number of layers, reserved
+        outfile.write(struct.pack('<4s5I', b'RTNB', 0x01020304, 3, model_dict["in_shape"][-1], len(layers), 0))
+        for record in records:
+            outfile.write(record)
+        for tensor_offset, data in tensors:
+            outfile.write(bytes(tensor_offset - outfile.tell()))
+            outfile.write(data)
@@ -70,22 +70,28 @@ int fastTanhTest(T limit)
 
     FastTanhT<T, layerSize> fastTanhT;
     std::cout << "Testing FastTanhT for data type " << dtype << std::endl;
-#if RTNEURAL_USE_XSIMD
+#if RTNEURAL_USE_XSIMD || RTNEURAL_USE_VECTOR_EXT
     result |= testTanh([&fastTanhT, &test_outs] (const T (&test_ins)[layerSize])
         {
             constexpr int layerSize = 8; // MSVC can't capture this in the lambda
             using b_type = xsimd::simd_type<T>;
             constexpr auto b_size = (int)b_type::size;
-            constexpr auto v_size = layerSize / b_size;
+            constexpr auto v_size = ceil_div(layerSize, b_size);
+
+            // the batches may be wider than the layer (e.g. with AVX-512)
+            T ins_padded alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size * b_size] {};
+            T outs_padded alignas(RTNEURAL_DEFAULT_ALIGNMENT)[v_size * b_size] {};
+            std::copy(test_ins, test_ins + layerSize, ins_padded);
 
             b_type test_ins_v[v_size];
             for(int i = 0; i < v_size; ++i)
-                test_ins_v[i] = xsimd::load_aligned(test_ins + i * b_size);
+                test_ins_v[i] = xsimd::load_aligned(ins_padded + i * b_size);
 
             fastTanhT.forward(test_ins_v);
 
             for(int i = 0; i < v_size; ++i)
-                xsimd::store_aligned(test_outs + i * b_size, fastTanhT.outs[i]);
+                xsimd::store_aligned(outs_padded + i * b_size, fastTanhT.outs[i]);
+            std::copy(outs_padded, outs_padded + layerSize, test_outs);
         }, test_outs);
 #elif RTNEURAL_USE_EIGEN
         result |= testTanh([&fastTanhT, &test_outs] (const T (&test_ins)[layerSize])
@@ -109,11 +115,68 @@ int fastTanhTest(T limit)
     return result;
 }
 
+/** Checks that softmax stays finite for large inputs (which would overflow a plain exp()). */
+template <typename T>
+int softmaxOverflowTest(T limit)
+{
+    using namespace RTNeural;
+    constexpr int layerSize = 6; // not a multiple of the SIMD width
+    constexpr int ioSize = 8;
+
+    auto dtype = std::is_same<T, float>::value ? "float" : "double";
+    std::cout << "Testing Softmax overflow for data type " << dtype << std::endl;
+
+    T test_ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ioSize] {};
+    long double expected[layerSize];
+    long double exp_sum = 0;
+    for(int n = 0; n < layerSize; ++n)
+    {
+        test_ins[n] = (T)1000 - (T)n;
+        expected[n] = std::exp((long double)(test_ins[n] - test_ins[0]));
+        exp_sum += expected[n];
+    }
+
+    auto checkOutputs = [&](const T* outs)
+    {
+        auto maxError = (T)0;
+        for(int n = 0; n < layerSize; ++n)
+        {
+            const auto error = std::abs(outs[n] - (T)(expected[n] / exp_sum));
+            maxError = std::isfinite(error) ? std::max(error, maxError) : std::numeric_limits<T>::infinity();
+        }
+
+        std::cout << "    Maximum error: " << maxError << std::endl;
+        if(maxError > limit)
+        {
+            std::cout << "    FAIL: Error is too high!" << std::endl;
+            return 1;
+        }
+
+        return 0;
+    };
+
+    int result = 0;
+    T test_outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[ioSize] {};
+    SoftmaxActivation<T> softmax { layerSize };
+    softmax.forward(test_ins, test_outs);
+    result |= checkOutputs(test_outs);
+
+#if MODELT_AVAILABLE
+    ModelT<T, layerSize, layerSize, SoftmaxActivationT<T, layerSize>> softmaxT;
+    softmaxT.forward(test_ins);
+    result |= checkOutputs(softmaxT.getOutputs());
+#endif
+
+    return result;
+}
+
 int approximationTests()
 {
     int result = 0;
     result |= fastTanhTest<float>(5.1e-5f);
     result |= fastTanhTest<double>(5.1e-5);
+    result |= softmaxOverflowTest<float>(1.0e-6f);
+    result |= softmaxOverflowTest<double>(1.0e-12);
 
     return result;
 }
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <RTNeural.h>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace binary_model_test
+{
+
+using TestType = double;
+
+/** Converts a json model to the binary format, and returns the binary data. */
+std::string convert_model(const TestConfig& test)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    std::ostringstream binaryStream;
+    if(!RTNeural::binary_parser::convertJson(modelJson, binaryStream, true))
+        return {};
+
+    return binaryStream.str();
+}
+
+/** Loads a model from the binary format, and compares it to the reference output. */
+int test_model(const TestConfig& test)
+{
+    std::cout << "Testing " << test.name << " model from binary" << std::endl;
+
+    const auto binaryData = convert_model(test);
+    if(binaryData.empty())
+    {
+        std::cout << "FAIL: Unable to convert model to binary!" << std::endl;
+        return 1;
+    }
+
+    auto model = RTNeural::binary_parser::parseBinary<TestType>(binaryData.data(), binaryData.size(), true);
+    if(model == nullptr)
+    {
+        std::cout << "FAIL: Unable to load binary model!" << std::endl;
+        return 1;
+    }
+
+    model->reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        TestType input[] = { xData[n] };
+        yData[n] = model->forward(input);
+    }
+
+    return compare(yData, yRefData, (TestType)test.threshold);
+}
+
+/** Writes a binary model to a file, and loads it with a memory-mapped file. */
+int test_file()
+{
+    const auto& test = tests.at("gru");
+    std::cout << "Testing " << test.name << " model from binary file" << std::endl;
+
+    const auto binaryData = convert_model(test);
+    const std::string filePath = "test_data/gru_model.rtnb";
+    {
+        std::ofstream binaryFile(filePath, std::ofstream::binary);
+        binaryFile.write(binaryData.data(), (std::streamsize)binaryData.size());
+    }
+
+    auto model = RTNeural::binary_parser::parseBinary<TestType>(filePath, true);
+    std::remove(filePath.c_str());
+    if(model == nullptr)
+    {
+        std::cout << "FAIL: Unable to load binary model file!" << std::endl;
+        return 1;
+    }
+
+    if(RTNeural::binary_parser::parseBinary<TestType>(std::string { "test_data/missing_model.rtnb" }) != nullptr)
+    {
+        std::cout << "FAIL: Loading a missing file should fail!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Returns true if a layer of a dynamic model uses its weights in place in a binary model file. */
+bool is_mapped_layer(RTNeural::Layer<float>* layer)
+{
+    return dynamic_cast<RTNeural::MappedDense<float>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::MappedConv1D<float>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::MappedGRULayer<float>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::MappedLSTMLayer<float>*>(layer) != nullptr;
+}
+
+/**
+ * Loads a float model from a binary file, checks that its layers use the
+ * weights in the file in place, and compares it to the same model with
+ * the weights copied into the layers, at the model's own sample rate
+ * and when prepared for twice that sample rate.
+ */
+int test_mapped_file(const TestConfig& test, int expectedMappedLayers)
+{
+    std::cout << "Testing " << test.name << " model with mapped weights" << std::endl;
+
+    const auto binaryData = convert_model(test);
+    const std::string filePath = "test_data/mapped_model.rtnb";
+    {
+        std::ofstream binaryFile(filePath, std::ofstream::binary);
+        binaryFile.write(binaryData.data(), (std::streamsize)binaryData.size());
+    }
+
+    auto model = RTNeural::binary_parser::parseBinary<float>(filePath);
+    std::remove(filePath.c_str()); // the file stays mapped until the model is destroyed
+    auto refModel = RTNeural::binary_parser::parseBinary<float>(binaryData.data(), binaryData.size());
+    if(model == nullptr || refModel == nullptr)
+    {
+        std::cout << "FAIL: Unable to load binary model!" << std::endl;
+        return 1;
+    }
+
+    const auto numMappedLayers = (int)std::count_if(model->layers.begin(), model->layers.end(), is_mapped_layer);
+    if(numMappedLayers != expectedMappedLayers || std::any_of(refModel->layers.begin(), refModel->layers.end(), is_mapped_layer))
+    {
+        std::cout << "FAIL: Expected " << expectedMappedLayers << " mapped layers, found " << numMappedLayers << std::endl;
+        return 1;
+    }
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<float>(pythonX);
+    const auto yData = run_model(*model, xData);
+    if(compare(yData, run_model(*refModel, xData), 1.0e-5f))
+        return 1;
+
+    // sample-rate correction should work the same way for the mapped layers
+    model->prepare(2.0f);
+    refModel->prepare(2.0f);
+    const auto yPreparedData = run_model(*model, xData);
+    const auto hasStatefulLayers = std::any_of(model->layers.begin(), model->layers.end(), [](auto* layer)
+        { return layer->getName() == "conv1d" || layer->getName() == "gru" || layer->getName() == "lstm"; });
+    if(hasStatefulLayers && yPreparedData == yData)
+    {
+        std::cout << "FAIL: Preparing the mapped layers at 2x has no effect!" << std::endl;
+        return 1;
+    }
+
+    return compare(yPreparedData, run_model(*refModel, xData), 1.0e-5f);
+}
+
+/** Overwrites a field of a binary model's header, or of one of its layer records. */
+template <typename FieldType>
+void set_field(std::string& binaryData, size_t offset, FieldType value)
+{
+    std::memcpy(&binaryData[offset], &value, sizeof(FieldType));
+}
+
+size_t record_offset(size_t layerIdx, size_t fieldOffset)
+{
+    return sizeof(RTNeural::binary_parser::BinaryFileHeader) + layerIdx * sizeof(RTNeural::binary_parser::BinaryLayerRecord) + fieldOffset;
+}
+
+/** Returns true (and prints a failure message) if a binary model loads when it should be rejected. */
+bool loads_invalid_model(const std::string& binaryData, const std::string& description)
+{
+    if(RTNeural::binary_parser::parseBinary<TestType>(binaryData.data(), binaryData.size()) == nullptr)
+        return false;
+
+    std::cout << "FAIL: Binary model with " << description << " should not load!" << std::endl;
+    return true;
+}
+
+/** Checks that invalid binary models are rejected. */
+int test_invalid_data()
+{
+    std::cout << "Testing invalid binary models" << std::endl;
+
+    int result = 0;
+    const auto binaryData = convert_model(tests.at("lstm"));
+
+    // truncated weights
+    const auto truncated = binaryData.substr(0, binaryData.size() - 4);
+    if(RTNeural::binary_parser::parseBinary<TestType>(truncated.data(), truncated.size()) != nullptr)
+    {
+        std::cout << "FAIL: Truncated binary model should not load!" << std::endl;
+        result = 1;
+    }
+
+    // wrong magic number
+    auto wrongMagic = binaryData;
+    wrongMagic[0] = 'X';
+    if(RTNeural::binary_parser::parseBinary<TestType>(wrongMagic.data(), wrongMagic.size()) != nullptr)
+    {
+        std::cout << "FAIL: Binary model with the wrong magic number should not load!" << std::endl;
+        result = 1;
+    }
+
+    using RTNeural::binary_parser::BinaryFileHeader;
+    using RTNeural::binary_parser::BinaryLayerRecord;
+
+    // byte-order marker from a machine with the other byte order
+    auto wrongByteOrder = binaryData;
+    std::reverse(&wrongByteOrder[offsetof(BinaryFileHeader, byte_order)], &wrongByteOrder[offsetof(BinaryFileHeader, byte_order) + sizeof(uint32_t)]);
+    result |= (int)loads_invalid_model(wrongByteOrder, "the wrong byte order");
+
+    // invalid input sizes
+    for(auto in_size : { (uint32_t)0, (uint32_t)std::numeric_limits<int>::max() + 1 })
+    {
+        auto wrongInSize = binaryData;
+        set_field(wrongInSize, offsetof(BinaryFileHeader, in_size), in_size);
+        result |= (int)loads_invalid_model(wrongInSize, "input size " + std::to_string(in_size));
+    }
+
+    // invalid convolution parameters (the conv1d model's second layer is a Conv1D layer)
+    const auto convData = convert_model(tests.at("conv1d"));
+    auto zeroKernel = convData;
+    set_field(zeroKernel, record_offset(1, offsetof(BinaryLayerRecord, kernel_size)), (int32_t)0);
+    set_field(zeroKernel, record_offset(1, offsetof(BinaryLayerRecord, tensor_sizes)), (uint64_t)0);
+    result |= (int)loads_invalid_model(zeroKernel, "kernel size 0");
+
+    for(auto dilation : { (int32_t)0, (int32_t)-1 })
+    {
+        auto wrongDilation = convData;
+        set_field(wrongDilation, record_offset(1, offsetof(BinaryLayerRecord, dilation)), dilation);
+        result |= (int)loads_invalid_model(wrongDilation, "dilation rate " + std::to_string(dilation));
+    }
+
+    // hostile dilation rates, which would make the Conv1D layer allocate a huge amount of memory
+    for(auto dilation : { (int32_t)1 << 24, std::numeric_limits<int32_t>::max() })
+    {
+        auto hugeDilation = convData;
+        set_field(hugeDilation, record_offset(1, offsetof(BinaryLayerRecord, dilation)), dilation);
+        result |= (int)loads_invalid_model(hugeDilation, "dilation rate " + std::to_string(dilation));
+    }
+
+    // tensor sizes that overflow: 16 * 2^30 * 2^30 wraps around to zero
+    nlohmann::json convJson;
+    convJson["in_shape"] = { nullptr, nullptr, 1 };
+    convJson["layers"] = { { { "type", "conv1d" }, { "activation", "" }, { "shape", { nullptr, nullptr, 16 } },
+        { "kernel_size", { 1 } }, { "dilation", { 1 } },
+        { "weights", { { { std::vector<float>(16, 0.0f) } }, std::vector<float>(16, 0.0f) } } } };
+    std::ostringstream convStream;
+    RTNeural::binary_parser::convertJson(convJson, convStream);
+    auto overflowData = convStream.str();
+    if(RTNeural::binary_parser::parseBinary<TestType>(overflowData.data(), overflowData.size()) == nullptr)
+    {
+        std::cout << "FAIL: Unable to load Conv1D binary model!" << std::endl;
+        result = 1;
+    }
+
+    constexpr int32_t largeSize = 1 << 30;
+    set_field(overflowData, offsetof(BinaryFileHeader, in_size), (uint32_t)largeSize);
+    set_field(overflowData, record_offset(0, offsetof(BinaryLayerRecord, in_size)), largeSize);
+    set_field(overflowData, record_offset(0, offsetof(BinaryLayerRecord, kernel_size)), largeSize);
+    set_field(overflowData, record_offset(0, offsetof(BinaryLayerRecord, tensor_sizes)), (uint64_t)0);
+    result |= (int)loads_invalid_model(overflowData, "overflowing tensor sizes");
+
+    // layers that are not supported by the binary format
+    std::ifstream jsonStream(tests.at("dense").model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+    modelJson["layers"][0]["type"] = "wavenet-block";
+    std::ostringstream binaryStream;
+    if(RTNeural::binary_parser::convertJson(modelJson, binaryStream))
+    {
+        std::cout << "FAIL: Unsupported layers should not be converted!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+int binary_model_test()
+{
+    std::cout << "TESTING BINARY MODELS..." << std::endl;
+
+    int result = 0;
+    for(const auto* name : { "dense", "conv1d", "gru", "gru_1d", "lstm", "lstm_1d" })
+        result |= test_model(tests.at(name));
+
+    result |= test_file();
+    result |= test_mapped_file(tests.at("dense"), 5);
+    result |= test_mapped_file(tests.at("conv1d"), 4);
+    result |= test_mapped_file(tests.at("gru"), 4);
+    result |= test_mapped_file(tests.at("lstm"), 3);
+    result |= test_invalid_data();
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace binary_model_test
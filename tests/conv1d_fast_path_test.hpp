@@ -0,0 +1,169 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace conv1d_fast_path_test
+{
+
+using TestType = double;
+
+struct Conv1DConfig
+{
+    int in_size;
+    int out_size;
+    int kernel_size;
+    int dilation;
+};
+
+// in_size == 1 and kernel_size == 1, then in_size == 1, then kernel_size == 1
+const Conv1DConfig conv1_config { 1, 1, 1, 1 };
+const Conv1DConfig conv2_config { 1, 4, 3, 2 };
+const Conv1DConfig conv3_config { 4, 3, 1, 1 };
+
+nlohmann::json conv1d_json(std::default_random_engine& generator, const Conv1DConfig& config, const std::string& activation)
+{
+    nlohmann::json layer;
+    layer["type"] = "conv1d";
+    layer["activation"] = activation;
+    layer["shape"] = { nullptr, nullptr, config.out_size };
+    layer["kernel_size"] = { config.kernel_size };
+    layer["dilation"] = { config.dilation };
+    layer["weights"] = {
+        random_weights(generator, { config.kernel_size, config.in_size, config.out_size }),
+        random_weights(generator, { config.out_size }),
+    };
+
+    return layer;
+}
+
+nlohmann::json fast_path_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { conv3_config.out_size, 1 }), random_weights(generator, { 1 }) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = {
+        conv1d_json(generator, conv1_config, ""),
+        conv1d_json(generator, conv2_config, "tanh"),
+        conv1d_json(generator, conv3_config, ""),
+        dense_out,
+    };
+
+    return model;
+}
+
+/**
+ * Offline (non-streaming) causal 1D convolution, computed directly
+ * from the Keras kernel layout over the full input history.
+ */
+std::vector<std::vector<TestType>> reference_conv1d(const std::vector<std::vector<TestType>>& frames,
+    const Conv1DConfig& config, const nlohmann::json& weights)
+{
+    std::vector<std::vector<TestType>> outs(frames.size(), std::vector<TestType>((size_t)config.out_size, (TestType)0));
+    for(int n = 0; n < (int)frames.size(); ++n)
+    {
+        for(int co = 0; co < config.out_size; ++co)
+        {
+            auto y = weights[1][co].get<TestType>();
+            for(int i = 0; i < config.kernel_size; ++i)
+            {
+                const auto t = n - (config.kernel_size - 1 - i) * config.dilation;
+                if(t < 0)
+                    continue;
+
+                for(int ci = 0; ci < config.in_size; ++ci)
+                    y += weights[0][i][ci][co].get<TestType>() * frames[t][ci];
+            }
+
+            outs[n][co] = y;
+        }
+    }
+
+    return outs;
+}
+
+int conv1d_fast_path_test()
+{
+    std::cout << "TESTING CONV1D FAST PATHS..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    constexpr TestType threshold = 1.0e-12;
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto modelJson = fast_path_model_json();
+    const auto& jsonLayers = modelJson["layers"];
+
+    // reference model, computed offline
+    std::vector<TestType> yRefData(xData.size(), (TestType)0);
+    {
+        std::vector<std::vector<TestType>> frames(xData.size());
+        for(size_t n = 0; n < xData.size(); ++n)
+            frames[n] = { xData[n] };
+
+        auto conv1_outs = reference_conv1d(frames, conv1_config, jsonLayers[0]["weights"]);
+        auto conv2_outs = reference_conv1d(conv1_outs, conv2_config, jsonLayers[1]["weights"]);
+        for(auto& frame : conv2_outs)
+            for(auto& x : frame)
+                x = std::tanh(x);
+
+        auto conv3_outs = reference_conv1d(conv2_outs, conv3_config, jsonLayers[2]["weights"]);
+        auto denseOut = RTNeural::json_parser::createDense<TestType>(conv3_config.out_size, 1, jsonLayers[3]["weights"]);
+        for(size_t n = 0; n < xData.size(); ++n)
+            denseOut->forward(conv3_outs[n].data(), &yRefData[n]);
+    }
+
+    // non-templated model
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    {
+        std::cout << "Testing non-templated model" << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        model->reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = model->forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    {
+        std::cout << "Testing templated model" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::Conv1DT<TestType, 1, 1, 1, 1>,
+            RTNeural::Conv1DT<TestType, 1, 4, 3, 2>,
+            RTNeural::TanhActivationT<TestType, 4>,
+            RTNeural::Conv1DT<TestType, 4, 3, 1, 1>,
+            RTNeural::DenseT<TestType, 3, 1>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        modelT.reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = modelT.forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+#endif
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace conv1d_fast_path_test
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace conv1d_sample_rate_test
+{
+
+using TestType = double;
+
+constexpr int in_size = 3;
+constexpr int out_size = 2;
+constexpr int kernel_size = 3;
+constexpr int dilation = 2;
+
+nlohmann::json sample_rate_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_in;
+    dense_in["type"] = "dense";
+    dense_in["activation"] = "";
+    dense_in["shape"] = { nullptr, nullptr, in_size };
+    dense_in["weights"] = { random_weights(generator, { 1, in_size }), random_weights(generator, { in_size }) };
+
+    nlohmann::json conv;
+    conv["type"] = "conv1d";
+    conv["activation"] = "tanh";
+    conv["shape"] = { nullptr, nullptr, out_size };
+    conv["kernel_size"] = { kernel_size };
+    conv["dilation"] = { dilation };
+    conv["weights"] = {
+        random_weights(generator, { kernel_size, in_size, out_size }),
+        random_weights(generator, { out_size }),
+    };
+
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { out_size, 1 }), random_weights(generator, { 1 }) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { dense_in, conv, dense_out };
+
+    return model;
+}
+
+/**
+ * Offline causal 1D convolution, with the dilation scaled by the
+ * sample-rate ratio, and fractional kernel taps linearly interpolated.
+ */
+std::vector<TestType> reference_model(const std::vector<TestType>& xData, const nlohmann::json& modelJson, TestType sampleRateRatio)
+{
+    const auto& jsonLayers = modelJson["layers"];
+    auto denseIn = RTNeural::json_parser::createDense<TestType>(1, in_size, jsonLayers[0]["weights"]);
+    auto denseOut = RTNeural::json_parser::createDense<TestType>(out_size, 1, jsonLayers[2]["weights"]);
+    const auto& weights = jsonLayers[1]["weights"];
+
+    std::vector<std::vector<TestType>> frames(xData.size(), std::vector<TestType>(in_size, (TestType)0));
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+        denseIn->forward(input, frames[n].data());
+    }
+
+    const auto getFrameValue = [&frames](int t, int ci)
+    { return t < 0 ? (TestType)0 : frames[(size_t)t][(size_t)ci]; };
+
+    std::vector<TestType> y(xData.size(), (TestType)0);
+    for(int n = 0; n < (int)xData.size(); ++n)
+    {
+        TestType conv_out alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+        for(int co = 0; co < out_size; ++co)
+        {
+            auto sum = weights[1][co].get<TestType>();
+            for(int i = 0; i < kernel_size; ++i)
+            {
+                const auto tapDelay = (TestType)((kernel_size - 1 - i) * dilation) * sampleRateRatio;
+                const auto lo = (int)std::floor(tapDelay);
+                const auto frac = tapDelay - (TestType)lo;
+
+                for(int ci = 0; ci < in_size; ++ci)
+                {
+                    const auto x = ((TestType)1 - frac) * getFrameValue(n - lo, ci) + frac * getFrameValue(n - lo - 1, ci);
+                    sum += weights[0][i][ci][co].get<TestType>() * x;
+                }
+            }
+
+            conv_out[co] = std::tanh(sum);
+        }
+
+        denseOut->forward(conv_out, &y[(size_t)n]);
+    }
+
+    return y;
+}
+
+#if MODELT_AVAILABLE
+template <RTNeural::SampleRateCorrectionMode mode, typename RatioType>
+int run_templated_model(const std::vector<TestType>& xData, const nlohmann::json& modelJson, RatioType sampleRateRatio)
+{
+    constexpr TestType threshold = 1.0e-12;
+    std::cout << "Testing templated model, sample-rate ratio: " << sampleRateRatio << std::endl;
+
+    RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, in_size>,
+        RTNeural::Conv1DT<TestType, in_size, out_size, kernel_size, dilation, mode>,
+        RTNeural::TanhActivationT<TestType, out_size>,
+        RTNeural::DenseT<TestType, out_size, 1>>
+        modelT;
+    modelT.parseJson(modelJson, true);
+    modelT.template get<1>().prepare(sampleRateRatio);
+    modelT.reset();
+
+    const auto yData = run_model(modelT, xData);
+    return compare(yData, reference_model(xData, modelJson, (TestType)sampleRateRatio), threshold);
+}
+#endif
+
+int conv1d_sample_rate_test()
+{
+    std::cout << "TESTING CONV1D SAMPLE-RATE CORRECTION..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    constexpr TestType threshold = 1.0e-12;
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto modelJson = sample_rate_model_json();
+
+    // non-templated model
+    for(auto sampleRateRatio : { (TestType)2, (TestType)1.5 })
+    {
+        std::cout << "Testing non-templated model, sample-rate ratio: " << sampleRateRatio << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        model->prepare(sampleRateRatio);
+
+        const auto yData = run_model(*model, xData);
+        if(compare(yData, reference_model(xData, modelJson, sampleRateRatio), threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    if(run_templated_model<RTNeural::SampleRateCorrectionMode::NoInterp>(xData, modelJson, 2))
+        return 1;
+
+    if(run_templated_model<RTNeural::SampleRateCorrectionMode::LinInterp>(xData, modelJson, (TestType)1.5))
+        return 1;
+#endif
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace conv1d_sample_rate_test
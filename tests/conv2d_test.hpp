@@ -0,0 +1,207 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace conv2d_test
+{
+
+using TestType = double;
+
+struct Conv2DConfig
+{
+    int num_filters_in;
+    int num_filters_out;
+    int num_features_in;
+    int kernel_size_time;
+    int kernel_size_feature;
+    int dilation;
+    int stride;
+    bool valid_pad;
+
+    int num_features_out() const
+    {
+        return valid_pad ? (num_features_in - kernel_size_feature + stride) / stride
+                         : (num_features_in + stride - 1) / stride;
+    }
+
+    int in_size() const { return num_filters_in * num_features_in; }
+    int out_size() const { return num_filters_out * num_features_out(); }
+};
+
+// "same" padding with stride and dilation, followed by "valid" padding
+const Conv2DConfig conv1_config { 2, 3, 8, 3, 3, 2, 2, false };
+const Conv2DConfig conv2_config { 3, 2, 4, 2, 3, 1, 1, true };
+
+nlohmann::json conv2d_json(std::default_random_engine& generator, const Conv2DConfig& config, const std::string& activation)
+{
+    nlohmann::json layer;
+    layer["type"] = "conv2d";
+    layer["activation"] = activation;
+    layer["shape"] = { nullptr, nullptr, config.out_size() };
+    layer["kernel_size"] = { config.kernel_size_time, config.kernel_size_feature };
+    layer["dilation"] = { config.dilation, 1 };
+    layer["strides"] = { 1, config.stride };
+    layer["padding"] = config.valid_pad ? "valid" : "same";
+    layer["weights"] = {
+        random_weights(generator, { config.kernel_size_time, config.kernel_size_feature, config.num_filters_in, config.num_filters_out }),
+        random_weights(generator, { config.num_filters_out }),
+    };
+
+    return layer;
+}
+
+nlohmann::json conv2d_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_in;
+    dense_in["type"] = "dense";
+    dense_in["activation"] = "";
+    dense_in["shape"] = { nullptr, nullptr, conv1_config.in_size() };
+    dense_in["weights"] = { random_weights(generator, { 1, conv1_config.in_size() }), random_weights(generator, { conv1_config.in_size() }) };
+
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { conv2_config.out_size(), 1 }), random_weights(generator, { 1 }) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = {
+        dense_in,
+        conv2d_json(generator, conv1_config, "tanh"),
+        conv2d_json(generator, conv2_config, ""),
+        dense_out,
+    };
+
+    return model;
+}
+
+/**
+ * Offline (non-streaming) 2D convolution, computed directly
+ * from the Keras kernel layout over the full input history.
+ */
+std::vector<std::vector<TestType>> reference_conv2d(const std::vector<std::vector<TestType>>& frames,
+    const Conv2DConfig& config, const nlohmann::json& weights)
+{
+    const auto num_features_out = config.num_features_out();
+    const auto pad_total = std::max((num_features_out - 1) * config.stride + config.kernel_size_feature - config.num_features_in, 0);
+    const auto pad_left = config.valid_pad ? 0 : pad_total / 2;
+
+    std::vector<std::vector<TestType>> outs(frames.size(), std::vector<TestType>((size_t)config.out_size(), (TestType)0));
+    for(int n = 0; n < (int)frames.size(); ++n)
+    {
+        for(int fo = 0; fo < num_features_out; ++fo)
+        {
+            for(int co = 0; co < config.num_filters_out; ++co)
+            {
+                auto y = weights[1][co].get<TestType>();
+                for(int i = 0; i < config.kernel_size_time; ++i)
+                {
+                    const auto t = n - (config.kernel_size_time - 1 - i) * config.dilation;
+                    if(t < 0)
+                        continue;
+
+                    for(int kf = 0; kf < config.kernel_size_feature; ++kf)
+                    {
+                        const auto fi = fo * config.stride + kf - pad_left;
+                        if(fi < 0 || fi >= config.num_features_in)
+                            continue;
+
+                        for(int ci = 0; ci < config.num_filters_in; ++ci)
+                            y += weights[0][i][kf][ci][co].get<TestType>() * frames[t][fi * config.num_filters_in + ci];
+                    }
+                }
+
+                outs[n][fo * config.num_filters_out + co] = y;
+            }
+        }
+    }
+
+    return outs;
+}
+
+int conv2d_test()
+{
+    std::cout << "TESTING CONV2D..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    constexpr TestType threshold = 1.0e-12;
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto modelJson = conv2d_model_json();
+    const auto& jsonLayers = modelJson["layers"];
+
+    // reference model, computed offline
+    std::vector<TestType> yRefData(xData.size(), (TestType)0);
+    {
+        std::unique_ptr<RTNeural::Dense<TestType>> denseIn = RTNeural::json_parser::createDense<TestType>(1, conv1_config.in_size(), jsonLayers[0]["weights"]);
+        std::unique_ptr<RTNeural::Dense<TestType>> denseOut = RTNeural::json_parser::createDense<TestType>(conv2_config.out_size(), 1, jsonLayers[3]["weights"]);
+
+        std::vector<std::vector<TestType>> frames(xData.size(), std::vector<TestType>((size_t)conv1_config.in_size()));
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            denseIn->forward(input, frames[n].data());
+        }
+
+        auto conv1_outs = reference_conv2d(frames, conv1_config, jsonLayers[1]["weights"]);
+        for(auto& frame : conv1_outs)
+            for(auto& x : frame)
+                x = std::tanh(x);
+
+        auto conv2_outs = reference_conv2d(conv1_outs, conv2_config, jsonLayers[2]["weights"]);
+        for(size_t n = 0; n < xData.size(); ++n)
+            denseOut->forward(conv2_outs[n].data(), &yRefData[n]);
+    }
+
+    // non-templated model
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    {
+        std::cout << "Testing non-templated model" << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        model->reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = model->forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    {
+        std::cout << "Testing templated model" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 16>,
+            RTNeural::Conv2DT<TestType, 2, 3, 8, 3, 3, 2, 2, false>,
+            RTNeural::TanhActivationT<TestType, 12>,
+            RTNeural::Conv2DT<TestType, 3, 2, 4, 2, 3, 1, 1, true>,
+            RTNeural::DenseT<TestType, 4, 1>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        modelT.reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = modelT.forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+#endif
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace conv2d_test
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+#if RTNEURAL_DISPATCH_ENABLED
+#include <RTNeural/dispatch/layer_kernels.h>
+#endif
+
+namespace dispatch_test
+{
+
+using TestType = double;
+
+#if RTNEURAL_DISPATCH_ENABLED
+using RTNeural::dispatch::InstructionSet;
+
+/** Test data for the kernels, with sizes that are not a multiple of any vector width. */
+template <typename T>
+struct KernelTestData
+{
+    static constexpr int rows = 37;
+    static constexpr int cols = 19;
+
+    KernelTestData()
+    {
+        std::default_random_engine generator;
+        std::uniform_real_distribution<T> distribution((T)-1, (T)1);
+        for(auto* vec : { &A, &x, &y })
+            std::generate(vec->begin(), vec->end(), [&] { return distribution(generator); });
+    }
+
+    std::vector<T> A = std::vector<T>((size_t)(rows * cols));
+    std::vector<T> x = std::vector<T>((size_t)cols);
+    std::vector<T> y = std::vector<T>((size_t)rows);
+};
+
+/** Returns the outputs of the matrix kernels, for every matrix size from 0 to [rows][cols]. */
+template <typename T>
+std::vector<T> run_kernels(const RTNeural::dispatch::LayerKernels& kernels, const KernelTestData<T>& data)
+{
+    std::vector<T> outs;
+    for(int rows = 0; rows <= data.rows; ++rows)
+    {
+        for(int cols : { 0, 1, 7, 15, 16, 17, data.cols })
+        {
+            std::vector<T> y((size_t)rows);
+            kernels.matVec(data.A.data(), rows, cols, data.x.data(), y.data());
+            outs.insert(outs.end(), y.begin(), y.end());
+
+            y.assign(data.y.begin(), data.y.begin() + rows);
+            kernels.multiplyAddColumns(data.A.data(), rows, cols, data.x.data(), y.data());
+            outs.insert(outs.end(), y.begin(), y.end());
+        }
+    }
+
+    return outs;
+}
+
+/**
+ * Compares the kernels of the given instruction set against a reference
+ * implementation, and against the baseline kernels. The kernels do the same
+ * operations in the same order on every instruction set, and are compiled
+ * without floating-point contraction, so they should match the baseline exactly.
+ */
+template <typename T>
+int test_kernels(const RTNeural::dispatch::LayerKernels& kernels, const RTNeural::dispatch::LayerKernels& baselineKernels, T threshold)
+{
+    const KernelTestData<T> data;
+    constexpr auto rows = KernelTestData<T>::rows;
+    constexpr auto cols = KernelTestData<T>::cols;
+
+    std::vector<T> y((size_t)rows);
+    kernels.matVec(data.A.data(), rows, cols, data.x.data(), y.data());
+    std::vector<T> yRef((size_t)rows);
+    for(int i = 0; i < rows; ++i)
+        yRef[(size_t)i] = std::inner_product(data.x.begin(), data.x.end(), data.A.begin() + i * cols, (T)0);
+    int result = compare(y, yRef, threshold);
+
+    y = data.y;
+    kernels.multiplyAddColumns(data.A.data(), rows, cols, data.x.data(), y.data());
+    yRef = data.y;
+    for(int k = 0; k < cols; ++k)
+        for(int i = 0; i < rows; ++i)
+            yRef[(size_t)i] += data.A[(size_t)(k * rows + i)] * data.x[(size_t)k];
+    result |= compare(y, yRef, threshold);
+
+    if(run_kernels(kernels, data) != run_kernels(baselineKernels, data))
+    {
+        std::cout << "FAIL: " << RTNeural::dispatch::getInstructionSetName(kernels.getInstructionSet())
+                  << " kernels do not match the baseline kernels exactly!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+/** Runs a model with the current instruction set's kernels, and compares the output against the reference data from Python. */
+int test_model(const TestConfig& test)
+{
+    std::cout << "Testing " << test.name << " model with instruction set: "
+              << RTNeural::dispatch::getInstructionSetName(RTNeural::dispatch::getInstructionSet()) << std::endl;
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<TestType>(jsonStream);
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(run_model(*model, xData), yRefData, (TestType)test.threshold);
+}
+#endif
+
+int dispatch_test()
+{
+    std::cout << "TESTING RUNTIME DISPATCH..." << std::endl;
+
+    int result = 0;
+
+#if RTNEURAL_DISPATCH_ENABLED
+    const auto bestISA = RTNeural::dispatch::getBestInstructionSet();
+    std::cout << "Best available instruction set: " << RTNeural::dispatch::getInstructionSetName(bestISA) << std::endl;
+    if(! RTNeural::dispatch::isCompiled(bestISA) || ! RTNeural::dispatch::isSupported(bestISA) || RTNeural::dispatch::getInstructionSet() != bestISA)
+    {
+        std::cout << "FAIL: Best instruction set is not being used!" << std::endl;
+        return 1;
+    }
+
+    RTNeural::dispatch::setInstructionSet(InstructionSet::Baseline);
+    const RTNeural::dispatch::LayerKernels baselineKernels;
+    if(baselineKernels.getInstructionSet() != InstructionSet::Baseline)
+    {
+        std::cout << "FAIL: Baseline kernels are not being used!" << std::endl;
+        result |= 1;
+    }
+
+    for(auto isa : { InstructionSet::Baseline, InstructionSet::AVX2, InstructionSet::AVX512 })
+    {
+        const auto available = RTNeural::dispatch::isCompiled(isa) && RTNeural::dispatch::isSupported(isa);
+        if(RTNeural::dispatch::setInstructionSet(isa) != available)
+        {
+            std::cout << "FAIL: Unable to choose the " << RTNeural::dispatch::getInstructionSetName(isa) << " instruction set!" << std::endl;
+            result |= 1;
+            continue;
+        }
+
+        if(! available)
+        {
+            std::cout << RTNeural::dispatch::getInstructionSetName(isa) << " instruction set is not available, skipping..." << std::endl;
+            continue;
+        }
+
+        if(isa > bestISA || RTNeural::dispatch::getInstructionSet() != isa)
+        {
+            std::cout << "FAIL: Wrong instruction set!" << std::endl;
+            result |= 1;
+        }
+
+        // layers keep the kernels that they were constructed with
+        const RTNeural::dispatch::LayerKernels kernels;
+        if(kernels.getInstructionSet() != isa || baselineKernels.getInstructionSet() != InstructionSet::Baseline)
+        {
+            std::cout << "FAIL: Layer kernels use the wrong instruction set!" << std::endl;
+            result |= 1;
+        }
+
+        result |= test_kernels<float>(kernels, baselineKernels, 1.0e-5f);
+        result |= test_kernels<double>(kernels, baselineKernels, 1.0e-12);
+        for(auto testName : { "dense", "conv1d", "gru", "lstm" })
+            result |= test_model(tests.at(testName));
+    }
+
+    RTNeural::dispatch::setInstructionSet(bestISA);
+#else
+    std::cout << "Runtime dispatch is not enabled, skipping..." << std::endl;
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace dispatch_test
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace fixed_point_test
+{
+
+using TestType = double;
+
+// 32-bit format, with values in [-128, 128)
+using Fixed32 = RTNeural::FixedPoint<int32_t, 24>;
+
+// 16-bit format, with values in [-16, 16)
+using Fixed16 = RTNeural::FixedPoint<int16_t, 11>;
+
+// error bounds for the reference models
+constexpr TestType fixed32_threshold = 1.0e-5;
+constexpr TestType fixed16_threshold = 2.0e-3;
+
+/** Checks that the fixed-point arithmetic saturates and rounds correctly. */
+int test_arithmetic()
+{
+    std::cout << "Testing fixed-point arithmetic" << std::endl;
+    int result = 0;
+    const auto check = [&result](bool condition, const std::string& message) {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << std::endl;
+            result = 1;
+        }
+    };
+
+    using RTNeural::Q15;
+    check(Q15::fromFloat(0.5).raw == 16384, "Q15 conversion");
+    check(Q15::fromFloat(1.0) == Q15::maxValue(), "Q15 positive saturation");
+    check(Q15::fromFloat(-2.0) == Q15::minValue(), "Q15 negative saturation");
+    check((Q15::fromFloat(0.75) + Q15::fromFloat(0.75)) == Q15::maxValue(), "Q15 saturating addition");
+    check((Q15::fromFloat(-0.75) - Q15::fromFloat(0.75)) == Q15::minValue(), "Q15 saturating subtraction");
+    check((-Q15::minValue()) == Q15::maxValue(), "Q15 saturating negation");
+    check((Q15::fromFloat(0.5) * Q15::fromFloat(-0.5)).raw == -8192, "Q15 multiplication");
+    check((Q15::minValue() * Q15::minValue()) == Q15::maxValue(), "Q15 saturating multiplication");
+    check((Q15::fromRaw(1) * Q15::fromFloat(0.5)).raw == 1, "Q15 multiplication rounding");
+
+    using RTNeural::Q31;
+    check(Q31::fromFloat(-0.25).raw == -536870912, "Q31 conversion");
+    check((Q31::fromFloat(0.5) * Q31::fromFloat(0.5)).raw == 536870912, "Q31 multiplication");
+    check((Q31::maxValue() + Q31::fromRaw(1)) == Q31::maxValue(), "Q31 saturating addition");
+
+    // a sum of products that overflows the storage type is saturated once, at the end
+    RTNeural::FixedAccumulator<Fixed16> acc;
+    for(int i = 0; i < 8; ++i)
+        acc.mac(Fixed16::fromFloat(15.0), Fixed16::fromFloat(15.0));
+    for(int i = 0; i < 8; ++i)
+        acc.mac(Fixed16::fromFloat(15.0), Fixed16::fromFloat(-15.0));
+    acc.add(Fixed16::fromFloat(1.5));
+    check(acc.get() == Fixed16::fromFloat(1.5), "Accumulator headroom");
+
+    return result;
+}
+
+/** Checks the fixed-point sigmoid and tanh approximations against the exact functions. */
+int test_activations()
+{
+    std::cout << "Testing fixed-point activations" << std::endl;
+
+    constexpr int frac_bits = 24;
+    auto maxSigmoidError = (TestType)0;
+    auto maxTanhError = (TestType)0;
+    for(int64_t x = -((int64_t)20 << frac_bits); x <= ((int64_t)20 << frac_bits); x += 4099)
+    {
+        const auto xFloat = std::ldexp((TestType)x, -frac_bits);
+        const auto sigmoid = std::ldexp((TestType)RTNeural::fixed_point_maths::sigmoid(x, frac_bits), -31);
+        const auto tanh = std::ldexp((TestType)RTNeural::fixed_point_maths::tanh(x, frac_bits), -31);
+
+        maxSigmoidError = std::max(maxSigmoidError, std::abs(sigmoid - (TestType)1 / ((TestType)1 + std::exp(-xFloat))));
+        maxTanhError = std::max(maxTanhError, std::abs(tanh - std::tanh(xFloat)));
+    }
+
+    std::cout << "    Maximum sigmoid error: " << maxSigmoidError << std::endl;
+    std::cout << "    Maximum tanh error: " << maxTanhError << std::endl;
+
+    int result = 0;
+    if(maxSigmoidError > 3.0e-6 || maxTanhError > 6.0e-6)
+    {
+        std::cout << "FAIL: Activation error is larger than the error bound!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+/** Runs a fixed-point model against the python reference, and checks that the results are repeatable. */
+template <typename ModelType>
+int test_model(ModelType& model, const TestConfig& test, TestType threshold)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    model.parseJson(jsonStream, true);
+    model.reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    const auto yData = run_model(model, xData);
+    auto maxError = (TestType)0;
+    for(size_t n = 0; n < yData.size(); ++n)
+        maxError = std::max(maxError, std::abs(yData[n] - yRefData[n]));
+    std::cout << "    Maximum error: " << maxError << " (bound: " << threshold << ")" << std::endl;
+
+    int result = compare(yData, yRefData, threshold);
+
+    model.reset();
+    if(run_model(model, xData) != yData)
+    {
+        std::cout << "FAIL: Fixed-point model output is not repeatable!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+template <typename FixedType>
+int test_models(TestType threshold)
+{
+    int result = 0;
+
+    {
+        std::cout << "Testing fixed-point CONV1D model, with " << FixedType::total_bits << "-bit storage" << std::endl;
+        RTNeural::FixedModelT<FixedType, 1, 1,
+            RTNeural::FixedDenseT<FixedType, 1, 8>,
+            RTNeural::FixedTanhActivationT<FixedType, 8>,
+            RTNeural::FixedConv1DT<FixedType, 8, 4, 3, 2>,
+            RTNeural::FixedTanhActivationT<FixedType, 4>,
+            RTNeural::FixedDenseT<FixedType, 4, 8>,
+            RTNeural::FixedSigmoidActivationT<FixedType, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 1>>
+            model;
+        result |= test_model(model, tests.at("conv1d"), threshold);
+    }
+
+    {
+        std::cout << "Testing fixed-point GRU model, with " << FixedType::total_bits << "-bit storage" << std::endl;
+        RTNeural::FixedModelT<FixedType, 1, 1,
+            RTNeural::FixedDenseT<FixedType, 1, 8>,
+            RTNeural::FixedTanhActivationT<FixedType, 8>,
+            RTNeural::FixedGRULayerT<FixedType, 8, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 8>,
+            RTNeural::FixedSigmoidActivationT<FixedType, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 1>>
+            model;
+        result |= test_model(model, tests.at("gru"), threshold);
+    }
+
+    {
+        std::cout << "Testing fixed-point GRU-1D model, with " << FixedType::total_bits << "-bit storage" << std::endl;
+        RTNeural::FixedModelT<FixedType, 1, 1,
+            RTNeural::FixedGRULayerT<FixedType, 1, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 8>,
+            RTNeural::FixedSigmoidActivationT<FixedType, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 1>>
+            model;
+        result |= test_model(model, tests.at("gru_1d"), threshold);
+    }
+
+    {
+        std::cout << "Testing fixed-point LSTM model, with " << FixedType::total_bits << "-bit storage" << std::endl;
+        RTNeural::FixedModelT<FixedType, 1, 1,
+            RTNeural::FixedDenseT<FixedType, 1, 8>,
+            RTNeural::FixedTanhActivationT<FixedType, 8>,
+            RTNeural::FixedLSTMLayerT<FixedType, 8, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 1>>
+            model;
+        result |= test_model(model, tests.at("lstm"), threshold);
+    }
+
+    {
+        std::cout << "Testing fixed-point LSTM-1D model, with " << FixedType::total_bits << "-bit storage" << std::endl;
+        RTNeural::FixedModelT<FixedType, 1, 1,
+            RTNeural::FixedLSTMLayerT<FixedType, 1, 8>,
+            RTNeural::FixedDenseT<FixedType, 8, 1>>
+            model;
+        result |= test_model(model, tests.at("lstm_1d"), threshold);
+    }
+
+    return result;
+}
+
+int fixed_point_test()
+{
+    std::cout << "TESTING FIXED-POINT MODELS..." << std::endl;
+
+    int result = 0;
+    result |= test_arithmetic();
+    result |= test_activations();
+
+#if MODELT_AVAILABLE
+    result |= test_models<Fixed32>(fixed32_threshold);
+    result |= test_models<Fixed16>(fixed16_threshold);
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace fixed_point_test
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace half_precision_test
+{
+
+using TestType = double;
+
+// error bounds for the reference models, with fp16 and bf16 weights
+constexpr TestType fp16_threshold = 5.0e-4;
+constexpr TestType bf16_threshold = 5.0e-3;
+
+/** Checks the conversions to and from the half-precision types. */
+int test_conversions()
+{
+    std::cout << "Testing half-precision conversions" << std::endl;
+    int result = 0;
+    const auto check = [&result](bool condition, const std::string& message) {
+        if(!condition)
+        {
+            std::cout << "FAIL: " << message << std::endl;
+            result = 1;
+        }
+    };
+
+    using RTNeural::Float16;
+    check(Float16::fromFloat(1.0f).bits == 0x3C00, "fp16 conversion");
+    check(Float16::fromFloat(-2.0f).bits == 0xC000, "fp16 negative conversion");
+    check(Float16::fromFloat(65504.0f).bits == 0x7BFF, "fp16 largest value");
+    check(Float16::fromFloat(65520.0f).bits == 0x7C00, "fp16 overflow to infinity");
+    check(Float16::fromFloat(std::ldexp(1.0f, -14)).bits == 0x0400, "fp16 smallest normal value");
+    check(Float16::fromFloat(std::ldexp(1.0f, -24)).bits == 0x0001, "fp16 smallest subnormal value");
+    check(Float16::fromFloat(std::ldexp(1.0f, -25)).bits == 0x0000, "fp16 underflow (tie to even)");
+    check(Float16::fromFloat(1.0f + std::ldexp(1.0f, -11)).bits == 0x3C00, "fp16 rounding (tie to even)");
+    check(Float16::fromFloat(1.0f + 3.0f * std::ldexp(1.0f, -11)).bits == 0x3C02, "fp16 rounding (tie to even, upwards)");
+    check(std::isnan(Float16::fromFloat(std::numeric_limits<float>::quiet_NaN()).toFloat()), "fp16 NaN");
+
+    using RTNeural::BFloat16;
+    check(BFloat16::fromFloat(1.0f).bits == 0x3F80, "bf16 conversion");
+    check(BFloat16::fromFloat(-2.0f).bits == 0xC000, "bf16 negative conversion");
+    check(BFloat16::fromFloat(1.0f + std::ldexp(1.0f, -8)).bits == 0x3F80, "bf16 rounding (tie to even)");
+    check(BFloat16::fromFloat(1.0f + 3.0f * std::ldexp(1.0f, -8)).bits == 0x3F82, "bf16 rounding (tie to even, upwards)");
+    check(std::isnan(BFloat16::fromFloat(std::numeric_limits<float>::quiet_NaN()).toFloat()), "bf16 NaN");
+
+    // every (non-NaN) half-precision value should survive a round-trip through float
+    bool fp16RoundTrip = true;
+    bool bf16RoundTrip = true;
+    for(uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+    {
+        const auto fp16 = Float16 { (uint16_t)bits };
+        if(!std::isnan(fp16.toFloat()))
+            fp16RoundTrip &= Float16::fromFloat(fp16.toFloat()).bits == fp16.bits;
+
+        const auto bf16 = BFloat16 { (uint16_t)bits };
+        if(!std::isnan(bf16.toFloat()))
+            bf16RoundTrip &= BFloat16::fromFloat(bf16.toFloat()).bits == bf16.bits;
+    }
+
+    check(fp16RoundTrip, "fp16 round-trip");
+    check(bf16RoundTrip, "bf16 round-trip");
+
+    return result;
+}
+
+/** Returns true if a layer of a dynamic model stores its weights with HalfType. */
+template <typename HalfType>
+bool is_half_layer(RTNeural::Layer<TestType>* layer)
+{
+    return dynamic_cast<RTNeural::HalfDense<TestType, HalfType>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::HalfConv1D<TestType, HalfType>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::HalfGRULayer<TestType, HalfType>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::HalfLSTMLayer<TestType, HalfType>*>(layer) != nullptr;
+}
+
+/**
+ * Loads a model with a "weight_storage" field on every layer, checks that
+ * the half-precision layers are created, and checks the model against the
+ * floating-point reference.
+ */
+template <typename HalfType>
+int test_json(const TestConfig& test, const std::string& storage, int expectedHalfLayers, TestType threshold,
+    std::vector<TestType>& yData)
+{
+    std::cout << "Testing " << test.name << " model with " << storage << " weights from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+    for(auto& layer : modelJson["layers"])
+        layer["weight_storage"] = storage;
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    const auto numHalfLayers = (int)std::count_if(model->layers.begin(), model->layers.end(), is_half_layer<HalfType>);
+    if(numHalfLayers != expectedHalfLayers)
+    {
+        std::cout << "FAIL: Expected " << expectedHalfLayers << " half-precision layers, found " << numHalfLayers << std::endl;
+        return 1;
+    }
+
+    yData = run_model(*model, xData);
+    auto maxError = (TestType)0;
+    for(size_t n = 0; n < yData.size(); ++n)
+        maxError = std::max(maxError, std::abs(yData[n] - yRefData[n]));
+    std::cout << "    Maximum error: " << maxError << " (bound: " << threshold << ")" << std::endl;
+
+    return compare(yData, yRefData, threshold);
+}
+
+#if MODELT_AVAILABLE
+/** Runs a templated model with half-precision layers, and compares it to the equivalent dynamic model. */
+template <typename ModelType>
+int test_templated(ModelType& modelT, const TestConfig& test, const std::vector<TestType>& yDynamic)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    modelT.parseJson(jsonStream, true);
+    modelT.reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    return compare(run_model(modelT, xData), yDynamic, (TestType)1.0e-12);
+}
+#endif
+
+template <typename HalfType>
+int test_models(const std::string& storage, TestType threshold)
+{
+    int result = 0;
+    std::vector<TestType> yDynamic;
+
+    result |= test_json<HalfType>(tests.at("dense"), storage, 5, threshold, yDynamic);
+
+    result |= test_json<HalfType>(tests.at("conv1d"), storage, 4, threshold, yDynamic);
+#if MODELT_AVAILABLE
+    {
+        std::cout << "Testing templated CONV1D model with " << storage << " weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::HalfDenseT<TestType, 1, 8, HalfType>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::HalfConv1DT<TestType, 8, 4, 3, 2, HalfType>,
+            RTNeural::TanhActivationT<TestType, 4>,
+            RTNeural::HalfDenseT<TestType, 4, 8, HalfType>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::HalfDenseT<TestType, 8, 1, HalfType>>
+            modelT;
+        result |= test_templated(modelT, tests.at("conv1d"), yDynamic);
+    }
+#endif
+
+    result |= test_json<HalfType>(tests.at("gru"), storage, 4, threshold, yDynamic);
+#if MODELT_AVAILABLE
+    {
+        std::cout << "Testing templated GRU model with " << storage << " weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::HalfDenseT<TestType, 1, 8, HalfType>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::HalfGRULayerT<TestType, 8, 8, HalfType>,
+            RTNeural::HalfDenseT<TestType, 8, 8, HalfType>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::HalfDenseT<TestType, 8, 1, HalfType>>
+            modelT;
+        result |= test_templated(modelT, tests.at("gru"), yDynamic);
+    }
+#endif
+
+    result |= test_json<HalfType>(tests.at("gru_1d"), storage, 3, threshold, yDynamic);
+
+    result |= test_json<HalfType>(tests.at("lstm"), storage, 3, threshold, yDynamic);
+#if MODELT_AVAILABLE
+    {
+        std::cout << "Testing templated LSTM model with " << storage << " weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::HalfDenseT<TestType, 1, 8, HalfType>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::HalfLSTMLayerT<TestType, 8, 8, HalfType>,
+            RTNeural::HalfDenseT<TestType, 8, 1, HalfType>>
+            modelT;
+        result |= test_templated(modelT, tests.at("lstm"), yDynamic);
+    }
+#endif
+
+    result |= test_json<HalfType>(tests.at("lstm_1d"), storage, 2, threshold, yDynamic);
+
+    return result;
+}
+
+int half_precision_test()
+{
+    std::cout << "TESTING HALF-PRECISION WEIGHTS..." << std::endl;
+
+    int result = 0;
+    result |= test_conversions();
+    result |= test_models<RTNeural::Float16>("fp16", fp16_threshold);
+    result |= test_models<RTNeural::BFloat16>("bf16", bf16_threshold);
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace half_precision_test
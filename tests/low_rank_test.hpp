@@ -0,0 +1,178 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace low_rank_test
+{
+
+using TestType = double;
+
+constexpr TestType threshold = 1.0e-12;
+
+/** Checks a LowRankDense layer against a Dense layer with the product of the low-rank factors as weights. */
+int test_layer()
+{
+    std::cout << "Testing LowRankDense layer" << std::endl;
+
+    constexpr int in_size = 13;
+    constexpr int out_size = 7;
+    constexpr int rank = 3;
+    constexpr int nIter = 100;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution((TestType)-1, (TestType)1);
+
+    std::vector<std::vector<TestType>> vWeights(rank, std::vector<TestType>(in_size, (TestType)0));
+    for(auto& row : vWeights)
+        for(auto& w : row)
+            w = distribution(generator);
+
+    std::vector<std::vector<TestType>> uWeights(out_size, std::vector<TestType>(rank, (TestType)0));
+    for(auto& row : uWeights)
+        for(auto& w : row)
+            w = distribution(generator);
+
+    std::vector<std::vector<TestType>> weights(out_size, std::vector<TestType>(in_size, (TestType)0));
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int r = 0; r < rank; ++r)
+                weights[(size_t)i][(size_t)k] += uWeights[(size_t)i][(size_t)r] * vWeights[(size_t)r][(size_t)k];
+
+    std::vector<TestType> bias(out_size, (TestType)0);
+    for(auto& b : bias)
+        b = distribution(generator);
+
+    RTNeural::Dense<TestType> dense { in_size, out_size };
+    dense.setWeights(weights);
+    dense.setBias(bias.data());
+
+    RTNeural::LowRankDense<TestType> lowRank { in_size, out_size, rank };
+    lowRank.setVWeights(vWeights);
+    lowRank.setUWeights(uWeights);
+    lowRank.setBias(bias.data());
+
+    TestType ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    TestType denseOuts alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    TestType lowRankOuts alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    auto maxError = (TestType)0;
+    for(int n = 0; n < nIter; ++n)
+    {
+        for(auto& x : ins)
+            x = distribution(generator);
+
+        dense.forward(ins, denseOuts);
+        lowRank.forward(ins, lowRankOuts);
+        for(int i = 0; i < out_size; ++i)
+            maxError = std::max(maxError, std::abs(denseOuts[i] - lowRankOuts[i]));
+    }
+
+    if(maxError > threshold)
+    {
+        std::cout << "FAIL: Low-rank layer output is incorrect! Maximum error: " << maxError << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Stores the 8x8 dense layers of a model as two factors, where the
+ * first factor is the identity matrix, and the second factor is the
+ * original kernel, so that the model output is unchanged.
+ */
+nlohmann::json load_factorized_model(const TestConfig& test)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    for(auto& layer : modelJson["layers"])
+    {
+        const auto& kernel = layer["weights"][0]; // kernel[in_size][out_size]
+        const auto in_size = kernel.size();
+        if(in_size != 8 || kernel[0].size() != 8)
+            continue;
+
+        auto identity = nlohmann::json::array();
+        for(size_t i = 0; i < in_size; ++i)
+        {
+            identity.push_back(nlohmann::json::array());
+            for(size_t j = 0; j < in_size; ++j)
+                identity[i].push_back(i == j ? 1.0 : 0.0);
+        }
+
+        layer["weights"] = { identity, kernel, layer["weights"][1] };
+        layer["rank"] = in_size;
+    }
+
+    return modelJson;
+}
+
+int test_factorized_model()
+{
+    const auto& test = tests.at("dense");
+    std::cout << "Testing factorized " << test.name << " model from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    const auto modelJson = load_factorized_model(test);
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    const auto numLowRankLayers = std::count_if(model->layers.begin(), model->layers.end(), [](RTNeural::Layer<TestType>* layer) {
+        return dynamic_cast<RTNeural::LowRankDense<TestType>*>(layer) != nullptr;
+    });
+    if(numLowRankLayers != 3)
+    {
+        std::cout << "FAIL: Expected 3 low-rank layers, found " << numLowRankLayers << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    const auto yData = run_model(*model, xData);
+    result |= compare(yData, yRefData, (TestType)test.threshold);
+
+#if MODELT_AVAILABLE
+    {
+        std::cout << "Testing factorized templated " << test.name << " model" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::LowRankDenseT<TestType, 8, 8, 8>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::LowRankDenseT<TestType, 8, 8, 8>,
+            RTNeural::ELuActivationT<TestType, 8>,
+            RTNeural::LowRankDenseT<TestType, 8, 8, 8>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        modelT.reset();
+        result |= compare(run_model(modelT, xData), yData, threshold);
+    }
+#endif
+
+    return result;
+}
+
+int low_rank_test()
+{
+    std::cout << "TESTING LOW-RANK LAYERS..." << std::endl;
+
+    int result = 0;
+    result |= test_layer();
+    result |= test_factorized_model();
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace low_rank_test
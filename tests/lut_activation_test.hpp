@@ -0,0 +1,193 @@
+#pragma once
+
+#include <limits>
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace lut_activation_test
+{
+
+using TestType = double;
+
+constexpr TestType model_threshold = 2.0e-4;
+
+/** Checks that a dynamic lookup-table activation stays within its error bound. */
+template <typename LUTFunction>
+int test_lut_accuracy(TestType expectedMaxError)
+{
+    constexpr int layerSize = 8;
+    constexpr int nIter = 1000;
+
+    RTNeural::LUTActivation<TestType, LUTFunction> layer { layerSize };
+    std::cout << "Testing " << layer.getName() << " lookup table, error bound: " << layer.getMaxError() << std::endl;
+    if(layer.getMaxError() > expectedMaxError)
+    {
+        std::cout << "FAIL: Error bound is too high!" << std::endl;
+        return 1;
+    }
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution((TestType)-20, (TestType)20);
+
+    TestType ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[layerSize];
+    TestType outs alignas(RTNEURAL_DEFAULT_ALIGNMENT)[layerSize];
+    auto maxError = (TestType)0;
+    for(int i = 0; i < nIter; ++i)
+    {
+        for(auto& x : ins)
+            x = distribution(generator);
+
+        layer.forward(ins, outs);
+        for(int n = 0; n < layerSize; ++n)
+            maxError = std::max(maxError, std::abs(outs[n] - LUTFunction::compute(ins[n])));
+    }
+
+    std::cout << "    Maximum error: " << maxError << std::endl;
+    if(maxError > layer.getMaxError())
+    {
+        std::cout << "FAIL: Error is larger than the error bound!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Loads a model with "activation_lut" fields, and checks that the lookup-table layers are created. */
+int test_json_opt_in(const TestConfig& test, const std::vector<TestType>& xData, const std::vector<TestType>& yRefData)
+{
+    std::cout << "Testing " << test.name << " model with lookup-table activations from json" << std::endl;
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+    for(auto& layer : modelJson["layers"])
+        layer["activation_lut"] = { { "size", 2048 } };
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    int numLUTLayers = 0;
+    for(auto* layer : model->layers)
+    {
+        if(dynamic_cast<RTNeural::TanhLUTActivation<TestType>*>(layer) != nullptr
+            || dynamic_cast<RTNeural::ELuLUTActivation<TestType>*>(layer) != nullptr)
+            numLUTLayers++;
+    }
+
+    // dense.json has one tanh and one elu activation
+    if(numLUTLayers != 2)
+    {
+        std::cout << "FAIL: Expected 2 lookup-table layers, found " << numLUTLayers << std::endl;
+        return 1;
+    }
+
+    return compare(run_model(*model, xData), yRefData, model_threshold);
+}
+
+#if MODELT_AVAILABLE
+/** Checks that a templated lookup-table activation maps NaN and infinite inputs into the table, like the dynamic layer. */
+template <typename LUTFunction, typename LayerType>
+int test_non_finite_inputs()
+{
+    constexpr int layerSize = 8;
+
+    RTNeural::LUTActivation<TestType, LUTFunction> refLayer { layerSize };
+    RTNeural::ModelT<TestType, layerSize, layerSize, LayerType> modelT;
+    std::cout << "Testing templated " << refLayer.getName() << " lookup table with non-finite inputs" << std::endl;
+
+    const auto nan = std::numeric_limits<TestType>::quiet_NaN();
+    const auto inf = std::numeric_limits<TestType>::infinity();
+    TestType ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[layerSize] { nan, inf, -inf, (TestType)0, (TestType)100, (TestType)-100, nan, (TestType)0.5 };
+    TestType refOuts alignas(RTNEURAL_DEFAULT_ALIGNMENT)[layerSize];
+
+    refLayer.forward(ins, refOuts);
+    modelT.reset();
+    modelT.forward(ins);
+    const auto* outs = modelT.getOutputs();
+
+    for(int n = 0; n < layerSize; ++n)
+    {
+        if(outs[n] != refOuts[n] && !(std::abs(outs[n] - refOuts[n]) < (TestType)1.0e-12))
+        {
+            std::cout << "FAIL: Output " << n << " for input " << ins[n] << " is " << outs[n] << ", expected " << refOuts[n] << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+int lut_activation_test()
+{
+    std::cout << "TESTING LOOKUP-TABLE ACTIVATIONS..." << std::endl;
+
+    int result = 0;
+    result |= test_lut_accuracy<RTNeural::lut_detail::TanhLUTFunction<TestType>>(2.4e-5);
+    result |= test_lut_accuracy<RTNeural::lut_detail::SigmoidLUTFunction<TestType>>(1.2e-5);
+    result |= test_lut_accuracy<RTNeural::lut_detail::ELuLUTFunction<TestType>>(3.1e-5);
+
+    const auto& denseTest = tests.at("dense");
+    std::ifstream pythonX(denseTest.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(denseTest.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    result |= test_json_opt_in(denseTest, xData, yRefData);
+
+#if MODELT_AVAILABLE
+    result |= test_non_finite_inputs<RTNeural::lut_detail::TanhLUTFunction<TestType>, RTNeural::TanhLUTActivationT<TestType, 8>>();
+    result |= test_non_finite_inputs<RTNeural::lut_detail::SigmoidLUTFunction<TestType>, RTNeural::SigmoidLUTActivationT<TestType, 8>>();
+    result |= test_non_finite_inputs<RTNeural::lut_detail::ELuLUTFunction<TestType>, RTNeural::ELuLUTActivationT<TestType, 8>>();
+
+    {
+        std::cout << "Testing templated DENSE model with lookup-table activations" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhLUTActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::ELuLUTActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+
+        std::ifstream jsonStream(denseTest.model_file, std::ifstream::binary);
+        modelT.parseJson(jsonStream);
+        modelT.reset();
+        result |= compare(run_model(modelT, xData), yRefData, model_threshold);
+    }
+
+    {
+        const auto& gruTest = tests.at("gru");
+        std::cout << "Testing templated GRU model with lookup-table activations" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhLUTActivationT<TestType, 8>,
+            RTNeural::GRULayerT<TestType, 8, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidLUTActivationT<TestType, 8, 4096>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+
+        std::ifstream jsonStream(gruTest.model_file, std::ifstream::binary);
+        modelT.parseJson(jsonStream);
+        modelT.reset();
+
+        std::ifstream gruX(gruTest.x_data_file);
+        std::ifstream gruY(gruTest.y_data_file);
+        result |= compare(run_model(modelT, load_csv::loadFile<TestType>(gruX)), load_csv::loadFile<TestType>(gruY), model_threshold);
+    }
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace lut_activation_test
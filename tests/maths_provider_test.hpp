@@ -0,0 +1,174 @@
+#pragma once
+
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace maths_provider_test
+{
+
+using TestType = double;
+
+/** Creates a dynamic activation layer that uses the given maths provider. */
+template <typename MathsProvider>
+std::unique_ptr<RTNeural::Activation<TestType>> create_activation(const std::string& type, int size)
+{
+    if(type == "tanh")
+        return std::make_unique<RTNeural::TanhActivation<TestType, MathsProvider>>(size);
+    if(type == "sigmoid")
+        return std::make_unique<RTNeural::SigmoidActivation<TestType, MathsProvider>>(size);
+    if(type == "elu")
+        return std::make_unique<RTNeural::ELuActivation<TestType, MathsProvider>>(size);
+    if(type == "softmax")
+        return std::make_unique<RTNeural::SoftmaxActivation<TestType, MathsProvider>>(size);
+
+    return std::make_unique<RTNeural::ReLuActivation<TestType>>(size);
+}
+
+/** Builds a dynamic model from a json file, with recurrent and activation layers that use the given maths provider. */
+template <typename MathsProvider>
+std::unique_ptr<RTNeural::Model<TestType>> load_dynamic_model(const TestConfig& test)
+{
+    using namespace RTNeural::json_parser;
+
+    const auto modelJson = load_model_json(test);
+    auto model = std::make_unique<RTNeural::Model<TestType>>(modelJson["in_shape"].back().get<int>());
+    for(const auto& l : modelJson["layers"])
+    {
+        const auto type = l["type"].get<std::string>();
+        const auto layerDims = l["shape"].back().get<int>();
+        const auto& weights = l["weights"];
+
+        if(type == "gru")
+        {
+            auto gru = std::make_unique<RTNeural::GRULayer<TestType, MathsProvider>>(model->getNextInSize(), layerDims);
+            loadGRU<TestType>(*gru, weights);
+            model->addLayer(gru.release());
+        }
+        else if(type == "lstm")
+        {
+            auto lstm = std::make_unique<RTNeural::LSTMLayer<TestType, MathsProvider>>(model->getNextInSize(), layerDims);
+            loadLSTM<TestType>(*lstm, weights);
+            model->addLayer(lstm.release());
+        }
+        else
+        {
+            model->addLayer(createDense<TestType>(model->getNextInSize(), layerDims, weights).release());
+
+            // the recurrent layers apply their own activations, so only dense layers are followed by one
+            if(l.contains("activation") && !l["activation"].get<std::string>().empty())
+                model->addLayer(create_activation<MathsProvider>(l["activation"].get<std::string>(), layerDims).release());
+        }
+    }
+
+    return model;
+}
+
+/** Runs a dynamic model, and compares the output against the reference data from Python. */
+template <typename MathsProvider>
+int run_dynamic_model(const TestConfig& test, const std::string& providerName, TestType threshold)
+{
+    std::cout << "Testing dynamic " << test.name << " model with " << providerName << std::endl;
+
+    auto model = load_dynamic_model<MathsProvider>(test);
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(::run_model(*model, xData), yRefData, threshold);
+}
+
+#if MODELT_AVAILABLE
+template <typename MathsProvider>
+using DenseModel = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 8>,
+    RTNeural::ReLuActivationT<TestType, 8>,
+    RTNeural::DenseT<TestType, 8, 8>,
+    RTNeural::ELuActivationT<TestType, 8, 1, 1, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 8>,
+    RTNeural::SoftmaxActivationT<TestType, 8, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+
+template <typename MathsProvider>
+using GRUModel = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8, MathsProvider>,
+    RTNeural::GRULayerT<TestType, 8, 8, RTNeural::SampleRateCorrectionMode::None, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 8>,
+    RTNeural::SigmoidActivationT<TestType, 8, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+
+template <typename MathsProvider>
+using LSTMModel = RTNeural::ModelT<TestType, 1, 1,
+    RTNeural::DenseT<TestType, 1, 8>,
+    RTNeural::TanhActivationT<TestType, 8, MathsProvider>,
+    RTNeural::LSTMLayerT<TestType, 8, 8, RTNeural::SampleRateCorrectionMode::None, MathsProvider>,
+    RTNeural::DenseT<TestType, 8, 1>>;
+
+/** Runs a templated model, and compares the output against the reference data from Python. */
+template <typename ModelType>
+int run_model(const TestConfig& test, const std::string& providerName, TestType threshold)
+{
+    std::cout << "Testing " << test.name << " model with " << providerName << std::endl;
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    ModelType model;
+    model.parseJson(jsonStream);
+    model.reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        TestType input[] = { xData[n] };
+        yData[n] = model.forward(input);
+    }
+
+    return compare(yData, yRefData, threshold);
+}
+
+#endif
+
+template <typename MathsProvider>
+int run_provider(const std::string& providerName, TestType threshold)
+{
+    int result = 0;
+    for(const auto* name : { "dense", "gru", "lstm" })
+        result |= run_dynamic_model<MathsProvider>(tests.at(name), providerName, threshold);
+
+#if MODELT_AVAILABLE
+    result |= run_model<DenseModel<MathsProvider>>(tests.at("dense"), providerName, threshold);
+    result |= run_model<GRUModel<MathsProvider>>(tests.at("gru"), providerName, threshold);
+    result |= run_model<LSTMModel<MathsProvider>>(tests.at("lstm"), providerName, threshold);
+#endif
+    return result;
+}
+
+int maths_provider_test()
+{
+    std::cout << "TESTING MATHS PROVIDERS..." << std::endl;
+
+    int result = 0;
+
+    result |= run_provider<RTNeural::DefaultMathsProvider>("DefaultMathsProvider", 5.0e-6);
+    result |= run_provider<RTNeural::PadeMathsProvider>("PadeMathsProvider", 5.0e-4);
+    result |= run_provider<RTNeural::PolynomialMathsProvider>("PolynomialMathsProvider", 5.0e-4);
+    result |= run_provider<RTNeural::BitTrickMathsProvider>("BitTrickMathsProvider", 1.0e-1);
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace maths_provider_test
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <RTNeural.h>
+#include "conv2d_test.hpp"
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include "wavenet_test.hpp"
+
+namespace parallel_loading_test
+{
+
+using TestType = double;
+
+constexpr TestType threshold = 1.0e-12;
+constexpr int numThreads = 4;
+
+/** Loads a model on multiple threads, and checks that it matches the model loaded on a single thread. */
+int test_model_json(const std::string& name, const nlohmann::json& modelJson, int threads)
+{
+    std::cout << "Testing " << name << " model loaded on " << threads << " threads" << std::endl;
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, false, threads);
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+
+    int result = 0;
+    if(model->layers.size() != refModel->layers.size())
+    {
+        std::cout << "FAIL: Expected " << refModel->layers.size() << " layers, found " << model->layers.size() << std::endl;
+        return 1;
+    }
+
+    for(size_t i = 0; i < model->layers.size(); ++i)
+    {
+        if(model->layers[i]->getName() != refModel->layers[i]->getName() || model->layers[i]->in_size != refModel->layers[i]->in_size)
+        {
+            std::cout << "FAIL: Layer " << i << " should be a " << refModel->layers[i]->getName() << " layer" << std::endl;
+            result = 1;
+        }
+    }
+
+    std::ifstream pythonX(tests.at("dense").x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    result |= compare(run_model(*model, xData), run_model(*refModel, xData), threshold);
+
+    return result;
+}
+
+int test_model(const TestConfig& test, int threads)
+{
+    return test_model_json(test.name, load_model_json(test), threads);
+}
+
+/** Checks that errors from loading a layer are passed on to the calling thread. */
+int test_invalid_weights()
+{
+    std::cout << "Testing invalid model loaded on " << numThreads << " threads" << std::endl;
+
+    auto modelJson = load_model_json(tests.at("gru"));
+    modelJson["layers"][1]["weights"] = "invalid";
+
+    try
+    {
+        RTNeural::json_parser::parseJson<TestType>(modelJson, false, numThreads);
+    }
+    catch(const nlohmann::json::exception&)
+    {
+        return 0;
+    }
+
+    std::cout << "FAIL: Loading invalid weights should throw an exception!" << std::endl;
+    return 1;
+}
+
+#if MODELT_AVAILABLE
+int test_templated_model()
+{
+    const auto& test = tests.at("gru");
+    std::cout << "Testing templated " << test.name << " model loaded on " << numThreads << " threads" << std::endl;
+
+    using ModelType = RTNeural::ModelT<TestType, 1, 1,
+        RTNeural::DenseT<TestType, 1, 8>,
+        RTNeural::TanhActivationT<TestType, 8>,
+        RTNeural::GRULayerT<TestType, 8, 8>,
+        RTNeural::DenseT<TestType, 8, 8>,
+        RTNeural::SigmoidActivationT<TestType, 8>,
+        RTNeural::DenseT<TestType, 8, 1>>;
+
+    const auto modelJson = load_model_json(test);
+    ModelType model;
+    model.parseJson(modelJson, false, {}, numThreads);
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(run_model(model, xData), yRefData, (TestType)test.threshold);
+}
+#endif
+
+int parallel_loading_test()
+{
+    std::cout << "TESTING PARALLEL MODEL LOADING..." << std::endl;
+
+    int result = 0;
+    for(const auto* name : { "dense", "conv1d", "gru", "gru_1d", "lstm", "lstm_1d" })
+        result |= test_model(tests.at(name), numThreads);
+
+    result |= test_model(tests.at("lstm"), 0);
+    result |= test_model_json("Conv2D", conv2d_test::conv2d_model_json(), numThreads);
+
+    result |= test_model_json("WaveNet", wavenet_test::wavenet_model_json(), numThreads);
+
+    result |= test_invalid_weights();
+
+#if MODELT_AVAILABLE
+    result |= test_templated_model();
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace parallel_loading_test
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace quantized_test
+{
+
+using TestType = double;
+
+// error bounds for the reference models, with int8 weights
+constexpr TestType dense_threshold = 1.0e-3;
+constexpr TestType conv1d_threshold = 5.0e-3;
+
+// error bounds for the recurrent reference models, with int8 and int16 weights
+constexpr TestType recurrent_int8_threshold = 5.0e-3;
+constexpr TestType recurrent_int16_threshold = 5.0e-6;
+
+bool is_quantizable(const nlohmann::json& layer)
+{
+    const auto type = layer["type"].get<std::string>();
+    return type == "dense" || type == "time-distributed-dense" || type == "conv1d";
+}
+
+/** Quantizes the layer kernels in the same way as `model_utils.py` (with `quantize='int8'`). */
+void prequantize_model(nlohmann::json& modelJson)
+{
+    for(auto& layer : modelJson["layers"])
+    {
+        if(!is_quantizable(layer))
+            continue;
+
+        // flatten the kernel into [channel_size][num_channels]
+        std::vector<nlohmann::json*> rows;
+        std::function<void(nlohmann::json&)> collectRows = [&](nlohmann::json& k) {
+            if(k.front().is_number())
+                rows.push_back(&k);
+            else
+                for(auto& sub : k)
+                    collectRows(sub);
+        };
+        collectRows(layer["weights"][0]);
+
+        const auto num_channels = rows.front()->size();
+        std::vector<double> scales(num_channels, 0.0);
+        for(auto* row : rows)
+            for(size_t j = 0; j < num_channels; ++j)
+                scales[j] = std::max(scales[j], std::abs((*row)[j].get<double>()));
+
+        for(auto& s : scales)
+            s = s > 0.0 ? s / 127.0 : 1.0;
+
+        for(auto* row : rows)
+            for(size_t j = 0; j < num_channels; ++j)
+                (*row)[j] = (int)std::round((*row)[j].get<double>() / scales[j]);
+
+        layer["quantization"] = { { "type", "int8" }, { "scales", scales } };
+    }
+}
+
+/** Counts the quantized layers in a dynamic model. */
+int count_quantized_layers(const RTNeural::Model<TestType>& model)
+{
+    int numQuantizedLayers = 0;
+    for(auto* layer : model.layers)
+    {
+        if(dynamic_cast<RTNeural::QuantizedDense<TestType>*>(layer) != nullptr
+            || dynamic_cast<RTNeural::QuantizedConv1D<TestType>*>(layer) != nullptr)
+            numQuantizedLayers++;
+    }
+
+    return numQuantizedLayers;
+}
+
+/**
+ * Loads a model with "quantization" fields, and checks that the quantized
+ * layers are created, and that they produce the same outputs as the weights
+ * that were quantized ahead of time.
+ */
+int test_json_opt_in(const TestConfig& test, int expectedQuantizedLayers, TestType threshold)
+{
+    std::cout << "Testing " << test.name << " model with int8 weights from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    auto modelJson = load_model_json(test);
+    for(auto& layer : modelJson["layers"])
+        if(is_quantizable(layer))
+            layer["quantization"] = "int8";
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    const auto numQuantizedLayers = count_quantized_layers(*model);
+    if(numQuantizedLayers != expectedQuantizedLayers)
+    {
+        std::cout << "FAIL: Expected " << expectedQuantizedLayers << " quantized layers, found " << numQuantizedLayers << std::endl;
+        return 1;
+    }
+
+    const auto yData = run_model(*model, xData);
+    auto maxError = (TestType)0;
+    for(size_t n = 0; n < yData.size(); ++n)
+        maxError = std::max(maxError, std::abs(yData[n] - yRefData[n]));
+    std::cout << "    Maximum error: " << maxError << " (bound: " << threshold << ")" << std::endl;
+
+    int result = compare(yData, yRefData, threshold);
+
+    std::cout << "Testing " << test.name << " model with pre-quantized int8 weights from json" << std::endl;
+    auto prequantizedJson = load_model_json(test);
+    prequantize_model(prequantizedJson);
+
+    auto prequantizedModel = RTNeural::json_parser::parseJson<TestType>(prequantizedJson, true);
+    prequantizedModel->reset();
+    if(count_quantized_layers(*prequantizedModel) != expectedQuantizedLayers)
+    {
+        std::cout << "FAIL: Pre-quantized layers were not loaded as quantized layers!" << std::endl;
+        result = 1;
+    }
+
+    result |= compare(run_model(*prequantizedModel, xData), yData, (TestType)1.0e-12);
+
+    return result;
+}
+
+/** Checks that the quantized weights are within half a quantization step of the original weights. */
+int test_weights()
+{
+    std::cout << "Testing int8 weight quantization" << std::endl;
+
+    constexpr int in_size = 5;
+    constexpr int out_size = 3;
+    std::vector<std::vector<TestType>> weights(out_size, std::vector<TestType>(in_size));
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            weights[i][k] = std::sin((TestType)(i * in_size + k)) * (TestType)(i + 1);
+    weights[1] = std::vector<TestType>(in_size, (TestType)0); // a channel with all-zero weights
+
+    RTNeural::QuantizedDense<TestType> dense { in_size, out_size };
+    dense.setWeights(weights);
+
+    int result = 0;
+    for(int i = 0; i < out_size; ++i)
+    {
+        auto maxAbs = (TestType)0;
+        for(auto w : weights[i])
+            maxAbs = std::max(maxAbs, std::abs(w));
+
+        const auto scale = maxAbs > (TestType)0 ? maxAbs / (TestType)127 : (TestType)1;
+        for(int k = 0; k < in_size; ++k)
+        {
+            if(std::abs(dense.getWeight(i, k) - weights[i][k]) > (TestType)0.5 * scale * ((TestType)1 + 1.0e-12))
+            {
+                std::cout << "FAIL: Quantized weight (" << i << ", " << k << ") is out of range!" << std::endl;
+                result = 1;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Checks that non-finite and out-of-range values are quantized with saturation. */
+int test_quantize_limits()
+{
+    std::cout << "Testing quantization of non-finite values" << std::endl;
+
+    using RTNeural::quantization_detail::quantize;
+    constexpr auto inf = std::numeric_limits<TestType>::infinity();
+    constexpr auto nan = std::numeric_limits<TestType>::quiet_NaN();
+
+    int result = 0;
+    const auto check = [&result](int q, int expected, const char* description)
+    {
+        if(q != expected)
+        {
+            std::cout << "FAIL: Quantizing " << description << " gave " << q << ", expected " << expected << std::endl;
+            result = 1;
+        }
+    };
+
+    check(quantize<int8_t>((TestType)1.0e12, (TestType)1), 127, "a large value (int8)");
+    check(quantize<int8_t>((TestType)-1.0e12, (TestType)1), -127, "a large negative value (int8)");
+    check(quantize<int8_t>(inf, (TestType)1), 127, "infinity (int8)");
+    check(quantize<int8_t>(-inf, (TestType)1), -127, "negative infinity (int8)");
+    check(quantize<int8_t>(nan, (TestType)1), 0, "NaN (int8)");
+    check(quantize<int8_t>((TestType)1, inf), 127, "a value with an infinite scale (int8)");
+    check(quantize<int16_t>((TestType)1.0e12, (TestType)1), 32767, "a large value (int16)");
+    check(quantize<int16_t>(-inf, (TestType)1), -32767, "negative infinity (int16)");
+    check(quantize<int16_t>(nan, (TestType)1), 0, "NaN (int16)");
+    check(quantize<int8_t>((TestType)-2.5, (TestType)1), -3, "-2.5 (int8)");
+
+    return result;
+}
+
+/** Returns true if a layer of a dynamic model is a quantized recurrent layer with QType weights. */
+template <typename QType>
+bool is_quantized_recurrent(RTNeural::Layer<TestType>* layer)
+{
+    return dynamic_cast<RTNeural::QuantizedGRULayer<TestType, QType>*>(layer) != nullptr
+        || dynamic_cast<RTNeural::QuantizedLSTMLayer<TestType, QType>*>(layer) != nullptr;
+}
+
+/**
+ * Loads a recurrent model with a "quantization" field on the recurrent layer,
+ * and checks the quantized model against the floating-point reference.
+ */
+template <typename QType>
+int test_recurrent_json(const TestConfig& test, const std::string& quantization, TestType threshold,
+    std::vector<TestType>& yData)
+{
+    std::cout << "Testing " << test.name << " model with " << quantization << " recurrent weights from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    auto modelJson = load_model_json(test);
+    for(auto& layer : modelJson["layers"])
+    {
+        const auto type = layer["type"].get<std::string>();
+        if(type == "gru" || type == "lstm")
+            layer["quantization"] = quantization;
+    }
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    if(std::count_if(model->layers.begin(), model->layers.end(), is_quantized_recurrent<QType>) != 1)
+    {
+        std::cout << "FAIL: Expected 1 quantized recurrent layer!" << std::endl;
+        return 1;
+    }
+
+    yData = run_model(*model, xData);
+    auto maxError = (TestType)0;
+    for(size_t n = 0; n < yData.size(); ++n)
+        maxError = std::max(maxError, std::abs(yData[n] - yRefData[n]));
+    std::cout << "    Maximum error: " << maxError << " (bound: " << threshold << ")" << std::endl;
+
+    return compare(yData, yRefData, threshold);
+}
+
+#if MODELT_AVAILABLE
+/** Runs a templated model with quantized recurrent layers, and compares it to the equivalent dynamic model. */
+template <typename ModelType>
+int test_recurrent_templated(ModelType& modelT, const TestConfig& test, const std::vector<TestType>& yDynamic)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    modelT.parseJson(jsonStream, true);
+    modelT.reset();
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    return compare(run_model(modelT, xData), yDynamic, (TestType)1.0e-12);
+}
+
+template <typename QType>
+int test_recurrent_models(const std::string& quantization, TestType threshold)
+{
+    int result = 0;
+    std::vector<TestType> yDynamic;
+
+    result |= test_recurrent_json<QType>(tests.at("gru"), quantization, threshold, yDynamic);
+    {
+        std::cout << "Testing templated GRU model with " << quantization << " recurrent weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::QuantizedGRULayerT<TestType, 8, 8, QType>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+        result |= test_recurrent_templated(modelT, tests.at("gru"), yDynamic);
+    }
+
+    result |= test_recurrent_json<QType>(tests.at("gru_1d"), quantization, threshold, yDynamic);
+    {
+        std::cout << "Testing templated GRU-1D model with " << quantization << " recurrent weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::QuantizedGRULayerT<TestType, 1, 8, QType>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+        result |= test_recurrent_templated(modelT, tests.at("gru_1d"), yDynamic);
+    }
+
+    result |= test_recurrent_json<QType>(tests.at("lstm"), quantization, threshold, yDynamic);
+    {
+        std::cout << "Testing templated LSTM model with " << quantization << " recurrent weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::QuantizedLSTMLayerT<TestType, 8, 8, QType>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+        result |= test_recurrent_templated(modelT, tests.at("lstm"), yDynamic);
+    }
+
+    result |= test_recurrent_json<QType>(tests.at("lstm_1d"), quantization, threshold, yDynamic);
+    {
+        std::cout << "Testing templated LSTM-1D model with " << quantization << " recurrent weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::QuantizedLSTMLayerT<TestType, 1, 8, QType>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            modelT;
+        result |= test_recurrent_templated(modelT, tests.at("lstm_1d"), yDynamic);
+    }
+
+    return result;
+}
+#endif
+
+int quantized_test()
+{
+    std::cout << "TESTING QUANTIZED LAYERS..." << std::endl;
+
+    int result = 0;
+    result |= test_weights();
+    result |= test_quantize_limits();
+
+    // dense.json has 5 dense layers, and conv.json has 3 dense layers and 1 conv1d layer
+    result |= test_json_opt_in(tests.at("dense"), 5, dense_threshold);
+    result |= test_json_opt_in(tests.at("conv1d"), 4, conv1d_threshold);
+
+#if MODELT_AVAILABLE
+    {
+        std::cout << "Testing templated DENSE model with int8 weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::QuantizedDenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::QuantizedDenseT<TestType, 8, 8>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::QuantizedDenseT<TestType, 8, 8>,
+            RTNeural::ELuActivationT<TestType, 8>,
+            RTNeural::QuantizedDenseT<TestType, 8, 8>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::QuantizedDenseT<TestType, 8, 1>>
+            modelT;
+
+        const auto& test = tests.at("dense");
+        std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+        modelT.parseJson(jsonStream, true);
+        modelT.reset();
+
+        // the templated model should match the dynamic quantized model
+        auto modelJson = load_model_json(test);
+        prequantize_model(modelJson);
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+        model->reset();
+
+        std::ifstream pythonX(test.x_data_file);
+        const auto xData = load_csv::loadFile<TestType>(pythonX);
+        result |= compare(run_model(modelT, xData), run_model(*model, xData), (TestType)1.0e-12);
+    }
+
+    {
+        std::cout << "Testing templated CONV1D model with int8 weights" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::QuantizedDenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::QuantizedConv1DT<TestType, 8, 4, 3, 2>,
+            RTNeural::TanhActivationT<TestType, 4>,
+            RTNeural::QuantizedDenseT<TestType, 4, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::QuantizedDenseT<TestType, 8, 1>>
+            modelT;
+
+        const auto& test = tests.at("conv1d");
+        std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+        modelT.parseJson(jsonStream, true);
+        modelT.reset();
+
+        auto modelJson = load_model_json(test);
+        prequantize_model(modelJson);
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson);
+        model->reset();
+
+        std::ifstream pythonX(test.x_data_file);
+        const auto xData = load_csv::loadFile<TestType>(pythonX);
+        result |= compare(run_model(modelT, xData), run_model(*model, xData), (TestType)1.0e-12);
+    }
+
+    result |= test_recurrent_models<int8_t>("int8", recurrent_int8_threshold);
+    result |= test_recurrent_models<int16_t>("int16", recurrent_int16_threshold);
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace quantized_test
@@ -16,28 +16,25 @@ auto getSampleRateVector(double sampleRate)
     return x;
 }
 
-template <template <RTNeural::SampleRateCorrectionMode> class ModelType, RTNeural::SampleRateCorrectionMode mode, int RLayerIdx, typename MultType>
-int runModelTest(const std::string& modelFile, MultType sampleRateMult)
-{
-    static constexpr auto baseSampleRate = 48000.0;
+static constexpr auto baseSampleRate = 48000.0;
 
+template <template <RTNeural::SampleRateCorrectionMode> class ModelType>
+std::vector<double> runBaseSampleRateModel(const std::string& modelFile)
+{
     ModelType<RTNeural::SampleRateCorrectionMode::None> baseSampleRateModel;
-    std::ifstream jsonStream1("models/" + modelFile, std::ifstream::binary);
-    baseSampleRateModel.parseJson(jsonStream1);
+    std::ifstream jsonStream("models/" + modelFile, std::ifstream::binary);
+    baseSampleRateModel.parseJson(jsonStream);
     baseSampleRateModel.reset();
     auto baseSampleRateSignal = getSampleRateVector(baseSampleRate);
     for(auto& sample : baseSampleRateSignal)
         sample = baseSampleRateModel.forward(&sample);
 
-    ModelType<mode> testSampleRateModel;
-    std::ifstream jsonStream2("models/" + modelFile, std::ifstream::binary);
-    testSampleRateModel.parseJson(jsonStream2);
-    testSampleRateModel.reset();
-    testSampleRateModel.template get<RLayerIdx>().prepare(sampleRateMult);
-    auto testSampleRateSignal = getSampleRateVector(baseSampleRate * sampleRateMult);
-    for(auto& sample : testSampleRateSignal)
-        sample = testSampleRateModel.forward(&sample);
+    return baseSampleRateSignal;
+}
 
+template <typename MultType>
+int checkSampleRateSignal(const std::vector<double>& baseSampleRateSignal, const std::vector<double>& testSampleRateSignal, MultType sampleRateMult)
+{
     double maxErr = 0.0;
     const auto checkSamplesInc = int (sampleRateMult * 4.0);
     for (int i = 0, j = (int) std::ceil (sampleRateMult) - 1; i < baseSampleRateSignal.size() && j < testSampleRateSignal.size(); i += 4, j += checkSamplesInc)
@@ -54,6 +51,42 @@ int runModelTest(const std::string& modelFile, MultType sampleRateMult)
     return 0;
 }
 
+template <template <RTNeural::SampleRateCorrectionMode> class ModelType, RTNeural::SampleRateCorrectionMode mode, int RLayerIdx, typename MultType>
+int runModelTest(const std::string& modelFile, MultType sampleRateMult)
+{
+    const auto baseSampleRateSignal = runBaseSampleRateModel<ModelType>(modelFile);
+
+    ModelType<mode> testSampleRateModel;
+    std::ifstream jsonStream("models/" + modelFile, std::ifstream::binary);
+    testSampleRateModel.parseJson(jsonStream);
+    testSampleRateModel.reset();
+    testSampleRateModel.template get<RLayerIdx>().prepare(sampleRateMult);
+    auto testSampleRateSignal = getSampleRateVector(baseSampleRate * sampleRateMult);
+    for(auto& sample : testSampleRateSignal)
+        sample = testSampleRateModel.forward(&sample);
+
+    return checkSampleRateSignal(baseSampleRateSignal, testSampleRateSignal, sampleRateMult);
+}
+
+/** Runs the same test as runModelTest(), but using dynamic models, prepared with Model::prepare() */
+int runDynamicModelTest(const std::string& modelFile, double sampleRateMult)
+{
+    std::ifstream jsonStream("models/" + modelFile, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJson<double>(jsonStream);
+
+    model->reset();
+    auto baseSampleRateSignal = getSampleRateVector(baseSampleRate);
+    for(auto& sample : baseSampleRateSignal)
+        sample = model->forward(&sample);
+
+    model->prepare(sampleRateMult);
+    auto testSampleRateSignal = getSampleRateVector(baseSampleRate * sampleRateMult);
+    for(auto& sample : testSampleRateSignal)
+        sample = model->forward(&sample);
+
+    return checkSampleRateSignal(baseSampleRateSignal, testSampleRateSignal, sampleRateMult);
+}
+
 template <RTNeural::SampleRateCorrectionMode mode>
 using GRUModel = RTNeural::ModelT<double, 1, 1,
     RTNeural::DenseT<double, 1, 8>,
@@ -92,21 +125,35 @@ int runTestAtSampleRateOffset(const std::string& model)
     {
         result |= runModelTest<GRUModel, SampleRateCorrectionMode::NoInterp, 2>("gru.json", 3);
         result |= runModelTest<GRUModel, SampleRateCorrectionMode::LinInterp, 2>("gru.json", 1.75);
+        result |= runModelTest<GRUModel, SampleRateCorrectionMode::NoInterp, 2>("gru.json", RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY); // longest supported delay
+        result |= runModelTest<GRUModel, SampleRateCorrectionMode::LinInterp, 2>("gru.json", (double)RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY);
+        result |= runDynamicModelTest("gru.json", 3);
+        result |= runDynamicModelTest("gru.json", 1.75);
+        result |= runDynamicModelTest("gru.json", 2 * RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY); // dynamic delays are not limited by the maximum
     }
     else if(model == "gru_1d")
     {
         result |= runModelTest<GRU1DModel, SampleRateCorrectionMode::NoInterp, 0>("gru_1d.json", 3);
         result |= runModelTest<GRU1DModel, SampleRateCorrectionMode::LinInterp, 0>("gru_1d.json", 1.75);
+        result |= runDynamicModelTest("gru_1d.json", 3);
+        result |= runDynamicModelTest("gru_1d.json", 1.75);
     }
     else if(model == "lstm")
     {
         result |= runModelTest<LSTMModel, SampleRateCorrectionMode::NoInterp, 2>("lstm.json", 4);
         result |= runModelTest<LSTMModel, SampleRateCorrectionMode::LinInterp, 2>("lstm.json", 2.5);
+        result |= runModelTest<LSTMModel, SampleRateCorrectionMode::NoInterp, 2>("lstm.json", RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY); // longest supported delay
+        result |= runModelTest<LSTMModel, SampleRateCorrectionMode::LinInterp, 2>("lstm.json", (double)RTNEURAL_MAX_SAMPLE_RATE_CORRECTION_DELAY);
+        result |= runDynamicModelTest("lstm.json", 4);
+        result |= runDynamicModelTest("lstm.json", 2.5);
+        result |= runDynamicModelTest("lstm.json", 20);
     }
     else if(model == "lstm_1d")
     {
         result |= runModelTest<LSTM1DModel, SampleRateCorrectionMode::NoInterp, 0>("lstm_1d.json", 2);
         result |= runModelTest<LSTM1DModel, SampleRateCorrectionMode::LinInterp, 0>("lstm_1d.json", 2.25);
+        result |= runDynamicModelTest("lstm_1d.json", 2);
+        result |= runDynamicModelTest("lstm_1d.json", 2.25);
     }
 
     return result;
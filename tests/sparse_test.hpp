@@ -0,0 +1,311 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace sparse_test
+{
+
+using TestType = double;
+
+constexpr TestType threshold = 1.0e-12;
+
+/** Checks a SparseDense layer against a Dense layer with the same (mostly zero) weights. */
+template <int block_rows, int block_cols>
+int test_layer()
+{
+    std::cout << "Testing SparseDense layer with " << block_rows << "x" << block_cols << " blocks" << std::endl;
+
+    constexpr int in_size = 13;
+    constexpr int out_size = 7;
+    constexpr int nIter = 100;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<TestType> distribution((TestType)-1, (TestType)1);
+
+    std::vector<std::vector<TestType>> weights(out_size, std::vector<TestType>(in_size, (TestType)0));
+    for(auto& row : weights)
+        for(auto& w : row)
+            w = distribution(generator) > (TestType)0.6 ? distribution(generator) : (TestType)0;
+
+    std::vector<TestType> bias(out_size, (TestType)0);
+    for(auto& b : bias)
+        b = distribution(generator);
+
+    RTNeural::Dense<TestType> dense { in_size, out_size };
+    dense.setWeights(weights);
+    dense.setBias(bias.data());
+
+    RTNeural::SparseDense<TestType, block_rows, block_cols> sparse { in_size, out_size };
+    sparse.setWeights(weights);
+    sparse.setBias(bias.data());
+
+    int result = 0;
+    for(int i = 0; i < out_size; ++i)
+    {
+        for(int k = 0; k < in_size; ++k)
+        {
+            if(sparse.getWeight(i, k) != weights[(size_t)i][(size_t)k])
+            {
+                std::cout << "FAIL: Sparse weight (" << i << ", " << k << ") is incorrect!" << std::endl;
+                result = 1;
+            }
+        }
+    }
+
+    const auto totalBlocks = RTNeural::ceil_div(out_size, block_rows) * RTNeural::ceil_div(in_size, block_cols);
+    std::cout << "    Non-zero blocks: " << sparse.getNumBlocks() << " / " << totalBlocks << std::endl;
+
+    TestType ins alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+    TestType denseOuts alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    TestType sparseOuts alignas(RTNEURAL_DEFAULT_ALIGNMENT)[out_size];
+    auto maxError = (TestType)0;
+    for(int n = 0; n < nIter; ++n)
+    {
+        for(auto& x : ins)
+            x = distribution(generator);
+
+        dense.forward(ins, denseOuts);
+        sparse.forward(ins, sparseOuts);
+        for(int i = 0; i < out_size; ++i)
+            maxError = std::max(maxError, std::abs(denseOuts[i] - sparseOuts[i]));
+    }
+
+    if(maxError > threshold)
+    {
+        std::cout << "FAIL: Sparse layer output is incorrect! Maximum error: " << maxError << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+/** Prunes the dense layers of a model, so that only one in four (1x4) weight blocks is non-zero. */
+nlohmann::json load_pruned_model(const TestConfig& test)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    for(auto& layer : modelJson["layers"])
+    {
+        auto& kernel = layer["weights"][0]; // kernel[in_size][out_size]
+        for(size_t k = 0; k < kernel.size(); ++k)
+            for(size_t i = 0; i < kernel[k].size(); ++i)
+                if((i + k / 4) % 4 != 0)
+                    kernel[k][i] = 0.0;
+    }
+
+    return modelJson;
+}
+
+int test_pruned_model()
+{
+    const auto& test = tests.at("dense");
+    std::cout << "Testing pruned " << test.name << " model from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    const auto modelJson = load_pruned_model(test);
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    // the output layer (8 -> 1) has one non-zero block out of two, so it stays dense
+    const auto numSparseLayers = std::count_if(model->layers.begin(), model->layers.end(), [](RTNeural::Layer<TestType>* layer) {
+        return dynamic_cast<RTNeural::SparseDense<TestType>*>(layer) != nullptr;
+    });
+    if(numSparseLayers != 4)
+    {
+        std::cout << "FAIL: Expected 4 sparse layers, found " << numSparseLayers << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    const auto yData = run_model(*model, xData);
+
+#if MODELT_AVAILABLE
+    {
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::ELuActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>
+            denseModelT;
+        denseModelT.parseJson(modelJson, true);
+        denseModelT.reset();
+        const auto yRefData = run_model(denseModelT, xData);
+        result |= compare(yData, yRefData, threshold);
+
+        std::cout << "Testing pruned templated " << test.name << " model with 1x4 blocks" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::SparseDenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8>,
+            RTNeural::ELuActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 1>>
+            sparseModelT;
+        sparseModelT.parseJson(modelJson, true);
+        sparseModelT.reset();
+        result |= compare(run_model(sparseModelT, xData), yRefData, threshold);
+
+        std::cout << "Testing pruned templated " << test.name << " model with 4x4 blocks" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::SparseDenseT<TestType, 1, 8, 4, 4>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8, 4, 4>,
+            RTNeural::ReLuActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8, 4, 4>,
+            RTNeural::ELuActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 8, 4, 4>,
+            RTNeural::SoftmaxActivationT<TestType, 8>,
+            RTNeural::SparseDenseT<TestType, 8, 1, 4, 4>>
+            blockModelT;
+        blockModelT.parseJson(modelJson, true);
+        blockModelT.reset();
+        result |= compare(run_model(blockModelT, xData), yRefData, threshold);
+    }
+#endif
+
+    return result;
+}
+
+/** Adds a pruning mask to the recurrent weights of a model, so that only one in four (1x4) weight blocks is non-zero. */
+nlohmann::json load_pruned_recurrent_model(const TestConfig& test, const std::string& layerType)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+
+    for(auto& layer : modelJson["layers"])
+    {
+        if(layer["type"] != layerType)
+            continue;
+
+        auto mask = layer["weights"][1]; // recurrent[out_size][num_gates * out_size]
+        for(size_t i = 0; i < mask.size(); ++i)
+            for(size_t k = 0; k < mask[i].size(); ++k)
+                mask[i][k] = (k + i / 4) % 4 == 0 ? 1 : 0;
+
+        layer["pruning_masks"] = { nullptr, mask };
+    }
+
+    return modelJson;
+}
+
+template <typename SparseLayerType, typename ModelType, typename SparseModelType, typename BlockModelType>
+int test_pruned_recurrent_model(const std::string& testName, const std::string& layerType)
+{
+    const auto& test = tests.at(testName);
+    std::cout << "Testing " << test.name << " model with pruned recurrent weights from json" << std::endl;
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    const auto modelJson = load_pruned_recurrent_model(test, layerType);
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    model->reset();
+
+    const auto numSparseLayers = std::count_if(model->layers.begin(), model->layers.end(), [](RTNeural::Layer<TestType>* layer) {
+        return dynamic_cast<SparseLayerType*>(layer) != nullptr;
+    });
+    if(numSparseLayers != 1)
+    {
+        std::cout << "FAIL: Expected 1 sparse layer, found " << numSparseLayers << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    const auto yData = run_model(*model, xData);
+
+    // the dense model applies the same pruning mask
+    ModelType modelT;
+    modelT.parseJson(modelJson, true);
+    modelT.reset();
+    const auto yRefData = run_model(modelT, xData);
+    result |= compare(yData, yRefData, threshold);
+
+    std::cout << "Testing templated " << test.name << " model with pruned recurrent weights (1x4 blocks)" << std::endl;
+    SparseModelType sparseModelT;
+    sparseModelT.parseJson(modelJson, true);
+    sparseModelT.reset();
+    result |= compare(run_model(sparseModelT, xData), yRefData, threshold);
+
+    std::cout << "Testing templated " << test.name << " model with pruned recurrent weights (4x4 blocks)" << std::endl;
+    BlockModelType blockModelT;
+    blockModelT.parseJson(modelJson, true);
+    blockModelT.reset();
+    result |= compare(run_model(blockModelT, xData), yRefData, threshold);
+
+    return result;
+}
+
+int sparse_test()
+{
+    std::cout << "TESTING SPARSE LAYERS..." << std::endl;
+
+    int result = 0;
+    result |= test_layer<1, 4>();
+    result |= test_layer<4, 4>();
+    result |= test_pruned_model();
+
+#if MODELT_AVAILABLE
+    result |= test_pruned_recurrent_model<RTNeural::SparseGRULayer<TestType>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::GRULayerT<TestType, 8, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseGRULayerT<TestType, 8, 8>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseGRULayerT<TestType, 8, 8, 4, 4>,
+            RTNeural::DenseT<TestType, 8, 8>,
+            RTNeural::SigmoidActivationT<TestType, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>>("gru", "gru");
+
+    result |= test_pruned_recurrent_model<RTNeural::SparseLSTMLayer<TestType>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::LSTMLayerT<TestType, 8, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseLSTMLayerT<TestType, 8, 8>,
+            RTNeural::DenseT<TestType, 8, 1>>,
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, 8>,
+            RTNeural::TanhActivationT<TestType, 8>,
+            RTNeural::SparseLSTMLayerT<TestType, 8, 8, 4, 4>,
+            RTNeural::DenseT<TestType, 8, 1>>>("lstm", "lstm");
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace sparse_test
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <RTNeural.h>
+#include <sstream>
+#include "conv2d_test.hpp"
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+#include "wavenet_test.hpp"
+
+namespace streaming_loader_test
+{
+
+using TestType = double;
+
+constexpr TestType threshold = 1.0e-12;
+
+/** Loads a model with the streaming parser, and compares it to the reference output. */
+int test_model(const TestConfig& test)
+{
+    std::cout << "Testing " << test.name << " model with streaming parser" << std::endl;
+
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    auto model = RTNeural::json_parser::parseJsonStreaming<TestType>(jsonStream, true);
+    if(model == nullptr)
+    {
+        std::cout << "FAIL: Unable to load model!" << std::endl;
+        return 1;
+    }
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(run_model(*model, xData), yRefData, (TestType)test.threshold);
+}
+
+/**
+ * Loads a model with the streaming parser, and checks that it has the
+ * same layers, and the same output, as the model from parseJson().
+ */
+int test_matches_parse_json(const nlohmann::json& modelJson, const std::vector<TestType>& xData)
+{
+    std::istringstream jsonStream(modelJson.dump());
+    auto model = RTNeural::json_parser::parseJsonStreaming<TestType>(jsonStream);
+    auto refModel = RTNeural::json_parser::parseJson<TestType>(modelJson);
+    if(model == nullptr || model->layers.size() != refModel->layers.size())
+    {
+        std::cout << "FAIL: Streaming parser created the wrong layers!" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    for(size_t i = 0; i < model->layers.size(); ++i)
+    {
+        if(model->layers[i]->getName() != refModel->layers[i]->getName())
+        {
+            std::cout << "FAIL: Layer " << i << " should be a " << refModel->layers[i]->getName() << " layer" << std::endl;
+            result = 1;
+        }
+    }
+
+    return result | compare(run_model(*model, xData), run_model(*refModel, xData), threshold);
+}
+
+/**
+ * Loads models with half-precision weights and lookup-table
+ * activations, and checks that the streaming parser creates
+ * the same model as the regular json parser.
+ */
+int test_weight_storage_options()
+{
+    std::cout << "Testing streaming parser with half-precision layers" << std::endl;
+
+    int result = 0;
+    for(const auto* name : { "dense", "gru", "lstm" })
+    {
+        const auto& test = tests.at(name);
+        auto modelJson = load_model_json(test);
+        for(auto& layer : modelJson["layers"])
+        {
+            layer["weight_storage"] = "fp16";
+            if(layer.contains("activation") && layer["activation"] == "tanh")
+                layer["activation_lut"] = true;
+        }
+
+        std::ifstream pythonX(test.x_data_file);
+        const auto xData = load_csv::loadFile<TestType>(pythonX);
+        result |= test_matches_parse_json(modelJson, xData);
+    }
+
+    return result;
+}
+
+/** Returns a pruning mask for a weights array, which keeps one in every `keep` weights. */
+nlohmann::json pruning_mask(const nlohmann::json& weights, int keep, int& count)
+{
+    if(!weights.is_array())
+        return (count++ % keep) == 0 ? 1 : 0;
+
+    auto mask = nlohmann::json::array();
+    for(const auto& w : weights)
+        mask.push_back(pruning_mask(w, keep, count));
+    return mask;
+}
+
+/**
+ * Loads models with int8, pruned (sparse), WaveNet, and Conv2D layers,
+ * and checks that the streaming parser creates the same model as the
+ * regular json parser.
+ */
+int test_layer_types()
+{
+    std::cout << "Testing streaming parser with quantized, sparse, WaveNet, and Conv2D layers" << std::endl;
+
+    std::ifstream pythonX(tests.at("dense").x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    // the first dense layer is quantized, and the second one is pruned
+    auto denseJson = load_model_json(tests.at("dense"));
+    auto& denseLayers = denseJson["layers"];
+    auto& quantizedLayer = denseLayers[0];
+    quantizedLayer["quantization"] = { { "type", "int8" }, { "scales", std::vector<double>(quantizedLayer["weights"][1].size(), 0.01) } };
+    for(auto& row : quantizedLayer["weights"][0])
+        for(auto& w : row)
+            w = (int)std::round(w.get<double>() * 100.0);
+
+    int count = 0;
+    denseLayers[1]["pruning_masks"] = { pruning_mask(denseLayers[1]["weights"][0], 8, count), nullptr };
+
+    // the recurrent weights are pruned
+    auto gruJson = load_model_json(tests.at("gru"));
+    for(auto& layer : gruJson["layers"])
+        if(layer["type"] == "gru")
+            layer["pruning_masks"] = { nullptr, pruning_mask(layer["weights"][1], 8, count), nullptr };
+
+    int result = 0;
+    result |= test_matches_parse_json(denseJson, xData);
+    result |= test_matches_parse_json(gruJson, xData);
+    result |= test_matches_parse_json(wavenet_test::wavenet_model_json(), xData);
+    result |= test_matches_parse_json(conv2d_test::conv2d_model_json(), xData);
+    return result;
+}
+
+/** Checks that models can be loaded when the input shape comes after the layers. */
+int test_layers_first()
+{
+    const auto& test = tests.at("conv1d");
+    std::cout << "Testing streaming parser with in_shape after layers" << std::endl;
+
+    const auto modelJson = load_model_json(test);
+    std::istringstream jsonStream("{ \"layers\": " + modelJson["layers"].dump()
+        + ", \"in_shape\": " + modelJson["in_shape"].dump() + " }");
+
+    auto model = RTNeural::json_parser::parseJsonStreaming<TestType>(jsonStream);
+    if(model == nullptr)
+    {
+        std::cout << "FAIL: Unable to load model!" << std::endl;
+        return 1;
+    }
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(run_model(*model, xData), yRefData, (TestType)test.threshold);
+}
+
+/** Checks that numbers with very long mantissas are parsed correctly. */
+int test_long_numbers()
+{
+    const auto& test = tests.at("dense");
+    std::cout << "Testing streaming parser with long numbers" << std::endl;
+
+    // pad the first weight of each layer with trailing zeros
+    auto jsonString = load_model_json(test).dump();
+    const std::string weightsKey = "\"weights\":[[[";
+    for(auto weightsPos = jsonString.find(weightsKey); weightsPos != std::string::npos; weightsPos = jsonString.find(weightsKey, weightsPos + 1))
+    {
+        // (before the exponent, if there is one)
+        const auto numberStart = weightsPos + weightsKey.size();
+        const auto numberEnd = jsonString.find_first_of(",]eE", numberStart);
+        jsonString.insert(numberEnd, std::string(100, '0'));
+    }
+
+    std::istringstream jsonStream(jsonString);
+    auto model = RTNeural::json_parser::parseJsonStreaming<TestType>(jsonStream);
+    if(model == nullptr)
+    {
+        std::cout << "FAIL: Unable to load model with long numbers!" << std::endl;
+        return 1;
+    }
+
+    std::ifstream pythonX(test.x_data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    std::ifstream pythonY(test.y_data_file);
+    const auto yRefData = load_csv::loadFile<TestType>(pythonY);
+
+    return compare(run_model(*model, xData), yRefData, (TestType)test.threshold);
+}
+
+/**
+ * Checks that a malformed json model is rejected, and that the
+ * syntax error is reported with its byte offset in the stream.
+ */
+int test_syntax_error(const std::string& name, const std::string& jsonString, const std::string& expectedError)
+{
+    std::istringstream jsonStream(jsonString);
+    std::ostringstream debugOutput;
+    auto* coutBuffer = std::cout.rdbuf(debugOutput.rdbuf());
+    const auto model = RTNeural::json_parser::parseJsonStreaming<TestType>(jsonStream, true);
+    std::cout.rdbuf(coutBuffer);
+
+    if(model != nullptr)
+    {
+        std::cout << "FAIL: Json model with " << name << " should not load!" << std::endl;
+        return 1;
+    }
+
+    const auto errorMessage = debugOutput.str();
+    if(errorMessage.find("parse error at byte ") == std::string::npos || errorMessage.find(expectedError) == std::string::npos)
+    {
+        std::cout << "FAIL: Json model with " << name << " reported the wrong error: " << errorMessage << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Checks that invalid json models are rejected. */
+int test_invalid_json()
+{
+    std::cout << "Testing streaming parser with invalid json" << std::endl;
+
+    int result = 0;
+    const auto jsonString = load_model_json(tests.at("lstm")).dump();
+
+    std::istringstream truncatedStream(jsonString.substr(0, jsonString.size() / 2));
+    if(RTNeural::json_parser::parseJsonStreaming<TestType>(truncatedStream) != nullptr)
+    {
+        std::cout << "FAIL: Truncated json model should not load!" << std::endl;
+        result = 1;
+    }
+
+    // truncated in the middle of a number, and after a complete value
+    const auto numberPos = jsonString.find_first_of("0123456789", jsonString.find("\"weights\""));
+    result |= test_syntax_error("a truncated number", jsonString.substr(0, numberPos + 1), "unexpected end of input");
+    result |= test_syntax_error("a truncated stream", jsonString.substr(0, jsonString.size() - 1), "unexpected end of input");
+
+    auto badNumber = jsonString;
+    badNumber.replace(numberPos, 1, "1.2.3");
+    result |= test_syntax_error("a bad number", badNumber, "unexpected '.'");
+
+    auto missingDigits = jsonString;
+    missingDigits.replace(numberPos, 1, "-x");
+    result |= test_syntax_error("a number without digits", missingDigits, "expected a digit");
+
+    result |= test_syntax_error("an unterminated string", "{ \"in_shape\": [null, null, 1], \"layers\": [ { \"type\": \"dense", "unterminated string");
+    result |= test_syntax_error("an invalid literal", "{ \"in_shape\": [nul, null, 1], \"layers\": [] }", "invalid literal");
+    result |= test_syntax_error("trailing data", "{ \"in_shape\": [null, null, 1], \"layers\": [] } {}", "unexpected '{'");
+
+    std::istringstream noShapeStream("{ \"layers\": [] }");
+    if(RTNeural::json_parser::parseJsonStreaming<TestType>(noShapeStream) != nullptr)
+    {
+        std::cout << "FAIL: Json model without an input shape should not load!" << std::endl;
+        result = 1;
+    }
+
+    auto wrongShape = load_model_json(tests.at("gru"));
+    wrongShape["layers"][1]["shape"] = { nullptr, nullptr, 16 };
+    std::istringstream wrongShapeStream(wrongShape.dump());
+    if(RTNeural::json_parser::parseJsonStreaming<TestType>(wrongShapeStream) != nullptr)
+    {
+        std::cout << "FAIL: Json model with the wrong weight dimensions should not load!" << std::endl;
+        result = 1;
+    }
+
+    auto raggedWeights = load_model_json(tests.at("gru"));
+    raggedWeights["layers"][1]["weights"][2][1].erase(0);
+    std::istringstream raggedStream(raggedWeights.dump());
+    if(RTNeural::json_parser::parseJsonStreaming<TestType>(raggedStream) != nullptr)
+    {
+        std::cout << "FAIL: Json model with ragged weight arrays should not load!" << std::endl;
+        result = 1;
+    }
+
+    auto mixedWeights = load_model_json(tests.at("dense"));
+    mixedWeights["layers"][0]["weights"][1].push_back({ 1.0 });
+    std::istringstream mixedStream(mixedWeights.dump());
+    if(RTNeural::json_parser::parseJsonStreaming<TestType>(mixedStream) != nullptr)
+    {
+        std::cout << "FAIL: Json model with mixed weight array levels should not load!" << std::endl;
+        result = 1;
+    }
+
+    return result;
+}
+
+int streaming_loader_test()
+{
+    std::cout << "TESTING STREAMING JSON PARSER..." << std::endl;
+
+    int result = 0;
+    for(const auto* name : { "dense", "conv1d", "gru", "gru_1d", "lstm", "lstm_1d" })
+        result |= test_model(tests.at(name));
+
+    result |= test_weight_storage_options();
+    result |= test_layer_types();
+    result |= test_layers_first();
+    result |= test_long_numbers();
+    result |= test_invalid_json();
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace streaming_loader_test
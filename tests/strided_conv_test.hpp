@@ -0,0 +1,159 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace strided_conv_test
+{
+
+using TestType = double;
+
+constexpr int conv_size = 4;
+constexpr int stride1 = 2;
+constexpr int stride2 = 3;
+
+nlohmann::json conv1d_json(std::default_random_engine& generator, int kernel_size, int dilation, int stride, const std::string& activation)
+{
+    nlohmann::json layer;
+    layer["type"] = "conv1d";
+    layer["activation"] = activation;
+    layer["shape"] = { nullptr, nullptr, conv_size };
+    layer["kernel_size"] = { kernel_size };
+    layer["dilation"] = { dilation };
+    layer["strides"] = { stride };
+    layer["weights"] = {
+        random_weights(generator, { kernel_size, conv_size, conv_size }),
+        random_weights(generator, { conv_size }),
+    };
+
+    return layer;
+}
+
+nlohmann::json strided_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_in;
+    dense_in["type"] = "dense";
+    dense_in["activation"] = "";
+    dense_in["shape"] = { nullptr, nullptr, conv_size };
+    dense_in["weights"] = { random_weights(generator, { 1, conv_size }), random_weights(generator, { conv_size }) };
+
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { conv_size, 1 }), random_weights(generator, { 1 }) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = {
+        dense_in,
+        conv1d_json(generator, 3, 1, stride1, "tanh"),
+        conv1d_json(generator, 2, 2, stride2, ""),
+        dense_out,
+    };
+
+    return model;
+}
+
+int strided_conv_test()
+{
+    std::cout << "TESTING STRIDED CONV1D..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    constexpr TestType threshold = 1.0e-12;
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto modelJson = strided_model_json();
+    const auto& jsonLayers = modelJson["layers"];
+
+    // reference model: un-strided convolutions, with the outputs decimated by hand
+    std::vector<TestType> yRefData(xData.size(), (TestType)0);
+    {
+        auto denseIn = RTNeural::json_parser::createDense<TestType>(1, conv_size, jsonLayers[0]["weights"]);
+        auto conv1 = RTNeural::json_parser::createConv1D<TestType>(conv_size, conv_size, 3, 1, jsonLayers[1]["weights"]);
+        auto conv2 = RTNeural::json_parser::createConv1D<TestType>(conv_size, conv_size, 2, 2, jsonLayers[2]["weights"]);
+        auto denseOut = RTNeural::json_parser::createDense<TestType>(conv_size, 1, jsonLayers[3]["weights"]);
+        conv1->reset();
+        conv2->reset();
+
+        TestType x alignas(RTNEURAL_DEFAULT_ALIGNMENT)[conv_size];
+        TestType y1 alignas(RTNEURAL_DEFAULT_ALIGNMENT)[conv_size];
+        TestType y2 alignas(RTNEURAL_DEFAULT_ALIGNMENT)[conv_size];
+        TestType yOut = (TestType)0;
+        int n1 = 0;
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            denseIn->forward(input, x);
+            conv1->forward(x, y1);
+
+            if(n % stride1 == 0)
+            {
+                for(auto& y : y1)
+                    y = std::tanh(y);
+
+                conv2->forward(y1, y2);
+                if(n1++ % stride2 == 0)
+                    denseOut->forward(y2, &yOut);
+            }
+
+            yRefData[n] = yOut;
+        }
+    }
+
+    // non-templated model
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    {
+        std::cout << "Testing non-templated model" << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        if(model->getOutputDecimation() != stride1 * stride2)
+        {
+            std::cout << "FAIL: incorrect output decimation: " << model->getOutputDecimation() << std::endl;
+            return 1;
+        }
+
+        model->reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = model->forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    {
+        std::cout << "Testing templated model" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, conv_size>,
+            RTNeural::StridedConv1DT<TestType, conv_size, conv_size, 3, 1, stride1>,
+            RTNeural::TanhActivationT<TestType, conv_size>,
+            RTNeural::StridedConv1DT<TestType, conv_size, conv_size, 2, 2, stride2>,
+            RTNeural::DenseT<TestType, conv_size, 1>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        modelT.reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = modelT.forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+#endif
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace strided_conv_test
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <RTNeural.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
 #include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 struct TestConfig
 {
@@ -28,3 +35,75 @@ static std::map<std::string, TestConfig> tests {
         TestConfig { "LSTM-1D", "models/lstm_1d.json", "test_data/lstm_1d_x_python.csv",
             "test_data/lstm_1d_y_python.csv", 1.0e-6 } },
 };
+
+/** Loads the json for a test model. */
+inline nlohmann::json load_model_json(const TestConfig& test)
+{
+    std::ifstream jsonStream(test.model_file, std::ifstream::binary);
+    nlohmann::json modelJson;
+    jsonStream >> modelJson;
+    return modelJson;
+}
+
+/** Resets a model with one input and one output, and processes a signal with it. */
+template <typename ModelType, typename T>
+std::vector<T> run_model(ModelType& model, const std::vector<T>& xData)
+{
+    model.reset();
+
+    std::vector<T> yData(xData.size(), (T)0);
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        T input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+        yData[n] = model.forward(input);
+    }
+
+    return yData;
+}
+
+/** Generates a random json weights array with the given shape. */
+inline nlohmann::json random_weights(std::default_random_engine& generator, std::vector<int> shape)
+{
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+
+    if(shape.size() == 1)
+    {
+        std::vector<double> w((size_t)shape[0]);
+        for(auto& x : w)
+            x = distribution(generator);
+        return w;
+    }
+
+    auto json = nlohmann::json::array();
+    const std::vector<int> inner_shape(shape.begin() + 1, shape.end());
+    for(int i = 0; i < shape[0]; ++i)
+        json.push_back(random_weights(generator, inner_shape));
+
+    return json;
+}
+
+/** Compares two signals, and reports the number of samples that differ by more than the threshold. */
+template <typename T>
+int compare(const std::vector<T>& yData, const std::vector<T>& yRefData, T threshold)
+{
+    size_t nErrs = 0;
+    T max_error = (T)0;
+    for(size_t n = 0; n < yData.size(); ++n)
+    {
+        auto err = std::abs(yData[n] - yRefData[n]);
+        if(err > threshold)
+        {
+            max_error = std::max(err, max_error);
+            nErrs++;
+        }
+    }
+
+    if(nErrs > 0)
+    {
+        std::cout << "FAIL: " << nErrs << " errors!" << std::endl;
+        std::cout << "Maximum error: " << max_error << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
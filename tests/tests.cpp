@@ -1,10 +1,28 @@
 #include "approx_tests.hpp"
+#include "binary_model_test.hpp"
+#include "conv1d_fast_path_test.hpp"
+#include "conv1d_sample_rate_test.hpp"
+#include "conv2d_test.hpp"
+#include "dispatch_test.hpp"
+#include "fixed_point_test.hpp"
+#include "half_precision_test.hpp"
 #include "load_csv.hpp"
+#include "low_rank_test.hpp"
+#include "lut_activation_test.hpp"
+#include "maths_provider_test.hpp"
 #include "model_test.hpp"
+#include "parallel_loading_test.hpp"
+#include "quantized_test.hpp"
 #include "sample_rate_rnn_test.hpp"
+#include "sparse_test.hpp"
+#include "streaming_loader_test.hpp"
+#include "strided_conv_test.hpp"
 #include "templated_tests.hpp"
 #include "test_configs.hpp"
+#include "transposed_conv_test.hpp"
 #include "util_tests.hpp"
+#include "wavenet_test.hpp"
+#include "weights_view_test.hpp"
 
 // @TODO: make tests for both float and double precision
 void help()
@@ -18,7 +36,25 @@ void help()
     std::cout << "    util" << std::endl;
     std::cout << "    model" << std::endl;
     std::cout << "    approx" << std::endl;
+    std::cout << "    maths_provider" << std::endl;
+    std::cout << "    lut_activation" << std::endl;
     std::cout << "    sample_rate_rnn" << std::endl;
+    std::cout << "    wavenet" << std::endl;
+    std::cout << "    conv1d_fast_path" << std::endl;
+    std::cout << "    conv1d_sample_rate" << std::endl;
+    std::cout << "    conv2d" << std::endl;
+    std::cout << "    strided_conv" << std::endl;
+    std::cout << "    transposed_conv" << std::endl;
+    std::cout << "    dispatch" << std::endl;
+    std::cout << "    fixed_point" << std::endl;
+    std::cout << "    quantized" << std::endl;
+    std::cout << "    half_precision" << std::endl;
+    std::cout << "    sparse" << std::endl;
+    std::cout << "    low_rank" << std::endl;
+    std::cout << "    binary_model" << std::endl;
+    std::cout << "    streaming_loader" << std::endl;
+    std::cout << "    parallel_loading" << std::endl;
+    std::cout << "    weights_view" << std::endl;
     for(auto& testConfig : tests)
         std::cout << "    " << testConfig.first << std::endl;
 }
@@ -81,6 +117,9 @@ int main(int argc, char* argv[])
 #if RTNEURAL_USE_XSIMD
     std::cout << "XSIMD float register width: " << xsimd::simd_type<float>::size << std::endl;
     std::cout << "XSIMD double register width: " << xsimd::simd_type<double>::size << std::endl;
+#elif RTNEURAL_USE_VECTOR_EXT
+    std::cout << "Vector extension float register width: " << RTNeural::vector_ext::simd_type<float>::size << std::endl;
+    std::cout << "Vector extension double register width: " << RTNeural::vector_ext::simd_type<double>::size << std::endl;
 #endif
 
     if(argc != 2)
@@ -98,12 +137,29 @@ int main(int argc, char* argv[])
 
     if(arg == "all")
     {
-        util_test();
-
         int result = 0;
+        result |= util_test();
         result |= model_test::model_test();
         result |= approximationTests();
+        result |= maths_provider_test::maths_provider_test();
+        result |= lut_activation_test::lut_activation_test();
         result |= sampleRateRNNTest();
+        result |= wavenet_test::wavenet_test();
+        result |= conv1d_fast_path_test::conv1d_fast_path_test();
+        result |= conv1d_sample_rate_test::conv1d_sample_rate_test();
+        result |= conv2d_test::conv2d_test();
+        result |= strided_conv_test::strided_conv_test();
+        result |= transposed_conv_test::transposed_conv_test();
+        result |= dispatch_test::dispatch_test();
+        result |= fixed_point_test::fixed_point_test();
+        result |= quantized_test::quantized_test();
+        result |= half_precision_test::half_precision_test();
+        result |= sparse_test::sparse_test();
+        result |= low_rank_test::low_rank_test();
+        result |= binary_model_test::binary_model_test();
+        result |= streaming_loader_test::streaming_loader_test();
+        result |= parallel_loading_test::parallel_loading_test();
+        result |= weights_view_test::weights_view_test();
 
         for(auto& testConfig : tests)
         {
@@ -116,8 +172,7 @@ int main(int argc, char* argv[])
 
     if(arg == "util")
     {
-        util_test();
-        return 0;
+        return util_test();
     }
 
     if(arg == "model")
@@ -130,11 +185,101 @@ int main(int argc, char* argv[])
         return approximationTests();
     }
 
+    if(arg == "maths_provider")
+    {
+        return maths_provider_test::maths_provider_test();
+    }
+
+    if(arg == "lut_activation")
+    {
+        return lut_activation_test::lut_activation_test();
+    }
+
     if(arg == "sample_rate_rnn")
     {
         return sampleRateRNNTest();
     }
 
+    if(arg == "wavenet")
+    {
+        return wavenet_test::wavenet_test();
+    }
+
+    if(arg == "conv1d_fast_path")
+    {
+        return conv1d_fast_path_test::conv1d_fast_path_test();
+    }
+
+    if(arg == "conv1d_sample_rate")
+    {
+        return conv1d_sample_rate_test::conv1d_sample_rate_test();
+    }
+
+    if(arg == "conv2d")
+    {
+        return conv2d_test::conv2d_test();
+    }
+
+    if(arg == "strided_conv")
+    {
+        return strided_conv_test::strided_conv_test();
+    }
+
+    if(arg == "transposed_conv")
+    {
+        return transposed_conv_test::transposed_conv_test();
+    }
+
+    if(arg == "dispatch")
+    {
+        return dispatch_test::dispatch_test();
+    }
+
+    if(arg == "fixed_point")
+    {
+        return fixed_point_test::fixed_point_test();
+    }
+
+    if(arg == "quantized")
+    {
+        return quantized_test::quantized_test();
+    }
+
+    if(arg == "half_precision")
+    {
+        return half_precision_test::half_precision_test();
+    }
+
+    if(arg == "sparse")
+    {
+        return sparse_test::sparse_test();
+    }
+
+    if(arg == "low_rank")
+    {
+        return low_rank_test::low_rank_test();
+    }
+
+    if(arg == "binary_model")
+    {
+        return binary_model_test::binary_model_test();
+    }
+
+    if(arg == "streaming_loader")
+    {
+        return streaming_loader_test::streaming_loader_test();
+    }
+
+    if(arg == "parallel_loading")
+    {
+        return parallel_loading_test::parallel_loading_test();
+    }
+
+    if(arg == "weights_view")
+    {
+        return weights_view_test::weights_view_test();
+    }
+
     if(tests.find(arg) != tests.end())
     {
         int result = 0;
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace transposed_conv_test
+{
+
+using TestType = double;
+
+constexpr int in_size = 3;
+constexpr int num_filters_out = 2;
+
+nlohmann::json transposed_model_json(int kernel_size, int stride)
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_in;
+    dense_in["type"] = "dense";
+    dense_in["activation"] = "";
+    dense_in["shape"] = { nullptr, nullptr, in_size };
+    dense_in["weights"] = { random_weights(generator, { 1, in_size }), random_weights(generator, { in_size }) };
+
+    nlohmann::json conv;
+    conv["type"] = "transposed-conv1d";
+    conv["activation"] = "tanh";
+    conv["shape"] = { nullptr, nullptr, stride * num_filters_out };
+    conv["kernel_size"] = { kernel_size };
+    conv["strides"] = { stride };
+    conv["weights"] = {
+        random_weights(generator, { in_size, num_filters_out, kernel_size }),
+        random_weights(generator, { num_filters_out }),
+    };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = { dense_in, conv };
+
+    return model;
+}
+
+/** Offline transposed convolution, computed by scattering each input frame into the output. */
+std::vector<TestType> reference_transposed_conv(const std::vector<TestType>& xData, const nlohmann::json& modelJson, int kernel_size, int stride)
+{
+    const auto& jsonLayers = modelJson["layers"];
+    auto denseIn = RTNeural::json_parser::createDense<TestType>(1, in_size, jsonLayers[0]["weights"]);
+    const auto& weights = jsonLayers[1]["weights"];
+
+    // one extra input frame of padding, to hold the tail of the last frame
+    std::vector<TestType> y((xData.size() + (size_t)kernel_size) * stride * num_filters_out, (TestType)0);
+    for(size_t m = 0; m < xData.size(); ++m)
+    {
+        TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[m] };
+        TestType x alignas(RTNEURAL_DEFAULT_ALIGNMENT)[in_size];
+        denseIn->forward(input, x);
+
+        for(int k = 0; k < kernel_size; ++k)
+            for(int co = 0; co < num_filters_out; ++co)
+                for(int ci = 0; ci < in_size; ++ci)
+                    y[(m * stride + k) * num_filters_out + co] += weights[0][ci][co][k].get<TestType>() * x[ci];
+    }
+
+    y.resize(xData.size() * stride * num_filters_out);
+    for(size_t n = 0; n < y.size(); ++n)
+        y[n] = std::tanh(y[n] + weights[1][n % num_filters_out].get<TestType>());
+
+    return y;
+}
+
+template <typename ModelType>
+std::vector<TestType> run_model(ModelType& model, const std::vector<TestType>& xData, int out_size)
+{
+    std::vector<TestType> yData;
+    model.reset();
+    for(size_t n = 0; n < xData.size(); ++n)
+    {
+        TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+        model.forward(input);
+        yData.insert(yData.end(), model.getOutputs(), model.getOutputs() + out_size);
+    }
+
+    return yData;
+}
+
+template <int kernel_size, int stride>
+int transposed_conv_test_config(const std::vector<TestType>& xData)
+{
+    std::cout << "Testing kernel size: " << kernel_size << ", stride: " << stride << std::endl;
+    constexpr TestType threshold = 1.0e-12;
+    constexpr int out_size = stride * num_filters_out;
+
+    const auto modelJson = transposed_model_json(kernel_size, stride);
+    const auto yRefData = reference_transposed_conv(xData, modelJson, kernel_size, stride);
+
+    // non-templated model
+    {
+        std::cout << "Testing non-templated model" << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        const auto yData = run_model(*model, xData, out_size);
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    {
+        std::cout << "Testing templated model" << std::endl;
+        RTNeural::ModelT<TestType, 1, out_size,
+            RTNeural::DenseT<TestType, 1, in_size>,
+            RTNeural::TransposedConv1DT<TestType, in_size, num_filters_out, kernel_size, stride>,
+            RTNeural::TanhActivationT<TestType, out_size>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        const auto yData = run_model(modelT, xData, out_size);
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+    // a templated model can't run the following layers once for each output frame
+    static_assert(!RTNeural::modelt_detail::checkUpsamplingLayers<false,
+                      RTNeural::TransposedConv1DT<TestType, in_size, num_filters_out, kernel_size, stride>,
+                      RTNeural::TanhActivationT<TestType, out_size>,
+                      RTNeural::DenseT<TestType, out_size, 1>>::value,
+        "A dense layer should not be allowed after a TransposedConv1DT layer!");
+#endif
+
+    return 0;
+}
+
+/** Checks that the layers following a transposed convolution run once for each output frame. */
+int transposed_conv_following_layer_test(const std::vector<TestType>& xData)
+{
+    std::cout << "Testing layers following a transposed convolution" << std::endl;
+    constexpr int kernel_size = 5;
+    constexpr int stride = 2;
+    constexpr TestType threshold = 1.0e-12;
+
+    auto modelJson = transposed_model_json(kernel_size, stride);
+    const auto yConvData = reference_transposed_conv(xData, modelJson, kernel_size, stride);
+
+    std::default_random_engine generator;
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { num_filters_out, 1 }), random_weights(generator, { 1 }) };
+    modelJson["layers"].push_back(dense_out);
+
+    auto denseOut = RTNeural::json_parser::createDense<TestType>(num_filters_out, 1, dense_out["weights"]);
+    std::vector<TestType> yRefData(xData.size() * stride);
+    for(size_t n = 0; n < yRefData.size(); ++n)
+        denseOut->forward(&yConvData[n * num_filters_out], &yRefData[n]);
+
+    auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+    if(model->getOutputUpsampling() != stride)
+    {
+        std::cout << "FAIL: incorrect output upsampling: " << model->getOutputUpsampling() << std::endl;
+        return 1;
+    }
+
+    return compare(run_model(*model, xData, stride), yRefData, threshold);
+}
+
+int transposed_conv_test()
+{
+    std::cout << "TESTING TRANSPOSED CONV1D..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+
+    int result = 0;
+    result |= transposed_conv_test_config<5, 2>(xData);
+    result |= transposed_conv_test_config<4, 4>(xData);
+    result |= transposed_conv_test_config<2, 3>(xData);
+    result |= transposed_conv_following_layer_test(xData);
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace transposed_conv_test
@@ -23,10 +23,206 @@ void rule_of_three_test()
 
     std::cout << "\t Testing Conv1D..." << std::endl;
     auto conv1d = make_layer_tuple<RTNeural::Conv1D<TestType>>({ 2, 2, 1, 1 });
+
+    std::cout << "\t Testing StridedConv1D..." << std::endl;
+    auto strided_conv1d = make_layer_tuple<RTNeural::StridedConv1D<TestType>>({ 2, 2, 2, 1, 2 });
+
+    std::cout << "\t Testing TransposedConv1D..." << std::endl;
+    auto transposed_conv1d = make_layer_tuple<RTNeural::TransposedConv1D<TestType>>({ 2, 2, 4, 2 });
+
+    std::cout << "\t Testing Conv2D..." << std::endl;
+    auto conv2d = make_layer_tuple<RTNeural::Conv2D<TestType>>({ 2, 2, 4, 2, 3, 1, 1, 0 });
+
+    std::cout << "\t Testing WaveNetBlock..." << std::endl;
+    auto wavenet = make_layer_tuple<RTNeural::WaveNetBlock<TestType>>({ 2, 1, 2, 2 });
+}
+
+/** Checks that an assigned StridedConv1D produces the same outputs as the layer it was assigned from. */
+int strided_conv1d_assignment_test()
+{
+    std::cout << "\t Testing StridedConv1D assignment..." << std::endl;
+
+    constexpr int in_size = 2;
+    constexpr int out_size = 3;
+    constexpr int kernel_size = 3;
+    std::vector<std::vector<std::vector<TestType>>> weights(out_size,
+        std::vector<std::vector<TestType>>(in_size, std::vector<TestType>(kernel_size)));
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                weights[i][k][j] = std::sin((TestType)(i * 7 + k * 3 + j));
+
+    RTNeural::StridedConv1D<TestType> conv { in_size, out_size, kernel_size, 2, 2 };
+    conv.setWeights(weights);
+    conv.setBias({ 0.1, -0.2, 0.3 });
+    conv.reset();
+
+    const auto input = [](int n, int k) { return std::cos((TestType)(n * in_size + k)); };
+    TestType x[in_size];
+    TestType y[out_size] {};
+    TestType yAssigned[out_size] {};
+
+    // advance the original layer, so that its state is copied as well
+    int n = 0;
+    for(; n < 5; ++n)
+    {
+        x[0] = input(n, 0);
+        x[1] = input(n, 1);
+        conv.forward(x, y);
+    }
+
+    RTNeural::StridedConv1D<TestType> assigned { in_size, out_size, kernel_size, 2, 2 };
+    assigned.reset();
+    assigned = conv;
+
+    for(; n < 20; ++n)
+    {
+        x[0] = input(n, 0);
+        x[1] = input(n, 1);
+        conv.forward(x, y);
+        assigned.forward(x, yAssigned);
+        if(conv.isOutputReady() != assigned.isOutputReady() || (conv.isOutputReady() && !std::equal(y, y + out_size, yAssigned)))
+        {
+            std::cout << "FAIL: Assigned StridedConv1D layer does not match the original layer!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs a layer for a few frames, then checks that a copy of the layer,
+ * and a layer with the same dimensions that it has been assigned to,
+ * produce the same outputs as the original layer from then on.
+ */
+template <typename LayerType>
+int layer_copy_test(const std::string& name, LayerType& layer, LayerType& assigned)
+{
+    std::cout << "\t Testing " << name << " copy and assignment..." << std::endl;
+
+    const auto in_size = layer.in_size;
+    const auto out_size = layer.out_size;
+    std::vector<TestType> x((size_t)in_size);
+    std::vector<TestType> y((size_t)out_size);
+    std::vector<TestType> yCopied((size_t)out_size);
+    std::vector<TestType> yAssigned((size_t)out_size);
+    const auto input = [&x, in_size](int n)
+    {
+        for(int k = 0; k < in_size; ++k)
+            x[(size_t)k] = std::cos((TestType)(n * in_size + k));
+    };
+
+    // advance the original layer, so that its state is copied as well
+    layer.reset();
+    int n = 0;
+    for(; n < 5; ++n)
+    {
+        input(n);
+        layer.forward(x.data(), y.data());
+    }
+
+    LayerType copied { layer };
+    assigned.reset();
+    assigned = layer;
+
+    for(; n < 20; ++n)
+    {
+        input(n);
+        layer.forward(x.data(), y.data());
+        copied.forward(x.data(), yCopied.data());
+        assigned.forward(x.data(), yAssigned.data());
+        if(y != yCopied || y != yAssigned)
+        {
+            std::cout << "FAIL: Copied " << name << " layer does not match the original layer!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/** Returns a vector of arbitrary weights. */
+inline std::vector<TestType> test_values(int size, int offset)
+{
+    std::vector<TestType> values((size_t)size);
+    for(int i = 0; i < size; ++i)
+        values[(size_t)i] = (TestType)0.5 * std::sin((TestType)(offset + i));
+    return values;
 }
 
-void util_test()
+int wavenet_copy_test()
+{
+    constexpr int channels = 2;
+    constexpr int skip_channels = 1;
+    constexpr int kernel_size = 2;
+    std::vector<std::vector<std::vector<TestType>>> convWeights(2 * channels, std::vector<std::vector<TestType>>(channels));
+    for(int i = 0; i < 2 * channels; ++i)
+        for(int k = 0; k < channels; ++k)
+            convWeights[i][k] = test_values(kernel_size, i * 7 + k * 3);
+
+    std::vector<std::vector<TestType>> projWeights(channels + skip_channels);
+    for(int i = 0; i < channels + skip_channels; ++i)
+        projWeights[i] = test_values(channels, i * 5 + 1);
+
+    RTNeural::WaveNetBlock<TestType> wavenet { channels, skip_channels, kernel_size, 2 };
+    wavenet.setConvWeights(convWeights);
+    wavenet.setConvBias(test_values(2 * channels, 11));
+    wavenet.setProjectionWeights(projWeights);
+    wavenet.setProjectionBias(test_values(channels + skip_channels, 13));
+
+    RTNeural::WaveNetBlock<TestType> assigned { channels, skip_channels, kernel_size, 2 };
+    return layer_copy_test("WaveNetBlock", wavenet, assigned);
+}
+
+int conv2d_copy_test()
+{
+    constexpr int filters_in = 2;
+    constexpr int filters_out = 2;
+    constexpr int kernel_size_time = 2;
+    constexpr int kernel_size_feature = 3;
+    std::vector<std::vector<std::vector<std::vector<TestType>>>> weights(filters_out,
+        std::vector<std::vector<std::vector<TestType>>>(filters_in, std::vector<std::vector<TestType>>(kernel_size_time)));
+    for(int i = 0; i < filters_out; ++i)
+        for(int k = 0; k < filters_in; ++k)
+            for(int j = 0; j < kernel_size_time; ++j)
+                weights[i][k][j] = test_values(kernel_size_feature, i * 7 + k * 3 + j * 11);
+
+    RTNeural::Conv2D<TestType> conv { filters_in, filters_out, 4, kernel_size_time, kernel_size_feature, 2, 1, false };
+    conv.setWeights(weights);
+    conv.setBias(test_values(filters_out, 5));
+
+    RTNeural::Conv2D<TestType> assigned { filters_in, filters_out, 4, kernel_size_time, kernel_size_feature, 2, 1, false };
+    return layer_copy_test("Conv2D", conv, assigned);
+}
+
+int transposed_conv1d_copy_test()
+{
+    constexpr int in_size = 2;
+    constexpr int filters_out = 3;
+    constexpr int kernel_size = 5;
+    std::vector<std::vector<std::vector<TestType>>> weights(filters_out, std::vector<std::vector<TestType>>(in_size));
+    for(int i = 0; i < filters_out; ++i)
+        for(int k = 0; k < in_size; ++k)
+            weights[i][k] = test_values(kernel_size, i * 7 + k * 3);
+
+    RTNeural::TransposedConv1D<TestType> conv { in_size, filters_out, kernel_size, 2 };
+    conv.setWeights(weights);
+    conv.setBias(test_values(filters_out, 5));
+
+    RTNeural::TransposedConv1D<TestType> assigned { in_size, filters_out, kernel_size, 2 };
+    return layer_copy_test("TransposedConv1D", conv, assigned);
+}
+
+int util_test()
 {
     std::cout << "Running Rule of Three Test:" << std::endl;
     rule_of_three_test();
+
+    int result = 0;
+    result |= strided_conv1d_assignment_test();
+    result |= wavenet_copy_test();
+    result |= conv2d_copy_test();
+    result |= transposed_conv1d_copy_test();
+    return result;
 }
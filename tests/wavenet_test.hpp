@@ -0,0 +1,181 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+#include "load_csv.hpp"
+#include "test_configs.hpp"
+
+namespace wavenet_test
+{
+
+using TestType = double;
+
+constexpr int channels = 8;
+constexpr int skip_channels = 4;
+constexpr int io_size = channels + skip_channels;
+
+nlohmann::json wavenet_block_json(std::default_random_engine& generator, int kernel_size, int dilation)
+{
+    nlohmann::json layer;
+    layer["type"] = "wavenet-block";
+    layer["activation"] = "";
+    layer["shape"] = { nullptr, nullptr, io_size };
+    layer["channels"] = channels;
+    layer["kernel_size"] = { kernel_size };
+    layer["dilation"] = { dilation };
+    layer["weights"] = {
+        random_weights(generator, { kernel_size, channels, 2 * channels }),
+        random_weights(generator, { 2 * channels }),
+        random_weights(generator, { channels, io_size }),
+        random_weights(generator, { io_size }),
+    };
+
+    return layer;
+}
+
+nlohmann::json wavenet_model_json()
+{
+    std::default_random_engine generator;
+
+    nlohmann::json dense_in;
+    dense_in["type"] = "dense";
+    dense_in["activation"] = "";
+    dense_in["shape"] = { nullptr, nullptr, io_size };
+    dense_in["weights"] = { random_weights(generator, { 1, io_size }), random_weights(generator, { io_size }) };
+
+    nlohmann::json dense_out;
+    dense_out["type"] = "dense";
+    dense_out["activation"] = "";
+    dense_out["shape"] = { nullptr, nullptr, 1 };
+    dense_out["weights"] = { random_weights(generator, { io_size, 1 }), random_weights(generator, { 1 }) };
+
+    nlohmann::json model;
+    model["in_shape"] = { nullptr, nullptr, 1 };
+    model["layers"] = {
+        dense_in,
+        wavenet_block_json(generator, 3, 2),
+        wavenet_block_json(generator, 2, 4),
+        wavenet_block_json(generator, 1, 1),
+        dense_out,
+    };
+
+    return model;
+}
+
+/** WaveNet block built from separate Conv1D and Dense layers. */
+struct ReferenceBlock
+{
+    ReferenceBlock(const nlohmann::json& l)
+        : conv(channels, 2 * channels, l["kernel_size"].back().get<int>(), l["dilation"].back().get<int>())
+        , proj(channels, io_size)
+    {
+        const auto weights = l["weights"];
+        RTNeural::json_parser::loadConv1D<TestType>(conv, conv.getKernelSize(), conv.getDilationRate(),
+            { weights[0], weights[1] });
+        RTNeural::json_parser::loadDense<TestType>(proj, { weights[2], weights[3] });
+    }
+
+    void forward(const TestType* input, TestType* out)
+    {
+        conv.forward(input, gate);
+        for(int i = 0; i < channels; ++i)
+            z[i] = std::tanh(gate[i]) / ((TestType)1 + std::exp(-gate[channels + i]));
+
+        proj.forward(z, out);
+        for(int i = 0; i < io_size; ++i)
+            out[i] += input[i];
+    }
+
+    RTNeural::Conv1D<TestType> conv;
+    RTNeural::Dense<TestType> proj;
+
+    TestType gate alignas(RTNEURAL_DEFAULT_ALIGNMENT)[2 * channels];
+    TestType z alignas(RTNEURAL_DEFAULT_ALIGNMENT)[channels];
+};
+
+int wavenet_test()
+{
+    std::cout << "TESTING WAVENET BLOCK..." << std::endl;
+
+    const std::string data_file = "test_data/conv_x_python.csv";
+    constexpr TestType threshold = 1.0e-12;
+
+    std::ifstream pythonX(data_file);
+    const auto xData = load_csv::loadFile<TestType>(pythonX);
+    const auto modelJson = wavenet_model_json();
+    const auto& jsonLayers = modelJson["layers"];
+
+    // reference model, made from separate layers
+    std::vector<TestType> yRefData(xData.size(), (TestType)0);
+    {
+        std::unique_ptr<RTNeural::Dense<TestType>> denseIn = RTNeural::json_parser::createDense<TestType>(1, io_size, jsonLayers[0]["weights"]);
+        std::unique_ptr<RTNeural::Dense<TestType>> denseOut = RTNeural::json_parser::createDense<TestType>(io_size, 1, jsonLayers[4]["weights"]);
+        // the blocks are kept on the stack, since operator new (before C++17)
+        // doesn't respect the alignment of the block's buffers.
+        ReferenceBlock blocks[] = { { jsonLayers[1] }, { jsonLayers[2] }, { jsonLayers[3] } };
+        for(auto& block : blocks)
+            block.conv.reset();
+
+        TestType xBuffer alignas(RTNEURAL_DEFAULT_ALIGNMENT)[io_size] {};
+        TestType yBuffer alignas(RTNEURAL_DEFAULT_ALIGNMENT)[io_size] {};
+        TestType* x = xBuffer;
+        TestType* y = yBuffer;
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            denseIn->forward(input, x);
+            for(auto& block : blocks)
+            {
+                block.forward(x, y);
+                std::swap(x, y);
+            }
+
+            denseOut->forward(x, &yRefData[n]);
+        }
+    }
+
+    // non-templated model
+    std::vector<TestType> yData(xData.size(), (TestType)0);
+    {
+        std::cout << "Testing non-templated model" << std::endl;
+        auto model = RTNeural::json_parser::parseJson<TestType>(modelJson, true);
+        model->reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = model->forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+
+#if MODELT_AVAILABLE
+    // templated model
+    {
+        std::cout << "Testing templated model" << std::endl;
+        RTNeural::ModelT<TestType, 1, 1,
+            RTNeural::DenseT<TestType, 1, io_size>,
+            RTNeural::WaveNetBlockT<TestType, channels, skip_channels, 3, 2>,
+            RTNeural::WaveNetBlockT<TestType, channels, skip_channels, 2, 4>,
+            RTNeural::WaveNetBlockT<TestType, channels, skip_channels, 1, 1>,
+            RTNeural::DenseT<TestType, io_size, 1>>
+            modelT;
+        modelT.parseJson(modelJson, true);
+        modelT.reset();
+        for(size_t n = 0; n < xData.size(); ++n)
+        {
+            TestType input alignas(RTNEURAL_DEFAULT_ALIGNMENT)[] = { xData[n] };
+            yData[n] = modelT.forward(input);
+        }
+
+        if(compare(yData, yRefData, threshold))
+            return 1;
+    }
+#endif
+
+    std::cout << "SUCCESS" << std::endl;
+    return 0;
+}
+
+} // namespace wavenet_test
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <random>
+#include <RTNeural.h>
+
+namespace weights_view_test
+{
+
+using TestType = double;
+
+constexpr TestType threshold = 1.0e-12;
+constexpr int nIter = 100;
+
+std::vector<TestType> random_values(size_t size, std::default_random_engine& generator)
+{
+    std::uniform_real_distribution<TestType> distribution((TestType)-1, (TestType)1);
+
+    std::vector<TestType> values(size);
+    for(auto& x : values)
+        x = distribution(generator);
+    return values;
+}
+
+std::vector<std::vector<TestType>> to_matrix(const RTNeural::WeightsView<TestType, 2>& view)
+{
+    std::vector<std::vector<TestType>> matrix((size_t)view.size(0), std::vector<TestType>((size_t)view.size(1)));
+    for(int i = 0; i < view.size(0); ++i)
+        for(int j = 0; j < view.size(1); ++j)
+            matrix[(size_t)i][(size_t)j] = view(i, j);
+    return matrix;
+}
+
+/** Runs two layers with the same random inputs, and checks that their outputs match. */
+int compare_layers(const std::string& name, RTNeural::Layer<TestType>& layer, RTNeural::Layer<TestType>& refLayer)
+{
+    std::default_random_engine generator;
+    std::vector<TestType> outs((size_t)layer.out_size);
+    std::vector<TestType> refOuts((size_t)layer.out_size);
+
+    layer.reset();
+    refLayer.reset();
+
+    auto maxError = (TestType)0;
+    for(int n = 0; n < nIter; ++n)
+    {
+        const auto ins = random_values((size_t)layer.in_size, generator);
+        layer.forward(ins.data(), outs.data());
+        refLayer.forward(ins.data(), refOuts.data());
+        for(size_t i = 0; i < outs.size(); ++i)
+            maxError = std::max(maxError, std::abs(outs[i] - refOuts[i]));
+    }
+
+    if(maxError > threshold)
+    {
+        std::cout << "FAIL: " << name << " layer loaded from a weights view is incorrect! Maximum error: " << maxError << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/** Checks the indexing of transposed and reversed views. */
+int test_view_layout()
+{
+    std::cout << "Testing weights view layout" << std::endl;
+
+    const TestType values[] = { 0, 1, 2, 3, 4, 5 };
+    const auto view = RTNeural::WeightsView<TestType, 2>::rowMajor(values, { 2, 3 });
+    const auto transposed = view.transposed();
+    const auto reversed = view.reversed(1);
+
+    int result = 0;
+    for(int i = 0; i < 2; ++i)
+    {
+        for(int j = 0; j < 3; ++j)
+        {
+            if(view(i, j) != values[i * 3 + j] || transposed(j, i) != view(i, j) || reversed(i, 2 - j) != view(i, j))
+                result = 1;
+        }
+    }
+
+    if(transposed.size(0) != 3 || transposed.size(1) != 2)
+        result = 1;
+
+    if(result != 0)
+        std::cout << "FAIL: Weights view has the wrong layout!" << std::endl;
+
+    return result;
+}
+
+int test_dense()
+{
+    std::cout << "Testing Dense layer with weights view" << std::endl;
+
+    constexpr int in_size = 13;
+    constexpr int out_size = 7;
+
+    // kernel stored as [in_size][out_size]
+    std::default_random_engine generator;
+    const auto kernel = random_values(in_size * out_size, generator);
+    auto bias = random_values(out_size, generator);
+    const auto view = RTNeural::WeightsView<TestType, 2>::rowMajor(kernel.data(), { in_size, out_size }).transposed();
+
+    RTNeural::Dense<TestType> dense { in_size, out_size };
+    dense.setWeights(view);
+    dense.setBias(bias.data());
+
+    RTNeural::Dense<TestType> refDense { in_size, out_size };
+    refDense.setWeights(to_matrix(view));
+    refDense.setBias(bias.data());
+
+    return compare_layers("Dense", dense, refDense);
+}
+
+int test_conv1d()
+{
+    std::cout << "Testing Conv1D layer with weights view" << std::endl;
+
+    constexpr int in_size = 3;
+    constexpr int out_size = 5;
+    constexpr int kernel_size = 4;
+    constexpr int dilation = 2;
+
+    // kernel stored as [kernel_size][in_size][out_size], with the taps in reverse order
+    std::default_random_engine generator;
+    const auto kernel = random_values(kernel_size * in_size * out_size, generator);
+    auto bias = random_values(out_size, generator);
+    const auto view = RTNeural::WeightsView<TestType, 3>::rowMajor(kernel.data(), { kernel_size, in_size, out_size })
+                          .transposed(0, 2)
+                          .reversed(2);
+
+    std::vector<std::vector<std::vector<TestType>>> weights(out_size,
+        std::vector<std::vector<TestType>>(in_size, std::vector<TestType>(kernel_size)));
+    for(int i = 0; i < out_size; ++i)
+        for(int k = 0; k < in_size; ++k)
+            for(int j = 0; j < kernel_size; ++j)
+                weights[(size_t)i][(size_t)k][(size_t)j] = kernel[(size_t)(((kernel_size - 1 - j) * in_size + k) * out_size + i)];
+
+    RTNeural::Conv1D<TestType> conv { in_size, out_size, kernel_size, dilation };
+    conv.setWeights(view);
+    conv.setBias(bias);
+
+    RTNeural::Conv1D<TestType> refConv { in_size, out_size, kernel_size, dilation };
+    refConv.setWeights(weights);
+    refConv.setBias(bias);
+
+    return compare_layers("Conv1D", conv, refConv);
+}
+
+int test_gru()
+{
+    std::cout << "Testing GRU layer with weights view" << std::endl;
+
+    constexpr int in_size = 4;
+    constexpr int out_size = 6;
+
+    std::default_random_engine generator;
+    const auto wVals = random_values(in_size * 3 * out_size, generator);
+    const auto uVals = random_values(out_size * 3 * out_size, generator);
+    const auto bVals = random_values(2 * 3 * out_size, generator);
+    const auto wView = RTNeural::WeightsView<TestType, 2>::rowMajor(wVals.data(), { in_size, 3 * out_size });
+    const auto uView = RTNeural::WeightsView<TestType, 2>::rowMajor(uVals.data(), { out_size, 3 * out_size });
+    const auto bView = RTNeural::WeightsView<TestType, 2>::rowMajor(bVals.data(), { 2, 3 * out_size });
+
+    RTNeural::GRULayer<TestType> gru { in_size, out_size };
+    gru.setWVals(wView);
+    gru.setUVals(uView);
+    gru.setBVals(bView);
+
+    RTNeural::GRULayer<TestType> refGru { in_size, out_size };
+    refGru.setWVals(to_matrix(wView));
+    refGru.setUVals(to_matrix(uView));
+    refGru.setBVals(to_matrix(bView));
+
+    return compare_layers("GRU", gru, refGru);
+}
+
+int test_lstm()
+{
+    std::cout << "Testing LSTM layer with weights view" << std::endl;
+
+    constexpr int in_size = 4;
+    constexpr int out_size = 6;
+
+    std::default_random_engine generator;
+    const auto wVals = random_values(in_size * 4 * out_size, generator);
+    const auto uVals = random_values(out_size * 4 * out_size, generator);
+    const auto bVals = random_values(4 * out_size, generator);
+    const auto wView = RTNeural::WeightsView<TestType, 2>::rowMajor(wVals.data(), { in_size, 4 * out_size });
+    const auto uView = RTNeural::WeightsView<TestType, 2>::rowMajor(uVals.data(), { out_size, 4 * out_size });
+
+    RTNeural::LSTMLayer<TestType> lstm { in_size, out_size };
+    lstm.setWVals(wView);
+    lstm.setUVals(uView);
+    lstm.setBVals(bVals);
+
+    RTNeural::LSTMLayer<TestType> refLstm { in_size, out_size };
+    refLstm.setWVals(to_matrix(wView));
+    refLstm.setUVals(to_matrix(uView));
+    refLstm.setBVals(bVals);
+
+    return compare_layers("LSTM", lstm, refLstm);
+}
+
+#if MODELT_AVAILABLE
+/** Checks that templated layers loaded from weights views match the same layers loaded from vectors. */
+int test_templated_layers()
+{
+    std::cout << "Testing templated layers with weights view" << std::endl;
+
+    constexpr int in_size = 4;
+    constexpr int out_size = 8;
+
+    using ModelType = RTNeural::ModelT<TestType, in_size, 1,
+        RTNeural::DenseT<TestType, in_size, out_size>,
+        RTNeural::GRULayerT<TestType, out_size, out_size>,
+        RTNeural::LSTMLayerT<TestType, out_size, out_size>,
+        RTNeural::DenseT<TestType, out_size, 1>>;
+
+    std::default_random_engine generator;
+    const auto denseKernel = random_values(out_size * in_size, generator);
+    auto denseBias = random_values(out_size, generator);
+    const auto gruW = random_values(out_size * 3 * out_size, generator);
+    const auto gruU = random_values(out_size * 3 * out_size, generator);
+    const auto gruB = random_values(2 * 3 * out_size, generator);
+    const auto lstmW = random_values(out_size * 4 * out_size, generator);
+    const auto lstmU = random_values(out_size * 4 * out_size, generator);
+    const auto lstmB = random_values(4 * out_size, generator);
+    const auto outKernel = random_values(out_size, generator);
+    auto outBias = random_values(1, generator);
+
+    using View2 = RTNeural::WeightsView<TestType, 2>;
+    const auto denseView = View2::rowMajor(denseKernel.data(), { out_size, in_size });
+    const auto gruWView = View2::rowMajor(gruW.data(), { out_size, 3 * out_size });
+    const auto gruUView = View2::rowMajor(gruU.data(), { out_size, 3 * out_size });
+    const auto gruBView = View2::rowMajor(gruB.data(), { 2, 3 * out_size });
+    const auto lstmWView = View2::rowMajor(lstmW.data(), { out_size, 4 * out_size });
+    const auto lstmUView = View2::rowMajor(lstmU.data(), { out_size, 4 * out_size });
+    const auto outView = View2::rowMajor(outKernel.data(), { 1, out_size });
+
+    ModelType model;
+    model.get<0>().setWeights(denseView);
+    model.get<0>().setBias(denseBias.data());
+    model.get<1>().setWVals(gruWView);
+    model.get<1>().setUVals(gruUView);
+    model.get<1>().setBVals(gruBView);
+    model.get<2>().setWVals(lstmWView);
+    model.get<2>().setUVals(lstmUView);
+    model.get<2>().setBVals(lstmB);
+    model.get<3>().setWeights(outView);
+    model.get<3>().setBias(outBias.data());
+
+    ModelType refModel;
+    refModel.get<0>().setWeights(to_matrix(denseView));
+    refModel.get<0>().setBias(denseBias.data());
+    refModel.get<1>().setWVals(to_matrix(gruWView));
+    refModel.get<1>().setUVals(to_matrix(gruUView));
+    refModel.get<1>().setBVals(to_matrix(gruBView));
+    refModel.get<2>().setWVals(to_matrix(lstmWView));
+    refModel.get<2>().setUVals(to_matrix(lstmUView));
+    refModel.get<2>().setBVals(lstmB);
+    refModel.get<3>().setWeights(to_matrix(outView));
+    refModel.get<3>().setBias(outBias.data());
+
+    model.reset();
+    refModel.reset();
+
+    auto maxError = (TestType)0;
+    for(int n = 0; n < nIter; ++n)
+    {
+        const auto ins = random_values(in_size, generator);
+        maxError = std::max(maxError, std::abs(model.forward(ins.data()) - refModel.forward(ins.data())));
+    }
+
+    if(maxError > threshold)
+    {
+        std::cout << "FAIL: Templated layers loaded from weights views are incorrect! Maximum error: " << maxError << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+#endif
+
+int weights_view_test()
+{
+    std::cout << "TESTING WEIGHTS VIEW SETTERS..." << std::endl;
+
+    int result = 0;
+    result |= test_view_layout();
+    result |= test_dense();
+    result |= test_conv1d();
+    result |= test_gru();
+    result |= test_lstm();
+
+#if MODELT_AVAILABLE
+    result |= test_templated_layers();
+#endif
+
+    if(result == 0)
+        std::cout << "SUCCESS" << std::endl;
+
+    return result;
+}
+
+} // namespace weights_view_test